@@ -1,1003 +1,862 @@
 #include "obj_parser.hpp"
 
 #include <fstream>
-#include <sstream>
-#include <cctype>
+#include <iterator>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
-bool obj::obj_parser::parse(std::istream& istream)
+namespace {
+
+// Whitespace within a line, lines are separated by '\n'
+inline bool is_space(char c)
 {
-    std::string line;
-    std::size_t line_number = 0;
-    
-    std::size_t number_of_geometric_vertices = 0, number_of_texture_vertices = 0, number_of_vertex_normals = 0, number_of_faces = 0, number_of_group_names = 0, number_of_smoothing_groups = 0, number_of_object_names = 0, number_of_material_libraries = 0, number_of_material_names = 0;
-    
-    while (!istream.eof() && std::getline(istream, line)) {
-        ++line_number;
-        std::istringstream stringstream(line);
-        stringstream.unsetf(std::ios_base::skipws);
-        
-        stringstream >> std::ws;
-        if (stringstream.eof()) {
-            if (flags_ & parse_blank_lines_as_comment) {
-                if (comment_callback_) {
-                    comment_callback_(line);
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline void skip_space(const char*& p, const char* end)
+{
+    while (p != end && is_space(*p)) {
+        ++p;
+    }
+}
+
+// Returns true if p is at the end of the line or at whitespace, i.e. the previous token is complete
+inline bool at_separator(const char* p, const char* end)
+{
+    return p == end || is_space(*p);
+}
+
+// Returns true if the token starting at p equals the keyword
+inline bool is_keyword(const char* p, const char* end, const char* keyword, std::size_t length)
+{
+    return std::size_t(end - p) == length && std::memcmp(p, keyword, length) == 0;
+}
+
+// Reads a word up to the next whitespace
+inline void parse_word(const char*& p, const char* end, const char*& word_begin, const char*& word_end)
+{
+    word_begin = p;
+    while (p != end && !is_space(*p)) {
+        ++p;
+    }
+    word_end = p;
+}
+
+bool parse_index(const char*& p, const char* end, obj::index_type& value)
+{
+    const char* s = p;
+    bool negative = false;
+    if (s != end && (*s == '+' || *s == '-')) {
+        negative = (*s == '-');
+        ++s;
+    }
+    if (s == end || !is_digit(*s)) {
+        return false;
+    }
+    obj::index_type result = 0;
+    while (s != end && is_digit(*s)) {
+        result = result * 10 + (*s - '0');
+        ++s;
+    }
+    value = negative ? -result : result;
+    p = s;
+    return true;
+}
+
+// Parses a decimal floating point number. Numbers with up to 19 significant digits and a small exponent are
+// converted exactly with a single multiplication or division, everything else is handed to strtod.
+bool parse_float(const char*& p, const char* end, obj::float_type& value)
+{
+    static const double powers_of_ten[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char* s = p;
+    bool negative = false;
+    if (s != end && (*s == '+' || *s == '-')) {
+        negative = (*s == '-');
+        ++s;
+    }
+
+    std::uint64_t mantissa = 0;
+    int exponent = 0, significant_digits = 0;
+    bool exact = true, has_digits = false;
+    while (s != end && is_digit(*s)) {
+        has_digits = true;
+        if (significant_digits < 19) {
+            mantissa = mantissa * 10 + std::uint64_t(*s - '0');
+            if (mantissa != 0) {
+                ++significant_digits;
+            }
+        }
+        else {
+            ++exponent;
+            exact &= (*s == '0');
+        }
+        ++s;
+    }
+    if (s != end && *s == '.') {
+        ++s;
+        while (s != end && is_digit(*s)) {
+            has_digits = true;
+            if (significant_digits < 19) {
+                mantissa = mantissa * 10 + std::uint64_t(*s - '0');
+                if (mantissa != 0) {
+                    ++significant_digits;
                 }
+                --exponent;
             }
+            else {
+                exact &= (*s == '0');
+            }
+            ++s;
         }
-        else if (stringstream.peek() == '#') {
-            if (comment_callback_) {
-                comment_callback_(line);
+    }
+    if (!has_digits) {
+        return false;
+    }
+    if (s != end && (*s == 'e' || *s == 'E')) {
+        ++s;
+        bool negative_exponent = false;
+        if (s != end && (*s == '+' || *s == '-')) {
+            negative_exponent = (*s == '-');
+            ++s;
+        }
+        if (s == end || !is_digit(*s)) {
+            return false;
+        }
+        int explicit_exponent = 0;
+        while (s != end && is_digit(*s)) {
+            if (explicit_exponent < 10000) {
+                explicit_exponent = explicit_exponent * 10 + (*s - '0');
             }
+            ++s;
+        }
+        exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+    }
+
+    if (exact && mantissa <= (std::uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+        double result = double(mantissa);
+        result = exponent < 0 ? result / powers_of_ten[-exponent] : result * powers_of_ten[exponent];
+        value = negative ? -result : result;
+    }
+    else {
+        char buffer[128];
+        std::size_t length = std::size_t(s - p);
+        if (length < sizeof(buffer)) {
+            std::memcpy(buffer, p, length);
+            buffer[length] = '\0';
+            value = std::strtod(buffer, nullptr);
         }
         else {
-            std::string keyword;
-            stringstream >> keyword;
-            
-            // geometric vertex (v)
-            if (keyword == "v") {
-                float_type x, y, z;
-                char whitespace_v_x, whitespace_x_y, whitespace_y_z;
-                stringstream >> whitespace_v_x >> std::ws >> x >> whitespace_x_y >> std::ws >> y >> whitespace_y_z >> std::ws >> z >> std::ws;
-                if (!stringstream.eof() || !std::isspace(whitespace_v_x) || !std::isspace(whitespace_x_y) || !std::isspace(whitespace_y_z)) {
-                    if (error_callback_) {
-                        error_callback_(line_number, "parse error (v)");
-                    }
-                    return false;
-                }
-                ++number_of_geometric_vertices;
-                if (geometric_vertex_callback_) {
-                    geometric_vertex_callback_(x, y, z);
-                }
+            value = std::strtod(std::string(p, s).c_str(), nullptr);
+        }
+    }
+    p = s;
+    return true;
+}
+
+// Reads v, v/vt, v//vn or v/vt/vn, missing indices are set to 0
+bool parse_face_vertex(const char*& p, const char* end, obj::obj_parser::face_format_type& format, obj::obj_parser::face_vertex_type& vertex)
+{
+    vertex.v = vertex.vt = vertex.vn = 0;
+    format = obj::obj_parser::face_format_v;
+    if (!parse_index(p, end, vertex.v)) {
+        return false;
+    }
+    if (p != end && *p == '/') {
+        ++p;
+        if (p != end && *p == '/') {
+            ++p;
+            format = obj::obj_parser::face_format_v_vn;
+            if (!parse_index(p, end, vertex.vn)) {
+                return false;
             }
-            
-            // texture vertex (vt)
-            else if (keyword == "vt") {
-                float_type u, v;
-                char whitespace_vt_u, whitespace_u_v;
-                stringstream >> whitespace_vt_u >> std::ws >> u >> whitespace_u_v >> std::ws >> v;
-                char whitespace_v_w = ' ';
-                if (!stringstream.eof()) {
-                    stringstream >> whitespace_v_w >> std::ws;
-                }
-                if (!std::isspace(whitespace_vt_u) || !std::isspace(whitespace_u_v) || !std::isspace(whitespace_v_w)) {
-                    if (error_callback_) {
-                        error_callback_(line_number, "parse error (vt)");
-                    }
-                    return false;
-                }
-                if (stringstream.eof()) {
-                    ++number_of_texture_vertices;
-                    if (texture_vertex_callback_) {
-                        texture_vertex_callback_(u, v);
-                    }
-                }
-                else {
-                    float_type w;
-                    stringstream >> w >> std::ws;
-                    if (!stringstream.eof()) {
-                        if (error_callback_) {
-                            error_callback_(line_number, "parse error (vt)");
-                        }
-                        return false;
-                    }
-                    ++number_of_texture_vertices;
-                    if (w == float_type(0.0)) {
-                        if (texture_vertex_callback_) {
-                            texture_vertex_callback_(u, v);
-                        }
-                    }
-                    else {
-                        if (error_callback_) {
-                            error_callback_(line_number, "parse error (vt)");
-                        }
-                        return false;
-                    }
-                }
+        }
+        else {
+            format = obj::obj_parser::face_format_v_vt;
+            if (!parse_index(p, end, vertex.vt)) {
+                return false;
             }
-            
-            // vertex normal (vn)
-            else if (keyword == "vn") {
-                float_type x, y, z;
-                char whitespace_vn_x, whitespace_x_y, whitespace_y_z;
-                stringstream >> whitespace_vn_x >> std::ws >> x >> whitespace_x_y >> std::ws >> y >> whitespace_y_z >> std::ws >> z >> std::ws;
-                if (!stringstream.eof() || !std::isspace(whitespace_vn_x) || !std::isspace(whitespace_x_y) || !std::isspace(whitespace_y_z)) {
-                    if (error_callback_) {
-                        error_callback_(line_number, "parse error (vn)");
-                    }
+            if (p != end && *p == '/') {
+                ++p;
+                format = obj::obj_parser::face_format_v_vt_vn;
+                if (!parse_index(p, end, vertex.vn)) {
                     return false;
                 }
-                ++number_of_vertex_normals;
-                if (vertex_normal_callback_) {
-                    vertex_normal_callback_(x, y, z);
-                }
             }
-            
-            // face (f)
-            else if ((keyword == "f") || (keyword == "fo")) {
-                index_type v1;
-                char whitespace_f_v1;
-                stringstream >> whitespace_f_v1 >> std::ws >> v1;
-                if (std::isspace(stringstream.peek())) {
-                    // f v
-                    index_type v2, v3;
-                    char whitespace_v1_v2, whitespace_v2_v3;
-                    stringstream >> whitespace_v1_v2 >> std::ws >> v2 >> whitespace_v2_v3 >> std::ws >> v3;
-                    char whitespace_v3_v4 = ' ';
-                    if (!stringstream.eof()) {
-                        stringstream >> whitespace_v3_v4 >> std::ws;
-                    }
-                    if (!std::isspace(whitespace_f_v1) || !std::isspace(whitespace_v1_v2) || !std::isspace(whitespace_v2_v3) || !std::isspace(whitespace_v3_v4)) {
-                        if (error_callback_) {
-                            error_callback_(line_number, "parse error (f/fo)");
-                        }
-                        return false;
-                    }
-                    if (((v1 < -index_type(number_of_geometric_vertices)) || (-1 < v1)) && ((v1 < 1) || (index_type(number_of_geometric_vertices) < v1))
-                        || ((v2 < -index_type(number_of_geometric_vertices)) || (-1 < v2)) && ((v2 < 1) || (index_type(number_of_geometric_vertices) < v2))
-                        || ((v3 < -index_type(number_of_geometric_vertices)) || (-1 < v3)) && ((v3 < 1) || (index_type(number_of_geometric_vertices) < v3))) {
-                        if (error_callback_) {
-                            error_callback_(line_number, "index out of bounds (f/fo)");
-                        }
-                        return false;
-                    }
-                    if (flags_ & translate_negative_indices) {
-                        if (v1 < 0) {
-                            v1 += number_of_geometric_vertices + 1;
-                        }
-                        if (v2 < 0) {
-                            v2 += number_of_geometric_vertices + 1;
-                        }
-                        if (v3 < 0) {
-                            v3 += number_of_geometric_vertices + 1;
-                        }
-                    }
-                    if (stringstream.eof()) {
-                        ++number_of_faces;
-                        if (triangular_face_geometric_vertices_callback_) {
-                            triangular_face_geometric_vertices_callback_(v1, v2, v3);
-                        }
-                    }
-                    else {
-                        index_type v4;
-                        stringstream >> v4;
-                        char whitespace_v4_v5 = ' ';
-                        if (!stringstream.eof()) {
-                            stringstream >> whitespace_v4_v5 >> std::ws;
-                        }
-                        if (!std::isspace(whitespace_v4_v5)) {
-                            if (error_callback_) {
-                                error_callback_(line_number, "parse error (f/fo)");
-                            }
-                            return false;
-                        }
-                        if (((v4 < -index_type(number_of_geometric_vertices)) || (-1 < v4)) && ((v4 < 1) || (index_type(number_of_geometric_vertices) < v4))) {
-                            if (error_callback_) {
-                                error_callback_(line_number, "index out of bounds (f/fo)");
-                            }
-                            return false;
-                        }
-                        if (flags_ & translate_negative_indices) {
-                            if (v4 < 0) {
-                                v4 += number_of_geometric_vertices + 1;
-                            }
-                        }
-                        if (stringstream.eof()) {
-                            ++number_of_faces;
-                            if (flags_ & triangulate_faces) {
-                                if (triangular_face_geometric_vertices_callback_) {
-                                    triangular_face_geometric_vertices_callback_(v1, v2, v3);
-                                    triangular_face_geometric_vertices_callback_(v1, v3, v4);
-                                }
-                            }
-                        }
-                        else {
-                            if (flags_ & triangulate_faces) {
-                                if (triangular_face_geometric_vertices_callback_) {
-                                    triangular_face_geometric_vertices_callback_(v1, v2, v3);
-                                    triangular_face_geometric_vertices_callback_(v1, v3, v4);
-                                }
-                                index_type v_previous = v4;
-                                do {
-                                    index_type v;
-                                    stringstream >> v;
-                                    char whitespace_v_v = ' ';
-                                    if (!stringstream.eof()) {
-                                        stringstream >> whitespace_v_v >> std::ws;
-                                    }
-                                    if (stringstream && std::isspace(whitespace_v_v)) {
-                                        if (((v < -index_type(number_of_geometric_vertices)) || (-1 < v)) && ((v < 1) || (index_type(number_of_geometric_vertices) < v))) {
-                                            if (error_callback_) {
-                                                error_callback_(line_number, "index out of bounds (f/fo)");
-                                            }
-                                            return false;
-                                        }
-                                        if (flags_ & translate_negative_indices) {
-                                            if (v < 0) {
-                                                v += number_of_geometric_vertices + 1;
-                                            }
-                                        }
-                                        if (triangular_face_geometric_vertices_callback_) {
-                                            triangular_face_geometric_vertices_callback_(v1, v_previous, v);
-                                        }
-                                        v_previous = v;
-                                    }
-                                }
-                                while (stringstream && !stringstream.eof());
-                                if (!stringstream.eof()) {
-                                    if (error_callback_) {
-                                        error_callback_(line_number, "parse error (f/fo)");
-                                    }
-                                    return false;
-                                }
-                                ++number_of_faces;
-                            }
-                            else {
-                                if (polygonal_face_geometric_vertices_begin_callback_) {
-                                    polygonal_face_geometric_vertices_begin_callback_(v1, v2, v3);
-                                }
-                                if (polygonal_face_geometric_vertices_vertex_callback_) {
-                                    polygonal_face_geometric_vertices_vertex_callback_(v4);
-                                }
-                                do {
-                                    index_type v;
-                                    stringstream >> v;
-                                    char whitespace_v_v = ' ';
-                                    if (!stringstream.eof()) {
-                                        stringstream >> whitespace_v_v >> std::ws;
-                                    }
-                                    if (stringstream && std::isspace(whitespace_v_v)) {
-                                        if (((v < -index_type(number_of_geometric_vertices)) || (-1 < v)) && ((v < 1) || (index_type(number_of_geometric_vertices) < v))) {
-                                            if (error_callback_) {
-                                                error_callback_(line_number, "index out of bounds (f/fo)");
-                                            }
-                                            return false;
-                                        }
-                                        if (flags_ & translate_negative_indices) {
-                                            if (v < 0) {
-                                                v += number_of_geometric_vertices + 1;
-                                            }
-                                        }
-                                        if (polygonal_face_geometric_vertices_vertex_callback_) {
-                                            polygonal_face_geometric_vertices_vertex_callback_(v);
-                                        }
-                                    }
-                                }
-                                while (stringstream && !stringstream.eof());
-                                if (!stringstream.eof()) {
-                                    if (error_callback_) {
-                                        error_callback_(line_number, "parse error (f/fo)");
-                                    }
-                                    return false;
-                                }
-                                ++number_of_faces;
-                                if (polygonal_face_geometric_vertices_end_callback_) {
-                                    polygonal_face_geometric_vertices_end_callback_();
-                                }
-                            }
-                        }
-                    }
-                }
-                else {
-                    char slash_v1_vt1;
-                    stringstream >> slash_v1_vt1;
-                    if (stringstream.peek() != '/') {
-                        index_type vt1;
-                        stringstream >> vt1;
-                        if (std::isspace(stringstream.peek())) {
-                            // f v/vt
-                            index_type v2, vt2, v3, vt3;
-                            char whitespace_vt1_v2, slash_v2_vt2, whitespace_vt2_v3, slash_v3_vt3;
-                            stringstream >> whitespace_vt1_v2 >> std::ws >> v2 >> slash_v2_vt2 >> vt2 >> whitespace_vt2_v3 >> std::ws >> v3 >> slash_v3_vt3 >> vt3;
-                            char whitespace_vt3_v4 = ' ';
-                            if (!stringstream.eof()) {
-                                stringstream >> whitespace_vt3_v4 >> std::ws;
-                            }
-                            if (!std::isspace(whitespace_f_v1) || !(slash_v1_vt1 == '/') || !std::isspace(whitespace_vt1_v2) || !(slash_v2_vt2 == '/') || !std::isspace(whitespace_vt2_v3) || !(slash_v3_vt3 == '/') || !std::isspace(whitespace_vt3_v4)) {
-                                if (error_callback_) {
-                                    error_callback_(line_number, "parse error (f/fo)");
-                                }
-                                return false;
-                            }
-                            if (((v1 < -index_type(number_of_geometric_vertices)) || (-1 < v1)) && ((v1 < 1) || (index_type(number_of_geometric_vertices) < v1))
-                                || ((vt1 < -index_type(number_of_texture_vertices)) || (-1 < vt1)) && ((vt1 < 1) || (index_type(number_of_texture_vertices) < vt1))
-                                || ((v2 < -index_type(number_of_geometric_vertices)) || (-1 < v2)) && ((v2 < 1) || (index_type(number_of_geometric_vertices) < v2))
-                                || ((vt2 < -index_type(number_of_texture_vertices)) || (-1 < vt2)) && ((vt2 < 1) || (index_type(number_of_texture_vertices) < vt2))
-                                || ((v3 < -index_type(number_of_geometric_vertices)) || (-1 < v3)) && ((v3 < 1) || (index_type(number_of_geometric_vertices) < v3))
-                                || ((vt3 < -index_type(number_of_texture_vertices)) || (-1 < vt3)) && ((vt3 < 1) || (index_type(number_of_texture_vertices) < vt3))) {
-                                if (error_callback_) {
-                                    error_callback_(line_number, "index out of bounds (f/fo)");
-                                }
-                                return false;
-                            }
-                            if (flags_ & translate_negative_indices) {
-                                if (v1 < 0) {
-                                    v1 += number_of_geometric_vertices + 1;
-                                }
-                                if (vt1 < 0) {
-                                    vt1 += number_of_texture_vertices + 1;
-                                }
-                                if (v2 < 0) {
-                                    v2 += number_of_geometric_vertices + 1;
-                                }
-                                if (vt2 < 0) {
-                                    vt2 += number_of_texture_vertices + 1;
-                                }
-                                if (v3 < 0) {
-                                    v3 += number_of_geometric_vertices + 1;
-                                }
-                                if (vt3 < 0) {
-                                    vt3 += number_of_texture_vertices + 1;
-                                }
-                            }
-                            if (stringstream.eof()) {
-                                ++number_of_faces;
-                                if (triangular_face_geometric_vertices_texture_vertices_callback_) {
-                                    triangular_face_geometric_vertices_texture_vertices_callback_(boost::make_tuple(v1, vt1), boost::make_tuple(v2, vt2), boost::make_tuple(v3, vt3));
-                                }
-                            }
-                            else {
-                                index_type v4, vt4;
-                                char slash_v4_vt4;
-                                stringstream >> v4 >> slash_v4_vt4 >> vt4;
-                                char whitespace_vt4_v5 = ' ';
-                                if (!stringstream.eof()) {
-                                    stringstream >> whitespace_vt4_v5 >> std::ws;
-                                }
-                                if (!(slash_v4_vt4 == '/') || !std::isspace(whitespace_vt4_v5)) {
-                                    if (error_callback_) {
-                                        error_callback_(line_number, "parse error (f/fo)");
-                                    }
-                                    return false;
-                                }
-                                if (((v4 < -index_type(number_of_geometric_vertices)) || (-1 < v4)) && ((v4 < 1) || (index_type(number_of_geometric_vertices) < v4))
-                                    || ((vt4 < -index_type(number_of_texture_vertices)) || (-1 < vt4)) && ((vt4 < 1) || (index_type(number_of_texture_vertices) < vt4))) {
-                                    if (error_callback_) {
-                                        error_callback_(line_number, "index out of bounds (f/fo)");
-                                    }
-                                    return false;
-                                }
-                                if (flags_ & translate_negative_indices) {
-                                    if (v4 < 0) {
-                                        v4 += number_of_geometric_vertices + 1;
-                                    }
-                                    if (vt4 < 0) {
-                                        vt4 += number_of_texture_vertices + 1;
-                                    }
-                                }
-                                if (stringstream.eof()) {
-                                    ++number_of_faces;
-                                    if (flags_ & triangulate_faces) {
-                                        if (triangular_face_geometric_vertices_texture_vertices_callback_) {
-                                            triangular_face_geometric_vertices_texture_vertices_callback_(boost::make_tuple(v1, vt1), boost::make_tuple(v2, vt2), boost::make_tuple(v3, vt3));
-                                            triangular_face_geometric_vertices_texture_vertices_callback_(boost::make_tuple(v1, vt1), boost::make_tuple(v3, vt3), boost::make_tuple(v4, vt4));
-                                        }
-                                    }
-                                }
-                                else {
-                                    if (flags_ & triangulate_faces) {
-                                        if (triangular_face_geometric_vertices_texture_vertices_callback_) {
-                                            triangular_face_geometric_vertices_texture_vertices_callback_(boost::make_tuple(v1, vt1), boost::make_tuple(v2, vt2), boost::make_tuple(v3, vt3));
-                                            triangular_face_geometric_vertices_texture_vertices_callback_(boost::make_tuple(v1, vt1), boost::make_tuple(v3, vt3), boost::make_tuple(v4, vt4));
-                                        }
-                                        index_type v_previous = v4, vt_previous = vt4;
-                                        do {
-                                            index_type v, vt;
-                                            char slash_geometric_vertices_texture_vertices;
-                                            stringstream >> v >> slash_geometric_vertices_texture_vertices >> vt;
-                                            char whitespace_vt_v = ' ';
-                                            if (!stringstream.eof()) {
-                                                stringstream >> whitespace_vt_v >> std::ws;
-                                            }
-                                            if (stringstream && (slash_geometric_vertices_texture_vertices == '/') && std::isspace(whitespace_vt_v)) {
-                                                if (((v < -index_type(number_of_geometric_vertices)) || (-1 < v)) && ((v < 1) || (index_type(number_of_geometric_vertices) < v))
-                                                    || ((vt < -index_type(number_of_texture_vertices)) || (-1 < vt)) && ((vt < 1) || (index_type(number_of_texture_vertices) < vt))) {
-                                                    if (error_callback_) {
-                                                        error_callback_(line_number, "index out of bounds (f/fo)");
-                                                    }
-                                                    return false;
-                                                }
-                                                if (flags_ & translate_negative_indices) {
-                                                    if (v < 0) {
-                                                        v += number_of_geometric_vertices + 1;
-                                                    }
-                                                    if (vt < 0) {
-                                                        vt += number_of_texture_vertices + 1;
-                                                    }
-                                                }
-                                                if (triangular_face_geometric_vertices_texture_vertices_callback_) {
-                                                    triangular_face_geometric_vertices_texture_vertices_callback_(boost::make_tuple(v1, vt1), boost::make_tuple(v_previous, vt_previous), boost::make_tuple(v, vt));
-                                                }
-                                                v_previous = v, vt_previous = vt;
-                                            }
-                                        }
-                                        while (stringstream && !stringstream.eof());
-                                        if (!stringstream.eof()) {
-                                            if (error_callback_) {
-                                                error_callback_(line_number, "parse error (f/fo)");
-                                            }
-                                            return false;
-                                        }
-                                        ++number_of_faces;
-                                    }
-                                    else {
-                                        if (polygonal_face_geometric_vertices_texture_vertices_begin_callback_) {
-                                            polygonal_face_geometric_vertices_texture_vertices_begin_callback_(index_2_tuple_type(v1, vt1), index_2_tuple_type(v2, vt2), index_2_tuple_type(v3, vt3));
-                                        }
-                                        if (polygonal_face_geometric_vertices_texture_vertices_vertex_callback_) {
-                                            polygonal_face_geometric_vertices_texture_vertices_vertex_callback_(index_2_tuple_type(v4, vt4));
-                                        }
-                                        do {
-                                            index_type v, vt;
-                                            char slash_geometric_vertices_texture_vertices;
-                                            stringstream >> v >> slash_geometric_vertices_texture_vertices >> vt;
-                                            char whitespace_vt_v = ' ';
-                                            if (!stringstream.eof()) {
-                                                stringstream >> whitespace_vt_v >> std::ws;
-                                            }
-                                            if (stringstream && (slash_geometric_vertices_texture_vertices == '/') && std::isspace(whitespace_vt_v)) {
-                                                if (((v < -index_type(number_of_geometric_vertices)) || (-1 < v)) && ((v < 1) || (index_type(number_of_geometric_vertices) < v))
-                                                    || ((vt < -index_type(number_of_texture_vertices)) || (-1 < vt)) && ((vt < 1) || (index_type(number_of_texture_vertices) < vt))) {
-                                                    if (error_callback_) {
-                                                        error_callback_(line_number, "index out of bounds (f/fo)");
-                                                    }
-                                                    return false;
-                                                }
-                                                if (flags_ & translate_negative_indices) {
-                                                    if (v < 0) {
-                                                        v += number_of_geometric_vertices + 1;
-                                                    }
-                                                    if (vt < 0) {
-                                                        vt += number_of_texture_vertices + 1;
-                                                    }
-                                                }
-                                                if (polygonal_face_geometric_vertices_texture_vertices_vertex_callback_) {
-                                                    polygonal_face_geometric_vertices_texture_vertices_vertex_callback_(index_2_tuple_type(v, vt));
-                                                }
-                                            }
-                                        }
-                                        while (stringstream && !stringstream.eof());
-                                        if (!stringstream.eof()) {
-                                            if (error_callback_) {
-                                                error_callback_(line_number, "parse error (f/fo)");
-                                            }
-                                            return false;
-                                        }
-                                        ++number_of_faces;
-                                        if (polygonal_face_geometric_vertices_texture_vertices_end_callback_) {
-                                            polygonal_face_geometric_vertices_texture_vertices_end_callback_();
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                        else {
-                            // f v/vt/vn
-                            index_type vn1, v2, vt2, vn2, v3, vt3, vn3;
-                            char slash_vt1_vn1, whitespace_vn1_v2, slash_v2_vt2, slash_vt2_vn2, whitespace_vn2_v3, slash_v3_vt3, slash_vt3_vn3;
-                            stringstream >> slash_vt1_vn1 >> vn1 >> whitespace_vn1_v2 >> std::ws >> v2 >> slash_v2_vt2 >> vt2 >> slash_vt2_vn2 >> vn2 >> whitespace_vn2_v3 >> std::ws >> v3 >> slash_v3_vt3 >> vt3 >> slash_vt3_vn3 >> vn3;
-                            char whitespace_vn3_v4 = ' ';
-                            if (!stringstream.eof()) {
-                                stringstream >> whitespace_vn3_v4 >> std::ws;
-                            }
-                            if (!std::isspace(whitespace_f_v1) || !(slash_v1_vt1 == '/') || !(slash_vt1_vn1 == '/') || !std::isspace(whitespace_vn1_v2) || !(slash_v2_vt2 == '/') || !(slash_vt2_vn2 == '/') || !std::isspace(whitespace_vn2_v3) || !(slash_v3_vt3 == '/') || !(slash_vt3_vn3 == '/') || !std::isspace(whitespace_vn3_v4)) {
-                                if (error_callback_) {
-                                    error_callback_(line_number, "parse error (f/fo)");
-                                }
-                                return false;
-                            }
-                            if (((v1 < -index_type(number_of_geometric_vertices)) || (-1 < v1)) && ((v1 < 1) || (index_type(number_of_geometric_vertices) < v1))
-                                || ((vt1 < -index_type(number_of_texture_vertices)) || (-1 < vt1)) && ((vt1 < 1) || (index_type(number_of_texture_vertices) < vt1))
-                                || ((vn1 < -index_type(number_of_vertex_normals)) || (-1 < vn1)) && ((vn1 < 1) || (index_type(number_of_vertex_normals) < vn1))
-                                || ((v2 < -index_type(number_of_geometric_vertices)) || (-1 < v2)) && ((v2 < 1) || (index_type(number_of_geometric_vertices) < v2))
-                                || ((vt2 < -index_type(number_of_texture_vertices)) || (-1 < vt2)) && ((vt2 < 1) || (index_type(number_of_texture_vertices) < vt2))
-                                || ((vn2 < -index_type(number_of_vertex_normals)) || (-1 < vn2)) && ((vn2 < 1) || (index_type(number_of_vertex_normals) < vn2))
-                                || ((v3 < -index_type(number_of_geometric_vertices)) || (-1 < v3)) && ((v3 < 1) || (index_type(number_of_geometric_vertices) < v3))
-                                || ((vt3 < -index_type(number_of_texture_vertices)) || (-1 < vt3)) && ((vt3 < 1) || (index_type(number_of_texture_vertices) < vt3))
-                                || ((vn3 < -index_type(number_of_vertex_normals)) || (-1 < vn3)) && ((vn3 < 1) || (index_type(number_of_vertex_normals) < vn3))) {
-                                if (error_callback_) {
-                                    error_callback_(line_number, "index out of bounds (f/fo)");
-                                }
-                                return false;
-                            }
-                            if (flags_ & translate_negative_indices) {
-                                if (v1 < 0) {
-                                    v1 += number_of_geometric_vertices + 1;
-                                }
-                                if (vt1 < 0) {
-                                    vt1 += number_of_texture_vertices + 1;
-                                }
-                                if (vn1 < 0) {
-                                    vn1 += number_of_vertex_normals + 1;
-                                }
-                                if (v2 < 0) {
-                                    v2 += number_of_geometric_vertices + 1;
-                                }
-                                if (vt2 < 0) {
-                                    vt2 += number_of_texture_vertices + 1;
-                                }
-                                if (vn2 < 0) {
-                                    vn2 += number_of_vertex_normals + 1;
-                                }
-                                if (v3 < 0) {
-                                    v3 += number_of_geometric_vertices + 1;
-                                }
-                                if (vt3 < 0) {
-                                    vt3 += number_of_texture_vertices + 1;
-                                }
-                                if (vn3 < 0) {
-                                    vn3 += number_of_vertex_normals + 1;
-                                }
-                            }
-                            if (stringstream.eof()) {
-                                ++number_of_faces;
-                                if (triangular_face_geometric_vertices_texture_vertices_vertex_normals_callback_) {
-                                    triangular_face_geometric_vertices_texture_vertices_vertex_normals_callback_(boost::make_tuple(v1, vt1, vn1), boost::make_tuple(v2, vt2, vn2), boost::make_tuple(v3, vt3, vn3));
-                                }
-                            }
-                            else {
-                                index_type v4, vt4, vn4;
-                                char slash_v4_vt4, slash_vt4_vn4;
-                                stringstream >> v4 >> slash_v4_vt4 >> vt4 >> slash_vt4_vn4 >> vn4;
-                                char whitespace_vn4_v5 = ' ';
-                                if (!stringstream.eof()) {
-                                    stringstream >> whitespace_vn4_v5 >> std::ws;
-                                }
-                                if (!(slash_v4_vt4 == '/') || !(slash_vt4_vn4 == '/') || !std::isspace(whitespace_vn4_v5)) {
-                                    if (error_callback_) {
-                                        error_callback_(line_number, "parse error (f/fo)");
-                                    }
-                                    return false;
-                                }
-                                if (((v4 < -index_type(number_of_geometric_vertices)) || (-1 < v4)) && ((v4 < 1) || (index_type(number_of_geometric_vertices) < v4))
-                                    || ((vt4 < -index_type(number_of_texture_vertices)) || (-1 < vt4)) && ((vt4 < 1) || (index_type(number_of_texture_vertices) < vt4))
-                                    || ((vn4 < -index_type(number_of_vertex_normals)) || (-1 < vn4)) && ((vn4 < 1) || (index_type(number_of_vertex_normals) < vn4))) {
-                                    if (error_callback_) {
-                                        error_callback_(line_number, "index out of bounds (f/fo)");
-                                    }
-                                    return false;
-                                }
-                                if (flags_ & translate_negative_indices) {
-                                    if (v4 < 0) {
-                                        v4 += number_of_geometric_vertices + 1;
-                                    }
-                                    if (vt4 < 0) {
-                                        vt4 += number_of_texture_vertices + 1;
-                                    }
-                                    if (vn4 < 0) {
-                                        vn4 += number_of_vertex_normals + 1;
-                                    }
-                                }
-                                if (stringstream.eof()) {
-                                    ++number_of_faces;
-                                    if (flags_ & triangulate_faces) {
-                                        if (triangular_face_geometric_vertices_texture_vertices_vertex_normals_callback_) {
-                                            triangular_face_geometric_vertices_texture_vertices_vertex_normals_callback_(boost::make_tuple(v1, vt1, vn1), boost::make_tuple(v2, vt2, vn2), boost::make_tuple(v3, vt3, vn3));
-                                            triangular_face_geometric_vertices_texture_vertices_vertex_normals_callback_(boost::make_tuple(v1, vt1, vn1), boost::make_tuple(v3, vt3, vn3), boost::make_tuple(v4, vt4, vn4));
-                                        }
-                                    }
-                                }
-                                else {
-                                    if (flags_ & triangulate_faces) {
-                                        if (triangular_face_geometric_vertices_texture_vertices_vertex_normals_callback_) {
-                                            triangular_face_geometric_vertices_texture_vertices_vertex_normals_callback_(boost::make_tuple(v1, vt1, vn1), boost::make_tuple(v2, vt2, vn2), boost::make_tuple(v3, vt3, vn3));
-                                            triangular_face_geometric_vertices_texture_vertices_vertex_normals_callback_(boost::make_tuple(v1, vt1, vn1), boost::make_tuple(v3, vt3, vn3), boost::make_tuple(v4, vt4, vn4));
-                                        }
-                                        index_type v_previous = v4, vt_previous = vt4, vn_previous = vn4;
-                                        do {
-                                            index_type v, vt, vn;
-                                            char slash_geometric_vertices_texture_vertices, slash_vt_vn;
-                                            stringstream >> v >> slash_geometric_vertices_texture_vertices >> vt >> slash_vt_vn >> vn;
-                                            char whitespace_vn_v = ' ';
-                                            if (!stringstream.eof()) {
-                                                stringstream >> whitespace_vn_v >> std::ws;
-                                            }
-                                            if (stringstream && (slash_geometric_vertices_texture_vertices == '/') && (slash_vt_vn == '/') && std::isspace(whitespace_vn_v)) {
-                                                if (((v < -index_type(number_of_geometric_vertices)) || (-1 < v)) && ((v < 1) || (index_type(number_of_geometric_vertices) < v))
-                                                    || ((vt < -index_type(number_of_texture_vertices)) || (-1 < vt)) && ((vt < 1) || (index_type(number_of_texture_vertices) < vt))
-                                                    || ((vn < -index_type(number_of_vertex_normals)) || (-1 < vn)) && ((vn < 1) || (index_type(number_of_vertex_normals) < vn))) {
-                                                    if (error_callback_) {
-                                                        error_callback_(line_number, "index out of bounds (f/fo)");
-                                                    }
-                                                    return false;
-                                                }
-                                                if (flags_ & translate_negative_indices) {
-                                                    if (v < 0) {
-                                                        v += number_of_geometric_vertices + 1;
-                                                    }
-                                                    if (vt < 0) {
-                                                        vt += number_of_texture_vertices + 1;
-                                                    }
-                                                    if (vn < 0) {
-                                                        vn += number_of_vertex_normals + 1;
-                                                    }
-                                                }
-                                                if (triangular_face_geometric_vertices_texture_vertices_vertex_normals_callback_) {
-                                                    triangular_face_geometric_vertices_texture_vertices_vertex_normals_callback_(boost::make_tuple(v1, vt1, vn1), boost::make_tuple(v_previous, vt_previous, vn_previous), boost::make_tuple(v, vt, vn));
-                                                }
-                                                v_previous = v, vt_previous = vt, vn_previous = vn;
-                                            }
-                                        }
-                                        while (stringstream && !stringstream.eof());
-                                        if (!stringstream.eof()) {
-                                            if (error_callback_) {
-                                                error_callback_(line_number, "parse error (f/fo)");
-                                            }
-                                            return false;
-                                        }
-                                        ++number_of_faces;
-                                    }
-                                    else {
-                                        if (polygonal_face_geometric_vertices_texture_vertices_vertex_normals_begin_callback_) {
-                                            polygonal_face_geometric_vertices_texture_vertices_vertex_normals_begin_callback_(index_3_tuple_type(v1, vt1, vn1), index_3_tuple_type(v2, vt2, vn2), index_3_tuple_type(v3, vt3, vn3));
-                                        }
-                                        if (polygonal_face_geometric_vertices_texture_vertices_vertex_normals_vertex_callback_) {
-                                            polygonal_face_geometric_vertices_texture_vertices_vertex_normals_vertex_callback_(index_3_tuple_type(v4, vt4, vn4));
-                                        }
-                                        do {
-                                            index_type v, vt, vn;
-                                            char slash_geometric_vertices_texture_vertices, slash_vt_vn;
-                                            stringstream >> v >> slash_geometric_vertices_texture_vertices >> vt >> slash_vt_vn >> vn;
-                                            char whitespace_vn_v = ' ';
-                                            if (!stringstream.eof()) {
-                                                stringstream >> whitespace_vn_v >> std::ws;
-                                            }
-                                            if (stringstream && (slash_geometric_vertices_texture_vertices == '/') && (slash_vt_vn == '/') && std::isspace(whitespace_vn_v)) {
-                                                if (((v < -index_type(number_of_geometric_vertices)) || (-1 < v)) && ((v < 1) || (index_type(number_of_geometric_vertices) < v))
-                                                    || ((vt < -index_type(number_of_texture_vertices)) || (-1 < vt)) && ((vt < 1) || (index_type(number_of_texture_vertices) < vt))
-                                                    || ((vn < -index_type(number_of_vertex_normals)) || (-1 < vn)) && ((vn < 1) || (index_type(number_of_vertex_normals) < vn))) {
-                                                    if (error_callback_) {
-                                                        error_callback_(line_number, "index out of bounds (f/fo)");
-                                                    }
-                                                    return false;
-                                                }
-                                                if (flags_ & translate_negative_indices) {
-                                                    if (v < 0) {
-                                                        v += number_of_geometric_vertices + 1;
-                                                    }
-                                                    if (vt < 0) {
-                                                        vt += number_of_texture_vertices + 1;
-                                                    }
-                                                    if (vn < 0) {
-                                                        vn += number_of_vertex_normals + 1;
-                                                    }
-                                                }
-                                                if (polygonal_face_geometric_vertices_texture_vertices_vertex_normals_vertex_callback_) {
-                                                    polygonal_face_geometric_vertices_texture_vertices_vertex_normals_vertex_callback_(index_3_tuple_type(v, vt, vn));
-                                                }
-                                            }
-                                        }
-                                        while (stringstream && !stringstream.eof());
-                                        if (!stringstream.eof()) {
-                                            if (error_callback_) {
-                                                error_callback_(line_number, "parse error (f/fo)");
-                                            }
-                                            return false;
-                                        }
-                                        ++number_of_faces;
-                                        if (polygonal_face_geometric_vertices_texture_vertices_vertex_normals_end_callback_) {
-                                            polygonal_face_geometric_vertices_texture_vertices_vertex_normals_end_callback_();
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    else {
-                        // f v//vn
-                        index_type vn1, v2, vn2, v3, vn3;
-                        char slash_vt1_vn1, whitespace_vn1_v2, slash_v2_vt2, slash_vt2_vn2, whitespace_vn2_v3, slash_v3_vt3, slash_vt3_vn3;
-                        stringstream >> slash_vt1_vn1 >> vn1 >> whitespace_vn1_v2 >> std::ws >> v2 >> slash_v2_vt2 >> slash_vt2_vn2 >> vn2 >> whitespace_vn2_v3 >> std::ws >> v3 >> slash_v3_vt3 >> slash_vt3_vn3 >> vn3;
-                        char whitespace_vn3_v4 = ' ';
-                        if (!stringstream.eof()) {
-                            stringstream >> whitespace_vn3_v4 >> std::ws;
-                        }
-                        if (!std::isspace(whitespace_f_v1) || !(slash_v1_vt1 == '/') || !(slash_vt1_vn1 == '/') || !std::isspace(whitespace_vn1_v2) || !(slash_v2_vt2 == '/') || !(slash_vt2_vn2 == '/') || !std::isspace(whitespace_vn2_v3) || !(slash_v3_vt3 == '/') || !(slash_vt3_vn3 == '/') || !std::isspace(whitespace_vn3_v4)) {
-                            if (error_callback_) {
-                                error_callback_(line_number, "parse error (f/fo)");
-                            }
-                            return false;
-                        }
-                        if (((v1 < -index_type(number_of_geometric_vertices)) || (-1 < v1)) && ((v1 < 1) || (index_type(number_of_geometric_vertices) < v1))
-                            || ((vn1 < -index_type(number_of_vertex_normals)) || (-1 < vn1)) && ((vn1 < 1) || (index_type(number_of_vertex_normals) < vn1))
-                            || ((v2 < -index_type(number_of_geometric_vertices)) || (-1 < v2)) && ((v2 < 1) || (index_type(number_of_geometric_vertices) < v2))
-                            || ((vn2 < -index_type(number_of_vertex_normals)) || (-1 < vn2)) && ((vn2 < 1) || (index_type(number_of_vertex_normals) < vn2))
-                            || ((v3 < -index_type(number_of_geometric_vertices)) || (-1 < v3)) && ((v3 < 1) || (index_type(number_of_geometric_vertices) < v3))
-                            || ((vn3 < -index_type(number_of_vertex_normals)) || (-1 < vn3)) && ((vn3 < 1) || (index_type(number_of_vertex_normals) < vn3))) {
-                            if (error_callback_) {
-                                error_callback_(line_number, "index out of bounds (f/fo)");
-                            }
-                            return false;
-                        }
-                        if (flags_ & translate_negative_indices) {
-                            if (v1 < 0) {
-                                v1 += number_of_geometric_vertices + 1;
-                            }
-                            if (vn1 < 0) {
-                                vn1 += number_of_vertex_normals + 1;
-                            }
-                            if (v2 < 0) {
-                                v2 += number_of_geometric_vertices + 1;
-                            }
-                            if (vn2 < 0) {
-                                vn2 += number_of_vertex_normals + 1;
-                            }
-                            if (v3 < 0) {
-                                v3 += number_of_geometric_vertices + 1;
-                            }
-                            if (vn3 < 0) {
-                                vn3 += number_of_vertex_normals + 1;
-                            }
-                        }
-                        if (stringstream.eof()) {
-                            ++number_of_faces;
-                            if (triangular_face_geometric_vertices_vertex_normals_callback_) {
-                                triangular_face_geometric_vertices_vertex_normals_callback_(boost::make_tuple(v1, vn1), boost::make_tuple(v2, vn2), boost::make_tuple(v3, vn3));
-                            }
-                        }
-                        else {
-                            index_type v4, vn4;
-                            char slash_v4_vt4, slash_vt4_vn4;
-                            stringstream >> v4 >> slash_v4_vt4 >> slash_vt4_vn4 >> vn4;
-                            char whitespace_vn4_v5 = ' ';
-                            if (!stringstream.eof()) {
-                                stringstream >> whitespace_vn4_v5 >> std::ws;
-                            }
-                            if (!(slash_v4_vt4 == '/') || !(slash_vt4_vn4 == '/') || !std::isspace(whitespace_vn4_v5)) {
-                                if (error_callback_) {
-                                    error_callback_(line_number, "parse error (f/fo)");
-                                }
-                                return false;
-                            }
-                            if (((v4 < -index_type(number_of_geometric_vertices)) || (-1 < v4)) && ((v4 < 1) || (index_type(number_of_geometric_vertices) < v4))
-                                || ((vn4 < -index_type(number_of_vertex_normals)) || (-1 < vn4)) && ((vn4 < 1) || (index_type(number_of_vertex_normals) < vn4))) {
-                                if (error_callback_) {
-                                    error_callback_(line_number, "index out of bounds (f/fo)");
-                                }
-                                return false;
-                            }
-                            if (flags_ & translate_negative_indices) {
-                                if (v4 < 0) {
-                                    v4 += number_of_geometric_vertices + 1;
-                                }
-                                if (vn4 < 0) {
-                                    vn4 += number_of_vertex_normals + 1;
-                                }
-                            }
-                            if (stringstream.eof()) {
-                                ++number_of_faces;
-                                if (flags_ & triangulate_faces) {
-                                    if (triangular_face_geometric_vertices_vertex_normals_callback_) {
-                                        triangular_face_geometric_vertices_vertex_normals_callback_(boost::make_tuple(v1, vn1), boost::make_tuple(v2, vn2), boost::make_tuple(v3, vn3));
-                                        triangular_face_geometric_vertices_vertex_normals_callback_(boost::make_tuple(v1, vn1), boost::make_tuple(v3, vn3), boost::make_tuple(v4, vn4));
-                                    }
-                                }
-                            }
-                            else {
-                                if (flags_ & triangulate_faces) {
-                                    if (triangular_face_geometric_vertices_vertex_normals_callback_) {
-                                        triangular_face_geometric_vertices_vertex_normals_callback_(boost::make_tuple(v1, vn1), boost::make_tuple(v2, vn2), boost::make_tuple(v3, vn3));
-                                        triangular_face_geometric_vertices_vertex_normals_callback_(boost::make_tuple(v1, vn1), boost::make_tuple(v3, vn3), boost::make_tuple(v4, vn4));
-                                    }
-                                    index_type v_previous = v4, vn_previous = vn4;
-                                    do {
-                                        index_type v, vn;
-                                        char slash_geometric_vertices_texture_vertices, slash_vt_vn;
-                                        stringstream >> v >> slash_geometric_vertices_texture_vertices >> slash_vt_vn >> vn;
-                                        char whitespace_vn_v = ' ';
-                                        if (!stringstream.eof()) {
-                                            stringstream >> whitespace_vn_v >> std::ws;
-                                        }
-                                        if (stringstream && (slash_geometric_vertices_texture_vertices == '/') && (slash_vt_vn == '/') && std::isspace(whitespace_vn_v)) {
-                                            if (((v < -index_type(number_of_geometric_vertices)) || (-1 < v)) && ((v < 1) || (index_type(number_of_geometric_vertices) < v))
-                                                || ((vn < -index_type(number_of_vertex_normals)) || (-1 < vn)) && ((vn < 1) || (index_type(number_of_vertex_normals) < vn))) {
-                                                if (error_callback_) {
-                                                    error_callback_(line_number, "index out of bounds (f/fo)");
-                                                }
-                                                return false;
-                                            }
-                                            if (flags_ & translate_negative_indices) {
-                                                if (v < 0) {
-                                                    v += number_of_geometric_vertices + 1;
-                                                }
-                                                if (vn < 0) {
-                                                    vn += number_of_vertex_normals + 1;
-                                                }
-                                            }
-                                            if (triangular_face_geometric_vertices_vertex_normals_callback_) {
-                                                triangular_face_geometric_vertices_vertex_normals_callback_(boost::make_tuple(v1, vn1), boost::make_tuple(v_previous, vn_previous), boost::make_tuple(v, vn));
-                                            }
-                                            v_previous = v, vn_previous = vn;
-                                        }
-                                    }
-                                    while (stringstream && !stringstream.eof());
-                                    if (!stringstream.eof()) {
-                                        if (error_callback_) {
-                                            error_callback_(line_number, "parse error (f/fo)");
-                                        }
-                                        return false;
-                                    }
-                                    ++number_of_faces;
-                                }
-                                else {
-                                    if (polygonal_face_geometric_vertices_vertex_normals_begin_callback_) {
-                                        polygonal_face_geometric_vertices_vertex_normals_begin_callback_(index_2_tuple_type(v1, vn1), index_2_tuple_type(v2, vn2), index_2_tuple_type(v3, vn3));
-                                    }
-                                    if (polygonal_face_geometric_vertices_vertex_normals_vertex_callback_) {
-                                        polygonal_face_geometric_vertices_vertex_normals_vertex_callback_(index_2_tuple_type(v4, vn4));
-                                    }
-                                    do {
-                                        index_type v, vn;
-                                        char slash_geometric_vertices_texture_vertices, slash_vt_vn;
-                                        stringstream >> v >> slash_geometric_vertices_texture_vertices >> slash_vt_vn >> vn;
-                                        char whitespace_vn_v = ' ';
-                                        if (!stringstream.eof()) {
-                                            stringstream >> whitespace_vn_v >> std::ws;
-                                        }
-                                        if (stringstream && (slash_geometric_vertices_texture_vertices == '/') && (slash_vt_vn == '/') && std::isspace(whitespace_vn_v)) {
-                                            if (((v < -index_type(number_of_geometric_vertices)) || (-1 < v)) && ((v < 1) || (index_type(number_of_geometric_vertices) < v))
-                                                || ((vn < -index_type(number_of_vertex_normals)) || (-1 < vn)) && ((vn < 1) || (index_type(number_of_vertex_normals) < vn))) {
-                                                if (error_callback_) {
-                                                    error_callback_(line_number, "index out of bounds (f/fo)");
-                                                }
-                                                return false;
-                                            }
-                                            if (flags_ & translate_negative_indices) {
-                                                if (v < 0) {
-                                                    v += number_of_geometric_vertices + 1;
-                                                }
-                                                if (vn < 0) {
-                                                    vn += number_of_vertex_normals + 1;
-                                                }
-                                            }
-                                            if (polygonal_face_geometric_vertices_vertex_normals_vertex_callback_) {
-                                                polygonal_face_geometric_vertices_vertex_normals_vertex_callback_(index_2_tuple_type(v, vn));
-                                            }
-                                        }
-                                    }
-                                    while (stringstream && !stringstream.eof());
-                                    if (!stringstream.eof()) {
-                                        if (error_callback_) {
-                                            error_callback_(line_number, "parse error (f/fo)");
-                                        }
-                                        return false;
-                                    }
-                                    ++number_of_faces;
-                                    if (polygonal_face_geometric_vertices_vertex_normals_end_callback_) {
-                                        polygonal_face_geometric_vertices_vertex_normals_end_callback_();
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+        }
+    }
+    return at_separator(p, end);
+}
+
+// Returns true if a one-based (or negative, relative) index refers to one of the count elements read so far
+inline bool index_in_bounds(obj::index_type index, std::size_t count)
+{
+    return ((-obj::index_type(count) <= index) && (index <= -1)) || ((1 <= index) && (index <= obj::index_type(count)));
+}
+
+// Reads up to max floats separated by whitespace until the end of the line, returns the number of floats or -1 on errors
+int parse_floats(const char* p, const char* end, obj::float_type* values, int max)
+{
+    int count = 0;
+    skip_space(p, end);
+    while (p != end) {
+        if (count == max || !parse_float(p, end, values[count]) || !at_separator(p, end)) {
+            return -1;
+        }
+        ++count;
+        skip_space(p, end);
+    }
+    return count;
+}
+
+// Reads all vertices of a face until the end of the line, all vertices have to be in the same format
+bool parse_face_vertices(const char* p, const char* end, obj::obj_parser::face_format_type& format, std::vector<obj::obj_parser::face_vertex_type>& vertices)
+{
+    vertices.clear();
+    skip_space(p, end);
+    while (p != end) {
+        obj::obj_parser::face_format_type vertex_format;
+        obj::obj_parser::face_vertex_type vertex;
+        if (!parse_face_vertex(p, end, vertex_format, vertex) || (!vertices.empty() && vertex_format != format)) {
+            return false;
+        }
+        format = vertex_format;
+        vertices.push_back(vertex);
+        skip_space(p, end);
+    }
+    return vertices.size() >= 3;
+}
+
+// Returns a pointer to the start of the next line and sets line_end to the end of the current line
+inline const char* find_line_end(const char* line_begin, const char* end, const char*& line_end)
+{
+    line_end = static_cast<const char*>(std::memchr(line_begin, '\n', std::size_t(end - line_begin)));
+    if (!line_end) {
+        line_end = end;
+        return end;
+    }
+    return line_end + 1;
+}
+
+} // namespace
+
+bool obj::obj_parser::parse(std::istream& istream)
+{
+    // Read the whole stream at once, its size is known for files
+    std::string buffer;
+    std::istream::pos_type begin = istream.tellg();
+    if (begin != std::istream::pos_type(-1) && istream.seekg(0, std::ios_base::end)) {
+        std::istream::pos_type end = istream.tellg();
+        istream.seekg(begin);
+        buffer.resize(std::size_t(end - begin));
+        if (!buffer.empty()) {
+            istream.read(&buffer[0], std::streamsize(buffer.size()));
+            buffer.resize(std::size_t(istream.gcount()));
+        }
+    }
+    else {
+        istream.clear();
+        buffer.assign(std::istreambuf_iterator<char>(istream), std::istreambuf_iterator<char>());
+    }
+    if (istream.bad()) {
+        return false;
+    }
+    return parse(buffer.data(), buffer.data() + buffer.size());
+}
+
+bool obj::obj_parser::parse(const char* begin, const char* end)
+{
+    std::size_t number_of_chunks = std::size_t(end - begin) / minimum_chunk_size;
+    if (number_of_threads_ > 1 && number_of_chunks > 1) {
+        return parse_parallel(begin, end);
+    }
+
+    state_type state;
+    std::size_t line_number = 0;
+    const char* line_begin = begin;
+    while (line_begin != end) {
+        const char* line_end;
+        const char* next_line = find_line_end(line_begin, end, line_end);
+        if (!parse_line(state, ++line_number, line_begin, line_end)) {
+            return false;
+        }
+        line_begin = next_line;
+    }
+    return true;
+}
+
+bool obj::obj_parser::parse_line(state_type& state, std::size_t line_number, const char* line_begin, const char* line_end)
+{
+    const char* p = line_begin;
+    skip_space(p, line_end);
+    if (p == line_end) {
+        if (flags_ & parse_blank_lines_as_comment) {
+            if (comment_callback_) {
+                state.line.assign(line_begin, line_end);
+                comment_callback_(state.line);
             }
-            
-            // group name (g)
-            else if (keyword == "g") {
-                char whitespace_mtllib_group_name = ' ';
-                if (!stringstream.eof()) {
-                    stringstream >> whitespace_mtllib_group_name >> std::ws;
-                }
-                if (!std::isspace(whitespace_mtllib_group_name)) {
-                    if (error_callback_) {
-                        error_callback_(line_number, "parse error (g)");
-                    }
-                    return false;
-                }
-                if (stringstream.eof()) {
-                    ++number_of_group_names;
-                    if (group_name_callback_) {
-                        group_name_callback_("default");
-                    }
-                }
-                else {
-                    std::string group_name;
-                    stringstream >> group_name >> std::ws;
-                    if (!stringstream.eof()) {
-                        if (error_callback_) {
-                            error_callback_(line_number, "parse error (g)");
-                        }
-                        return false;
-                    }
-                    ++number_of_group_names;
-                    if (group_name_callback_) {
-                        group_name_callback_(group_name);
-                    }
-                }
+        }
+        return true;
+    }
+    if (*p == '#') {
+        if (comment_callback_) {
+            state.line.assign(line_begin, line_end);
+            comment_callback_(state.line);
+        }
+        return true;
+    }
+
+    const char *keyword, *keyword_end;
+    parse_word(p, line_end, keyword, keyword_end);
+
+    // geometric vertex (v)
+    if (is_keyword(keyword, keyword_end, "v", 1)) {
+        float_type xyz[3];
+        if (parse_floats(p, line_end, xyz, 3) != 3) {
+            if (error_callback_) {
+                error_callback_(line_number, "parse error (v)");
             }
-            
-            // smoothing group (s)
-            else if (keyword == "s") {
-                std::string group_number_string;
-                char whitespace_mtllib_group_number;
-                stringstream >> whitespace_mtllib_group_number >> std::ws >> group_number_string >> std::ws;
-                if (!stringstream.eof() || !std::isspace(whitespace_mtllib_group_number)) {
-                    if (error_callback_) {
-                        error_callback_(line_number, "parse error (s)");
-                    }
-                    return false;
-                }
-                size_type group_number;
-                if (group_number_string == "off") {
-                    group_number = 0;
-                }
-                else {
-                    std::istringstream stringstream(group_number_string);
-                    stringstream >> group_number;
-                    if (!stringstream.eof()) {
-                        if (error_callback_) {
-                            error_callback_(line_number, "parse error (s)");
-                        }
-                        return false;
-                    }
-                }
-                ++number_of_smoothing_groups;
-                if (smoothing_group_callback_) {
-                    smoothing_group_callback_(group_number);
-                }
+            return false;
+        }
+        ++state.number_of_geometric_vertices;
+        if (geometric_vertex_callback_) {
+            geometric_vertex_callback_(xyz[0], xyz[1], xyz[2]);
+        }
+    }
+
+    // texture vertex (vt)
+    else if (is_keyword(keyword, keyword_end, "vt", 2)) {
+        float_type uvw[3];
+        int count = parse_floats(p, line_end, uvw, 3);
+        if (count < 2 || (count == 3 && uvw[2] != float_type(0.0))) {
+            if (error_callback_) {
+                error_callback_(line_number, "parse error (vt)");
             }
-            
-            // object name (o)
-            else if (keyword == "o") {
-                std::string object_name;
-                char whitespace_mtllib_object_name;
-                stringstream >> whitespace_mtllib_object_name >> std::ws >> object_name >> std::ws;
-                if (!stringstream.eof() || !std::isspace(whitespace_mtllib_object_name)) {
-                    if (error_callback_) {
-                        error_callback_(line_number, "parse error (o)");
-                    }
-                    return false;
-                }
-                ++number_of_object_names;
-                if (object_name_callback_) {
-                    object_name_callback_(object_name);
-                }
+            return false;
+        }
+        ++state.number_of_texture_vertices;
+        if (texture_vertex_callback_) {
+            texture_vertex_callback_(uvw[0], uvw[1]);
+        }
+    }
+
+    // vertex normal (vn)
+    else if (is_keyword(keyword, keyword_end, "vn", 2)) {
+        float_type xyz[3];
+        if (parse_floats(p, line_end, xyz, 3) != 3) {
+            if (error_callback_) {
+                error_callback_(line_number, "parse error (vn)");
             }
-            
-            // material library (mtllib)
-            else if (keyword == "mtllib") {
-                std::string filename;
-                char whitespace_mtllib_filename;
-                stringstream >> whitespace_mtllib_filename >> std::ws >> filename >> std::ws;
-                if (!stringstream.eof() || !std::isspace(whitespace_mtllib_filename)) {
-                    if (error_callback_) {
-                        error_callback_(line_number, "parse error (mtllib)");
-                    }
-                    return false;
-                }
-                ++number_of_material_libraries;
-                if (material_library_callback_) {
-                    material_library_callback_(filename);
-                }
+            return false;
+        }
+        ++state.number_of_vertex_normals;
+        if (vertex_normal_callback_) {
+            vertex_normal_callback_(xyz[0], xyz[1], xyz[2]);
+        }
+    }
+
+    // face (f)
+    else if (is_keyword(keyword, keyword_end, "f", 1) || is_keyword(keyword, keyword_end, "fo", 2)) {
+        face_format_type format = face_format_v;
+        if (!parse_face_vertices(p, line_end, format, state.face_vertices)) {
+            if (error_callback_) {
+                error_callback_(line_number, "parse error (f/fo)");
             }
-            
-            // material name (usemtl)
-            else if (keyword == "usemtl") {
-                std::string material_name;
-                char whitespace_mtllib_material_name;
-                stringstream >> whitespace_mtllib_material_name >> std::ws >> material_name >> std::ws;
-                if (!stringstream.eof() || !std::isspace(whitespace_mtllib_material_name)) {
-                    if (error_callback_) {
-                        error_callback_(line_number, "parse error (usemtl)");
-                    }
-                    return false;
-                }
-                ++number_of_material_names;
-                if (material_name_callback_) {
-                    material_name_callback_(material_name);
-                }
+            return false;
+        }
+        return face(state, line_number, format, state.face_vertices.data(), state.face_vertices.size());
+    }
+
+    // group name (g)
+    else if (is_keyword(keyword, keyword_end, "g", 1)) {
+        const char *name_begin, *name_end;
+        skip_space(p, line_end);
+        parse_word(p, line_end, name_begin, name_end);
+        skip_space(p, line_end);
+        if (p != line_end) {
+            if (error_callback_) {
+                error_callback_(line_number, "parse error (g)");
+            }
+            return false;
+        }
+        ++state.number_of_group_names;
+        if (group_name_callback_) {
+            if (name_begin == name_end) {
+                state.name.assign("default");
             }
-            
-            // unknown keyword
             else {
-                std::string message = "ignoring line ‘" + line + "’";
-                if (warning_callback_) {
-                    warning_callback_(line_number, message);
-                }
+                state.name.assign(name_begin, name_end);
+            }
+            group_name_callback_(state.name);
+        }
+    }
+
+    // smoothing group (s)
+    else if (is_keyword(keyword, keyword_end, "s", 1)) {
+        size_type group_number = 0;
+        const char *number_begin, *number_end;
+        skip_space(p, line_end);
+        parse_word(p, line_end, number_begin, number_end);
+        skip_space(p, line_end);
+        bool ok = number_begin != number_end && p == line_end;
+        if (ok && !is_keyword(number_begin, number_end, "off", 3)) {
+            for (const char* digit = number_begin; digit != number_end && ok; ++digit) {
+                ok = is_digit(*digit);
+                group_number = group_number * 10 + size_type(*digit - '0');
+            }
+        }
+        if (!ok) {
+            if (error_callback_) {
+                error_callback_(line_number, "parse error (s)");
+            }
+            return false;
+        }
+        ++state.number_of_smoothing_groups;
+        if (smoothing_group_callback_) {
+            smoothing_group_callback_(group_number);
+        }
+    }
+
+    // object name (o), material library (mtllib) and material name (usemtl)
+    else if (is_keyword(keyword, keyword_end, "o", 1) || is_keyword(keyword, keyword_end, "mtllib", 6) || is_keyword(keyword, keyword_end, "usemtl", 6)) {
+        const char *name_begin, *name_end;
+        skip_space(p, line_end);
+        parse_word(p, line_end, name_begin, name_end);
+        skip_space(p, line_end);
+        if (name_begin == name_end || p != line_end) {
+            if (error_callback_) {
+                error_callback_(line_number, "parse error (" + std::string(keyword, keyword_end) + ")");
+            }
+            return false;
+        }
+        state.name.assign(name_begin, name_end);
+        if (*keyword == 'o') {
+            ++state.number_of_object_names;
+            if (object_name_callback_) {
+                object_name_callback_(state.name);
+            }
+        }
+        else if (keyword[1] == 't') {
+            ++state.number_of_material_libraries;
+            if (material_library_callback_) {
+                material_library_callback_(state.name);
+            }
+        }
+        else {
+            ++state.number_of_material_names;
+            if (material_name_callback_) {
+                material_name_callback_(state.name);
+            }
+        }
+    }
+
+    // unknown keyword
+    else {
+        std::string message = "ignoring line ‘" + std::string(line_begin, line_end) + "’";
+        if (warning_callback_) {
+            warning_callback_(line_number, message);
+        }
+    }
+
+    return true;
+}
+
+bool obj::obj_parser::face(state_type& state, std::size_t line_number, face_format_type format, const face_vertex_type* vertices, std::size_t number_of_vertices)
+{
+    bool texture_vertices = (format == face_format_v_vt || format == face_format_v_vt_vn);
+    bool vertex_normals = (format == face_format_v_vn || format == face_format_v_vt_vn);
+
+    // Indices refer to the vertices read so far, negative indices are relative to the last one
+    if (state.translated_face_vertices.size() < number_of_vertices) {
+        state.translated_face_vertices.resize(number_of_vertices);
+    }
+    face_vertex_type* translated = state.translated_face_vertices.data();
+    for (std::size_t i = 0; i < number_of_vertices; ++i) {
+        face_vertex_type vertex = vertices[i];
+        if (!index_in_bounds(vertex.v, state.number_of_geometric_vertices)
+            || (texture_vertices && !index_in_bounds(vertex.vt, state.number_of_texture_vertices))
+            || (vertex_normals && !index_in_bounds(vertex.vn, state.number_of_vertex_normals))) {
+            if (error_callback_) {
+                error_callback_(line_number, "index out of bounds (f/fo)");
+            }
+            return false;
+        }
+        if (flags_ & translate_negative_indices) {
+            if (vertex.v < 0) {
+                vertex.v += state.number_of_geometric_vertices + 1;
+            }
+            if (vertex.vt < 0) {
+                vertex.vt += state.number_of_texture_vertices + 1;
+            }
+            if (vertex.vn < 0) {
+                vertex.vn += state.number_of_vertex_normals + 1;
+            }
+        }
+        translated[i] = vertex;
+    }
+
+    ++state.number_of_faces;
+    if (number_of_vertices == 3) {
+        triangular_face(format, translated[0], translated[1], translated[2]);
+    }
+    else if (flags_ & triangulate_faces) {
+        for (std::size_t i = 2; i < number_of_vertices; ++i) {
+            triangular_face(format, translated[0], translated[i - 1], translated[i]);
+        }
+    }
+    else {
+        polygonal_face_begin(format, translated[0], translated[1], translated[2]);
+        for (std::size_t i = 3; i < number_of_vertices; ++i) {
+            polygonal_face_vertex(format, translated[i]);
+        }
+        polygonal_face_end(format);
+    }
+    return true;
+}
+
+/* Parallel parsing */
+
+// The records of a chunk of lines, which are tokenized by a worker thread and then passed to the callbacks in order
+struct obj::obj_parser::chunk_type
+{
+    typedef enum {
+        record_geometric_vertex,
+        record_texture_vertex,
+        record_vertex_normal,
+        record_face,
+        record_line,
+        record_error
+    } record_kind_type;
+
+    struct record_type {
+        record_kind_type kind;
+        face_format_type format;
+        std::size_t number_of_face_vertices;
+        std::size_t line_number;
+        const char* line_begin;
+        const char* line_end;
+    };
+
+    std::size_t index = std::size_t(-1);
+    std::size_t number_of_lines = 0;
+    std::vector<record_type> records;
+    std::vector<float_type> floats;
+    std::vector<face_vertex_type> face_vertices;
+    std::vector<face_vertex_type> line_face_vertices;
+    std::string error_message;
+};
+
+void obj::obj_parser::tokenize_chunk(chunk_type& chunk, const char* begin, const char* end)
+{
+    chunk.number_of_lines = 0;
+    chunk.records.clear();
+    chunk.floats.clear();
+    chunk.face_vertices.clear();
+
+    const char* line_begin = begin;
+    while (line_begin != end) {
+        const char* line_end;
+        const char* next_line = find_line_end(line_begin, end, line_end);
+        std::size_t line_number = ++chunk.number_of_lines;
+
+        const char* p = line_begin;
+        skip_space(p, line_end);
+        const char *keyword, *keyword_end;
+        parse_word(p, line_end, keyword, keyword_end);
+
+        chunk_type::record_type record = { chunk_type::record_line, face_format_v, 0, line_number, line_begin, line_end };
+        bool ok = true;
+        if (is_keyword(keyword, keyword_end, "v", 1) || is_keyword(keyword, keyword_end, "vn", 2)) {
+            float_type xyz[3];
+            ok = parse_floats(p, line_end, xyz, 3) == 3;
+            if (ok) {
+                record.kind = keyword[1] == 'n' ? chunk_type::record_vertex_normal : chunk_type::record_geometric_vertex;
+                chunk.floats.insert(chunk.floats.end(), xyz, xyz + 3);
+            }
+            else {
+                chunk.error_message = keyword[1] == 'n' ? "parse error (vn)" : "parse error (v)";
+            }
+        }
+        else if (is_keyword(keyword, keyword_end, "vt", 2)) {
+            float_type uvw[3];
+            int count = parse_floats(p, line_end, uvw, 3);
+            ok = count >= 2 && (count == 2 || uvw[2] == float_type(0.0));
+            if (ok) {
+                record.kind = chunk_type::record_texture_vertex;
+                chunk.floats.insert(chunk.floats.end(), uvw, uvw + 2);
+            }
+            else {
+                chunk.error_message = "parse error (vt)";
             }
-            
         }
+        else if (is_keyword(keyword, keyword_end, "f", 1) || is_keyword(keyword, keyword_end, "fo", 2)) {
+            ok = parse_face_vertices(p, line_end, record.format, chunk.line_face_vertices);
+            if (ok) {
+                record.kind = chunk_type::record_face;
+                record.number_of_face_vertices = chunk.line_face_vertices.size();
+                chunk.face_vertices.insert(chunk.face_vertices.end(), chunk.line_face_vertices.begin(), chunk.line_face_vertices.end());
+            }
+            else {
+                chunk.error_message = "parse error (f/fo)";
+            }
+        }
+
+        // Errors end the chunk, the lines before are still passed to the callbacks
+        if (!ok) {
+            record.kind = chunk_type::record_error;
+            chunk.records.push_back(record);
+            return;
+        }
+        chunk.records.push_back(record);
+        line_begin = next_line;
+    }
+}
+
+bool obj::obj_parser::dispatch_chunk(state_type& state, std::size_t first_line_number, const chunk_type& chunk)
+{
+    const float_type* floats = chunk.floats.data();
+    const face_vertex_type* face_vertices = chunk.face_vertices.data();
+    for (auto record = chunk.records.begin(); record != chunk.records.end(); ++record) {
+        std::size_t line_number = first_line_number + record->line_number;
+        switch (record->kind) {
+        case chunk_type::record_geometric_vertex:
+            ++state.number_of_geometric_vertices;
+            if (geometric_vertex_callback_) {
+                geometric_vertex_callback_(floats[0], floats[1], floats[2]);
+            }
+            floats += 3;
+            break;
+        case chunk_type::record_texture_vertex:
+            ++state.number_of_texture_vertices;
+            if (texture_vertex_callback_) {
+                texture_vertex_callback_(floats[0], floats[1]);
+            }
+            floats += 2;
+            break;
+        case chunk_type::record_vertex_normal:
+            ++state.number_of_vertex_normals;
+            if (vertex_normal_callback_) {
+                vertex_normal_callback_(floats[0], floats[1], floats[2]);
+            }
+            floats += 3;
+            break;
+        case chunk_type::record_face:
+            if (!face(state, line_number, record->format, face_vertices, record->number_of_face_vertices)) {
+                return false;
+            }
+            face_vertices += record->number_of_face_vertices;
+            break;
+        case chunk_type::record_line:
+            if (!parse_line(state, line_number, record->line_begin, record->line_end)) {
+                return false;
+            }
+            break;
+        case chunk_type::record_error:
+            if (error_callback_) {
+                error_callback_(line_number, chunk.error_message);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+bool obj::obj_parser::parse_parallel(const char* begin, const char* end)
+{
+    // Split the text at line boundaries
+    std::vector<const char*> boundaries(1, begin);
+    while (boundaries.back() != end) {
+        const char* chunk_begin = boundaries.back();
+        if (std::size_t(end - chunk_begin) <= minimum_chunk_size) {
+            boundaries.push_back(end);
+        }
+        else {
+            const char* line_end;
+            boundaries.push_back(find_line_end(chunk_begin + minimum_chunk_size, end, line_end));
+        }
+    }
+    std::size_t number_of_chunks = boundaries.size() - 1;
+
+    // Workers tokenize chunks ahead of the calling thread, which passes them to the callbacks in order.
+    // A chunk's memory is reused once it has been passed on, so at most a few chunks are kept at once.
+    std::size_t number_of_workers = number_of_threads_ - 1;
+    std::size_t number_of_slots = 2 * number_of_threads_;
+    std::vector<chunk_type> slots(number_of_slots);
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::size_t next_chunk = 0, number_of_dispatched_chunks = 0;
+    bool stop = false;
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            condition.wait(lock, [&]() { return stop || next_chunk == number_of_chunks || next_chunk < number_of_dispatched_chunks + number_of_slots; });
+            if (stop || next_chunk == number_of_chunks) {
+                return;
+            }
+            std::size_t index = next_chunk++;
+            chunk_type& chunk = slots[index % number_of_slots];
+            lock.unlock();
+            tokenize_chunk(chunk, boundaries[index], boundaries[index + 1]);
+            lock.lock();
+            chunk.index = index;
+            condition.notify_all();
+        }
+    };
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < number_of_workers; ++i) {
+        workers.push_back(std::thread(worker));
+    }
+    auto stop_workers = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        condition.notify_all();
+        for (auto i = workers.begin(); i != workers.end(); ++i) {
+            i->join();
+        }
+    };
+
+    state_type state;
+    std::size_t first_line_number = 0;
+    bool result = true;
+    try {
+        for (std::size_t index = 0; index < number_of_chunks && result; ++index) {
+            chunk_type& chunk = slots[index % number_of_slots];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]() { return chunk.index == index; });
+            }
+            result = dispatch_chunk(state, first_line_number, chunk);
+            first_line_number += chunk.number_of_lines;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                number_of_dispatched_chunks = index + 1;
+            }
+            condition.notify_all();
+        }
+    }
+    catch (...) {
+        stop_workers();
+        throw;
+    }
+    stop_workers();
+    return result;
+}
+
+void obj::obj_parser::triangular_face(face_format_type format, const face_vertex_type& v1, const face_vertex_type& v2, const face_vertex_type& v3)
+{
+    switch (format) {
+    case face_format_v:
+        if (triangular_face_geometric_vertices_callback_) {
+            triangular_face_geometric_vertices_callback_(v1.v, v2.v, v3.v);
+        }
+        break;
+    case face_format_v_vt:
+        if (triangular_face_geometric_vertices_texture_vertices_callback_) {
+            triangular_face_geometric_vertices_texture_vertices_callback_(index_2_tuple_type(v1.v, v1.vt), index_2_tuple_type(v2.v, v2.vt), index_2_tuple_type(v3.v, v3.vt));
+        }
+        break;
+    case face_format_v_vn:
+        if (triangular_face_geometric_vertices_vertex_normals_callback_) {
+            triangular_face_geometric_vertices_vertex_normals_callback_(index_2_tuple_type(v1.v, v1.vn), index_2_tuple_type(v2.v, v2.vn), index_2_tuple_type(v3.v, v3.vn));
+        }
+        break;
+    case face_format_v_vt_vn:
+        if (triangular_face_geometric_vertices_texture_vertices_vertex_normals_callback_) {
+            triangular_face_geometric_vertices_texture_vertices_vertex_normals_callback_(index_3_tuple_type(v1.v, v1.vt, v1.vn), index_3_tuple_type(v2.v, v2.vt, v2.vn), index_3_tuple_type(v3.v, v3.vt, v3.vn));
+        }
+        break;
+    }
+}
+
+void obj::obj_parser::polygonal_face_begin(face_format_type format, const face_vertex_type& v1, const face_vertex_type& v2, const face_vertex_type& v3)
+{
+    switch (format) {
+    case face_format_v:
+        if (polygonal_face_geometric_vertices_begin_callback_) {
+            polygonal_face_geometric_vertices_begin_callback_(v1.v, v2.v, v3.v);
+        }
+        break;
+    case face_format_v_vt:
+        if (polygonal_face_geometric_vertices_texture_vertices_begin_callback_) {
+            polygonal_face_geometric_vertices_texture_vertices_begin_callback_(index_2_tuple_type(v1.v, v1.vt), index_2_tuple_type(v2.v, v2.vt), index_2_tuple_type(v3.v, v3.vt));
+        }
+        break;
+    case face_format_v_vn:
+        if (polygonal_face_geometric_vertices_vertex_normals_begin_callback_) {
+            polygonal_face_geometric_vertices_vertex_normals_begin_callback_(index_2_tuple_type(v1.v, v1.vn), index_2_tuple_type(v2.v, v2.vn), index_2_tuple_type(v3.v, v3.vn));
+        }
+        break;
+    case face_format_v_vt_vn:
+        if (polygonal_face_geometric_vertices_texture_vertices_vertex_normals_begin_callback_) {
+            polygonal_face_geometric_vertices_texture_vertices_vertex_normals_begin_callback_(index_3_tuple_type(v1.v, v1.vt, v1.vn), index_3_tuple_type(v2.v, v2.vt, v2.vn), index_3_tuple_type(v3.v, v3.vt, v3.vn));
+        }
+        break;
+    }
+}
+
+void obj::obj_parser::polygonal_face_vertex(face_format_type format, const face_vertex_type& v)
+{
+    switch (format) {
+    case face_format_v:
+        if (polygonal_face_geometric_vertices_vertex_callback_) {
+            polygonal_face_geometric_vertices_vertex_callback_(v.v);
+        }
+        break;
+    case face_format_v_vt:
+        if (polygonal_face_geometric_vertices_texture_vertices_vertex_callback_) {
+            polygonal_face_geometric_vertices_texture_vertices_vertex_callback_(index_2_tuple_type(v.v, v.vt));
+        }
+        break;
+    case face_format_v_vn:
+        if (polygonal_face_geometric_vertices_vertex_normals_vertex_callback_) {
+            polygonal_face_geometric_vertices_vertex_normals_vertex_callback_(index_2_tuple_type(v.v, v.vn));
+        }
+        break;
+    case face_format_v_vt_vn:
+        if (polygonal_face_geometric_vertices_texture_vertices_vertex_normals_vertex_callback_) {
+            polygonal_face_geometric_vertices_texture_vertices_vertex_normals_vertex_callback_(index_3_tuple_type(v.v, v.vt, v.vn));
+        }
+        break;
+    }
+}
+
+void obj::obj_parser::polygonal_face_end(face_format_type format)
+{
+    switch (format) {
+    case face_format_v:
+        if (polygonal_face_geometric_vertices_end_callback_) {
+            polygonal_face_geometric_vertices_end_callback_();
+        }
+        break;
+    case face_format_v_vt:
+        if (polygonal_face_geometric_vertices_texture_vertices_end_callback_) {
+            polygonal_face_geometric_vertices_texture_vertices_end_callback_();
+        }
+        break;
+    case face_format_v_vn:
+        if (polygonal_face_geometric_vertices_vertex_normals_end_callback_) {
+            polygonal_face_geometric_vertices_vertex_normals_end_callback_();
+        }
+        break;
+    case face_format_v_vt_vn:
+        if (polygonal_face_geometric_vertices_texture_vertices_vertex_normals_end_callback_) {
+            polygonal_face_geometric_vertices_texture_vertices_vertex_normals_end_callback_();
+        }
+        break;
     }
-    
-    return istream.fail() && istream.eof() && !istream.bad();
 }
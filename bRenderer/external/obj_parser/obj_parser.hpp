@@ -4,6 +4,7 @@
 #include <fstream>
 #include <istream>
 #include <string>
+#include <vector>
 
 #include <functional>
 
@@ -46,13 +47,24 @@ public:
   typedef std::function<void (const std::string&)> material_library_callback_type;
   typedef std::function<void (const std::string&)> material_name_callback_type;
   typedef std::function<void (const std::string&)> comment_callback_type;
+  typedef enum {
+    face_format_v,
+    face_format_v_vt,
+    face_format_v_vn,
+    face_format_v_vt_vn
+  } face_format_type;
+  struct face_vertex_type {
+    index_type v, vt, vn;
+  };
   typedef int flags_type;
   typedef enum {
     parse_blank_lines_as_comment = 1 << 0,
     triangulate_faces = 1 << 1,
     translate_negative_indices = 1 << 2
   };
+  static const std::size_t minimum_chunk_size = 1 << 20;
   obj_parser(flags_type flags = 0);
+  void number_of_threads(std::size_t number_of_threads);
   void info_callback(const info_callback_type& info_callback);
   void warning_callback(const warning_callback_type& warning_callback);
   void error_callback(const error_callback_type& error_callback);
@@ -68,8 +80,25 @@ public:
   void comment_callback(const comment_callback_type& comment_callback);
   bool parse(std::istream& istream);
   bool parse(const std::string& filename);
+  bool parse(const char* begin, const char* end);
 private:
+  struct state_type {
+    std::size_t number_of_geometric_vertices = 0, number_of_texture_vertices = 0, number_of_vertex_normals = 0, number_of_faces = 0, number_of_group_names = 0, number_of_smoothing_groups = 0, number_of_object_names = 0, number_of_material_libraries = 0, number_of_material_names = 0;
+    std::string line, name;
+    std::vector<face_vertex_type> face_vertices, translated_face_vertices;
+  };
+  struct chunk_type;
+  bool parse_line(state_type& state, std::size_t line_number, const char* line_begin, const char* line_end);
+  bool face(state_type& state, std::size_t line_number, face_format_type format, const face_vertex_type* vertices, std::size_t number_of_vertices);
+  bool parse_parallel(const char* begin, const char* end);
+  void tokenize_chunk(chunk_type& chunk, const char* begin, const char* end);
+  bool dispatch_chunk(state_type& state, std::size_t first_line_number, const chunk_type& chunk);
+  void triangular_face(face_format_type format, const face_vertex_type& v1, const face_vertex_type& v2, const face_vertex_type& v3);
+  void polygonal_face_begin(face_format_type format, const face_vertex_type& v1, const face_vertex_type& v2, const face_vertex_type& v3);
+  void polygonal_face_vertex(face_format_type format, const face_vertex_type& v);
+  void polygonal_face_end(face_format_type format);
   flags_type flags_;
+  std::size_t number_of_threads_;
   info_callback_type info_callback_;
   warning_callback_type warning_callback_;
   error_callback_type error_callback_;
@@ -103,8 +132,14 @@ private:
 } // namespace obj
 
 inline obj::obj_parser::obj_parser(flags_type flags)
-  : flags_(flags)
+  : flags_(flags), number_of_threads_(1)
+{
+}
+
+// Files larger than two chunks are tokenized by number_of_threads - 1 worker threads, callbacks are always called from the parsing thread and in order
+inline void obj::obj_parser::number_of_threads(std::size_t number_of_threads)
 {
+  number_of_threads_ = number_of_threads > 0 ? number_of_threads : 1;
 }
 
 inline bool obj::obj_parser::parse(const std::string& filename)
@@ -0,0 +1,82 @@
+#ifndef B_ASSET_COOKER_H
+#define B_ASSET_COOKER_H
+
+#include <string>
+#include <vector>
+#include "Renderer_GL.h"
+
+/** @brief Converts models and textures ahead of time into binary files that are loaded without parsing or decoding.
+*
+*	Models are written as model caches (see ModelCache), textures as cooked files containing the RGBA data and all mip levels (see TextureData::saveCooked).
+*	The outputs are placed next to the sources, so loading a model or texture picks them up automatically.
+*	Outputs that are up-to-date are skipped, so cooking can be repeated after every change of the data.
+*
+*	Cooking runs on the desktop, the cooked files can then be shipped with the application (e.g. in the iOS bundle).
+*	The bRendererCook tool (project/cook) cooks every model and image of a data directory.
+*/
+class AssetCooker
+{
+public:
+	/* Functions */
+
+	/**	@brief Adds a model to be cooked
+	*	@param[in] fileName The name of the OBJ file
+	*	@param[in] flipT Must match the option the model is loaded with
+	*	@param[in] flipZ Must match the option the model is loaded with
+	*/
+	void addModel(const std::string &fileName, bool flipT = false, bool flipZ = false);
+
+	/**	@brief Adds a texture to be cooked
+	*	@param[in] fileName The name of the image file
+	*/
+	void addTexture(const std::string &fileName);
+
+	/**	@brief Cooks all added assets, returns false if any of them failed
+	*	@param[in] manifestPath The full path to a JSON file listing the sources and outputs, no manifest is written if empty
+	*	@param[in] nThreads The number of threads to cook on, 0 uses all cores
+	*/
+	bool run(const std::string &manifestPath = "", GLuint nThreads = 0);
+
+private:
+
+	/* Structs */
+
+	enum AssetType
+	{
+		AT_MODEL,
+		AT_TEXTURE
+	};
+
+	struct Job
+	{
+		AssetType	type;
+		std::string	fileName;
+		bool		flipT = false;
+		bool		flipZ = false;
+		bool		skipped = false;
+		bool		succeeded = false;
+	};
+
+	/* Functions */
+
+	/**	@brief Cooks a single asset unless its output is up-to-date
+	*	@param[in] job
+	*/
+	static void cook(Job &job);
+
+	/**	@brief Returns the path of the output of a job
+	*	@param[in] job
+	*/
+	static std::string getOutputPath(const Job &job);
+
+	/**	@brief Writes the manifest of the last run
+	*	@param[in] manifestPath
+	*/
+	bool writeManifest(const std::string &manifestPath) const;
+
+	/* Variables */
+
+	std::vector< Job > _jobs;
+};
+
+#endif /* defined(B_ASSET_COOKER_H) */
@@ -0,0 +1,192 @@
+#ifndef B_BINARY_FILE_H
+#define B_BINARY_FILE_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+
+/** @brief Builds a binary file in memory, used for cooked assets.
+*
+*	Values are stored in the byte order of the machine, files should contain a marker to detect a mismatch.
+*/
+class BinaryWriter
+{
+public:
+	/* Functions */
+
+	/**	@brief Appends raw bytes
+	*	@param[in] data
+	*	@param[in] size
+	*/
+	void write(const void *data, size_t size)
+	{
+		const char *bytes = static_cast<const char *>(data);
+		_data.insert(_data.end(), bytes, bytes + size);
+	}
+
+	/**	@brief Appends a value
+	*	@param[in] v
+	*/
+	template< typename T >
+	void value(const T &v) { write(&v, sizeof(T)); }
+
+	/**	@brief Appends a string preceded by its length
+	*	@param[in] s
+	*/
+	void string(const std::string &s)
+	{
+		value(static_cast<uint32_t>(s.size()));
+		write(s.data(), s.size());
+	}
+
+	/**	@brief Pads the data with zeros to a multiple of the alignment
+	*	@param[in] alignment
+	*/
+	void align(size_t alignment) { _data.resize((_data.size() + alignment - 1) / alignment * alignment, 0); }
+
+	/**	@brief Overwrites a 64 bit value written before, e.g. an offset that wasn't known yet
+	*	@param[in] offset
+	*	@param[in] v
+	*/
+	void patch(size_t offset, uint64_t v) { std::memcpy(&_data[offset], &v, sizeof(v)); }
+
+	/**	@brief Returns the number of bytes written so far
+	*/
+	size_t size() const { return _data.size(); }
+
+	/**	@brief Writes the data to a file, returns false if that failed
+	*
+	*	The data is written to a temporary file which then replaces the file, so a failed write never leaves a broken file behind.
+	*
+	*	@param[in] filePath The full path to the file
+	*/
+	bool save(const std::string &filePath) const;
+
+private:
+
+	/* Variables */
+
+	std::vector< char > _data;
+};
+
+/** @brief Reads values from binary data, e.g. a mapped file.
+*
+*	Once a read went past the end every following read fails as well, so ok() only needs to be checked once in a while.
+*/
+class BinaryReader
+{
+public:
+	/* Functions */
+
+	/**	@brief Constructor
+	*	@param[in] begin
+	*	@param[in] end
+	*/
+	BinaryReader(const char *begin, const char *end) : _begin(begin), _p(begin), _end(end) {}
+
+	/**	@brief Reads raw bytes, returns false if there aren't enough left
+	*	@param[out] data
+	*	@param[in] size
+	*/
+	bool read(void *data, size_t size)
+	{
+		if (!_ok || static_cast<size_t>(_end - _p) < size)
+			return _ok = false;
+		std::memcpy(data, _p, size);
+		_p += size;
+		return true;
+	}
+
+	/**	@brief Reads a value
+	*/
+	template< typename T >
+	T value()
+	{
+		T v = T();
+		read(&v, sizeof(T));
+		return v;
+	}
+
+	/**	@brief Reads a string preceded by its length
+	*/
+	std::string string()
+	{
+		uint32_t size = value< uint32_t >();
+		if (!_ok || static_cast<size_t>(_end - _p) < size){
+			_ok = false;
+			return std::string();
+		}
+		std::string s(_p, size);
+		_p += size;
+		return s;
+	}
+
+	/**	@brief Returns a pointer to count elements at an offset from the start or nullptr if they are out of bounds
+	*	@param[in] offset
+	*	@param[in] count
+	*	@param[in] elementSize
+	*/
+	const char *blob(uint64_t offset, uint64_t count, size_t elementSize) const
+	{
+		uint64_t length = static_cast<uint64_t>(_end - _begin);
+		if (offset > length || count > (length - offset) / elementSize)
+			return nullptr;
+		return _begin + offset;
+	}
+
+	/**	@brief Returns false if a read failed
+	*/
+	bool ok() const { return _ok; }
+
+private:
+
+	/* Variables */
+
+	const char	*_begin, *_p, *_end;
+	bool		_ok = true;
+};
+
+/** @brief Identifies the version of a source file an asset was cooked from.
+*
+*	A stamp is current if the size and either the modification time or a hash of the content match.
+*	Cooked files therefore stay valid if the sources are copied (e.g. into an application bundle) without being changed.
+*	The content is only hashed if the modification time differs.
+*/
+struct SourceStamp
+{
+	/* Functions */
+
+	/**	@brief Creates the stamp of a file, returns false if the file doesn't exist
+	*	@param[in] fileName The name of the file (see bRenderer::getFilePath)
+	*/
+	bool create(const std::string &fileName);
+
+	/**	@brief Returns true if the file still matches the stamp
+	*/
+	bool isCurrent() const;
+
+	/**	@brief Writes the stamp
+	*	@param[in] writer
+	*/
+	void write(BinaryWriter &writer) const;
+
+	/**	@brief Reads a stamp, returns false if that failed
+	*	@param[in] reader
+	*/
+	bool read(BinaryReader &reader);
+
+	/**	@brief Returns a hash of the content of a file or 0 if it cannot be read
+	*	@param[in] filePath The full path to the file
+	*/
+	static uint64_t hashFile(const std::string &filePath);
+
+	/* Variables */
+
+	std::string	fileName;
+	int64_t		size = 0;
+	int64_t		modificationTime = 0;
+	uint64_t	hash = 0;
+};
+
+#endif /* defined(B_BINARY_FILE_H) */
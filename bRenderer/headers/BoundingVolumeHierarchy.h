@@ -0,0 +1,129 @@
+#ifndef B_BOUNDING_VOLUME_HIERARCHY_H
+#define B_BOUNDING_VOLUME_HIERARCHY_H
+
+#include <vector>
+#include "Renderer_GL.h"
+#include "Frustum.h"
+
+/** @brief A bounding volume hierarchy of axis-aligned boxes in world space for culling many objects against the view frustum at once.
+*
+*	The tree is built top-down by splitting the objects at the median of their centers along the longest axis.
+*	Objects that move only update the boxes of the nodes above them (refitting), which keeps the tree valid but may make it less tight.
+*	Adding or removing objects rebuilds the tree the next time it is used.
+*
+*	Culling visits the tree from the root and keeps track of the frustum planes a node is completely inside of,
+*	so nodes further down only test the remaining planes, and subtrees completely inside the frustum are accepted without any test.
+*	The objects of a leaf are tested together with Frustum::testBoxes().
+*/
+class BoundingVolumeHierarchy
+{
+public:
+	/* Functions */
+
+	/**	@brief Adds an object and returns its ID
+	*	@param[in] boxWorldSpace The bounding box of the object in world space
+	*/
+	GLuint addObject(const vmml::AABBf &boxWorldSpace);
+
+	/**	@brief Updates the bounding box of an object that moved
+	*	@param[in] objectID
+	*	@param[in] boxWorldSpace The new bounding box of the object in world space
+	*/
+	void moveObject(GLuint objectID, const vmml::AABBf &boxWorldSpace);
+
+	/**	@brief Removes an object, its ID may be reused for objects added later
+	*	@param[in] objectID
+	*/
+	void removeObject(GLuint objectID);
+
+	/**	@brief Removes all objects
+	*/
+	void clear();
+
+	/**	@brief Rebuilds the tree if objects were added or removed and refits it if objects moved
+	*
+	*	This is done automatically before culling.
+	*/
+	void update();
+
+	/**	@brief Appends the IDs of all objects whose bounding box is at least partially inside the view frustum
+	*	@param[in] viewProjectionMatrix The view projection matrix (projection * view)
+	*	@param[out] visibleObjects
+	*/
+	void cull(const vmml::Matrix4f &viewProjectionMatrix, std::vector< GLuint > &visibleObjects);
+
+	/**	@brief Appends the IDs of all objects whose bounding box is at least partially inside the view frustum
+	*	@param[in] frustum The view frustum in world space
+	*	@param[out] visibleObjects
+	*/
+	void cull(const Frustum &frustum, std::vector< GLuint > &visibleObjects);
+
+	/**	@brief Returns the number of objects in the tree
+	*/
+	size_t getNumObjects() const { return _nObjects; }
+
+	/**	@brief Returns the number of nodes that were tested against the frustum during the last call to cull()
+	*/
+	size_t getNumNodesTested() const { return _nNodesTested; }
+
+	/**	@brief Returns the bounding box of an object box transformed by a matrix
+	*	@param[in] boxObjectSpace
+	*	@param[in] modelMatrix
+	*/
+	static vmml::AABBf transformBox(const vmml::AABBf &boxObjectSpace, const vmml::Matrix4f &modelMatrix);
+
+	/* Variables */
+
+	// Leaves are not split any further once they hold this many objects, enough for the SIMD tests to pay off
+	static const GLuint MAX_OBJECTS_PER_LEAF = 8;
+
+private:
+
+	/* Structs */
+
+	struct Node
+	{
+		vmml::Vector3f	min, max;
+		// Leaves hold count objects starting at first in the object order, inner nodes have their children at first and first + 1
+		GLuint			first;
+		GLuint			count;
+	};
+
+	/* Functions */
+
+	/**	@brief Builds the tree from scratch
+	*/
+	void build();
+
+	/**	@brief Recomputes the bounding boxes of all nodes from their objects
+	*/
+	void refit();
+
+	/**	@brief Splits the objects of a node until the leaves are small enough
+	*	@param[in] node
+	*/
+	void split(GLuint node);
+
+	/**	@brief Sets the bounding box of a node to the union of the boxes of its objects or children
+	*	@param[in] node
+	*/
+	void fitNode(GLuint node);
+
+	/* Variables */
+
+	std::vector< vmml::Vector3f >	_objectMin, _objectMax;
+	std::vector< bool >				_objectAlive;
+	std::vector< GLuint >			_freeIDs;
+	size_t							_nObjects = 0;
+
+	std::vector< Node >		_nodes;
+	std::vector< GLuint >	_order;
+	Frustum::BoxArray		_orderedBoxes;
+	bool					_needsBuild = false;
+	bool					_needsRefit = false;
+
+	std::vector< std::pair< GLuint, GLuint > >	_stack;
+	size_t										_nNodesTested = 0;
+};
+
+#endif /* defined(B_BOUNDING_VOLUME_HIERARCHY_H) */
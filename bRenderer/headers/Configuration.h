@@ -12,101 +12,132 @@ namespace bRenderer
 	*/
 	bool loadConfigFile(const std::string &fileName);
 
+	/**	@brief Registers a function that gets called every time a configuration file was loaded
+	*
+	*	All configurations are read into a cache once when the file is loaded, the functions below
+	*	only return references to the cached values. Objects that copied a configuration value can use 
+	*	this hook to update their copy after reloading.
+	*
+	*	@param[in] f The function to be called
+	*/
+	void addConfigReloadFunction(void(*f)());
+
 	/* Renderer configuration */
-	vmml::Vector3f DEFAULT_AMBIENT_COLOR();
+	const vmml::Vector3f &DEFAULT_AMBIENT_COLOR();
 
 	/* Logger */
-	std::string LOG_MODE_INFO();
-	std::string LOG_MODE_WARNING();
-	std::string LOG_MODE_ERROR();
-	std::string LOG_MODE_SYSTEM();
+	const std::string &LOG_MODE_INFO();
+	const std::string &LOG_MODE_WARNING();
+	const std::string &LOG_MODE_ERROR();
+	const std::string &LOG_MODE_SYSTEM();
 
 	/* Desktop specific view configuration */
 	GLint DEFAULT_VIEW_WIDTH();
 	GLint DEFAULT_VIEW_HEIGHT();
-	std::string DEFAULT_WINDOW_TITLE();
+	const std::string &DEFAULT_WINDOW_TITLE();
 
 	/* Desktop specific file path configuration */
-	std::string DEFAULT_FILE_PATH();
+	const std::string &DEFAULT_FILE_PATH();
 
 	/* OBJ loader default group name */
-	std::string DEFAULT_GROUP_NAME();
+	const std::string &DEFAULT_GROUP_NAME();
+
+	/* Binary model cache, written to its own directory at runtime (next to the OBJ files if empty) and next to the OBJ files when cooked */
+	bool MODEL_CACHE_ENABLED();
+	const std::string &MODEL_CACHE_FILE_EXTENSION();
+	const std::string &MODEL_CACHE_DIRECTORY();
+
+	/* Vertex cache optimization of loaded models */
+	bool MESH_OPTIMIZATION_ENABLED();
+
+	/* Free the vertices and indices of loaded models in main memory once they are on the GPU (see Geometry::releaseCPUData) */
+	bool RELEASE_GEOMETRY_CPU_DATA();
+
+	/* Levels of detail generated for loaded models, selected by their size on the screen */
+	GLuint LOD_LEVELS();
+	GLfloat LOD_REDUCTION();
+	GLfloat LOD_SCREEN_SIZE();
+	GLfloat LOD_HYSTERESIS();
+
+	/* Cooked textures, written next to images by the AssetCooker */
+	const std::string &COOKED_TEXTURE_FILE_EXTENSION();
 
 	/* Shader macros*/
-	std::string SHADER_VERSION_MACRO();
-	std::string SHADER_MAX_LIGHTS_MACRO();
+	const std::string &SHADER_VERSION_MACRO();
+	const std::string &SHADER_MAX_LIGHTS_MACRO();
 
 	/* Shader configuration */
-	std::string DEFAULT_SHADER_VERSION_DESKTOP();
-	std::string DEFAULT_SHADER_VERSION_ES();
+	const std::string &DEFAULT_SHADER_VERSION_DESKTOP();
+	const std::string &DEFAULT_SHADER_VERSION_ES();
 	GLuint DEFAULT_SHADER_MAX_LIGHTS();
-	std::string DEFAULT_FRAGMENT_SHADER_FILENAME_EXTENSION();
-	std::string DEFAULT_VERTEX_SHADER_FILENAME_EXTENSION();
+	const std::string &DEFAULT_FRAGMENT_SHADER_FILENAME_EXTENSION();
+	const std::string &DEFAULT_VERTEX_SHADER_FILENAME_EXTENSION();
 
 	/* Shader uniforms */
-	std::string DEFAULT_SHADER_UNIFORM_DIFFUSE_MAP();
-	std::string DEFAULT_SHADER_UNIFORM_SPECULAR_MAP();
-	std::string DEFAULT_SHADER_UNIFORM_NORMAL_MAP();
-	std::string DEFAULT_SHADER_UNIFORM_CUBE_MAP();
-	std::string DEFAULT_SHADER_UNIFORM_SPHERE_MAP();
-	std::string DEFAULT_SHADER_UNIFORM_CHARACTER_MAP();
-	std::string DEFAULT_SHADER_UNIFORM_NORMAL_MATRIX();
-	std::string DEFAULT_SHADER_UNIFORM_MODEL_MATRIX();
-	std::string DEFAULT_SHADER_UNIFORM_VIEW_MATRIX();
-	std::string DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX();
-	std::string DEFAULT_SHADER_UNIFORM_INVERSE_VIEW_MATRIX();
-	std::string DEFAULT_SHADER_UNIFORM_PROJECTION_MATRIX();
-	std::string DEFAULT_SHADER_UNIFORM_NUMBER_OF_LIGHTS();
-	std::string DEFAULT_SHADER_UNIFORM_LIGHT_POSITION_VIEW_SPACE();
-	std::string DEFAULT_SHADER_UNIFORM_DIFFUSE_LIGHT_COLOR();
-	std::string DEFAULT_SHADER_UNIFORM_SPECULAR_LIGHT_COLOR();
-	std::string DEFAULT_SHADER_UNIFORM_LIGHT_INTENSITY();
-	std::string DEFAULT_SHADER_UNIFORM_LIGHT_ATTENUATION();
-	std::string DEFAULT_SHADER_UNIFORM_LIGHT_RADIUS();
-	std::string DEFAULT_SHADER_UNIFORM_AMBIENT_COLOR();
-	std::string DEFAULT_SHADER_UNIFORM_TRANSPARENCY();
+	const std::string &DEFAULT_SHADER_UNIFORM_DIFFUSE_MAP();
+	const std::string &DEFAULT_SHADER_UNIFORM_SPECULAR_MAP();
+	const std::string &DEFAULT_SHADER_UNIFORM_NORMAL_MAP();
+	const std::string &DEFAULT_SHADER_UNIFORM_CUBE_MAP();
+	const std::string &DEFAULT_SHADER_UNIFORM_SPHERE_MAP();
+	const std::string &DEFAULT_SHADER_UNIFORM_CHARACTER_MAP();
+	const std::string &DEFAULT_SHADER_UNIFORM_NORMAL_MATRIX();
+	const std::string &DEFAULT_SHADER_UNIFORM_MODEL_MATRIX();
+	const std::string &DEFAULT_SHADER_UNIFORM_VIEW_MATRIX();
+	const std::string &DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX();
+	const std::string &DEFAULT_SHADER_UNIFORM_INVERSE_VIEW_MATRIX();
+	const std::string &DEFAULT_SHADER_UNIFORM_PROJECTION_MATRIX();
+	const std::string &DEFAULT_SHADER_UNIFORM_NUMBER_OF_LIGHTS();
+	const std::string &DEFAULT_SHADER_UNIFORM_LIGHT_POSITION_VIEW_SPACE();
+	const std::string &DEFAULT_SHADER_UNIFORM_DIFFUSE_LIGHT_COLOR();
+	const std::string &DEFAULT_SHADER_UNIFORM_SPECULAR_LIGHT_COLOR();
+	const std::string &DEFAULT_SHADER_UNIFORM_LIGHT_INTENSITY();
+	const std::string &DEFAULT_SHADER_UNIFORM_LIGHT_ATTENUATION();
+	const std::string &DEFAULT_SHADER_UNIFORM_LIGHT_RADIUS();
+	const std::string &DEFAULT_SHADER_UNIFORM_AMBIENT_COLOR();
+	const std::string &DEFAULT_SHADER_UNIFORM_TRANSPARENCY();
 	
 	/* Shader attributes */
-	std::string DEFAULT_SHADER_ATTRIBUTE_POSITION();
-	std::string DEFAULT_SHADER_ATTRIBUTE_NORMAL();
-	std::string DEFAULT_SHADER_ATTRIBUTE_TANGENT();
-	std::string DEFAULT_SHADER_ATTRIBUTE_BITANGENT();
-	std::string DEFAULT_SHADER_ATTRIBUTE_TEXCOORD();
+	const std::string &DEFAULT_SHADER_ATTRIBUTE_POSITION();
+	const std::string &DEFAULT_SHADER_ATTRIBUTE_NORMAL();
+	const std::string &DEFAULT_SHADER_ATTRIBUTE_TANGENT();
+	const std::string &DEFAULT_SHADER_ATTRIBUTE_BITANGENT();
+	const std::string &DEFAULT_SHADER_ATTRIBUTE_TEXCOORD();
+	const std::string &DEFAULT_SHADER_ATTRIBUTE_INSTANCE_MODEL_VIEW_MATRIX();
 
 	/* Material key words */
-	std::string WAVEFRONT_MATERIAL_NEWMTL();
-	std::string WAVEFRONT_MATERIAL_AMBIENT_COLOR();
-	std::string WAVEFRONT_MATERIAL_DIFFUSE_COLOR();
-	std::string WAVEFRONT_MATERIAL_SPECULAR_COLOR();
-	std::string WAVEFRONT_MATERIAL_TRANSMISSION_FILTER();
-	std::string WAVEFRONT_MATERIAL_SPECULAR_EXPONENT();
-	std::string WAVEFRONT_MATERIAL_OPTICAL_DENSITY();
-	std::string WAVEFRONT_MATERIAL_ILLUMINATION_MODEL();
-	std::string WAVEFRONT_MATERIAL_DIFFUSE_MAP();
-	std::string WAVEFRONT_MATERIAL_SPECULAR_MAP();
-	std::string WAVEFRONT_MATERIAL_NORMAL_MAP();
-	std::string WAVEFRONT_MATERIAL_DISSOLVE();
-	std::string WAVEFRONT_MATERIAL_REFLECTION();
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE();
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_TOP();
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BOTTOM();
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_FRONT();
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BACK();
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_LEFT();
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_RIGHT();
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_SPHERE();
+	const std::string &WAVEFRONT_MATERIAL_NEWMTL();
+	const std::string &WAVEFRONT_MATERIAL_AMBIENT_COLOR();
+	const std::string &WAVEFRONT_MATERIAL_DIFFUSE_COLOR();
+	const std::string &WAVEFRONT_MATERIAL_SPECULAR_COLOR();
+	const std::string &WAVEFRONT_MATERIAL_TRANSMISSION_FILTER();
+	const std::string &WAVEFRONT_MATERIAL_SPECULAR_EXPONENT();
+	const std::string &WAVEFRONT_MATERIAL_OPTICAL_DENSITY();
+	const std::string &WAVEFRONT_MATERIAL_ILLUMINATION_MODEL();
+	const std::string &WAVEFRONT_MATERIAL_DIFFUSE_MAP();
+	const std::string &WAVEFRONT_MATERIAL_SPECULAR_MAP();
+	const std::string &WAVEFRONT_MATERIAL_NORMAL_MAP();
+	const std::string &WAVEFRONT_MATERIAL_DISSOLVE();
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION();
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE();
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_TOP();
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BOTTOM();
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_FRONT();
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BACK();
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_LEFT();
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_RIGHT();
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE_SPHERE();
 
 	/* Camera configuration */
 	GLfloat DEFAULT_FIELD_OF_VIEW();
 	GLfloat DEFAULT_ASPECT_RATIO();
 	GLfloat DEFAULT_NEAR_CLIPPING_PLANE();
 	GLfloat DEFAULT_FAR_CLIPPING_PLANE();
-	vmml::Vector3f DEFAULT_CAMERA_POSITION();
-	vmml::Vector3f DEFAULT_CAMERA_ROTATION_AXES();
+	const vmml::Vector3f &DEFAULT_CAMERA_POSITION();
+	const vmml::Vector3f &DEFAULT_CAMERA_ROTATION_AXES();
 
 	/* Light configuration */
-	vmml::Vector4f DEFAULT_LIGHT_POSITION();
-	vmml::Vector3f DEFAULT_LIGHT_COLOR();
+	const vmml::Vector4f &DEFAULT_LIGHT_POSITION();
+	const vmml::Vector3f &DEFAULT_LIGHT_COLOR();
 	GLfloat DEFAULT_LIGHT_INTENSITY();
 	GLfloat DEFAULT_LIGHT_ATTENUATION();
 	GLfloat DEFAULT_LIGHT_RADIUS();
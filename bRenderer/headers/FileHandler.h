@@ -4,6 +4,7 @@
 #include "OSdetect.h"
 #include "Renderer_GL.h"
 #include <string>
+#include <vector>
 
 namespace bRenderer
 {
@@ -22,6 +23,84 @@ namespace bRenderer
 	 */
 	bool fileExists(const std::string &fileName);
 
+	/**	@brief Gets the size and the time of the last modification of a file, returns false if the file doesn't exist
+	*	@param[in] filePath The full path to the file (see getFilePath)
+	*	@param[out] size Size in bytes
+	*	@param[out] modificationTime Seconds since the epoch
+	*/
+	bool getFileStatus(const std::string &filePath, long long &size, long long &modificationTime);
+
+	/**	@brief Lists all files in a directory and its subdirectories, returns false if the directory can't be read
+	*	@param[in] directory The directory relative to the standard file path, empty for the standard file path itself
+	*	@param[out] fileNames The names of the files relative to the standard file path, sorted
+	*/
+	bool listFiles(const std::string &directory, std::vector< std::string > &fileNames);
+
+	/**	@brief Creates a directory and its missing parent directories, returns true if the directory exists afterwards
+	*	@param[in] directoryPath The full path to the directory
+	*/
+	bool createDirectory(const std::string &directoryPath);
+
+	/** @brief Read-only view of the contents of a file.
+	*
+	*	On Linux and OSX the file is memory mapped, so its contents are never copied.
+	*	On other systems or if mapping fails the whole file is read into memory at once.
+	*	The contents stay valid as long as the object exists.
+	*/
+	class MappedFile
+	{
+	public:
+		/* Functions */
+
+		/**	@brief Constructor
+		*	@param[in] filePath The full path to the file (see getFilePath)
+		*/
+		MappedFile(const std::string &filePath);
+
+		/**	@brief Destructor, unmaps the file
+		*/
+		~MappedFile();
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+
+		/**	@brief Returns true if the file could be opened
+		*/
+		bool isOpen() const { return _open; }
+
+		/**	@brief Returns true if the file is memory mapped, false if it was read into memory
+		*/
+		bool isMapped() const { return _mapped; }
+
+		/**	@brief Returns a pointer to the first byte of the file
+		*/
+		const char *begin() const { return _data; }
+
+		/**	@brief Returns a pointer past the last byte of the file
+		*/
+		const char *end() const { return _data + _size; }
+
+		/**	@brief Returns the size of the file in bytes
+		*/
+		size_t size() const { return _size; }
+
+	private:
+		/* Functions */
+
+		/**	@brief Reads the whole file into memory
+		*	@param[in] filePath
+		*/
+		bool read(const std::string &filePath);
+
+		/* Variables */
+
+		const char			*_data = nullptr;
+		size_t				_size = 0;
+		bool				_open = false;
+		bool				_mapped = false;
+		std::vector< char >	_buffer;
+	};
+
 } // namespace bRenderer
 
 #endif /* defined(B_FILE_HANDLER_H) */
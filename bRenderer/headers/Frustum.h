@@ -0,0 +1,118 @@
+#ifndef B_FRUSTUM_H
+#define B_FRUSTUM_H
+
+#include <vector>
+#include <cstdint>
+#include "Renderer_GL.h"
+#include "vmmlib/aabb.hpp"
+#include "vmmlib/matrix.hpp"
+#include "vmmlib/frustum_culler.hpp"
+
+/** @brief The planes of a view frustum, extracted once from a (model) view projection matrix and used to test many bounding boxes.
+*
+*	Boxes can be tested one at a time or in batches stored as separate arrays per coordinate (see BoxArray).
+*	Batches are tested four boxes at a time with SSE on x86 and NEON on ARM, and with scalar code elsewhere.
+*	Both give the same result as testBoxesReference().
+*/
+class Frustum
+{
+public:
+	/* Structs */
+
+	/* Bounding boxes stored as one array per coordinate, so that consecutive boxes can be loaded into SIMD registers */
+	struct BoxArray
+	{
+		std::vector< GLfloat > minX, minY, minZ, maxX, maxY, maxZ;
+
+		/**	@brief Returns the number of boxes
+		*/
+		size_t size() const { return minX.size(); }
+
+		/**	@brief Changes the number of boxes
+		*	@param[in] n
+		*/
+		void resize(size_t n);
+
+		/**	@brief Removes all boxes
+		*/
+		void clear() { resize(0); }
+
+		/**	@brief Appends a box
+		*	@param[in] box
+		*/
+		void push_back(const vmml::AABBf &box);
+
+		/**	@brief Replaces a box
+		*	@param[in] i Index of the box
+		*	@param[in] min
+		*	@param[in] max
+		*/
+		void set(size_t i, const vmml::Vector3f &min, const vmml::Vector3f &max);
+	};
+
+	/* Functions */
+
+	/**	@brief Constructor
+	*/
+	Frustum() {}
+
+	/**	@brief Constructor
+	*	@param[in] viewProjectionMatrix The matrix that transforms the boxes into clip space (e.g. projection * view for boxes in world space)
+	*/
+	Frustum(const vmml::Matrix4f &viewProjectionMatrix) { setup(viewProjectionMatrix); }
+
+	/**	@brief Extracts the planes from a matrix (Gribb and Hartmann)
+	*	@param[in] viewProjectionMatrix The matrix that transforms the boxes into clip space (e.g. projection * view for boxes in world space)
+	*/
+	void setup(const vmml::Matrix4f &viewProjectionMatrix);
+
+	/**	@brief Returns whether a box is completely, partially or not at all inside of the frustum
+	*	@param[in] box
+	*/
+	vmml::Visibility testBox(const vmml::AABBf &box) const;
+
+	/**	@brief Tests a box against the planes in a mask, returns false if it is outside
+	*
+	*	Planes the box is completely inside of are removed from the mask, so boxes contained in this one only have to test the remaining planes.
+	*
+	*	@param[in] min
+	*	@param[in] max
+	*	@param[in,out] planeMask One bit per plane (left, right, bottom, top, near, far), ALL_PLANES to test all of them
+	*/
+	bool testBox(const vmml::Vector3f &min, const vmml::Vector3f &max, GLuint &planeMask) const;
+
+	/**	@brief Tests up to 32 consecutive boxes and returns a mask with a bit set for every box that is at least partially inside
+	*	@param[in] boxes
+	*	@param[in] first Index of the first box, bit 0 of the result
+	*	@param[in] count Number of boxes to test (at most 32)
+	*/
+	uint32_t testBoxes(const BoxArray &boxes, size_t first, size_t count) const;
+
+	/**	@brief Tests all boxes and writes a bit for every box that is at least partially inside (bit i % 32 of word i / 32)
+	*	@param[in] boxes
+	*	@param[out] visibilityMask
+	*/
+	void testBoxes(const BoxArray &boxes, std::vector< uint32_t > &visibilityMask) const;
+
+	/**	@brief Scalar version of testBoxes() that the SIMD versions have to agree with
+	*	@param[in] boxes
+	*	@param[out] visibilityMask
+	*/
+	void testBoxesReference(const BoxArray &boxes, std::vector< uint32_t > &visibilityMask) const;
+
+	/**	@brief Returns the planes facing into the frustum (left, right, bottom, top, near, far), not normalized
+	*/
+	const vmml::Vector4f *getPlanes() const { return _planes; }
+
+	/* Variables */
+
+	static const GLuint ALL_PLANES = 0x3f;
+
+private:
+
+	/* Variables */
+
+	vmml::Vector4f _planes[6];
+};
+
+#endif /* defined(B_FRUSTUM_H) */
@@ -14,6 +14,13 @@
 #include "vmmlib/aabb.hpp"
 
 /** @brief A geometry object containing vertices and indices that can be rendered to the screen.
+*
+*	Vertices and indices are uploaded to buffers on the GPU. Indices are stored with 16 bits if all vertices
+*	can be addressed that way and with 32 bits otherwise.
+*	If the material is set before initialization, the vertices are uploaded in the most compact layout
+*	that contains only the components the data provides and the shader uses (see VertexLayout).
+*	If supported, a vertex array object is created for every shader the geometry is drawn with.
+*	Levels of detail in the geometry data become geometry objects of their own that share the material, properties and instances.
 *	@author Rahul Mukhi, David Steiner
 */
 class Geometry : public IDrawable
@@ -21,14 +28,14 @@ class Geometry : public IDrawable
 public:
 	/* Typedefs */
 	typedef std::shared_ptr< Vertex >   VertexDataPtr;
-    typedef std::shared_ptr< GLushort > IndexDataPtr;
+    typedef std::shared_ptr< Index >    IndexDataPtr;
 	typedef std::unordered_map< std::string, PropertiesPtr >	PropertiesMap;
 
 	/* Functions */
 
 	/**	@brief Constructor
 	*/
-	Geometry(){ _initialized = false; }
+	Geometry() : _id(++_idCounter) { _initialized = false; }
 
 	/**	@brief Virtual destructor
 	*/
@@ -37,6 +44,9 @@ public:
     }
 
 	/**	@brief Initializes the geometry object based on geometry data
+	*
+	*	The material should be set beforehand so that the vertex layout can be chosen according to its shader.
+	*
 	*	@param[in] geometryData
 	*/
 	virtual void initialize(GeometryDataPtr geometryData);
@@ -52,6 +62,18 @@ public:
 	*/
 	virtual void drawInstance(const std::string &instanceName, GLenum mode = GL_TRIANGLES) override;
 
+	/**	@brief Draws multiple instances of the geometry to the screen
+	*
+	*	If the instances only differ in their model view matrix they are drawn together: with a single instanced draw call
+	*	if the shader and the context support it, otherwise the instances are transformed on the CPU and batched into one vertex buffer.
+	*	Instances with other differing properties are drawn one by one.
+	*
+	*	@param[in] instanceNames
+	*	@param[in] nInstances Number of instance names to be used
+	*	@param[in] mode
+	*/
+	virtual void drawInstances(const std::vector<std::string> &instanceNames, size_t nInstances, GLenum mode = GL_TRIANGLES) override;
+
 	/**	@brief Creates an instance of this geometry
 	*	@param[in] instanceName	Name of the instance
 	*/
@@ -77,11 +99,18 @@ public:
 	*/
 	virtual void			clearInstances();
 
-	/**	@brief Returns a pointer to the vertices of the geometry
+	/**	@brief Frees the copies of the vertices and indices kept in main memory
+	*
+	*	The geometry can still be drawn since the data is stored on the GPU, but instances have to be drawn one by one
+	*	if hardware instancing isn't available.
+	*/
+	void			releaseCPUData();
+
+	/**	@brief Returns a pointer to the vertices of the geometry (nullptr if the CPU data was released)
 	*/
     VertexDataPtr   getVertexData()					{ return _vertexData;   }
 
-	/**	@brief Returns a pointer to the indices of the geometry
+	/**	@brief Returns a pointer to the indices of the geometry (nullptr if the CPU data was released)
 	*/
 	IndexDataPtr    getIndexData()					{ return _indexData; }
 
@@ -92,6 +121,14 @@ public:
 	/**	@brief Returns the number of indices in the geometry
 	*/
 	size_t			getNumIndices()					{ return _nIndices; }
+
+	/**	@brief Returns the type of the indices stored on the GPU (GL_UNSIGNED_SHORT or GL_UNSIGNED_INT)
+	*/
+	GLenum			getIndexType()					{ return _indexType; }
+
+	/**	@brief Returns the layout of the vertices stored on the GPU
+	*/
+	const VertexLayout *getVertexLayout()			{ return _vertexLayout; }
     
 	/**	@brief Sets the vertices of the geometry
 	*	@param[in] arg The new vertices that should be used for the geometry
@@ -110,7 +147,7 @@ public:
 	/**	@brief Sets the material of the geometry
 	*	@param[in] arg The new material that should be used for the geometry
 	*/
-    void            setMaterial(MaterialPtr arg)        { _material     = arg;  }
+    void            setMaterial(MaterialPtr arg);
 
 	/**	@brief Returns a pointer to the properties of the geometry
 	*/
@@ -119,7 +156,7 @@ public:
 	/**	@brief Sets the properties of the geometry
 	*	@param[in] arg The properties for the geometry
 	*/
-	void            setProperties(PropertiesPtr arg)	{ _properties = arg; }
+	void            setProperties(PropertiesPtr arg);
 
 	/**	@brief Returns the bounding box of the geometry in object space
 	*/
@@ -130,12 +167,56 @@ public:
 	*/
 	void            setBoundingBoxObjectSpace(vmml::AABBf arg)						{ _boundingBox = arg; }
 
+	/**	@brief Returns a level of detail of the geometry, nullptr for level 0 (the geometry itself)
+	*
+	*	Levels beyond the last one return the last level.
+	*
+	*	@param[in] level
+	*/
+	std::shared_ptr< Geometry > getLevelOfDetail(GLuint level);
+
+	/**	@brief Returns the number of levels of detail below the full detail
+	*/
+	GLuint			getNumLevelsOfDetail()			{ return static_cast<GLuint>(_levelsOfDetail.size()); }
+
+	/**	@brief Returns a number that uniquely identifies the geometry
+	*/
+	GLuint			getID()											{ return _id; }
+
+	/**	@brief Returns true if the context supports drawing instances with a single draw call
+	*/
+	static bool supportsHardwareInstancing();
+
+	/**	@brief Returns true if the context supports vertex array objects
+	*/
+	static bool supportsVertexArrayObjects();
+
+	/**	@brief Returns true if the context supports 32 bit indices (always on the desktop, with OES_element_index_uint on OpenGL ES 2.0)
+	*/
+	static bool supports32BitIndices();
+
 	/**	@brief Deletes the geometry
 	*/
 	virtual void deleteGeometry()
 	{
+		deleteIndexChunks();
 		if (_vertexBuffer)
 			glDeleteBuffers(1, &_vertexBuffer);
+		if (_indexBuffer)
+			glDeleteBuffers(1, &_indexBuffer);
+		if (_instanceBuffer)
+			glDeleteBuffers(1, &_instanceBuffer);
+		if (_batchIndexBuffer)
+			glDeleteBuffers(1, &_batchIndexBuffer);
+		for (auto i = _instanceBatches.begin(); i != _instanceBatches.end(); ++i)
+			glDeleteBuffers(1, &i->buffer);
+		_vertexBuffer = _indexBuffer = _instanceBuffer = _batchIndexBuffer = 0;
+		_batchIndexCapacity = 0;
+		_instanceBatches.clear();
+		deleteVertexArrays();
+		for (auto i = _levelsOfDetail.begin(); i != _levelsOfDetail.end(); ++i)
+			(*i)->deleteGeometry();
+		_levelsOfDetail.clear();
 		_initialized = false;
 	}
 
@@ -147,6 +228,46 @@ protected:
 	*/
 	virtual void initializeVertexBuffer();
 
+	/**	@brief Initializes an index buffer for the geometry data, choosing the smallest sufficient index type
+	*/
+	virtual void initializeIndexBuffer();
+
+	/**	@brief Splits the triangles into chunks that each address at most 65536 vertices, so they can be drawn with 16 bit indices
+	*
+	*	Used if the geometry has more vertices than 16 bit indices can address and the context doesn't support 32 bit indices.
+	*	Each chunk gets a vertex buffer holding the vertices it uses, the indices of all chunks are stored in the index buffer.
+	*/
+	virtual void initializeIndexChunks();
+
+	/**	@brief Uploads the vertices of a chunk and adds it to the chunks of the geometry
+	*	@param[in] vertices The indices of the vertices the chunk uses, in the order its 16 bit indices refer to them
+	*	@param[in] firstIndex The position of the first index of the chunk in the index buffer
+	*	@param[in] nIndices The number of indices of the chunk
+	*/
+	void addIndexChunk(const std::vector< Index > &vertices, size_t firstIndex, size_t nIndices);
+
+	/**	@brief Deletes the vertex buffers of the chunks, except the first one which is the vertex buffer of the geometry
+	*/
+	void deleteIndexChunks();
+
+	/**	@brief Draws the indices of the geometry, chunk by chunk if it was split into chunks
+	*	@param[in] mode
+	*/
+	void drawElements(GLenum mode);
+
+	/**	@brief Binds the vertex array object for the shader or, if not available, the vertex and index buffer
+	*	@param[in] shader The shader used for drawing (may be nullptr)
+	*/
+	virtual void bindBuffers(ShaderPtr shader);
+
+	/**	@brief Unbinds whatever bindBuffers() bound (unless the render state is being tracked)
+	*/
+	virtual void unbindBuffers();
+
+	/**	@brief Deletes all vertex array objects of the geometry
+	*/
+	virtual void deleteVertexArrays();
+
 	/**	@brief Allocates the vertex data
 	*/
 	virtual VertexDataPtr   allocVertexData(size_t nVertices);
@@ -170,13 +291,72 @@ protected:
 	*/
 	virtual vmml::AABBf createBoundingBoxObjectSpace(const GeometryData::VboVertices &arg);
 
+	/**	@brief Draws all instances whose model view matrices are stored in the instance matrices with one instanced draw call
+	*	@param[in] instanceProperties Properties shared by all instances
+	*	@param[in] mode
+	*/
+	virtual void drawInstancesHardware(PropertiesPtr instanceProperties, GLenum mode);
+
+	/**	@brief Draws all instances whose model view matrices are stored in the instance matrices by transforming them into one vertex buffer
+	*
+	*	The vertices are transformed relative to the first instance and kept between frames,
+	*	only instances that moved relative to it are transformed and uploaded again.
+	*
+	*	@param[in] instanceProperties Properties shared by all instances
+	*	@param[in] mode
+	*/
+	virtual void drawInstancesBatched(PropertiesPtr instanceProperties, GLenum mode);
+
+	/**	@brief Transforms the vertices of the geometry by a matrix
+	*	@param[in] m
+	*	@param[out] vertices
+	*/
+	void transformVertices(const vmml::Matrix4f &m, GeometryData::VboVertices &vertices) const;
+
+	/**	@brief Returns true if two matrices are equal up to rounding errors
+	*	@param[in] a
+	*	@param[in] b
+	*/
+	static bool equalsApproximately(const vmml::Matrix4f &a, const vmml::Matrix4f &b);
+
+	/**	@brief Multiplies a direction with the upper 3x3 part of a matrix
+	*	@param[in] m
+	*	@param[in] d
+	*/
+	static Vector3 transformDirection(const vmml::Matrix4f &m, const Vector3 &d);
+
 private:
 
+	/* Structs */
+
+	/* Part of the indices addressing their own vertex buffer with 16 bit indices (see initializeIndexChunks) */
+	struct IndexChunk
+	{
+		GLuint	vertexBuffer = 0;
+		size_t	firstIndex = 0;
+		size_t	nIndices = 0;
+	};
+
+	/* Vertex buffer holding the transformed vertices of up to capacity instances */
+	struct InstanceBatch
+	{
+		GLuint							buffer = 0;
+		size_t							capacity = 0;
+		std::vector< vmml::Matrix4f >	matrices;	// the matrices the stored instances were transformed with
+	};
+
 	/* Variables */
 
 	bool _initialized = false;
     GLuint _indexBuffer = 0, _vertexBuffer = 0;
     size_t _nIndices = 0, _nVertices = 0;
+	GLenum _indexType = GL_UNSIGNED_SHORT;
+	std::vector< IndexChunk > _indexChunks;
+	const VertexLayout *_vertexLayout = nullptr;
+
+	/* Vertex array objects mapped to program IDs, invalidated when any program gets deleted since IDs may be reused */
+	std::unordered_map< GLuint, GLuint > _vertexArrays;
+	GLuint _vertexArraysProgramDeletions = 0;
     
 	VertexDataPtr   _vertexData = nullptr;
 	IndexDataPtr    _indexData = nullptr;
@@ -187,6 +367,19 @@ private:
 	vmml::AABBf _boundingBox;
 
 	PropertiesMap _instances;
+
+	std::vector< std::shared_ptr< Geometry > > _levelsOfDetail;
+
+	/* Buffers for drawing multiple instances, reused every frame */
+	GLuint _instanceBuffer = 0, _batchIndexBuffer = 0;
+	size_t _batchIndexCapacity = 0;
+	std::vector< vmml::Matrix4f >	_instanceMatrices;
+	std::vector< InstanceBatch >	_instanceBatches;
+	GeometryData::VboVertices		_batchVertices;
+	std::vector< GLubyte >			_batchPacked;
+
+	GLuint _id;
+	static GLuint _idCounter;
 };
 
 typedef std::shared_ptr<Geometry> GeometryPtr;
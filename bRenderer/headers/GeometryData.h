@@ -2,16 +2,18 @@
 #define B_GEOMETRY_DATA_H
 
 #include <vector>
+#include <memory>
 #include "Renderer_GL.h"
 #include "vmmlib/vector.hpp"
 #include "MaterialData.h"
 #include "Texture.h"
+#include "VertexLayout.h"
 
 struct IndexData
 {
-    GLushort vertexIndex;
-    GLushort texCoordsIndex;
-    GLushort normalIndex;
+    GLuint vertexIndex;
+    GLuint texCoordsIndex;
+    GLuint normalIndex;
     
     IndexData()
     : vertexIndex(0)
@@ -19,7 +21,7 @@ struct IndexData
     , normalIndex(0)
     {}
 
-	IndexData(GLushort vIndex, GLushort tIndex, GLushort nIndex)
+	IndexData(GLuint vIndex, GLuint tIndex, GLuint nIndex)
 		: vertexIndex(vIndex)
 		, texCoordsIndex(tIndex)
 		, normalIndex(nIndex)
@@ -117,7 +119,7 @@ struct Vertex
 	TexCoord    texCoord;
 };
 
-typedef GLushort Index;
+typedef GLuint Index;
 
 /** @brief The underlying data of a geometry object.
 *	@author David Steiner
@@ -125,7 +127,7 @@ typedef GLushort Index;
 struct GeometryData
 {
     typedef std::vector< Vertex >   VboVertices;
-    typedef std::vector< GLushort > VboIndices;
+    typedef std::vector< Index >    VboIndices;
     
     std::vector< IndexData > indices;
     
@@ -133,6 +135,12 @@ struct GeometryData
     VboIndices  vboIndices;
     
     MaterialData materialData;
+
+    // The vertex components that contain meaningful data, the geometry only uploads those the shader uses
+    VertexLayout::Components vertexComponents = VertexLayout::VC_ALL;
+
+    // Simplified versions of the geometry with decreasing detail (see MeshSimplifier)
+    std::vector< std::shared_ptr< GeometryData > > levelsOfDetail;
 };
 
 typedef std::shared_ptr< GeometryData > GeometryDataPtr;
@@ -1,6 +1,9 @@
 #ifndef B_I_DRAWABLE_H
 #define B_I_DRAWABLE_H
 
+#include <memory>
+#include <string>
+#include <vector>
 #include "Renderer_GL.h"
 
 /** @brief An interface for drawable objects.
@@ -24,6 +27,20 @@ public:
 	*	@param[in] mode
 	*/
 	virtual void drawInstance(const std::string &instanceName, GLenum mode) = 0;
+
+	/**	@brief Draws multiple instances of the object to the screen
+	*
+	*	Drawables that can draw their instances together override this function.
+	*
+	*	@param[in] instanceNames
+	*	@param[in] nInstances Number of instance names to be used
+	*	@param[in] mode
+	*/
+	virtual void drawInstances(const std::vector<std::string> &instanceNames, size_t nInstances, GLenum mode)
+	{
+		for (size_t i = 0; i < nInstances; i++)
+			drawInstance(instanceNames[i], mode);
+	}
     
 };
 
@@ -60,56 +60,60 @@ public:
 	/**	@brief Sets the position of the light
 	*	@param[in] position Position of the light
 	*/
-	void setPosition(const vmml::Vector3f &position)	{ _position = vmml::Vector4f(position, 1.0); }
+	void setPosition(const vmml::Vector3f &position)	{ _position = vmml::Vector4f(position, 1.0); _version++; }
 
 	/**	@brief Sets the color of the light for diffuse lighting
 	*	@param[in] color Color of the light for diffuse lighting
 	*/
-	void setDiffuseColor(const vmml::Vector3f &color)	{ _diffuseColor = color; }
+	void setDiffuseColor(const vmml::Vector3f &color)	{ _diffuseColor = color; _version++; }
 
 	/**	@brief Sets the color of the light for specular lighting
 	*	@param[in] color Color of the light for specular lighting
 	*/
-	void setSpecularColor(const vmml::Vector3f &color)	{ _specularColor = color; }
+	void setSpecularColor(const vmml::Vector3f &color)	{ _specularColor = color; _version++; }
 
 	/**	@brief Sets the intensity of the light
 	*	@param[in] intensity Intensity of the light
 	*/
-	void setIntensity(GLfloat intensity)		{ _intensity = intensity; }
+	void setIntensity(GLfloat intensity)		{ _intensity = intensity; _version++; }
 
 	/**	@brief Sets the attenuation of the light
 	*	@param[in] attenuation Attenuation of the light
 	*/
-	void setAttenuation(GLfloat attenuation)	{ _attenuation = attenuation; }
+	void setAttenuation(GLfloat attenuation)	{ _attenuation = attenuation; _version++; }
 
 	/**	@brief Sets the radius of the light
 	*	@param[in] radius Radius of the light
 	*/
-	void setRadius(GLfloat radius)		{ _radius = radius; }
+	void setRadius(GLfloat radius)		{ _radius = radius; _version++; }
 
 	/**	@brief Returns the position of the light
 	*/
-	const vmml::Vector4f &getPosition()		{ return _position; }
+	const vmml::Vector4f &getPosition() const		{ return _position; }
 
 	/**	@brief Returns the color of the light for diffuse lighting
 	*/
-	const vmml::Vector3f &getDiffuseColor()	{ return _diffuseColor; }
+	const vmml::Vector3f &getDiffuseColor() const	{ return _diffuseColor; }
 
 	/**	@brief Returns the color of the light for specular lighting
 	*/
-	const vmml::Vector3f &getSpecularColor()	{ return _specularColor; }
+	const vmml::Vector3f &getSpecularColor() const	{ return _specularColor; }
 
 	/**	@brief Returns the intensity of the light
 	*/
-	GLfloat getIntensity()		{ return _intensity; }
+	GLfloat getIntensity() const		{ return _intensity; }
 
 	/**	@brief Returns the attenuation of the light
 	*/
-	GLfloat getAttenuation()	{ return _attenuation; }
+	GLfloat getAttenuation() const	{ return _attenuation; }
 
 	/**	@brief Returns the radius of the light
 	*/
-	GLfloat getRadius()			{ return _radius; }
+	GLfloat getRadius() const			{ return _radius; }
+
+	/**	@brief Returns a number that changes every time a value of the light is set
+	*/
+	GLuint getVersion() const	{ return _version; }
 
 private:
 
@@ -121,6 +125,7 @@ private:
 	GLfloat _intensity;
 	GLfloat _attenuation;
 	GLfloat _radius;
+	GLuint _version = 0;
 
 };
 
@@ -0,0 +1,88 @@
+#ifndef B_LIGHT_PACK_H
+#define B_LIGHT_PACK_H
+
+#include <vector>
+#include <cstring>
+#include "vmmlib/matrix.hpp"
+#include "Renderer_GL.h"
+
+/** @brief The lighting data of a set of lights seen through one camera, packed into one array.
+*
+*	The positions are in view space, so a pack is built for one camera and then passed to every shader
+*	of a model or instance in one call (see Shader::setLights() and ModelRenderer::getLightPack()).
+*/
+class LightPack
+{
+public:
+	/* Structs */
+
+	/* The values of one light slot in the order of the shader uniforms */
+	struct Light
+	{
+		vmml::Vector4f	positionViewSpace;
+		vmml::Vector3f	diffuseColor;
+		vmml::Vector3f	specularColor;
+		GLfloat			intensity;
+		GLfloat			attenuation;
+		GLfloat			radius;
+	};
+
+	/* Functions */
+
+	/**	@brief Adds a light to the next slot
+	*	@param[in] viewMatrix
+	*	@param[in] position Position of the light in world space
+	*	@param[in] diffuseColor
+	*	@param[in] specularColor
+	*	@param[in] intensity
+	*	@param[in] attenuation
+	*	@param[in] radius
+	*/
+	void addLight(const vmml::Matrix4f &viewMatrix, const vmml::Vector4f &position, const vmml::Vector3f &diffuseColor, const vmml::Vector3f &specularColor, GLfloat intensity, GLfloat attenuation, GLfloat radius)
+	{
+		Light light;
+		light.positionViewSpace = viewMatrix*position;
+		light.diffuseColor = diffuseColor;
+		light.specularColor = specularColor;
+		light.intensity = intensity;
+		light.attenuation = attenuation;
+		light.radius = radius;
+		_lights.push_back(light);
+	}
+
+	/**	@brief Adds a light that is already transformed into view space to the next slot
+	*	@param[in] light
+	*/
+	void addLight(const Light &light) { _lights.push_back(light); }
+
+	/**	@brief Returns the number of lights
+	*/
+	GLuint getNumLights() const { return static_cast<GLuint>(_lights.size()); }
+
+	/**	@brief Returns the values of a light slot
+	*	@param[in] light
+	*/
+	const Light &getLight(GLuint light) const { return _lights[light]; }
+
+	/**	@brief Removes all lights
+	*/
+	void clear() { _lights.clear(); }
+
+	/**	@brief Returns true if both packs hold the same lights with the same values
+	*	@param[in] other
+	*/
+	bool operator==(const LightPack &other) const
+	{
+		return _lights.size() == other._lights.size() && (_lights.empty() || std::memcmp(_lights.data(), other._lights.data(), _lights.size() * sizeof(Light)) == 0);
+	}
+
+	bool operator!=(const LightPack &other) const { return !(*this == other); }
+
+private:
+
+	/* Variables */
+
+	std::vector< Light >	_lights;
+};
+
+#endif /* defined(B_LIGHT_PACK_H) */
@@ -24,7 +24,7 @@ public:
 
 	/**	@brief Constructor
 	*/
-	Material() {}
+	Material() : _id(++_idCounter) {}
 
 	/**	@brief Virtual destructor
 	*/
@@ -38,6 +38,9 @@ public:
 	virtual void initialize(ObjectManager *o, const MaterialData &materialData, ShaderPtr shader);
     
 	/**	@brief Bind the shader and pass the attributes of the material
+	*
+	*	While the render state is tracked, textures and uniforms are only passed if another material was bound in the meantime.
+	*	Properties should therefore not use the same uniform names as materials.
 	*/
 	virtual void bind();
     
@@ -118,6 +121,10 @@ public:
 	*	@param[in] arg Name for the material
 	*/
     void        setName(const std::string &arg) { _name = arg;  }
+
+	/**	@brief Returns a number that uniquely identifies the material
+	*/
+	GLuint		getID()						{ return _id; }
     
 private:
 	
@@ -130,6 +137,9 @@ private:
 	ShaderPtr   _shader = nullptr;
     
     std::string _name;
+
+	GLuint		_id;
+	static GLuint _idCounter;
 };
 
 typedef std::shared_ptr< Material > MaterialPtr;
@@ -0,0 +1,67 @@
+#ifndef B_MESH_OPTIMIZER_H
+#define B_MESH_OPTIMIZER_H
+
+#include "GeometryData.h"
+
+/** @brief Reorders the triangles and vertices of a geometry group so the GPU transforms and fetches fewer vertices.
+*
+*	Triangles are ordered for the post-transform vertex cache using Tipsify (Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw").
+*	The ordering falls into clusters that each start with a cold cache. These clusters can be sorted so that those facing away from the center of the mesh
+*	are drawn first, which reduces overdraw from any view direction. Finally the vertices are ordered by their first use.
+*
+*	The optimization runs on the data created by the OBJLoader, before it is cached or uploaded by the Geometry.
+*/
+class MeshOptimizer
+{
+public:
+	/* Structs */
+
+	/* Vertex cache efficiency of a group, measured by simulating a FIFO cache */
+	struct Statistics
+	{
+		size_t nTriangles = 0;
+		size_t nVertices = 0;
+		size_t nTransforms = 0;	// cache misses, i.e. vertices the GPU transforms
+
+		/**	@brief Average cache miss ratio, transformed vertices per triangle (between 0.5 and 3, lower is better)
+		*/
+		GLfloat getACMR() const { return nTriangles > 0 ? static_cast<GLfloat>(nTransforms) / nTriangles : 0.0f; }
+
+		/**	@brief Average transform to vertex ratio, transformed vertices per vertex (1 is optimal)
+		*/
+		GLfloat getATVR() const { return nVertices > 0 ? static_cast<GLfloat>(nTransforms) / nVertices : 0.0f; }
+	};
+
+	/* Functions */
+
+	/**	@brief Optimizes the triangle and vertex order of a group
+	*	@param[in,out] group
+	*	@param[in] sortForOverdraw Sort the clusters of triangles to reduce overdraw
+	*/
+	static void optimize(GeometryData &group, bool sortForOverdraw = true);
+
+	/**	@brief Reorders the triangles of a group for the post-transform vertex cache
+	*	@param[in,out] group
+	*	@param[in] sortForOverdraw Sort the clusters of triangles to reduce overdraw
+	*/
+	static void optimizeVertexCache(GeometryData &group, bool sortForOverdraw = true);
+
+	/**	@brief Reorders the vertices of a group in the order the triangles use them
+	*	@param[in,out] group
+	*/
+	static void optimizeVertexFetch(GeometryData &group);
+
+	/**	@brief Simulates a FIFO vertex cache to measure how well the triangle order of a group uses it
+	*	@param[in] group
+	*	@param[in] cacheSize The number of vertices the cache holds
+	*/
+	static Statistics analyze(const GeometryData &group, size_t cacheSize = CACHE_SIZE);
+
+	/* Variables */
+
+	// Conservative size of the post-transform cache, larger caches benefit from the order as well
+	static const size_t CACHE_SIZE = 16;
+
+};
+
+#endif /* defined(B_MESH_OPTIMIZER_H) */
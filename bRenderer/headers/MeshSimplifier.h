@@ -0,0 +1,38 @@
+#ifndef B_MESH_SIMPLIFIER_H
+#define B_MESH_SIMPLIFIER_H
+
+#include "GeometryData.h"
+
+/** @brief Creates simplified versions of geometry groups for levels of detail.
+*
+*	Edges are collapsed in the order of their quadric error (Garland and Heckbert, "Surface Simplification Using Quadric Error Metrics").
+*	A vertex is always collapsed onto one of its neighbors, so the remaining vertices keep their original attributes.
+*	Vertices on borders and on seams of the texture coordinates or normals are never removed, which keeps the outline and the texture mapping intact.
+*	Collapses that would flip a triangle are skipped.
+*/
+class MeshSimplifier
+{
+public:
+	/* Functions */
+
+	/**	@brief Returns the indices of a simplified version of a triangle list that uses the same vertices
+	*	@param[in] vertices
+	*	@param[in] indices
+	*	@param[in] targetIndexCount The number of indices to reduce the triangles to, may not be reached if too many vertices are locked
+	*/
+	static GeometryData::VboIndices simplify(const GeometryData::VboVertices &vertices, const GeometryData::VboIndices &indices, size_t targetIndexCount);
+
+	/**	@brief Creates the levels of detail of a group, each keeping a fraction of the triangles of the one before
+	*
+	*	The levels are stored in GeometryData::levelsOfDetail, each with only the vertices it uses.
+	*	Fewer levels are created if simplifying doesn't reduce the triangles anymore.
+	*
+	*	@param[in,out] group
+	*	@param[in] nLevels The maximum number of levels below the full detail
+	*	@param[in] reduction The fraction of triangles each level keeps
+	*/
+	static void createLevelsOfDetail(GeometryData &group, GLuint nLevels, GLfloat reduction);
+
+};
+
+#endif /* defined(B_MESH_SIMPLIFIER_H) */
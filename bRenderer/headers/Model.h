@@ -14,6 +14,9 @@ class ObjectManager;
 class ModelData;
 
 /** @brief A 3d model that can be rendered to the screen.
+*
+*	If the geometry has levels of detail, every instance keeps track of the level it was last drawn with (see selectLevelOfDetail()).
+*
 *	@author Rahul Mukhi, David Steiner
 */
 class Model : public IDrawable
@@ -105,6 +108,25 @@ public:
 	*/
 	virtual void			clearInstances();
     
+	/**	@brief Returns the highest number of levels of detail of any geometry in the model
+	*/
+	GLuint getNumLevelsOfDetail();
+
+	/**	@brief Selects the level of detail for an instance from the size of the model on the screen and returns it
+	*
+	*	Level i + 1 is used below a size of LOD_SCREEN_SIZE * sqrt(LOD_REDUCTION)^i, which keeps the density of triangles on the screen
+	*	roughly the same. To avoid popping, the level only changes once the size is LOD_HYSTERESIS (as a fraction) beyond that threshold.
+	*
+	*	@param[in] instanceName Name of the instance
+	*	@param[in] screenSize The size of the bounding box on the screen as a fraction of the viewport
+	*/
+	GLuint selectLevelOfDetail(const std::string &instanceName, GLfloat screenSize);
+
+	/**	@brief Returns the level of detail for a size of the model on the screen without keeping track of the last level (no hysteresis)
+	*	@param[in] screenSize The size of the bounding box on the screen as a fraction of the viewport
+	*/
+	GLuint selectLevelOfDetail(GLfloat screenSize);
+
 	/**	@brief Returns the material of the model
 	*/
     MaterialPtr getMaterial()   { return _material; }
@@ -163,6 +185,16 @@ public:
 	*/
 	virtual void			removeGeometry(const std::string &name)								{ _groups.erase(name); }
 
+	/**	@brief Frees the copies of the vertices and indices of all geometry kept in main memory
+	*/
+	void releaseCPUData()
+	{
+		for (auto i = _groups.begin(); i != _groups.end(); ++i)
+		{
+			i->second->releaseCPUData();
+		}
+	}
+
 	/**	@brief Deletes all geometry of the model
 	*/
 	virtual void deleteModelGeometry()
@@ -183,6 +215,7 @@ private:
 	PropertiesPtr	_properties = nullptr;
 	vmml::AABBf		_boundingBox;
 	InstancesMap	_instances;
+	std::unordered_map< std::string, GLuint >	_instanceLevels;
 };
 
 typedef std::shared_ptr<Model> ModelPtr;
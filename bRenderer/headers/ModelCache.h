@@ -0,0 +1,63 @@
+#ifndef B_MODEL_CACHE_H
+#define B_MODEL_CACHE_H
+
+#include <string>
+#include <vector>
+#include "ModelData.h"
+
+/** @brief Reads and writes the geometry groups of a model in a binary format, so the OBJ text doesn't have to be parsed again.
+*
+*	The file starts with a header (magic, format version, byte order, vertex size and the options the model was loaded with),
+*	followed by the source files the model was created from (OBJ and material libraries) with their size, modification time and hash (see SourceStamp),
+*	and a table of groups with their material data and the offsets of their vertex and index blobs, followed by those of their levels of detail.
+*	The blobs are stored exactly like GeometryData::vboVertices and GeometryData::vboIndices, aligned to 16 bytes,
+*	so reading a group only copies memory out of the mapped file.
+*
+*	A cache is only used if the format version, the optimization and level of detail settings and all source files match, otherwise the model is parsed and the cache rewritten.
+*/
+class ModelCache
+{
+public:
+	/* Functions */
+
+	/**	@brief Reads the groups of a model from a cache file, returns false if the cache doesn't exist or is outdated
+	*	@param[in] cachePath The full path to the cache file
+	*	@param[in] flipT Must match the option the cache was written with
+	*	@param[in] flipZ Must match the option the cache was written with
+	*	@param[out] groups
+	*/
+	static bool read(const std::string &cachePath, bool flipT, bool flipZ, ModelData::GroupMap &groups);
+
+	/**	@brief Writes the groups of a model to a cache file, returns false if the file couldn't be written
+	*	@param[in] cachePath The full path to the cache file
+	*	@param[in] sourceFiles The names of the files the model was created from (see bRenderer::getFilePath)
+	*	@param[in] flipT
+	*	@param[in] flipZ
+	*	@param[in] groups
+	*/
+	static bool write(const std::string &cachePath, const std::vector< std::string > &sourceFiles, bool flipT, bool flipZ, const ModelData::GroupMap &groups);
+
+	/**	@brief Returns true if the cache file exists and matches the format version, the options and the source files
+	*	@param[in] cachePath The full path to the cache file
+	*	@param[in] flipT
+	*	@param[in] flipZ
+	*/
+	static bool isUpToDate(const std::string &cachePath, bool flipT, bool flipZ);
+
+	/**	@brief Returns the path of the cooked cache file next to a model (see AssetCooker)
+	*	@param[in] fileName The name of the OBJ file
+	*/
+	static std::string getCachePath(const std::string &fileName);
+
+	/**	@brief Returns the path of the cache file written for a model at runtime, inside MODEL_CACHE_DIRECTORY
+	*	@param[in] fileName The name of the OBJ file
+	*/
+	static std::string getRuntimeCachePath(const std::string &fileName);
+
+	/* Variables */
+
+	static const GLuint VERSION = 6;
+
+};
+
+#endif /* defined(B_MODEL_CACHE_H) */
@@ -38,9 +38,18 @@ public:
 	virtual ~ModelData();
     
 	/**	@brief Loads the model from a file
+	*
+	*	An up-to-date binary cache next to the file is used instead of parsing it (see ModelCache).
+	*	If enabled in the configuration, the cache is written after parsing.
+	*
 	*	@param[in] fileName The name of the OBJ file
 	*/
     virtual ModelData &load(const std::string &fileName);
+
+	/**	@brief Parses the model and writes its binary cache next to it regardless of the configuration, returns false if that failed
+	*	@param[in] fileName The name of the OBJ file
+	*/
+	bool cook(const std::string &fileName);
     
 	/**	@brief Returns the geometry groups
 	*/
@@ -55,10 +64,34 @@ public:
 	bool getFlipZ() { return _flipZ; }
     
 private:
+
+	/* Functions */
+
+	/**	@brief Parses the OBJ file, returns false if it couldn't be read or contained errors
+	*	@param[in] fileName The name of the OBJ file
+	*/
+	bool parse(const std::string &fileName);
+
+	/**	@brief Writes the binary cache of the parsed model
+	*	@param[in] fileName The name of the OBJ file
+	*	@param[in] cachePath The full path to the cache file (see ModelCache::getCachePath() and ModelCache::getRuntimeCachePath())
+	*/
+	bool writeCache(const std::string &fileName, const std::string &cachePath);
+
+	/**	@brief Reorders the triangles and vertices of all groups for the vertex cache and logs the improvement (see MeshOptimizer)
+	*	@param[in] fileName The name of the OBJ file
+	*/
+	void optimize(const std::string &fileName);
+
+	/**	@brief Creates the levels of detail of all groups and logs their triangle counts (see MeshSimplifier)
+	*	@param[in] fileName The name of the OBJ file
+	*/
+	void createLevelsOfDetail(const std::string &fileName);
 	
 	/* Variables */
 	
 	OBJLoader		*_objLoader = nullptr;
+	GroupMap		_groups;
     bool            _flipT = false;
     bool            _flipZ = false;
 };
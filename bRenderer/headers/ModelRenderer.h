@@ -5,6 +5,8 @@
 #include "Logger.h"
 #include "ObjectManager.h"
 #include "RenderQueue.h"
+#include "BoundingVolumeHierarchy.h"
+#include "OcclusionCuller.h"
 
 /* vmmlib includes */
 #include "vmmlib/util.hpp"
@@ -12,6 +14,19 @@
 
 
 /** @brief A helper class to efficiently draw and queue models with one function call.
+*
+*	Models with levels of detail are drawn with the level that fits their size on the screen (see Model::selectLevelOfDetail()).
+*	Queued instances keep their level until their size changes clearly, drawn models use the level of their current size without hysteresis.
+*
+*	Model instances can also be added to a scene, which keeps their bounding boxes in a bounding volume hierarchy.
+*	Queueing the scene then only visits the instances inside the view frustum instead of testing every instance on its own.
+*
+*	If an occlusion culler is set, queued instances seen through the camera its occluders were last rendered with
+*	are only submitted to the render queue if they aren't hidden behind the occluders.
+*
+*	The lights are transformed into view space once per camera and gathered into one pack per model (see getLightPack()),
+*	which is passed to its shaders in one call.
+*
 *	@author Benjamin Buergisser
 */
 class ModelRenderer
@@ -67,6 +82,17 @@ public:
 	*/
 	virtual void drawModel(ModelPtr model, const vmml::Matrix4f &modelMatrix, const vmml::Matrix4f &viewMatrix, const vmml::Matrix4f &projectionMatrix, const std::vector<std::string> &lightNames, bool doFrustumCulling = true, bool cullIndividualGeometry = false);
 
+	/**	@brief Draw specified model into the current framebuffer
+	*	@param[in] model The model to be drawn
+	*	@param[in] modelMatrix
+	*	@param[in] viewMatrix
+	*	@param[in] projectionMatrix
+	*	@param[in] lights Handles of the lights (see ObjectManager::getLightHandles())
+	*	@param[in] doFrustumCulling Set true if the model should be tested against the view frustum (optional)
+	*	@param[in] cullIndividualGeometry Set true if all the geometry should be tested against the view frustum (optional)
+	*/
+	virtual void drawModel(ModelPtr model, const vmml::Matrix4f &modelMatrix, const vmml::Matrix4f &viewMatrix, const vmml::Matrix4f &projectionMatrix, const std::vector< LightHandle > &lights, bool doFrustumCulling = true, bool cullIndividualGeometry = false);
+
 	/**	@brief Queue specified model into the render queue
 	*	@param[in] modelName Name of the model
 	*	@param[in] instanceName The name of the model instance to be queued (instance is created automatically if not present)
@@ -98,6 +124,74 @@ public:
 	*/
 	virtual void queueModelInstance(ModelPtr model, const std::string &instanceName, const vmml::Matrix4f &modelMatrix, const vmml::Matrix4f &viewMatrix, const vmml::Matrix4f &projectionMatrix, const std::vector<std::string> &lightNames, bool doFrustumCulling = true, bool cullIndividualGeometry = false, bool isTransparent = false, GLenum blendSfactor = GL_SRC_ALPHA, GLenum blendDfactor = GL_ONE_MINUS_SRC_ALPHA, GLfloat customDistance = 10000.0f);
 
+	/**	@brief Queue specified model into the render queue
+	*	@param[in] model The model to be drawn
+	*	@param[in] instanceName The name of the model instance to be queued (instance is created automatically if not present)
+	*	@param[in] modelMatrix
+	*	@param[in] viewMatrix
+	*	@param[in] projectionMatrix
+	*	@param[in] lights Handles of the lights (see ObjectManager::getLightHandles())
+	*	@param[in] doFrustumCulling Set true if the model should be tested against the view frustum (optional)
+	*	@param[in] cullIndividualGeometry Set true if all the geometry should be tested against the view frustum (optional)
+	*	@param[in] isTransparent Set true if the model is (partially) transparent and sorting according to distance should occur (optional)
+	*	@param[in] blendSfactor Specifies how the red, green, blue, and alpha source blending factors are computed (optional)
+	*	@param[in] blendDfactor Specifies how the red, green, blue, and alpha destination blending factors are computed (optional)
+	*	@param[in] customDistance If the function should not determine the distance to the camera a custom distance can be set (optional)
+	*/
+	virtual void queueModelInstance(ModelPtr model, const std::string &instanceName, const vmml::Matrix4f &modelMatrix, const vmml::Matrix4f &viewMatrix, const vmml::Matrix4f &projectionMatrix, const std::vector< LightHandle > &lights, bool doFrustumCulling = true, bool cullIndividualGeometry = false, bool isTransparent = false, GLenum blendSfactor = GL_SRC_ALPHA, GLenum blendDfactor = GL_ONE_MINUS_SRC_ALPHA, GLfloat customDistance = 10000.0f);
+
+	/**	@brief Adds a model instance to the scene and returns its ID
+	*	@param[in] modelName Name of the model
+	*	@param[in] instanceName The name of the model instance (instance is created automatically if not present)
+	*	@param[in] modelMatrix
+	*	@param[in] lightNames Names of the lights in a vector, the lights must already exist
+	*	@param[in] isTransparent Set true if the model is (partially) transparent and sorting according to distance should occur (optional)
+	*/
+	virtual GLuint addSceneInstance(const std::string &modelName, const std::string &instanceName, const vmml::Matrix4f &modelMatrix, const std::vector<std::string> &lightNames, bool isTransparent = false);
+
+	/**	@brief Moves a model instance in the scene
+	*	@param[in] sceneInstanceID The ID returned by addSceneInstance()
+	*	@param[in] modelMatrix
+	*/
+	virtual void moveSceneInstance(GLuint sceneInstanceID, const vmml::Matrix4f &modelMatrix);
+
+	/**	@brief Removes a model instance from the scene
+	*	@param[in] sceneInstanceID The ID returned by addSceneInstance()
+	*/
+	virtual void removeSceneInstance(GLuint sceneInstanceID);
+
+	/**	@brief Removes all model instances from the scene
+	*/
+	virtual void clearScene();
+
+	/**	@brief Queues all model instances of the scene that are inside the view frustum of a camera into the render queue
+	*	@param[in] cameraName Name of the camera
+	*/
+	virtual void queueScene(const std::string &cameraName);
+
+	/**	@brief Queues all model instances of the scene that are inside the view frustum into the render queue
+	*	@param[in] viewMatrix
+	*	@param[in] projectionMatrix
+	*/
+	virtual void queueScene(const vmml::Matrix4f &viewMatrix, const vmml::Matrix4f &projectionMatrix);
+
+	/**	@brief Returns the bounding volume hierarchy of the scene
+	*/
+	BoundingVolumeHierarchy &getSceneHierarchy() { return _sceneHierarchy; }
+
+	/**	@brief Sets the occlusion culler that queued model instances are tested against, nullptr disables occlusion culling
+	*
+	*	Render the occluders with OcclusionCuller::render() every frame before queueing the instances.
+	*	Instances queued with another view or projection matrix (e.g. sprites in front of the camera) are not tested.
+	*
+	*	@param[in] occlusionCuller
+	*/
+	void setOcclusionCuller(OcclusionCullerPtr occlusionCuller) { _occlusionCuller = occlusionCuller; }
+
+	/**	@brief Returns the occlusion culler that queued model instances are tested against
+	*/
+	OcclusionCullerPtr getOcclusionCuller() { return _occlusionCuller; }
+
 	/**	@brief Draw specified text sprite into the current framebuffer
 	*	@param[in] textSpriteName Name of the text sprite
 	*	@param[in] cameraName Name of the camera
@@ -125,22 +219,102 @@ public:
 	*/
 	void drawQueue(GLenum mode = GL_TRIANGLES);
 
-	/**	@brief Clears the render queue
+	/**	@brief Clears the render queue and the level of detail statistics
 	*/
 	void clearQueue();
 
+	/**	@brief Returns the number of triangles drawn or queued at each level of detail since the statistics were last reset
+	*/
+	const std::vector< size_t > &getTrianglesPerLevelOfDetail() const { return _trianglesPerLevel; }
+
+	/**	@brief Resets the number of triangles drawn or queued at each level of detail
+	*/
+	void resetLevelOfDetailStatistics() { _trianglesPerLevel.clear(); }
+
+	/**	@brief Returns the lights seen through a camera packed for the shaders
+	*
+	*	All registered lights are transformed into view space once per view matrix and kept in an array indexed by their slot,
+	*	so the pack of each model only gathers its lights from that array by handle.
+	*	The array is refilled if the view matrix changes or lights are added or removed, a single light is transformed again if one of its values changed.
+	*	Lights whose handle is no longer valid are left out. The returned pack is overwritten by the next call.
+	*
+	*	@param[in] viewMatrix
+	*	@param[in] lights Handles of the lights
+	*/
+	const LightPack &getLightPack(const vmml::Matrix4f &viewMatrix, const std::vector< LightHandle > &lights);
+
 	/**	@brief Tests an axis-aligned bounding box against the view frustum
 	*	@param[in] aabbObjectSpace The axis-aligned bounding box in object space
 	*	@param[in] modelViewProjectionMatrix The model view projection matrix (projection * view * model)
 	*/
 	vmml::Visibility viewFrustumCulling(const vmml::AABBf &aabbObjectSpace, const vmml::Matrix4f &modelViewProjectionMatrix);
 
+	/**	@brief Returns the size of an axis-aligned bounding box on the screen as a fraction of the viewport (larger dimension)
+	*
+	*	Boxes that reach behind the camera are considered to fill the screen.
+	*
+	*	@param[in] aabbObjectSpace The axis-aligned bounding box in object space
+	*	@param[in] modelViewProjectionMatrix The model view projection matrix (projection * view * model)
+	*/
+	static GLfloat getScreenSize(const vmml::AABBf &aabbObjectSpace, const vmml::Matrix4f &modelViewProjectionMatrix);
+
 private:
 
+	/* Structs */
+
+	struct SceneInstance
+	{
+		ModelPtr					model;
+		std::string					instanceName;
+		vmml::Matrix4f				modelMatrix;
+		std::vector< LightHandle >	lights;
+		bool						isTransparent;
+	};
+
+	/* All registered lights in view space indexed by their slot in the light registry */
+	struct ViewSpaceLights
+	{
+		bool							valid = false;
+		vmml::Matrix4f					viewMatrix;
+		GLuint							registryVersion = 0;
+		std::vector< LightPack::Light >	lights;
+		std::vector< const Light* >		objects;		// nullptr for free slots, the registry keeps them alive
+		std::vector< GLuint >			generations;
+		std::vector< GLuint >			versions;
+		LightPack						pack;			// the lights gathered for the last model
+	};
+
+	/* Functions */
+
+	/**	@brief Adds the triangles of a drawn or queued geometry to the statistics of its level of detail
+	*	@param[in] geometry
+	*	@param[in] level
+	*/
+	void countTriangles(GeometryPtr geometry, GLuint level);
+
+	/**	@brief Transforms all registered lights into view space if the view matrix changed or lights were added or removed
+	*	@param[in] viewMatrix
+	*/
+	void updateViewSpaceLights(const vmml::Matrix4f &viewMatrix);
+
+	/**	@brief Transforms a light into view space and stores it in its slot
+	*	@param[in] slot
+	*	@param[in] light
+	*/
+	void transformLight(GLuint slot, const Light &light);
+
 	/* Variables */
 
 	ObjectManagerPtr	_objectManager = nullptr;
 	RenderQueuePtr		_renderQueue = nullptr;
+	std::vector< size_t >	_trianglesPerLevel;
+	OcclusionCullerPtr		_occlusionCuller = nullptr;
+	ViewSpaceLights			_viewSpaceLights;
+
+	/* Scene instances indexed by their ID in the bounding volume hierarchy */
+	std::vector< SceneInstance >	_sceneInstances;
+	BoundingVolumeHierarchy			_sceneHierarchy;
+	std::vector< GLuint >			_visibleSceneInstances;
 };
 
 typedef std::shared_ptr< ModelRenderer >  ModelRendererPtr;
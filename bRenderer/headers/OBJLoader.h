@@ -20,23 +20,25 @@ public:
 	typedef std::unordered_map< std::string, MaterialData >   MaterialMap;
 
 	/* Structs */
+	struct Statistics
+	{
+		size_t nCorners = 0;	// face corners, i.e. indices
+		size_t nVertices = 0;	// vertices after removing duplicates
+		size_t nPolygons = 0;	// faces with more than three vertices that were triangulated
+		size_t nConcavePolygons = 0;	// polygons that needed ear clipping
+	};
+
 	struct FaceData
 	{
 		Index       v1;
 		Index       v2;
 		Index       v3;
-		vmml::Vector3f normal;
-		vmml::Vector3f tangent;
-		vmml::Vector3f bitangent;
 	};
 
 	struct VertexData
 	{
-		std::vector<Index>  faces;
 		vmml::Vector3f         position;
 		vmml::Vector3f         normal;
-		vmml::Vector3f         tangent;
-		vmml::Vector3f         bitangent;
 
 		GLfloat x()   { return position.x(); }
 		GLfloat y()   { return position.y(); }
@@ -44,6 +46,7 @@ public:
 
 		VertexData(const vmml::Vector3f &position)
 			: position(position)
+			, normal(vmml::Vector3f::ZERO)
 		{}
 	};
 
@@ -74,26 +77,102 @@ public:
 	*/
 	bool load(std::istream& istream);
 
+	/**	@brief Loads the model data from the contents of an OBJ file in memory, the text is parsed in place
+	*	@param[in] begin Pointer to the first character
+	*	@param[in] end Pointer past the last character
+	*/
+	bool load(const char *begin, const char *end);
+
 	/**	@brief Loads an obj material
 	*	@param[in] fileName File name including extension
 	*	@param[in] materialName Name of the material
 	*/
 	static MaterialData loadMaterial(const std::string &fileName, const std::string &materialName);
 
-	/**	@brief Creates the normal vectors of the face
+	/**	@brief Creates the normal vectors of the vertices that have none from the faces around them
+	*
+	*	The normal of each face is added to the normals of its three vertices in a flat array, so no per vertex lists of faces are needed.
+	*	Large meshes are split into ranges of faces that are accumulated in separate arrays on multiple threads.
 	*/
-	void createFaceNormals();
+	void createVertexNormals();
 
-	/**	@brief Creates the normal vectors of the vertex
+	/**	@brief Creates the tangents and bitangents of a group from its texture coordinates
+	*
+	*	The tangent and bitangent of each triangle follow the directions in which the texture coordinates s and t increase.
+	*	They are accumulated per vertex weighted by the angle of the triangle at that vertex,
+	*	then the tangent is made orthogonal to the normal (Gram-Schmidt) and the bitangent is the cross product of both,
+	*	keeping the handedness of the texture mapping. The normals of the group must already be set.
+	*
+	*	@param[in,out] group
 	*/
-	void createVertexNormals();
+	static void createTangents(GeometryData &group);
 
 	/**	@brief Returns the geometry groups
 	*/
 	ModelData::GroupMap getData() { return _groups; }
 
+	/**	@brief Returns the names of the material libraries the model uses
+	*/
+	const std::vector< std::string > &getMaterialLibraries() const { return _materialLibraries; }
+
+	/**	@brief Returns how many vertices were generated for how many face corners
+	*/
+	const Statistics &getStatistics() const { return _statistics; }
+
 private:
 
+	/* Structs */
+
+	/* Identifies a vertex by the indices of its position, texture coordinates and normal (see _canonicalTexCoords) */
+	struct VertexKey
+	{
+		Index v, t, n;
+
+		bool operator==(const VertexKey &other) const { return v == other.v && t == other.t && n == other.n; }
+	};
+
+	struct VertexKeyHash
+	{
+		size_t operator()(const VertexKey &key) const
+		{
+			size_t h = std::hash< Index >()(key.v);
+			h ^= std::hash< Index >()(key.t) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			h ^= std::hash< Index >()(key.n) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			return h;
+		}
+	};
+
+	/* Compares texture coordinates or normals component by component, so 0 and -0 are equal */
+	template< typename T >
+	struct AttributeEqual
+	{
+		bool operator()(const T &a, const T &b) const
+		{
+			for (size_t i = 0; i < T::DIMENSION; ++i)
+				if (a.array[i] != b.array[i])
+					return false;
+			return true;
+		}
+	};
+
+	template< typename T >
+	struct AttributeHash
+	{
+		size_t operator()(const T &value) const
+		{
+			size_t h = 0;
+			// adding 0 turns -0 into 0
+			for (size_t i = 0; i < T::DIMENSION; ++i)
+				h ^= std::hash< GLfloat >()(value.array[i] + 0.0f) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			return h;
+		}
+	};
+
+	/* Typedefs */
+	typedef std::unordered_map< VertexKey, Index, VertexKeyHash >	VertexIndexMap;
+	typedef std::unordered_map< vmml::Vector2f, Index, AttributeHash< vmml::Vector2f >, AttributeEqual< vmml::Vector2f > >	TexCoordIndexMap;
+	typedef std::unordered_map< vmml::Vector3f, Index, AttributeHash< vmml::Vector3f >, AttributeEqual< vmml::Vector3f > >	NormalIndexMap;
+
 	/* Functions */
 
 	void createGroup(const std::string& name)
@@ -105,6 +184,7 @@ private:
 			group = GeometryDataPtr(new GeometryData);
 		}
 		_group = group;
+		_vertexIndices = &_groupVertexIndices[_groupName];
 	}
 
 	void info_callback(const std::string& filename, std::size_t line_number, const std::string& message);
@@ -142,6 +222,24 @@ private:
 	template< bool NORMAL >
 	void genFace(const IndexData &d1, const IndexData &d2, const IndexData &d3);
 
+	template< bool TEX_COORD, bool NORMAL >
+	void genTriangle(const IndexData &d1, const IndexData &d2, const IndexData &d3);
+
+	/**	@brief Triangulates the polygon collected by the polygonal face callbacks
+	*
+	*	Convex polygons are split into a triangle fan, concave polygons are triangulated by ear clipping.
+	*/
+	template< bool TEX_COORD, bool NORMAL >
+	void genPolygon();
+
+	/**	@brief Returns true if the corner cur of the polygon (projected to 2D) is convex for the given orientation
+	*/
+	static bool isConvexCorner(const vmml::Vector2f &prev, const vmml::Vector2f &cur, const vmml::Vector2f &next, GLfloat orientation);
+
+	/**	@brief Returns true if p lies inside or on the border of the triangle a, b, c
+	*/
+	static bool isInTriangle(const vmml::Vector2f &p, const vmml::Vector2f &a, const vmml::Vector2f &b, const vmml::Vector2f &c);
+
 	/**	@brief Loads an OBJ material
 	*	@param[in] fileName File name including extension
 	*	@param[out] materials The materials map the new material data is stored in
@@ -151,19 +249,38 @@ private:
 
 	/* Variables */
 
+	// Below this many faces per thread the normals are accumulated on a single thread
+	static const size_t MIN_FACES_PER_THREAD = 1 << 16;
+
 	obj::obj_parser::flags_type _flags;
 	ModelData                   *_data = nullptr;
 	MaterialMap                  _materials;
+	std::vector< std::string >   _materialLibraries;
 	std::string                 _groupName;
 	ModelData::GroupMap         _groups;
 	GeometryDataPtr             _group = nullptr;
 
+	// Vertices already generated for each group, used to share identical vertices
+	std::unordered_map< std::string, VertexIndexMap >	_groupVertexIndices;
+	VertexIndexMap              *_vertexIndices = nullptr;
+	Statistics                  _statistics;
+
+	// Corners of the polygon currently being parsed, reused for every polygon
+	std::vector<IndexData>      _polygon;
+	std::vector<vmml::Vector2f> _polygonPoints;
+	std::vector<size_t>         _polygonCorners;
+
 	std::vector<FaceData>       _faces;
 	std::vector<VertexData>     _vertices;
 	std::vector<vmml::Vector2f>    _texCoords;
 	std::vector<vmml::Vector3f>    _normals;
-	std::vector<vmml::Vector3f>    _tangents;
-	std::vector<vmml::Vector3f>    _bitangents;
+
+	// Exporters often write the same texture coordinates or normal many times,
+	// vertices are identified by the index of the first occurrence of each value so these duplicates are shared
+	TexCoordIndexMap            _texCoordIndices;
+	NormalIndexMap              _normalIndices;
+	std::vector<Index>          _canonicalTexCoords;
+	std::vector<Index>          _canonicalNormals;
 };
 
 
@@ -22,6 +22,7 @@
 #include "TextureData.h"
 #include "IShaderData.h"
 #include "ShaderDataGenerator.h"
+#include "ResourceRegistry.h"
 
 /* vmmlib includes */
 #include "vmmlib/util.hpp"
@@ -40,25 +41,38 @@ enum Options {
 	IS_TEXT = 0x100
 };
 
+/* Handles to objects of the object manager */
+typedef ResourceRegistry< Shader >::Handle		ShaderHandle;
+typedef ResourceRegistry< Texture >::Handle		TextureHandle;
+typedef ResourceRegistry< Material >::Handle	MaterialHandle;
+typedef ResourceRegistry< Model >::Handle		ModelHandle;
+typedef ResourceRegistry< Camera >::Handle		CameraHandle;
+typedef ResourceRegistry< Light >::Handle		LightHandle;
+
 /** @brief This class manages all objects in a project and makes sure no object is created twice.
+*
+*	Shaders, textures, materials, models, cameras and lights can also be referred to by handles.
+*	Get the handle of an object once by its name and use it every frame, resolving a handle doesn't hash the name.
+*	Handles of removed objects resolve to nullptr.
+*
 *	@author Benjamin Buergisser
 */
 class ObjectManager
 {
 public:
 	/* Typedefs */
-	typedef std::unordered_map< std::string, ShaderPtr >		ShaderMap;
-	typedef std::unordered_map< std::string, TexturePtr >		TextureMap;
+	typedef ResourceRegistry< Shader >		ShaderRegistry;
+	typedef ResourceRegistry< Texture >		TextureRegistry;
 	typedef std::unordered_map< std::string, CubeMapPtr >		CubeMapMap;
 	typedef std::unordered_map< std::string, DepthMapPtr >		DepthMapMap;
 	typedef std::unordered_map< std::string, FontPtr >			FontMap;
-	typedef std::unordered_map< std::string, MaterialPtr >		MaterialMap;
+	typedef ResourceRegistry< Material >	MaterialRegistry;
 	typedef std::unordered_map< std::string, PropertiesPtr >	PropertiesMap;
-	typedef std::unordered_map< std::string, ModelPtr >			ModelMap;
+	typedef ResourceRegistry< Model >		ModelRegistry;
 	typedef std::unordered_map< std::string, TextSpritePtr >	TextSpriteMap;
-	typedef std::unordered_map< std::string, CameraPtr >		CameraMap;
+	typedef ResourceRegistry< Camera >		CameraRegistry;
 	typedef std::unordered_map< std::string, MatrixStackPtr >	MatrixStackMap;
-	typedef std::unordered_map< std::string, LightPtr >			LightMap;
+	typedef ResourceRegistry< Light >		LightRegistry;
 	typedef std::unordered_map< std::string, FramebufferPtr >	FramebufferMap;
 	typedef std::unordered_map< std::string, DrawablePtr >		DrawableMap;
 	typedef unsigned char OPTIONS;
@@ -631,11 +645,31 @@ public:
 	*/
 	ShaderPtr getShader(const std::string &name);
 
+	/**	@brief Get a shader by its handle (returns nullptr if it was removed)
+	*	@param[in] handle Handle of the shader
+	*/
+	ShaderPtr getShader(ShaderHandle handle);
+
+	/**	@brief Get the handle of a shader (the handle is invalid if there is no shader with that name)
+	*	@param[in] name Name of the shader
+	*/
+	ShaderHandle getShaderHandle(const std::string &name);
+
 	/**	@brief Get a texture
 	*	@param[in] name Name of the texture
 	*/
 	TexturePtr getTexture(const std::string &name);
 
+	/**	@brief Get a texture by its handle (returns nullptr if it was removed)
+	*	@param[in] handle Handle of the texture
+	*/
+	TexturePtr getTexture(TextureHandle handle);
+
+	/**	@brief Get the handle of a texture (the handle is invalid if there is no texture with that name)
+	*	@param[in] name Name of the texture
+	*/
+	TextureHandle getTextureHandle(const std::string &name);
+
 	/**	@brief Get a cube map
 	*	@param[in] name Name of the cube map
 	*/
@@ -656,6 +690,16 @@ public:
 	*/
 	MaterialPtr getMaterial(const std::string &name);
 
+	/**	@brief Get a material by its handle (returns nullptr if it was removed)
+	*	@param[in] handle Handle of the material
+	*/
+	MaterialPtr getMaterial(MaterialHandle handle);
+
+	/**	@brief Get the handle of a material (the handle is invalid if there is no material with that name)
+	*	@param[in] name Name of the material
+	*/
+	MaterialHandle getMaterialHandle(const std::string &name);
+
 	/**	@brief Get properties
 	*	@param[in] name Name of the properties
 	*/
@@ -666,6 +710,16 @@ public:
 	*/
 	ModelPtr getModel(const std::string &name);
 
+	/**	@brief Get a 3D model by its handle (returns nullptr if it was removed)
+	*	@param[in] handle Handle of the model
+	*/
+	ModelPtr getModel(ModelHandle handle);
+
+	/**	@brief Get the handle of a 3D model (the handle is invalid if there is no model with that name)
+	*	@param[in] name Name of the model
+	*/
+	ModelHandle getModelHandle(const std::string &name);
+
 	/**	@brief Get a text sprite
 	*	@param[in] name Name of the text sprite
 	*/
@@ -676,6 +730,16 @@ public:
 	*/
 	CameraPtr getCamera(const std::string &name);
 
+	/**	@brief Get a camera by its handle (returns nullptr if it was removed)
+	*	@param[in] handle Handle of the camera
+	*/
+	CameraPtr getCamera(CameraHandle handle);
+
+	/**	@brief Get the handle of a camera (the handle is invalid if there is no camera with that name)
+	*	@param[in] name Name of the camera
+	*/
+	CameraHandle getCameraHandle(const std::string &name);
+
 	/**	@brief Get a matrix stack
 	*	@param[in] name Name of the matrix stack
 	*/
@@ -686,6 +750,25 @@ public:
 	*/
 	LightPtr getLight(const std::string &name);
 
+	/**	@brief Get a light by its handle (returns nullptr if it was removed)
+	*	@param[in] handle Handle of the light
+	*/
+	LightPtr getLight(LightHandle handle);
+
+	/**	@brief Get the handle of a light (the handle is invalid if there is no light with that name)
+	*	@param[in] name Name of the light
+	*/
+	LightHandle getLightHandle(const std::string &name);
+
+	/**	@brief Get the handles of lights, so they are looked up by name only once (see ModelRenderer)
+	*	@param[in] names Names of the lights
+	*/
+	std::vector< LightHandle > getLightHandles(const std::vector< std::string > &names);
+
+	/**	@brief Get the registry of all lights, e.g. to iterate over them by slot
+	*/
+	const LightRegistry &getLightRegistry() const;
+
 	/**	@brief Get a framebuffer
 	*	@param[in] name Name of the framebuffer
 	*/
@@ -802,18 +885,18 @@ private:
 
 	/* Variables */
 
-	ShaderMap		_shaders;
-	TextureMap		_textures;
+	ShaderRegistry		_shaders;
+	TextureRegistry		_textures;
 	CubeMapMap		_cubeMaps;
 	DepthMapMap		_depthMaps;
 	FontMap			_fonts;
-	MaterialMap		_materials;
+	MaterialRegistry	_materials;
 	PropertiesMap	_properties;
-	ModelMap	    _models;
+	ModelRegistry		_models;
 	TextSpriteMap	_textSprites;
-	CameraMap		_cameras;
+	CameraRegistry		_cameras;
 	MatrixStackMap	_matrixStacks;
-	LightMap		_lights;
+	LightRegistry		_lights;
 	FramebufferMap	_framebuffers;
 	DrawableMap		_drawables;
 
@@ -0,0 +1,225 @@
+#ifndef B_OCCLUSION_CULLER_H
+#define B_OCCLUSION_CULLER_H
+
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Renderer_GL.h"
+#include "ModelData.h"
+#include "vmmlib/aabb.hpp"
+#include "vmmlib/matrix.hpp"
+
+/** @brief Culls instances hidden behind occluders by testing their bounding boxes against a small depth buffer rendered on the CPU.
+*
+*	Occluders are meshes with few triangles, ideally proxies that lie inside the geometry they stand for.
+*	Once per frame render() draws them into a depth buffer of a few hundred pixels: the screen is split into horizontal bands
+*	that are rasterized on worker threads, four pixels at a time with SSE on x86 and NEON on ARM and with scalar code elsewhere.
+*	A pyramid holding the farthest depth of every 2x2 block is then built from the buffer.
+*
+*	isVisible() projects a bounding box onto the screen and compares its nearest depth with the farthest occluder depth
+*	of the pyramid level where the rectangle covers at most 2x2 texels. Like on the GPU, a pixel is covered by an occluder
+*	if its center is, so the test is only as exact as the resolution of the buffer.
+*	Boxes crossing the near plane or lying outside of the screen are considered visible, frustum culling is done elsewhere.
+*/
+class OcclusionCuller
+{
+public:
+	/* Functions */
+
+	/**	@brief Constructor
+	*	@param[in] width Width of the depth buffer, rounded up to a multiple of 4
+	*	@param[in] height Height of the depth buffer
+	*	@param[in] nThreads The number of threads to rasterize on including the calling thread, 0 uses all cores
+	*/
+	OcclusionCuller(GLuint width = DEFAULT_WIDTH, GLuint height = DEFAULT_HEIGHT, GLuint nThreads = 0);
+
+	/**	@brief Destructor, stops the worker threads
+	*/
+	~OcclusionCuller();
+
+	/**	@brief Adds an occluder and returns its ID
+	*	@param[in] positions The vertex positions in object space
+	*	@param[in] indices Three indices per triangle
+	*	@param[in] modelMatrix
+	*/
+	GLuint addOccluder(const std::vector< vmml::Vector3f > &positions, const std::vector< Index > &indices, const vmml::Matrix4f &modelMatrix);
+
+	/**	@brief Adds all groups of a model as one occluder and returns its ID
+	*	@param[in] modelData
+	*	@param[in] modelMatrix
+	*/
+	GLuint addOccluder(const ModelData &modelData, const vmml::Matrix4f &modelMatrix);
+
+	/**	@brief Changes the model matrix of an occluder
+	*	@param[in] occluderID
+	*	@param[in] modelMatrix
+	*/
+	void moveOccluder(GLuint occluderID, const vmml::Matrix4f &modelMatrix);
+
+	/**	@brief Removes an occluder, its ID may be reused for occluders added later
+	*	@param[in] occluderID
+	*/
+	void removeOccluder(GLuint occluderID);
+
+	/**	@brief Removes all occluders
+	*/
+	void clearOccluders();
+
+	/**	@brief Renders the occluders into the depth buffer, builds the depth pyramid and resets the statistics
+	*
+	*	Call this once per frame before testing the instances seen through the same camera.
+	*
+	*	@param[in] viewMatrix
+	*	@param[in] projectionMatrix
+	*/
+	void render(const vmml::Matrix4f &viewMatrix, const vmml::Matrix4f &projectionMatrix);
+
+	/**	@brief Returns false if a bounding box is completely hidden behind the occluders and counts the result
+	*	@param[in] aabbObjectSpace
+	*	@param[in] modelViewProjectionMatrix Has to use the view and projection matrix the occluders were rendered with
+	*/
+	bool isVisible(const vmml::AABBf &aabbObjectSpace, const vmml::Matrix4f &modelViewProjectionMatrix);
+
+	/**	@brief Returns the view projection matrix (projection * view) the occluders were last rendered with
+	*/
+	const vmml::Matrix4f &getViewProjectionMatrix() const { return _viewProjectionMatrix; }
+
+	/**	@brief Returns the number of bounding boxes tested since the last call to render()
+	*/
+	size_t getNumTested() const { return _nTested; }
+
+	/**	@brief Returns the number of bounding boxes found to be hidden since the last call to render()
+	*/
+	size_t getNumCulled() const { return _nCulled; }
+
+	/**	@brief Returns the number of occluder triangles rasterized during the last call to render()
+	*/
+	size_t getNumTrianglesRendered() const { return _triangles.size(); }
+
+	/**	@brief Returns the number of threads the occluders are rasterized on
+	*/
+	GLuint getNumThreads() const { return _nBands; }
+
+	/**	@brief Returns the width of a level of the depth pyramid, level 0 is the depth buffer
+	*	@param[in] level
+	*/
+	GLuint getWidth(GLuint level = 0) const { return _levels[level].width; }
+
+	/**	@brief Returns the height of a level of the depth pyramid, level 0 is the depth buffer
+	*	@param[in] level
+	*/
+	GLuint getHeight(GLuint level = 0) const { return _levels[level].height; }
+
+	/**	@brief Returns the number of levels of the depth pyramid
+	*/
+	GLuint getNumLevels() const { return static_cast<GLuint>(_levels.size()); }
+
+	/**	@brief Returns the depth of a texel between 0 (near plane) and 1 (far plane or nothing rendered), the farthest of the block it covers above level 0
+	*	@param[in] level
+	*	@param[in] x
+	*	@param[in] y
+	*/
+	GLfloat getDepth(GLuint level, GLuint x, GLuint y) const { return _levels[level].depth[y * _levels[level].width + x]; }
+
+	/* Variables */
+
+	static const GLuint DEFAULT_WIDTH = 256;
+	static const GLuint DEFAULT_HEIGHT = 128;
+
+private:
+
+	/* Structs */
+
+	struct Occluder
+	{
+		std::vector< vmml::Vector3f >	positions;
+		std::vector< Index >			indices;
+		vmml::Matrix4f					modelMatrix;
+		bool							alive = false;
+	};
+
+	/* A triangle in screen space, set up for rasterizing */
+	struct Triangle
+	{
+		// edge functions a * x + b * y + c, positive inside
+		GLfloat	a[3], b[3], c[3];
+		// depth plane dzdx * x + dzdy * y + z
+		GLfloat	dzdx, dzdy, z;
+		// pixels whose centers may be covered
+		GLint	minX, maxX, minY, maxY;
+	};
+
+	struct Level
+	{
+		GLuint					width, height;
+		std::vector< GLfloat >	depth;
+	};
+
+	/* Functions */
+
+	/**	@brief Clips a triangle in clip space against the near plane and adds the remaining parts
+	*	@param[in] v Vertices in clip space
+	*/
+	void addTriangle(const vmml::Vector4f *v);
+
+	/**	@brief Sets up a triangle in clip space completely in front of the near plane
+	*	@param[in] v0
+	*	@param[in] v1
+	*	@param[in] v2
+	*/
+	void setupTriangle(const vmml::Vector4f &v0, const vmml::Vector4f &v1, const vmml::Vector4f &v2);
+
+	/**	@brief Clears the rows of a band and rasterizes all triangles overlapping it
+	*	@param[in] band
+	*/
+	void rasterizeBand(GLuint band);
+
+	/**	@brief Rasterizes the pixels first to last of a row, four at a time with SIMD where first has to be a multiple of 4
+	*
+	*	The SIMD versions do the same operations in the same order as the scalar version, so they give the same depth.
+	*
+	*	@param[in] t
+	*	@param[in,out] row
+	*	@param[in] first
+	*	@param[in] last
+	*	@param[in] py Vertical position of the pixel centers
+	*/
+	static void rasterizeRow(const Triangle &t, GLfloat *row, GLint first, GLint last, GLfloat py);
+
+	/**	@brief Builds the levels of the depth pyramid above level 0
+	*/
+	void buildPyramid();
+
+	/**	@brief Rasterizes a band every time render() is called until the culler is destroyed
+	*	@param[in] band
+	*/
+	void work(GLuint band);
+
+	/* Variables */
+
+	std::vector< Occluder >	_occluders;
+	std::vector< GLuint >	_freeIDs;
+
+	std::vector< Level >			_levels;
+	std::vector< Triangle >			_triangles;
+	std::vector< vmml::Vector4f >	_clipSpace;
+	vmml::Matrix4f					_viewProjectionMatrix = vmml::Matrix4f::ZERO;
+
+	size_t	_nTested = 0;
+	size_t	_nCulled = 0;
+
+	// The calling thread rasterizes band 0 and every worker one of the others
+	GLuint						_nBands = 1;
+	std::vector< std::thread >	_workers;
+	std::mutex					_mutex;
+	std::condition_variable		_start, _done;
+	size_t						_frame = 0;
+	GLuint						_pending = 0;
+	bool						_stop = false;
+};
+
+typedef std::shared_ptr< OcclusionCuller >  OcclusionCullerPtr;
+
+#endif /* defined(B_OCCLUSION_CULLER_H) */
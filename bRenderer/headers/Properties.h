@@ -3,6 +3,9 @@
 
 #include <memory>
 #include <map>
+#include <vector>
+#include <cstring>
+#include <algorithm>
 #include "vmmlib/matrix.hpp"
 
 #include "Shader.h"
@@ -18,7 +21,6 @@ class Properties
 {
 public:
 	/* Typedefs */
-	// Since properties are likely to change every frame (transformation matrices) maps are used over unordered maps
 	typedef std::map<std::string, vmml::Matrix4f>		Matrix4x4Map;
 	typedef std::map<std::string, vmml::Matrix3f>		Matrix3x3Map;
 	typedef std::map<std::string, vmml::Vector4f>		Vector4Map;
@@ -33,103 +35,155 @@ public:
 
 	/**	@brief Returns all 4x4 matrices
 	*/
-	const Matrix4x4Map	&getMatrices4x4()												{ return _matrices4x4; }
+	const Matrix4x4Map	&getMatrices4x4() const											{ updateMaps(); return _matrices4x4; }
 
 	/**	@brief Returns a 4x4 matrix
 	*	@param[in] name Name of the matrix
 	*/
-	vmml::Matrix4f			getMatrix4x4(const std::string &name)							{ return _matrices4x4[name]; }
+	vmml::Matrix4f			getMatrix4x4(const std::string &name) const					{ return getValue<vmml::Matrix4f>(Shader::getUniformHandle(name), PT_MATRIX4x4); }
+
+	/**	@brief Returns a 4x4 matrix
+	*	@param[in] handle Uniform handle of the matrix
+	*/
+	vmml::Matrix4f			getMatrix4x4(Shader::UniformHandle handle) const				{ return getValue<vmml::Matrix4f>(handle, PT_MATRIX4x4); }
 
 	/**	@brief Returns all 3x3 matrices
 	*/
-	const Matrix3x3Map	&getMatrices3x3()												{ return _matrices3x3; }
+	const Matrix3x3Map	&getMatrices3x3() const											{ updateMaps(); return _matrices3x3; }
 
 	/**	@brief Returns a 3x3 matrix
 	*	@param[in] name Name of the matrix
 	*/
-	vmml::Matrix3f			getMatrix3x3(const std::string &name)							{ return _matrices3x3[name]; }
+	vmml::Matrix3f			getMatrix3x3(const std::string &name) const					{ return getValue<vmml::Matrix3f>(Shader::getUniformHandle(name), PT_MATRIX3x3); }
 
 	/**	@brief Returns all 4x1 vectors
 	*/
-	const Vector4Map	&getVectors4()													{ return _vectors4; }
+	const Vector4Map	&getVectors4() const											{ updateMaps(); return _vectors4; }
 
 	/**	@brief Returns a 4x1 vector
 	*	@param[in] name Name of the vector
 	*/
-	vmml::Vector4f			getVector4(const std::string &name)								{ return _vectors4[name]; }
+	vmml::Vector4f			getVector4(const std::string &name) const						{ return getValue<vmml::Vector4f>(Shader::getUniformHandle(name), PT_VECTOR4); }
 
 	/**	@brief Returns all 3x1 vectors 
 	*/
-	const Vector3Map	&getVectors3()													{ return _vectors3; }
+	const Vector3Map	&getVectors3() const											{ updateMaps(); return _vectors3; }
 
 	/**	@brief Returns a 3x1 vector
 	*	@param[in] name Name of the vector
 	*/
-	vmml::Vector3f			getVector3(const std::string &name)								{ return _vectors3[name]; }
+	vmml::Vector3f			getVector3(const std::string &name) const						{ return getValue<vmml::Vector3f>(Shader::getUniformHandle(name), PT_VECTOR3); }
 
 	/**	@brief Returns all scalars
 	*/
-	const ScalarMap		&getScalars()													{ return _scalars; }
+	const ScalarMap		&getScalars() const												{ updateMaps(); return _scalars; }
 
 	/**	@brief Returns a scalar 
 	*	@param[in] name Name of the scalar
 	*/
-	GLfloat				getScalar(const std::string &name)								{ return _scalars[name]; }
+	GLfloat				getScalar(const std::string &name) const						{ return getValue<GLfloat>(Shader::getUniformHandle(name), PT_SCALAR); }
 
 	/**	@brief Sets all 4x4 matrices
 	*	@param[in] arg 4x4 matrices
 	*/
-	void				setMatrices4x4(const Matrix4x4Map& arg)							{ _matrices4x4 = arg; }
+	void				setMatrices4x4(const Matrix4x4Map& arg)							{ setMap(arg, PT_MATRIX4x4); }
 
 	/**	@brief Sets a 4x4 matrix
 	*	@param[in] name Name of the matrix
 	*	@param[in] arg 4x4 matrix
 	*/
-	void				setMatrix(const std::string &name, const vmml::Matrix4f &arg)		{ _matrices4x4[name] = arg; }
+	void				setMatrix(const std::string &name, const vmml::Matrix4f &arg)		{ setMatrix(Shader::getUniformHandle(name), arg); }
+
+	/**	@brief Sets a 4x4 matrix
+	*	@param[in] handle Uniform handle of the matrix
+	*	@param[in] arg 4x4 matrix
+	*/
+	void				setMatrix(Shader::UniformHandle handle, const vmml::Matrix4f &arg)	{ setValue(handle, PT_MATRIX4x4, arg.begin()); }
 
 	/**	@brief Sets all 3x3 matrices
 	*	@param[in] arg 3x3 matrices
 	*/
-	void				setMatrices3x3(const Matrix3x3Map& arg)							{ _matrices3x3 = arg; }
+	void				setMatrices3x3(const Matrix3x3Map& arg)							{ setMap(arg, PT_MATRIX3x3); }
 
 	/**	@brief Sets a 3x3 matrix
 	*	@param[in] name Name of the matrix
 	*	@param[in] arg 3x3 matrix
 	*/
-	void				setMatrix(const std::string &name, const vmml::Matrix3f &arg)		{ _matrices3x3[name] = arg; }
+	void				setMatrix(const std::string &name, const vmml::Matrix3f &arg)		{ setMatrix(Shader::getUniformHandle(name), arg); }
+
+	/**	@brief Sets a 3x3 matrix
+	*	@param[in] handle Uniform handle of the matrix
+	*	@param[in] arg 3x3 matrix
+	*/
+	void				setMatrix(Shader::UniformHandle handle, const vmml::Matrix3f &arg)	{ setValue(handle, PT_MATRIX3x3, arg.begin()); }
 
 	/**	@brief Sets all 4x1 vectors
 	*	@param[in] arg 4x1 Vectors
 	*/
-	void				setVectors4(const Vector4Map& arg)								{ _vectors4 = arg; }
+	void				setVectors4(const Vector4Map& arg)								{ setMap(arg, PT_VECTOR4); }
 
 	/**	@brief Sets a 4x1 vector
 	*	@param[in] name Name of the vector
 	*	@param[in] arg 4x1 vector
 	*/
-	void				setVector(const std::string &name, const vmml::Vector4f &arg)		{ _vectors4[name] = arg; }
+	void				setVector(const std::string &name, const vmml::Vector4f &arg)		{ setVector(Shader::getUniformHandle(name), arg); }
+
+	/**	@brief Sets a 4x1 vector
+	*	@param[in] handle Uniform handle of the vector
+	*	@param[in] arg 4x1 vector
+	*/
+	void				setVector(Shader::UniformHandle handle, const vmml::Vector4f &arg)	{ setValue(handle, PT_VECTOR4, arg.begin()); }
 
 	/**	@brief Sets all 3x1 vectors
 	*	@param[in] arg 3x1 vectors
 	*/
-	void				setVectors3(const Vector3Map& arg)								{ _vectors3 = arg; }
+	void				setVectors3(const Vector3Map& arg)								{ setMap(arg, PT_VECTOR3); }
 
 	/**	@brief Sets a 3x1 vector
 	*	@param[in] name Name of the vector
 	*	@param[in] arg 3x1 vector
 	*/
-	void				setVector(const std::string &name, const vmml::Vector3f &arg)		{ _vectors3[name] = arg; }
+	void				setVector(const std::string &name, const vmml::Vector3f &arg)		{ setVector(Shader::getUniformHandle(name), arg); }
+
+	/**	@brief Sets a 3x1 vector
+	*	@param[in] handle Uniform handle of the vector
+	*	@param[in] arg 3x1 vector
+	*/
+	void				setVector(Shader::UniformHandle handle, const vmml::Vector3f &arg)	{ setValue(handle, PT_VECTOR3, arg.begin()); }
 
 	/**	@brief Sets all scalars
 	*	@param[in] arg Scalar
 	*/
-	void				setScalars(const ScalarMap &arg)									{ _scalars = arg; }
+	void				setScalars(const ScalarMap &arg)									{ setMap(arg, PT_SCALAR); }
 
 	/**	@brief Sets a scalar
 	*	@param[in] name Name of the scalar
 	*	@param[in] arg Scalar
 	*/
-	void				setScalar(const std::string &name, GLfloat arg)					{ _scalars[name] = arg; }
+	void				setScalar(const std::string &name, GLfloat arg)					{ setScalar(Shader::getUniformHandle(name), arg); }
+
+	/**	@brief Sets a scalar
+	*	@param[in] handle Uniform handle of the scalar
+	*	@param[in] arg Scalar
+	*/
+	void				setScalar(Shader::UniformHandle handle, GLfloat arg)				{ setValue(handle, PT_SCALAR, &arg); }
+
+	/**	@brief Sets the lights, they are passed to the shader as one block
+	*	@param[in] lights Lights in view space
+	*/
+	void				setLights(const LightPack &lights)
+	{
+		if (!_hasLights || _lights != lights)
+		{
+			_lights = lights;
+			_hasLights = true;
+			_lightsDirty = true;
+		}
+	}
+
+	/**	@brief Returns the lights or an empty light pack if none were set
+	*/
+	const LightPack		&getLights() const												{ return _lights; }
 
 	/**	@brief Returns the name of the properties
 	*/
@@ -141,37 +195,217 @@ public:
 	void        setName(const std::string &arg) { _name = arg; }
 
 	/**	@brief Pass properties to specified shader
+	*
+	*	If the shader's uniforms haven't been changed since the properties were last passed to it,
+	*	only the properties that were modified in the meantime are uploaded.
+	*
 	*	@param[in] shader The shader the properties are passed to
 	*/
 	void				passToShader(ShaderPtr shader)				
 	{ 
-		shader->setUniforms(_matrices4x4);
-		shader->setUniforms(_matrices3x3);
-		shader->setUniforms(_vectors4);
-		shader->setUniforms(_vectors3);
-		shader->setUniforms(_scalars);
+		bool passAll = shader.get() != _lastShader || shader->getUniformVersion() != _lastUniformVersion;
+		for (auto i = _properties.begin(); i != _properties.end(); ++i)
+		{
+			if (!passAll && !i->dirty)
+				continue;
+			const GLfloat *value = &_data[i->offset];
+			switch (i->type)
+			{
+			case PT_MATRIX4x4:	shader->setUniform(i->handle, value, GL_FLOAT_MAT4); break;
+			case PT_MATRIX3x3:	shader->setUniform(i->handle, value, GL_FLOAT_MAT3); break;
+			case PT_VECTOR4:	shader->setUniform(i->handle, value, GL_FLOAT_VEC4); break;
+			case PT_VECTOR3:	shader->setUniform(i->handle, value, GL_FLOAT_VEC3); break;
+			case PT_SCALAR:		shader->setUniform(i->handle, value, GL_FLOAT); break;
+			}
+			i->dirty = false;
+		}
+		if (_hasLights && (passAll || _lightsDirty))
+			shader->setLights(_lights);
+		_lightsDirty = false;
+		_lastShader = shader.get();
+		_lastUniformVersion = shader->getUniformVersion();
+	}
+
+	/**	@brief Returns true if both properties contain the same values, apart from the value of one uniform
+	*
+	*	Used to find out whether instances can be drawn together.
+	*
+	*	@param[in] other The properties to compare to
+	*	@param[in] ignoredHandle Uniform handle of the value that may differ
+	*/
+	bool				equalsExcept(const Properties &other, Shader::UniformHandle ignoredHandle) const
+	{
+		if (_properties.size() != other._properties.size() || _hasLights != other._hasLights || _lights != other._lights)
+			return false;
+		for (size_t i = 0; i < _properties.size(); ++i)
+		{
+			const Property &a = _properties[i];
+			const Property &b = other._properties[i];
+			if (a.handle != b.handle || a.type != b.type)
+				return false;
+			if (a.handle != ignoredHandle && std::memcmp(&_data[a.offset], &other._data[b.offset], getSize(a.type) * sizeof(GLfloat)) != 0)
+				return false;
+		}
+		return true;
 	}
 
 	/**	@brief Clear all properties
 	*/
 	void				clear()
 	{
-		_matrices4x4.clear();
-		_matrices3x3.clear();
-		_vectors4.clear();
-		_vectors3.clear();
-		_scalars.clear();
+		_properties.clear();
+		_data.clear();
+		_lights.clear();
+		_hasLights = false;
+		_lastShader = nullptr;
+		_mapsValid = false;
 	}
 
 
 private:
 
+	/* Enums */
+	enum PropertyType
+	{
+		PT_MATRIX4x4, PT_MATRIX3x3, PT_VECTOR4, PT_VECTOR3, PT_SCALAR
+	};
+
+	/* Structs */
+	struct Property
+	{
+		Shader::UniformHandle	handle;
+		PropertyType			type;
+		GLuint					offset;		// index of the first value in the data buffer
+		bool					dirty;
+	};
+
+	/* Functions */
+
+	static GLuint getSize(PropertyType type)
+	{
+		static const GLuint sizes[] = { 16, 9, 4, 3, 1 };
+		return sizes[type];
+	}
+
+	// returns the index of the property or -1 if it doesn't exist
+	GLint findProperty(Shader::UniformHandle handle, PropertyType type) const
+	{
+		for (size_t i = 0; i < _properties.size(); ++i)
+		{
+			if (_properties[i].handle == handle && _properties[i].type == type)
+				return static_cast<GLint>(i);
+		}
+		return -1;
+	}
+
+	void setValue(Shader::UniformHandle handle, PropertyType type, const GLfloat *value)
+	{
+		GLuint size = getSize(type);
+		GLint index = findProperty(handle, type);
+		if (index < 0)
+		{
+			Property property = { handle, type, static_cast<GLuint>(_data.size()), true };
+			_properties.push_back(property);
+			_data.insert(_data.end(), value, value + size);
+			_mapsValid = false;
+			return;
+		}
+		Property &p = _properties[index];
+		GLfloat *data = &_data[p.offset];
+		if (std::memcmp(data, value, size * sizeof(GLfloat)) != 0)
+		{
+			std::memcpy(data, value, size * sizeof(GLfloat));
+			p.dirty = true;
+			_mapsValid = false;
+		}
+	}
+
+	template< typename T >
+	T getValue(Shader::UniformHandle handle, PropertyType type) const
+	{
+		GLint index = findProperty(handle, type);
+		if (index < 0)
+			return T();
+		T value;
+		readValue(&_data[_properties[index].offset], value);
+		return value;
+	}
+
+	// copies stored values into a matrix, vector or scalar
+	template< typename T >
+	static void readValue(const GLfloat *data, T &value)			{ std::copy(data, data + sizeof(value.array) / sizeof(GLfloat), value.array); }
+	static void readValue(const GLfloat *data, GLfloat &value)	{ value = *data; }
+
+	// returns the values of a matrix, vector or scalar to store
+	template< typename T >
+	static const GLfloat *getArray(const T &value)				{ return value.array; }
+	static const GLfloat *getArray(const GLfloat &value)		{ return &value; }
+
+	template< typename T >
+	void fillMap(std::map<std::string, T> &map, PropertyType type) const
+	{
+		map.clear();
+		for (auto i = _properties.begin(); i != _properties.end(); ++i)
+		{
+			if (i->type == type)
+				readValue(&_data[i->offset], map[Shader::getUniformName(i->handle)]);
+		}
+	}
+
+	// rebuilds the maps returned by the map getters if a property changed since they were last built
+	void updateMaps() const
+	{
+		if (_mapsValid)
+			return;
+		fillMap(_matrices4x4, PT_MATRIX4x4);
+		fillMap(_matrices3x3, PT_MATRIX3x3);
+		fillMap(_vectors4, PT_VECTOR4);
+		fillMap(_vectors3, PT_VECTOR3);
+		fillMap(_scalars, PT_SCALAR);
+		_mapsValid = true;
+	}
+
+	template< typename T >
+	void setMap(const std::map<std::string, T> &map, PropertyType type)
+	{
+		// replace all properties of the type
+		std::vector<Property> properties;
+		std::vector<GLfloat> data;
+		for (auto i = _properties.begin(); i != _properties.end(); ++i)
+		{
+			if (i->type == type)
+				continue;
+			Property property = { i->handle, i->type, static_cast<GLuint>(data.size()), true };
+			properties.push_back(property);
+			data.insert(data.end(), _data.begin() + i->offset, _data.begin() + i->offset + getSize(i->type));
+		}
+		_properties.swap(properties);
+		_data.swap(data);
+		_mapsValid = false;
+		for (auto i = map.begin(); i != map.end(); ++i)
+		{
+			setValue(Shader::getUniformHandle(i->first), type, getArray(i->second));
+		}
+	}
+
 	/* Variables */
-	Matrix4x4Map	_matrices4x4;
-	Matrix3x3Map	_matrices3x3;
-	Vector4Map		_vectors4;
-	Vector3Map		_vectors3;
-	ScalarMap		_scalars;
+	std::vector<Property>	_properties;
+	std::vector<GLfloat>	_data;				// values of all properties packed together
+
+	LightPack				_lights;
+	bool					_hasLights = false;
+	bool					_lightsDirty = false;
+
+	Shader					*_lastShader = nullptr;
+	GLuint					_lastUniformVersion = 0;
+
+	// maps returned by the map getters, only built when requested
+	mutable Matrix4x4Map	_matrices4x4;
+	mutable Matrix3x3Map	_matrices3x3;
+	mutable Vector4Map		_vectors4;
+	mutable Vector3Map		_vectors3;
+	mutable ScalarMap		_scalars;
+	mutable bool			_mapsValid = false;
 
 	std::string _name;
 };
@@ -2,13 +2,16 @@
 #define B_RENDERQUEUE_H
 
 #include <memory>
-#include <map>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
 
 #include "Renderer_GL.h"
 #include "Shader.h"
 #include "Material.h"
 #include "Properties.h"
 #include "IDrawable.h"
+#include "RenderState.h"
 
 struct RenderCall
 {
@@ -17,18 +20,31 @@ struct RenderCall
 	GLenum blendSfactor, blendDfactor;
 };
 
-/** @brief A render queue stores render calls and performs drawing in sorted order. 
+/** @brief A render queue stores render calls and performs drawing in sorted order.
 *
 *	Transparent objects are drawn in a back-to-front order whereas opaque objects are arranged in a manner that avoids state changes as much as possible.
 *
+*	Every render call is assigned a 64 bit key (from most to least significant bits):
+*	layer (4), transparency (1) and then for opaque calls program (10), material (12), geometry (13), depth (24)
+*	or for transparent calls inverted depth (24), program (10), material (12), geometry (13).
+*	IDs that don't fit into their field wrap around, which only affects how well state changes are avoided.
+*	The calls are stored in arrays that are reused every frame and sorted with a radix sort.
+*
 *	@author Benjamin Buergisser
 */
 class RenderQueue : public IDrawable
 {
 public:
+	/* Structs */
+	struct SortEntry
+	{
+		uint64_t	key;
+		GLuint		index;		// index of the render call
+	};
+
 	/* Typedefs */
-	typedef std::multimap< std::string, RenderCall> RenderCallsOpaque;
-	typedef std::multimap< GLfloat, RenderCall> RenderCallsTransparent;
+	typedef std::vector< RenderCall >	RenderCalls;
+	typedef std::vector< SortEntry >	SortEntries;
 
 	/* Functions */
 
@@ -41,6 +57,9 @@ public:
 	virtual ~RenderQueue(){}
 
 	/**	@brief Add a render call to the queue
+	*
+	*	The names are mapped to IDs internally, prefer the function taking IDs directly.
+	*
 	*	@param[in] programID
 	*	@param[in] materialName
 	*	@param[in] drawableName
@@ -53,6 +72,20 @@ public:
 	*/
 	virtual void submitToRenderQueue(GLuint programID, const std::string &materialName, const std::string &drawableName, const std::string &instanceName, DrawablePtr drawable, GLfloat distanceToCamera = 0.0, bool isTransparent = false, GLenum blendSfactor = GL_SRC_ALPHA, GLenum blendDfactor = GL_ONE_MINUS_SRC_ALPHA);
 
+	/**	@brief Add a render call to the queue
+	*	@param[in] programID
+	*	@param[in] materialID
+	*	@param[in] drawableID
+	*	@param[in] instanceName
+	*	@param[in] drawable
+	*	@param[in] distanceToCamera The distance of the drawable to the camera (optional)
+	*	@param[in] isTransparent Set true if the object is transparent (optional)
+	*	@param[in] blendSfactor Specifies how the red, green, blue, and alpha source blending factors are computed (optional)
+	*	@param[in] blendDfactor Specifies how the red, green, blue, and alpha destination blending factors are computed (optional)
+	*	@param[in] layer Calls in lower layers are drawn first, has to be smaller than 16 (optional)
+	*/
+	virtual void submitToRenderQueue(GLuint programID, GLuint materialID, GLuint drawableID, const std::string &instanceName, DrawablePtr drawable, GLfloat distanceToCamera = 0.0, bool isTransparent = false, GLenum blendSfactor = GL_SRC_ALPHA, GLenum blendDfactor = GL_ONE_MINUS_SRC_ALPHA, GLuint layer = 0);
+
 	/**	@brief Draw all drawable in the queue in a sorted manner
 	*/
 	virtual void draw(GLenum mode = GL_TRIANGLES) override;
@@ -67,13 +100,56 @@ public:
 	*/
 	virtual void clear();
 
+	/**	@brief Set true if opaque instances of the same drawable should be drawn together (enabled by default)
+	*	@param[in] instancing
+	*/
+	void setInstancing(bool instancing) { _instancing = instancing; }
+
+	/**	@brief Returns true if opaque instances of the same drawable are drawn together
+	*/
+	bool getInstancing() const { return _instancing; }
+
+	/**	@brief Returns the number of render calls in the queue
+	*/
+	size_t getNumRenderCalls() const { return _nRenderCalls; }
+
+	/**	@brief Returns the number of state changes and avoided state changes of the last time the queue was drawn
+	*/
+	const RenderState::Statistics &getStatistics() const { return _statistics; }
+
+protected:
+
+	/* Functions */
+
+	/**	@brief Sorts the keys of all render calls
+	*/
+	virtual void sort();
+
+	/**	@brief Returns a 24 bit number that preserves the order of the distance
+	*	@param[in] distance
+	*/
+	static GLuint quantizeDepth(GLfloat distance);
+
+	/**	@brief Returns an ID for a name
+	*	@param[in] name
+	*/
+	GLuint getNameID(const std::string &name);
 
 private:
 
 	/* Variables */
-	
-	RenderCallsOpaque			_renderCallsOpaque;
-	RenderCallsTransparent		_renderCallsTransparent;
+
+	RenderCalls			_renderCalls;		// entries are reused to avoid allocations every frame
+	size_t				_nRenderCalls = 0;
+	SortEntries			_sortEntries;
+	SortEntries			_sortBuffer;
+	bool				_sorted = true;
+	bool				_instancing = true;
+	std::vector< std::string >	_instanceNames;
+
+	RenderState::Statistics	_statistics;
+
+	std::unordered_map< std::string, GLuint >	_nameIDs;
 
 };
 
@@ -0,0 +1,151 @@
+#ifndef B_RENDER_STATE_H
+#define B_RENDER_STATE_H
+
+#include "Renderer_GL.h"
+
+class VertexLayout;
+
+/** @brief Keeps track of the OpenGL state set by the renderer to avoid redundant state changes.
+*
+*	The current program and vertex array object are always tracked. Vertex buffers, materials, textures and the blend function are
+*	only tracked between begin() and end(), where the renderer is the only one modifying them (e.g. while a render queue is drawn).
+*	Outside of that everything is bound as requested.
+*/
+class RenderState
+{
+public:
+
+	/* Structs */
+
+	struct Statistics
+	{
+		GLuint programBinds = 0,		programBindsAvoided = 0;
+		GLuint materialBinds = 0,		materialBindsAvoided = 0;
+		GLuint vertexBufferBinds = 0,	vertexBufferBindsAvoided = 0;
+		GLuint indexBufferBinds = 0,	indexBufferBindsAvoided = 0;
+		GLuint vertexArrayBinds = 0,	vertexArrayBindsAvoided = 0;
+		GLuint attribSetups = 0,		attribSetupsAvoided = 0;
+		GLuint textureBinds = 0,		textureBindsAvoided = 0;
+		GLuint blendChanges = 0,		blendChangesAvoided = 0;
+	};
+
+	/* Functions */
+
+	/**	@brief Starts tracking the state, everything apart from the current program and vertex array is assumed to be unknown
+	*
+	*	The statistics are reset as well.
+	*/
+	static void begin();
+
+	/**	@brief Stops tracking the state, unbinds the vertex array, vertex and index buffer and resets the blend function if it was changed
+	*/
+	static void end();
+
+	/**	@brief Returns true if the state is being tracked
+	*/
+	static bool isTracking() { return _tracking; }
+
+	/**	@brief Makes a program current if it isn't already, returns true if the program changed
+	*	@param[in] programID
+	*/
+	static bool bindProgram(GLuint programID);
+
+	/**	@brief Has to be called when a program is deleted
+	*	@param[in] programID
+	*/
+	static void deleteProgram(GLuint programID);
+
+	/**	@brief Binds a vertex buffer if it isn't already bound, returns true if the buffer changed
+	*	@param[in] buffer
+	*	@param[in] layout The layout of the vertices in the buffer, nullptr if the attributes registered in the shader should be used (optional)
+	*/
+	static bool bindVertexBuffer(GLuint buffer, const VertexLayout *layout = nullptr);
+
+	/**	@brief Returns the layout of the vertex buffer bound last
+	*/
+	static const VertexLayout *getVertexLayout() { return _vertexLayout; }
+
+	/**	@brief Unbinds the vertex buffer unless the state is being tracked
+	*/
+	static void unbindVertexBuffer();
+
+	/**	@brief Binds an index buffer if it isn't already bound, returns true if the buffer changed
+	*
+	*	The index buffer binding is part of the vertex array object, only the one of the default vertex array (0) is tracked.
+	*
+	*	@param[in] buffer
+	*/
+	static bool bindIndexBuffer(GLuint buffer);
+
+	/**	@brief Unbinds the index buffer unless the state is being tracked
+	*/
+	static void unbindIndexBuffer();
+
+	/**	@brief Binds a vertex array object if it isn't already bound, returns true if the vertex array changed
+	*	@param[in] vertexArray
+	*/
+	static bool bindVertexArray(GLuint vertexArray);
+
+	/**	@brief Binds the default vertex array unless the state is being tracked
+	*/
+	static void unbindVertexArray();
+
+	/**	@brief Has to be called when a vertex array object is deleted
+	*	@param[in] vertexArray
+	*/
+	static void deleteVertexArray(GLuint vertexArray);
+
+	/**	@brief Returns the number of programs deleted so far, objects that depend on program IDs can be invalidated when it changes
+	*/
+	static GLuint getProgramDeletions() { return _programDeletions; }
+
+	/**	@brief Returns true if the vertex attributes need to be set up for the current program and vertex buffer
+	*
+	*	Never true while a vertex array object is bound, since it stores the attributes itself.
+	*/
+	static bool needsAttribSetup();
+
+	/**	@brief Returns true if the material needs to be bound, i.e. if it is not the material bound last
+	*	@param[in] material Any value identifying the material
+	*/
+	static bool bindMaterial(const void *material);
+
+	/**	@brief Binds a texture to a texture unit if it isn't already bound there
+	*	@param[in] texUnit Texture unit (e.g. GL_TEXTURE0)
+	*	@param[in] target GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP
+	*	@param[in] textureID
+	*/
+	static void bindTexture(GLint texUnit, GLenum target, GLuint textureID);
+
+	/**	@brief Sets the blend function if it differs from the current one
+	*	@param[in] sfactor
+	*	@param[in] dfactor
+	*/
+	static void setBlendFunc(GLenum sfactor, GLenum dfactor);
+
+	/**	@brief Returns the statistics collected since begin() was called
+	*/
+	static const Statistics &getStatistics() { return _statistics; }
+
+private:
+
+	/* Variables */
+
+	static const GLuint MAX_TEXTURE_UNITS = 32;
+
+	static bool			_tracking;
+	static GLuint		_program;
+	static GLuint		_programDeletions;
+	static GLuint		_vertexArray;
+	static GLuint		_vertexBuffer;
+	static const VertexLayout	*_vertexLayout;
+	static GLuint		_indexBuffer;
+	static GLuint		_attribProgram, _attribVertexBuffer;
+	static const void	*_material;
+	static GLuint		_textures[MAX_TEXTURE_UNITS];
+	static bool			_blendFuncKnown;
+	static GLenum		_blendSfactor, _blendDfactor;
+	static Statistics	_statistics;
+};
+
+#endif /* defined(B_RENDER_STATE_H) */
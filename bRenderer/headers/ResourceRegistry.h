@@ -0,0 +1,224 @@
+#ifndef B_RESOURCE_REGISTRY_H
+#define B_RESOURCE_REGISTRY_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include "Renderer_GL.h"
+
+/** @brief Stores named objects of one type in dense arrays and hands out handles to them.
+*
+*	A handle holds the index of a slot and the generation of the slot when the object was added.
+*	Removing an object increases the generation of its slot, so old handles no longer resolve once the slot is reused.
+*	Resolving a handle costs two array accesses, the name is only hashed when the object is added or looked up by name.
+*	The objects are kept contiguous (the last one is moved into the gap when one is removed), so iterating over them skips no holes.
+*	The version of the registry increases whenever an object is added or removed, so caches indexed by slot know when to refill.
+*/
+template< typename T >
+class ResourceRegistry
+{
+public:
+	/* Typedefs */
+	typedef std::shared_ptr< T >	Ptr;
+	typedef typename std::vector< Ptr >::const_iterator	const_iterator;
+
+	/* Structs */
+
+	/* Refers to an object of this registry, handles of different registries are different types */
+	struct Handle
+	{
+		GLuint	index = NO_INDEX;
+		GLuint	generation = 0;
+
+		/**	@brief Returns true if the handle was returned for an object, even if it has been removed since
+		*/
+		bool isValid() const { return index != NO_INDEX; }
+
+		bool operator==(const Handle &other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const Handle &other) const { return !(*this == other); }
+	};
+
+	/* Functions */
+
+	/**	@brief Adds an object and returns its handle, or an invalid handle if the name is already taken
+	*	@param[in] name
+	*	@param[in] ptr
+	*/
+	Handle add(const std::string &name, Ptr ptr)
+	{
+		auto inserted = _indices.insert(std::make_pair(name, 0u));
+		if (!inserted.second)
+			return Handle();
+
+		GLuint slot;
+		if (!_freeSlots.empty())
+		{
+			slot = _freeSlots.back();
+			_freeSlots.pop_back();
+		}
+		else
+		{
+			slot = static_cast<GLuint>(_slots.size());
+			_slots.push_back(Slot());
+		}
+		inserted.first->second = slot;
+		_slots[slot].dense = static_cast<GLuint>(_objects.size());
+		_objects.push_back(ptr);
+		_names.push_back(name);
+		_denseSlots.push_back(slot);
+		_version++;
+		return makeHandle(slot);
+	}
+
+	/**	@brief Returns the handle of an object, or an invalid handle if there is no object with that name
+	*	@param[in] name
+	*/
+	Handle find(const std::string &name) const
+	{
+		auto i = _indices.find(name);
+		if (i == _indices.end())
+			return Handle();
+		return makeHandle(i->second);
+	}
+
+	/**	@brief Returns an object or nullptr if the handle is invalid or the object was removed
+	*	@param[in] handle
+	*/
+	Ptr get(Handle handle) const
+	{
+		if (handle.index >= _slots.size() || _slots[handle.index].generation != handle.generation || _slots[handle.index].dense == NO_INDEX)
+			return nullptr;
+		return _objects[_slots[handle.index].dense];
+	}
+
+	/**	@brief Returns an object or nullptr if there is no object with that name
+	*	@param[in] name
+	*/
+	Ptr get(const std::string &name) const
+	{
+		auto i = _indices.find(name);
+		if (i == _indices.end())
+			return nullptr;
+		return _objects[_slots[i->second].dense];
+	}
+
+	/**	@brief Returns the name of an object or an empty string if the handle is invalid or the object was removed
+	*	@param[in] handle
+	*/
+	std::string getName(Handle handle) const
+	{
+		if (!get(handle))
+			return "";
+		return _names[_slots[handle.index].dense];
+	}
+
+	/**	@brief Removes an object and returns it, or returns nullptr if there is no object with that name
+	*	@param[in] name
+	*/
+	Ptr remove(const std::string &name)
+	{
+		auto i = _indices.find(name);
+		if (i == _indices.end())
+			return nullptr;
+		GLuint slot = i->second;
+		_indices.erase(i);
+
+		// move the last object into the gap
+		GLuint dense = _slots[slot].dense;
+		Ptr removed = _objects[dense];
+		GLuint last = static_cast<GLuint>(_objects.size() - 1);
+		_objects[dense] = _objects[last];
+		_names[dense] = _names[last];
+		_denseSlots[dense] = _denseSlots[last];
+		_slots[_denseSlots[dense]].dense = dense;
+		_objects.pop_back();
+		_names.pop_back();
+		_denseSlots.pop_back();
+
+		_slots[slot].dense = NO_INDEX;
+		_slots[slot].generation++;
+		_freeSlots.push_back(slot);
+		_version++;
+		return removed;
+	}
+
+	/**	@brief Removes all objects, handles returned before don't resolve anymore
+	*/
+	void clear()
+	{
+		for (auto i = _denseSlots.begin(); i != _denseSlots.end(); ++i)
+		{
+			_slots[*i].dense = NO_INDEX;
+			_slots[*i].generation++;
+			_freeSlots.push_back(*i);
+		}
+		_objects.clear();
+		_names.clear();
+		_denseSlots.clear();
+		_indices.clear();
+		_version++;
+	}
+
+	/**	@brief Returns the number of objects
+	*/
+	size_t size() const { return _objects.size(); }
+
+	/**	@brief Returns an iterator to the first object, the order changes when objects are removed
+	*/
+	const_iterator begin() const { return _objects.begin(); }
+
+	/**	@brief Returns an iterator past the last object
+	*/
+	const_iterator end() const { return _objects.end(); }
+
+	/**	@brief Returns the handle of the object an iterator points to
+	*	@param[in] i Iterator between begin() and end()
+	*/
+	Handle getHandle(const_iterator i) const { return makeHandle(_denseSlots[i - _objects.begin()]); }
+
+	/**	@brief Returns the number of slots, the index of every handle is smaller
+	*/
+	size_t getNumSlots() const { return _slots.size(); }
+
+	/**	@brief Returns a number that changes whenever an object is added or removed
+	*/
+	GLuint getVersion() const { return _version; }
+
+	/* Variables */
+
+	static const GLuint NO_INDEX = 0xffffffff;
+
+private:
+
+	/* Structs */
+
+	struct Slot
+	{
+		GLuint	dense = NO_INDEX;
+		GLuint	generation = 0;
+	};
+
+	/* Functions */
+
+	Handle makeHandle(GLuint slot) const
+	{
+		Handle handle;
+		handle.index = slot;
+		handle.generation = _slots[slot].generation;
+		return handle;
+	}
+
+	/* Variables */
+
+	std::vector< Ptr >			_objects;
+	std::vector< std::string >	_names;
+	std::vector< GLuint >		_denseSlots;
+
+	std::vector< Slot >		_slots;
+	std::vector< GLuint >	_freeSlots;
+	std::unordered_map< std::string, GLuint >	_indices;
+	GLuint	_version = 0;
+};
+
+#endif /* defined(B_RESOURCE_REGISTRY_H) */
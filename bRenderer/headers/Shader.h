@@ -4,12 +4,16 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "vmmlib/matrix.hpp"
 #include "Renderer_GL.h"
 #include "Texture.h"
+#include "RenderState.h"
+#include "LightPack.h"
 
 
 class IShaderData;
+class VertexLayout;
 
 /** @brief A shader class that represents a program to be run on the GPU.
 *	@author Rahul Mukhi, David Steiner
@@ -31,8 +35,21 @@ public:
 
 	/* Typedefs */
 
+	typedef GLuint UniformHandle;
+
     typedef std::unordered_map< std::string, GLint >    LocationMap;
     typedef std::unordered_map< std::string, Attrib >   AttribMap;
+
+	/* Uniform handles of one light slot */
+	struct LightUniforms
+	{
+		UniformHandle	positionViewSpace;
+		UniformHandle	diffuseColor;
+		UniformHandle	specularColor;
+		UniformHandle	intensity;
+		UniformHandle	attenuation;
+		UniformHandle	radius;
+	};
     
 	/* Functions */
 
@@ -51,6 +68,14 @@ public:
 	/**	@brief Binds the shader and its attributes
 	*/
     virtual void bind();
+
+	/**	@brief Enables and sets the attribute pointers for the vertex buffer currently bound
+	*
+	*	Attributes of the shader missing in the layout are disabled.
+	*
+	*	@param[in] layout The layout of the vertex buffer, the registered attributes are used if nullptr
+	*/
+	virtual void bindAttribs(const VertexLayout *layout);
     
 	/**	@brief Pass a 4 dimensional matrix to the shader
 	*	@param[in] name Uniform name
@@ -87,6 +112,76 @@ public:
 	*	@param[in] arg Texture
 	*/
     virtual void setUniform(const std::string &name, TexturePtr texture);
+
+	/**	@brief Pass a 4 dimensional matrix to the shader
+	*	@param[in] handle Uniform handle
+	*	@param[in] arg 4 dimensional matrix
+	*/
+	virtual void setUniform(UniformHandle handle, const vmml::Matrix4f &arg);
+
+	/**	@brief Pass a 3 dimensional matrix to the shader
+	*	@param[in] handle Uniform handle
+	*	@param[in] arg 3 dimensional matrix
+	*/
+	virtual void setUniform(UniformHandle handle, const vmml::Matrix3f &arg);
+
+	/**	@brief Pass a 4 dimensional vector to the shader
+	*	@param[in] handle Uniform handle
+	*	@param[in] arg 4 dimensional vector
+	*/
+	virtual void setUniform(UniformHandle handle, const vmml::Vector4f &arg);
+
+	/**	@brief Pass a 3 dimensional vector to the shader
+	*	@param[in] handle Uniform handle
+	*	@param[in] arg 3 dimensional vector
+	*/
+	virtual void setUniform(UniformHandle handle, const vmml::Vector3f &arg);
+
+	/**	@brief Pass a floating-point number to the shader
+	*	@param[in] handle Uniform handle
+	*	@param[in] arg Floating-point number
+	*/
+	virtual void setUniform(UniformHandle handle, GLfloat arg);
+
+	/**	@brief Pass an array of floating-point numbers to the shader
+	*	@param[in] handle Uniform handle
+	*	@param[in] value Values in the layout of the uniform type (column-major for matrices)
+	*	@param[in] type GL_FLOAT_MAT4, GL_FLOAT_MAT3, GL_FLOAT_VEC4, GL_FLOAT_VEC3 or GL_FLOAT
+	*/
+	virtual void setUniform(UniformHandle handle, const GLfloat *value, GLenum type);
+
+	/**	@brief Pass a texture to the shader
+	*	@param[in] handle Uniform handle
+	*	@param[in] arg Texture
+	*/
+	virtual void setUniform(UniformHandle handle, TexturePtr texture);
+
+	/**	@brief Pass the lights of a light pack to the shader
+	*
+	*	At most getMaxLights() lights are passed, the number of lights is set as well if it is variable in the shader.
+	*
+	*	@param[in] lights
+	*/
+	virtual void setLights(const LightPack &lights);
+
+	/**	@brief Returns the handle of a uniform name
+	*
+	*	Handles are shared by all shaders, a name always maps to the same handle.
+	*	Setting uniforms through handles avoids looking up the name on every call.
+	*
+	*	@param[in] name Uniform name
+	*/
+	static UniformHandle getUniformHandle(const std::string &name);
+
+	/**	@brief Returns the uniform name of a handle
+	*	@param[in] handle Uniform handle
+	*/
+	static const std::string &getUniformName(UniformHandle handle);
+
+	/**	@brief Returns the uniform handles of a light slot, the names are only built the first time a slot is used
+	*	@param[in] light Index of the light slot
+	*/
+	static const LightUniforms &getLightUniforms(GLuint light);
     
 	/**	@brief Register a uniform
 	*	@param[in] name Uniform name
@@ -101,16 +196,37 @@ public:
 	*	@param[in] offset
 	*/
     virtual GLint registerAttrib(const std::string &name, GLint size, GLenum type, GLsizei stride, size_t offset);
+
+	/**	@brief Returns the location of a registered attribute or -1 if the shader doesn't use it
+	*	@param[in] name Attribute name
+	*/
+	GLint getAttribLocation(const std::string &name) const
+	{
+		auto i = _attribs.find(name);
+		return i != _attribs.end() ? i->second.loc - 1 : -1;
+	}
     
 	/**	@brief Returns the shader ID
 	*/
 	GLuint getProgramID() { return _programID; }
+
+	/**	@brief Returns a number that changes every time a uniform value of the shader is uploaded
+	*
+	*	Numbers are unique across all shaders, an unchanged number guarantees that no uniform
+	*	of this shader has been modified in the meantime.
+	*/
+	GLuint getUniformVersion() const { return _uniformVersion; }
     
 	/**	@brief Returns uniform location (tries to register uniform if not already available)
 	*	@param[in] name Uniform name
 	*/
     virtual GLint findUniformLocation(const std::string &name);
 
+	/**	@brief Returns uniform location (the location is looked up only once per shader)
+	*	@param[in] handle Uniform handle
+	*/
+	virtual GLint findUniformLocation(UniformHandle handle);
+
 	/**	@brief Returns attribute location (tries to register attribute if not already available)
 	*	@param[in] name Attribute name
 	*	@param[in] size
@@ -153,6 +269,25 @@ public:
 	/**	@brief Returns true if the shader supports a cubic reflection map
 	*/
 	bool supportsCubicReflectionMap() const { return _cubicReflectionMap; }
+
+	/**	@brief Returns true if the shader reads the model view matrix from a per instance attribute
+	*
+	*	The shader needs to declare a mat4 attribute with the name defined in DEFAULT_SHADER_ATTRIBUTE_INSTANCE_MODEL_VIEW_MATRIX
+	*	to support hardware instancing.
+	*/
+	bool supportsInstancing() const { return _instanceMatrixLoc > -1; }
+
+	/**	@brief Returns the location of the per instance model view matrix attribute (the matrix occupies four consecutive locations)
+	*/
+	GLint getInstanceMatrixLocation() const { return _instanceMatrixLoc; }
+
+	/**	@brief Sets the model view matrix last passed to the shader as the value of the instance attribute
+	*
+	*	Shaders supporting instancing store the model view matrix passed as uniform instead of uploading it.
+	*	The value of an attribute without an array is shared by all programs, so it has to be set before every draw call
+	*	that doesn't read the matrices from an instance buffer.
+	*/
+	void applyInstanceMatrix();
     
     template< typename T >
 	/**	@brief Sets multiple uniforms
@@ -175,14 +310,37 @@ public:
 	virtual void deleteShader()
 	{
 		if (_programID) {
+			RenderState::deleteProgram(_programID);
 			glDeleteProgram(_programID);
 		}
 	}
 
 protected:
+
+	/* Structs */
+
+	/* Location and last uploaded value of a uniform */
+	struct UniformState
+	{
+		GLint	loc = -1;
+		bool	resolved = false;
+		GLsizei	size = 0;		// number of floats in value, 0 if nothing was uploaded yet
+		GLfloat	value[16];
+	};
 	
 	/* Functions */
 
+	/**	@brief Makes the shader the current program if it isn't already
+	*/
+	void useProgram();
+
+	/**	@brief Stores a value in the uniform state, returns false if the value equals the last uploaded one
+	*	@param[in] state Uniform state
+	*	@param[in] value Values to store
+	*	@param[in] size Number of values
+	*/
+	bool updateUniformState(UniformState &state, const GLfloat *value, GLsizei size);
+
     virtual void resetTexUnit();
 	virtual bool compile(GLuint* shader, GLenum type, const std::string &src);
 	virtual bool link();
@@ -197,15 +355,20 @@ private:
     GLint   _cTexUnit = 0;
     GLint   _maxTexUnits = 0;
     
-	LocationMap   _uniformLocations;
+	std::vector<UniformState>	_uniforms;		// indexed by uniform handle
 	AttribMap     _attribs;
 
+	GLuint	_uniformVersion;
+
+	static GLuint _uniformVersionCounter;
+
 	GLuint		_shaderMaxLights;
 	bool		_variableNumberOfLights;
 	bool		_ambientLighting;
 	bool		_diffuseLighting;
 	bool		_specularLighting;
 	bool		_cubicReflectionMap;
+	GLint		_instanceMatrixLoc = -1;
 };
 
 typedef std::shared_ptr< Shader > ShaderPtr;
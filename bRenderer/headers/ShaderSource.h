@@ -19,7 +19,9 @@ namespace bRenderer
     std::string shader_source_light_properties(GLuint maxLights, bool normalMap, bool diffuseLighting, bool specularLighting);
 
 	// Matrices
-	std::string SHADER_SOURCE_MATRICES();
+	std::string shader_source_matrices(bool instancing);
+
+	std::string shader_source_model_view_matrix(bool instancing);
 
 	// Attributes
 	std::string SHADER_SOURCE_ATTRIBUTES();
@@ -49,10 +51,10 @@ namespace bRenderer
 
 	// Vertex Shader Main Function
 	//Begin
-	std::string shader_source_function_vertex_main_begin(bool hasLighting, bool hasTextures, bool normalMap);
+	std::string shader_source_function_vertex_main_begin(bool hasLighting, bool hasTextures, bool normalMap, bool instancing);
 
 	// TBN for normal map
-	std::string SHADER_SOURCE_FUNCTION_VERTEX_MAIN_TBN();
+	std::string shader_source_function_vertex_main_tbn(bool instancing);
 	// Camera tangent space
 	std::string SHADER_SOURCE_FUNCTION_VERTEX_MAIN_CAMERA_TANGENT_SPACE();
 	// Camera view space
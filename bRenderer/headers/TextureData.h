@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include "Renderer_GL.h"
 
 typedef std::shared_ptr< GLubyte > ImageDataPtr;
@@ -42,6 +43,24 @@ public:
 	*/
 	virtual TextureData &load(const std::string &fileName);
 
+	/**	@brief Loads the texture from its cooked file, returns false if there is none or it is outdated
+	*
+	*	Cooked files are written next to the image by saveCooked (see AssetCooker) and contain the decoded RGBA data and all mip levels.
+	*	Loading one makes decoding the image and generating the mipmap at runtime unnecessary.
+	*
+	*	@param[in] fileName The name of the texture file (not the cooked file)
+	*/
+	bool loadCooked(const std::string &fileName);
+
+	/**	@brief Writes the texture including its mip levels to the cooked file of an image, returns false if that failed
+	*	@param[in] fileName The name of the texture file the data was loaded from
+	*/
+	bool saveCooked(const std::string &fileName) const;
+
+	/**	@brief Creates all mip levels of the texture by averaging 2x2 blocks of the level above
+	*/
+	TextureData &generateMipLevels();
+
 	/**	@brief Creates a texture
 	*	@param[in] width
 	*	@param[in] height
@@ -65,6 +84,25 @@ public:
 	/**	@brief Gets the image data of the texture
 	*/
     ImageDataPtr    getImageData()  const   { return _imageData;    }
+
+	/**	@brief Gets the image data of the mip levels below the base level, empty if the mipmap should be generated when uploading
+	*/
+	const std::vector< ImageDataPtr > &getMipLevels() const { return _mipLevels; }
+
+	/**	@brief Returns the path of the cooked file of an image
+	*	@param[in] fileName The name of the texture file
+	*/
+	static std::string getCookedPath(const std::string &fileName);
+
+	/**	@brief Returns true if the cooked file of an image exists and matches the image
+	*	@param[in] fileName The name of the texture file
+	*/
+	static bool isCookedUpToDate(const std::string &fileName);
+
+	/**	@brief Returns the number of bytes per pixel of a format
+	*	@param[in] format
+	*/
+	static GLsizei getBytesPerPixel(GLenum format);
     
 private:
 
@@ -74,6 +112,7 @@ private:
     GLsizei         _height;
     GLenum          _format;
 	ImageDataPtr    _imageData = nullptr;
+	std::vector< ImageDataPtr > _mipLevels;
 };
 
 #endif /* defined(B_TEXTURE_DATA_H) */
@@ -0,0 +1,121 @@
+#ifndef B_VERTEX_LAYOUT_H
+#define B_VERTEX_LAYOUT_H
+
+#include <string>
+#include <vector>
+#include "Renderer_GL.h"
+
+struct Vertex;
+class Shader;
+
+/** @brief Describes how vertices are stored in a vertex buffer on the GPU.
+*
+*	A layout is defined by the vertex components it contains, the position is always part of it.
+*	Layouts containing the bitangent store the vertices exactly like the Vertex struct (56 bytes).
+*	All other layouts are compact: normals and tangents are stored as packed signed normalized integers
+*	(10:10:10:2 if supported, bytes otherwise) and texture coordinates as half floats if supported.
+*	The w component of the tangent holds the sign of the bitangent, so shaders can reconstruct it as cross(normal, tangent.xyz) * sign(tangent.w).
+*
+*	Layouts are created on demand and need a valid OpenGL context.
+*/
+class VertexLayout
+{
+public:
+	/* Enums */
+
+	enum VertexComponent
+	{
+		VC_POSITION = 0,
+		VC_NORMAL = 1,
+		VC_TANGENT = 2,
+		VC_BITANGENT = 4,
+		VC_TEXCOORD = 8,
+		VC_ALL = VC_NORMAL | VC_TANGENT | VC_BITANGENT | VC_TEXCOORD
+	};
+
+	/* Typedefs */
+	typedef GLuint Components;
+
+	/* Structs */
+
+	struct Attribute
+	{
+		VertexComponent	component;
+		std::string		name;
+		GLint			size;
+		GLenum			type;
+		GLboolean		normalized;
+		size_t			offset;
+	};
+
+	typedef std::vector< Attribute >	Attributes;
+
+	/* Functions */
+
+	/**	@brief Returns the layout for the given components
+	*	@param[in] components Combination of vertex components
+	*/
+	static const VertexLayout &get(Components components);
+
+	/**	@brief Returns the components whose attributes are active in the shader
+	*	@param[in] shader
+	*/
+	static Components getRequiredComponents(Shader &shader);
+
+	/**	@brief Returns the components stored in the layout
+	*/
+	Components getComponents() const { return _components; }
+
+	/**	@brief Returns true if the layout is compact, false if it stores vertices like the Vertex struct
+	*/
+	bool isCompact() const { return (_components & VC_BITANGENT) == 0; }
+
+	/**	@brief Returns the size of a vertex in bytes
+	*/
+	GLsizei getStride() const { return _stride; }
+
+	/**	@brief Returns the attributes of the layout
+	*/
+	const Attributes &getAttributes() const { return _attributes; }
+
+	/**	@brief Returns the attribute with the given name or nullptr if the layout doesn't contain it
+	*	@param[in] name
+	*/
+	const Attribute *findAttribute(const std::string &name) const;
+
+	/**	@brief Converts vertices to the layout
+	*	@param[in] vertices
+	*	@param[in] nVertices
+	*	@param[out] buffer The converted vertices, ready to be uploaded
+	*/
+	void pack(const Vertex *vertices, size_t nVertices, std::vector< GLubyte > &buffer) const;
+
+private:
+
+	/* Functions */
+
+	/**	@brief Constructor
+	*	@param[in] components
+	*/
+	VertexLayout(Components components);
+
+	/**	@brief Adds an attribute at the end of a vertex
+	*/
+	void addAttribute(VertexComponent component, const std::string &name, GLint size, GLenum type, GLboolean normalized, size_t bytes);
+
+	/**	@brief Returns true if normals and tangents can be stored as 10:10:10:2 integers
+	*/
+	static bool supportsPackedVectors();
+
+	/**	@brief Returns true if texture coordinates can be stored as half floats
+	*/
+	static bool supportsHalfFloats();
+
+	/* Variables */
+
+	Components	_components;
+	GLsizei		_stride = 0;
+	Attributes	_attributes;
+};
+
+#endif /* defined(B_VERTEX_LAYOUT_H) */
@@ -0,0 +1,133 @@
+#include "headers/AssetCooker.h"
+#include "headers/ModelData.h"
+#include "headers/ModelCache.h"
+#include "headers/TextureData.h"
+#include "headers/FileHandler.h"
+#include "headers/Logger.h"
+#include "headers/Configuration.h"
+#include "external/jsoncpp/json.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <fstream>
+
+/* Public functions */
+
+void AssetCooker::addModel(const std::string &fileName, bool flipT, bool flipZ)
+{
+	Job job;
+	job.type = AT_MODEL;
+	job.fileName = fileName;
+	job.flipT = flipT;
+	job.flipZ = flipZ;
+	_jobs.push_back(job);
+}
+
+void AssetCooker::addTexture(const std::string &fileName)
+{
+	Job job;
+	job.type = AT_TEXTURE;
+	job.fileName = fileName;
+	_jobs.push_back(job);
+}
+
+bool AssetCooker::run(const std::string &manifestPath, GLuint nThreads)
+{
+	if (nThreads == 0)
+		nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	nThreads = std::min(nThreads, static_cast<GLuint>(_jobs.size()));
+
+	// Every thread takes the next job until all are done
+	std::atomic< size_t > next(0);
+	auto worker = [this, &next]()
+	{
+		for (size_t i = next++; i < _jobs.size(); i = next++)
+			cook(_jobs[i]);
+	};
+	std::vector< std::thread > threads;
+	for (GLuint i = 1; i < nThreads; i++)
+		threads.push_back(std::thread(worker));
+	worker();
+	for (auto i = threads.begin(); i != threads.end(); ++i)
+		i->join();
+
+	size_t nSkipped = 0, nFailed = 0;
+	for (auto i = _jobs.begin(); i != _jobs.end(); ++i)
+	{
+		if (i->skipped) nSkipped++;
+		if (!i->succeeded) nFailed++;
+	}
+	bRenderer::log("Cooked " + std::to_string(_jobs.size() - nSkipped - nFailed) + " assets, skipped " + std::to_string(nSkipped) + " up-to-date assets, "
+		+ std::to_string(nFailed) + " failed", nFailed > 0 ? bRenderer::LM_WARNING : bRenderer::LM_INFO);
+
+	bool manifestWritten = manifestPath.empty() || writeManifest(manifestPath);
+	return nFailed == 0 && manifestWritten;
+}
+
+/* Private functions */
+
+void AssetCooker::cook(Job &job)
+{
+	if (!bRenderer::fileExists(job.fileName))
+	{
+		bRenderer::log("Could not find " + job.fileName + " for cooking", bRenderer::LM_ERROR);
+		return;
+	}
+
+	switch (job.type)
+	{
+	case AT_MODEL:
+		if (ModelCache::isUpToDate(getOutputPath(job), job.flipT, job.flipZ))
+			job.skipped = job.succeeded = true;
+		else
+			job.succeeded = ModelData(job.flipT, job.flipZ).cook(job.fileName);
+		break;
+	case AT_TEXTURE:
+		if (TextureData::isCookedUpToDate(job.fileName))
+			job.skipped = job.succeeded = true;
+		else
+		{
+			TextureData data;
+			job.succeeded = data.load(job.fileName).getImageData() && data.generateMipLevels().saveCooked(job.fileName);
+		}
+		break;
+	}
+
+	if (!job.succeeded)
+		bRenderer::log("Could not cook " + job.fileName, bRenderer::LM_ERROR);
+}
+
+std::string AssetCooker::getOutputPath(const Job &job)
+{
+	return job.type == AT_MODEL ? ModelCache::getCachePath(job.fileName) : TextureData::getCookedPath(job.fileName);
+}
+
+bool AssetCooker::writeManifest(const std::string &manifestPath) const
+{
+	Json::Value assets(Json::arrayValue);
+	for (auto i = _jobs.begin(); i != _jobs.end(); ++i)
+	{
+		Json::Value asset;
+		asset["type"] = i->type == AT_MODEL ? "model" : "texture";
+		asset["source"] = i->fileName;
+		asset["output"] = i->fileName + (i->type == AT_MODEL ? bRenderer::MODEL_CACHE_FILE_EXTENSION() : bRenderer::COOKED_TEXTURE_FILE_EXTENSION());
+		asset["status"] = !i->succeeded ? "failed" : (i->skipped ? "up-to-date" : "cooked");
+		if (i->type == AT_MODEL)
+		{
+			asset["flipT"] = i->flipT;
+			asset["flipZ"] = i->flipZ;
+		}
+		assets.append(asset);
+	}
+	Json::Value manifest;
+	manifest["assets"] = assets;
+
+	std::ofstream file(manifestPath, std::ofstream::out | std::ofstream::trunc);
+	file << Json::StyledWriter().write(manifest);
+	if (!file)
+	{
+		bRenderer::log("Could not write manifest " + manifestPath, bRenderer::LM_ERROR);
+		return false;
+	}
+	return true;
+}
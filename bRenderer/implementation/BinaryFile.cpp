@@ -0,0 +1,89 @@
+#include "headers/BinaryFile.h"
+#include "headers/FileHandler.h"
+#include "headers/Logger.h"
+#include <fstream>
+#include <cstdio>
+
+/* BinaryWriter */
+
+bool BinaryWriter::save(const std::string &filePath) const
+{
+	std::string tempPath = filePath + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+		if (file && !_data.empty())
+			file.write(_data.data(), static_cast<std::streamsize>(_data.size()));
+		if (!file)
+		{
+			bRenderer::log("Could not write " + filePath, bRenderer::LM_WARNING);
+			std::remove(tempPath.c_str());
+			return false;
+		}
+	}
+	// rename doesn't replace existing files on every system
+	std::remove(filePath.c_str());
+	if (std::rename(tempPath.c_str(), filePath.c_str()) != 0)
+	{
+		bRenderer::log("Could not write " + filePath, bRenderer::LM_WARNING);
+		std::remove(tempPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+/* SourceStamp */
+
+bool SourceStamp::create(const std::string &name)
+{
+	fileName = name;
+	std::string filePath = bRenderer::getFilePath(fileName);
+	long long fileSize, fileModificationTime;
+	if (!bRenderer::getFileStatus(filePath, fileSize, fileModificationTime))
+		return false;
+	size = fileSize;
+	modificationTime = fileModificationTime;
+	hash = hashFile(filePath);
+	return true;
+}
+
+bool SourceStamp::isCurrent() const
+{
+	std::string filePath = bRenderer::getFilePath(fileName);
+	long long fileSize, fileModificationTime;
+	if (!bRenderer::getFileStatus(filePath, fileSize, fileModificationTime) || fileSize != size)
+		return false;
+	return fileModificationTime == modificationTime || hashFile(filePath) == hash;
+}
+
+void SourceStamp::write(BinaryWriter &writer) const
+{
+	writer.string(fileName);
+	writer.value(size);
+	writer.value(modificationTime);
+	writer.value(hash);
+}
+
+bool SourceStamp::read(BinaryReader &reader)
+{
+	fileName = reader.string();
+	size = reader.value< int64_t >();
+	modificationTime = reader.value< int64_t >();
+	hash = reader.value< uint64_t >();
+	return reader.ok();
+}
+
+uint64_t SourceStamp::hashFile(const std::string &filePath)
+{
+	bRenderer::MappedFile file(filePath);
+	if (!file.isOpen())
+		return 0;
+
+	// 64 bit FNV-1a
+	uint64_t h = 14695981039346656037ULL;
+	for (const char *p = file.begin(); p != file.end(); ++p)
+	{
+		h ^= static_cast<unsigned char>(*p);
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
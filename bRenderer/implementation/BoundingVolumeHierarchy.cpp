@@ -0,0 +1,234 @@
+#include "headers/BoundingVolumeHierarchy.h"
+#include <algorithm>
+#include <cmath>
+
+/* Public functions */
+
+GLuint BoundingVolumeHierarchy::addObject(const vmml::AABBf &boxWorldSpace)
+{
+	GLuint objectID;
+	if (!_freeIDs.empty())
+	{
+		objectID = _freeIDs.back();
+		_freeIDs.pop_back();
+	}
+	else
+	{
+		objectID = static_cast<GLuint>(_objectAlive.size());
+		_objectMin.push_back(vmml::Vector3f::ZERO);
+		_objectMax.push_back(vmml::Vector3f::ZERO);
+		_objectAlive.push_back(false);
+	}
+	_objectMin[objectID] = boxWorldSpace.getMin();
+	_objectMax[objectID] = boxWorldSpace.getMax();
+	_objectAlive[objectID] = true;
+	_nObjects++;
+	_needsBuild = true;
+	return objectID;
+}
+
+void BoundingVolumeHierarchy::moveObject(GLuint objectID, const vmml::AABBf &boxWorldSpace)
+{
+	if (objectID >= _objectAlive.size() || !_objectAlive[objectID])
+		return;
+	_objectMin[objectID] = boxWorldSpace.getMin();
+	_objectMax[objectID] = boxWorldSpace.getMax();
+	_needsRefit = true;
+}
+
+void BoundingVolumeHierarchy::removeObject(GLuint objectID)
+{
+	if (objectID >= _objectAlive.size() || !_objectAlive[objectID])
+		return;
+	_objectAlive[objectID] = false;
+	_freeIDs.push_back(objectID);
+	_nObjects--;
+	_needsBuild = true;
+}
+
+void BoundingVolumeHierarchy::clear()
+{
+	_objectMin.clear();
+	_objectMax.clear();
+	_objectAlive.clear();
+	_freeIDs.clear();
+	_nObjects = 0;
+	_nodes.clear();
+	_order.clear();
+	_orderedBoxes.clear();
+	_needsBuild = _needsRefit = false;
+}
+
+void BoundingVolumeHierarchy::update()
+{
+	if (_needsBuild)
+		build();
+	else if (_needsRefit)
+		refit();
+	_needsBuild = _needsRefit = false;
+}
+
+void BoundingVolumeHierarchy::cull(const vmml::Matrix4f &viewProjectionMatrix, std::vector< GLuint > &visibleObjects)
+{
+	cull(Frustum(viewProjectionMatrix), visibleObjects);
+}
+
+void BoundingVolumeHierarchy::cull(const Frustum &frustum, std::vector< GLuint > &visibleObjects)
+{
+	update();
+	_nNodesTested = 0;
+	if (_nodes.empty())
+		return;
+
+	_stack.clear();
+	_stack.push_back(std::make_pair(0u, Frustum::ALL_PLANES));
+	while (!_stack.empty())
+	{
+		GLuint nodeIndex = _stack.back().first;
+		GLuint mask = _stack.back().second;
+		_stack.pop_back();
+		const Node &node = _nodes[nodeIndex];
+
+		if (mask)
+		{
+			_nNodesTested++;
+			if (!frustum.testBox(node.min, node.max, mask))
+				continue;
+		}
+
+		if (node.count == 0)
+		{
+			_stack.push_back(std::make_pair(node.first + 1, mask));
+			_stack.push_back(std::make_pair(node.first, mask));
+			continue;
+		}
+
+		// Objects in leaves that are only partially inside are tested individually
+		uint32_t visible = mask ? frustum.testBoxes(_orderedBoxes, node.first, node.count) : ~0u;
+		for (GLuint i = 0; i < node.count; ++i)
+		{
+			if (visible & (1u << i))
+				visibleObjects.push_back(_order[node.first + i]);
+		}
+	}
+}
+
+vmml::AABBf BoundingVolumeHierarchy::transformBox(const vmml::AABBf &boxObjectSpace, const vmml::Matrix4f &modelMatrix)
+{
+	// The extent along each axis is the sum of the extents projected onto it (Arvo, "Transforming Axis-Aligned Bounding Boxes")
+	vmml::Vector3f center = (boxObjectSpace.getMin() + boxObjectSpace.getMax()) * 0.5f;
+	vmml::Vector3f extent = (boxObjectSpace.getMax() - boxObjectSpace.getMin()) * 0.5f;
+	vmml::Vector3f newCenter, newExtent;
+	for (int i = 0; i < 3; ++i)
+	{
+		newCenter[i] = modelMatrix(i, 0) * center.x() + modelMatrix(i, 1) * center.y() + modelMatrix(i, 2) * center.z() + modelMatrix(i, 3);
+		newExtent[i] = std::fabs(modelMatrix(i, 0)) * extent.x() + std::fabs(modelMatrix(i, 1)) * extent.y() + std::fabs(modelMatrix(i, 2)) * extent.z();
+	}
+	return vmml::AABBf(newCenter - newExtent, newCenter + newExtent);
+}
+
+/* Private functions */
+
+void BoundingVolumeHierarchy::build()
+{
+	_nodes.clear();
+	_order.clear();
+	for (GLuint i = 0; i < _objectAlive.size(); ++i)
+	{
+		if (_objectAlive[i])
+			_order.push_back(i);
+	}
+	_orderedBoxes.resize(_order.size());
+	if (_order.empty())
+		return;
+
+	// Every leaf holds at least one object and a tree with n leaves has 2n - 1 nodes
+	_nodes.reserve(2 * _order.size());
+	Node root;
+	root.first = 0;
+	root.count = static_cast<GLuint>(_order.size());
+	_nodes.push_back(root);
+	split(0);
+
+	for (size_t i = 0; i < _order.size(); ++i)
+		_orderedBoxes.set(i, _objectMin[_order[i]], _objectMax[_order[i]]);
+}
+
+void BoundingVolumeHierarchy::refit()
+{
+	for (size_t i = 0; i < _order.size(); ++i)
+		_orderedBoxes.set(i, _objectMin[_order[i]], _objectMax[_order[i]]);
+
+	// Children are always stored after their parent
+	for (size_t i = _nodes.size(); i-- > 0;)
+		fitNode(static_cast<GLuint>(i));
+}
+
+void BoundingVolumeHierarchy::split(GLuint node)
+{
+	GLuint first = _nodes[node].first;
+	GLuint count = _nodes[node].count;
+	if (count > MAX_OBJECTS_PER_LEAF)
+	{
+		// Split along the longest axis of the box around the centers of the objects
+		vmml::Vector3f centerMin = _objectMin[_order[first]] + _objectMax[_order[first]];
+		vmml::Vector3f centerMax = centerMin;
+		for (GLuint i = first + 1; i < first + count; ++i)
+		{
+			vmml::Vector3f center = _objectMin[_order[i]] + _objectMax[_order[i]];
+			for (int k = 0; k < 3; ++k)
+			{
+				centerMin[k] = std::min(centerMin[k], center[k]);
+				centerMax[k] = std::max(centerMax[k], center[k]);
+			}
+		}
+		vmml::Vector3f size = centerMax - centerMin;
+		int axis = size.x() > size.y() ? (size.x() > size.z() ? 0 : 2) : (size.y() > size.z() ? 1 : 2);
+
+		GLuint middle = first + count / 2;
+		std::nth_element(_order.begin() + first, _order.begin() + middle, _order.begin() + first + count, [this, axis](GLuint a, GLuint b)
+		{
+			return _objectMin[a][axis] + _objectMax[a][axis] < _objectMin[b][axis] + _objectMax[b][axis];
+		});
+
+		GLuint left = static_cast<GLuint>(_nodes.size());
+		Node child;
+		child.first = first;
+		child.count = middle - first;
+		_nodes.push_back(child);
+		child.first = middle;
+		child.count = first + count - middle;
+		_nodes.push_back(child);
+		_nodes[node].first = left;
+		_nodes[node].count = 0;
+
+		split(left);
+		split(left + 1);
+	}
+	fitNode(node);
+}
+
+void BoundingVolumeHierarchy::fitNode(GLuint node)
+{
+	Node &n = _nodes[node];
+	if (n.count == 0)
+	{
+		const Node &left = _nodes[n.first], &right = _nodes[n.first + 1];
+		for (int k = 0; k < 3; ++k)
+		{
+			n.min[k] = std::min(left.min[k], right.min[k]);
+			n.max[k] = std::max(left.max[k], right.max[k]);
+		}
+		return;
+	}
+	n.min = _objectMin[_order[n.first]];
+	n.max = _objectMax[_order[n.first]];
+	for (GLuint i = n.first + 1; i < n.first + n.count; ++i)
+	{
+		for (int k = 0; k < 3; ++k)
+		{
+			n.min[k] = std::min(n.min[k], _objectMin[_order[i]][k]);
+			n.max[k] = std::max(n.max[k], _objectMax[_order[i]][k]);
+		}
+	}
+}
@@ -3,12 +3,285 @@
 #include "headers/Logger.h"
 #include "headers/FileHandler.h"
 #include <fstream>
+#include <vector>
 
 namespace bRenderer
 {
 	Json::Value jsonValue;   // will contains the root value after parsing.
 	Json::Reader jsonReader;
-	
+
+	/* Reads a vector of three floats, falls back to the default if the array is too short */
+	vmml::Vector3f readVector3(const Json::Value &x, const vmml::Vector3f &defaultValue = vmml::Vector3f(0.0f))
+	{
+		if (x.size() < 3)
+			return defaultValue;
+		return vmml::Vector3f(x[0].asFloat(), x[1].asFloat(), x[2].asFloat());
+	}
+
+	/* All configuration values are read once into this cache so the accessors never need to query jsoncpp */
+	struct ConfigurationValues
+	{
+		ConfigurationValues() { read(Json::Value()); }
+
+		void read(const Json::Value &json)
+		{
+			/* Renderer configuration */
+			DEFAULT_AMBIENT_COLOR = readVector3(json["DEFAULT_AMBIENT_COLOR"]);
+
+			/* Logger */
+			LOG_MODE_INFO = json.get("LOG_MODE_INFO", "INFO").asString();
+			LOG_MODE_WARNING = json.get("LOG_MODE_WARNING", "WARNING").asString();
+			LOG_MODE_ERROR = json.get("LOG_MODE_ERROR", "ERROR").asString();
+			LOG_MODE_SYSTEM = json.get("LOG_MODE_SYSTEM", "SYSTEM").asString();
+
+			/* Desktop specific view configuration */
+			DEFAULT_VIEW_WIDTH = json.get("DEFAULT_VIEW_WIDTH", 640).asInt();
+			DEFAULT_VIEW_HEIGHT = json.get("DEFAULT_VIEW_HEIGHT", 480).asInt();
+			DEFAULT_WINDOW_TITLE = json.get("DEFAULT_WINDOW_TITLE", "bRenderer").asString();
+
+			/* Desktop specific file path configuration */
+			DEFAULT_FILE_PATH = json.get("DEFAULT_FILE_PATH", "data/").asString();
+
+			/* OBJ loader default group name */
+			DEFAULT_GROUP_NAME = json.get("DEFAULT_GROUP_NAME", "default").asString();
+
+			/* Binary model cache, the application bundle is read-only on iOS so only cooked caches are used there */
+#ifdef B_OS_DESKTOP
+			MODEL_CACHE_ENABLED = json.get("MODEL_CACHE_ENABLED", true).asBool();
+#else
+			MODEL_CACHE_ENABLED = json.get("MODEL_CACHE_ENABLED", false).asBool();
+#endif
+			MODEL_CACHE_FILE_EXTENSION = json.get("MODEL_CACHE_FILE_EXTENSION", ".bmesh").asString();
+			MODEL_CACHE_DIRECTORY = json.get("MODEL_CACHE_DIRECTORY", "cache/").asString();
+
+			/* Vertex cache optimization of loaded models */
+			MESH_OPTIMIZATION_ENABLED = json.get("MESH_OPTIMIZATION_ENABLED", true).asBool();
+
+			/* Models only keep their vertices and indices on the GPU */
+			RELEASE_GEOMETRY_CPU_DATA = json.get("RELEASE_GEOMETRY_CPU_DATA", false).asBool();
+
+			/* Levels of detail */
+			LOD_LEVELS = json.get("LOD_LEVELS", 0).asUInt();
+			LOD_REDUCTION = json.get("LOD_REDUCTION", 0.5f).asFloat();
+			LOD_SCREEN_SIZE = json.get("LOD_SCREEN_SIZE", 0.5f).asFloat();
+			LOD_HYSTERESIS = json.get("LOD_HYSTERESIS", 0.1f).asFloat();
+
+			/* Cooked textures */
+			COOKED_TEXTURE_FILE_EXTENSION = json.get("COOKED_TEXTURE_FILE_EXTENSION", ".btex").asString();
+
+			/* Shader macros*/
+			SHADER_VERSION_MACRO = json.get("SHADER_VERSION_MACRO", "$B_SHADER_VERSION").asString();
+			SHADER_MAX_LIGHTS_MACRO = json.get("SHADER_MAX_LIGHTS_MACRO", "$B_SHADER_MAX_LIGHTS").asString();
+
+			/* Shader configuration */
+			DEFAULT_SHADER_VERSION_DESKTOP = json.get("DEFAULT_SHADER_VERSION_DESKTOP", "#version 120").asString();
+			DEFAULT_SHADER_VERSION_ES = json.get("DEFAULT_SHADER_VERSION_ES", "#version 100").asString();
+			DEFAULT_SHADER_MAX_LIGHTS = json.get("DEFAULT_SHADER_MAX_LIGHTS", 3).asUInt();
+			DEFAULT_FRAGMENT_SHADER_FILENAME_EXTENSION = json.get("DEFAULT_FRAGMENT_SHADER_FILENAME_EXTENSION", ".frag").asString();
+			DEFAULT_VERTEX_SHADER_FILENAME_EXTENSION = json.get("DEFAULT_VERTEX_SHADER_FILENAME_EXTENSION", ".vert").asString();
+
+			/* Shader uniforms */
+			DEFAULT_SHADER_UNIFORM_DIFFUSE_MAP = json.get("DEFAULT_SHADER_UNIFORM_DIFFUSE_MAP", "DiffuseMap").asString();
+			DEFAULT_SHADER_UNIFORM_SPECULAR_MAP = json.get("DEFAULT_SHADER_UNIFORM_SPECULAR_MAP", "SpecularMap").asString();
+			DEFAULT_SHADER_UNIFORM_NORMAL_MAP = json.get("DEFAULT_SHADER_UNIFORM_NORMAL_MAP", "NormalMap").asString();
+			DEFAULT_SHADER_UNIFORM_CUBE_MAP = json.get("DEFAULT_SHADER_UNIFORM_CUBE_MAP", "CubeMap").asString();
+			DEFAULT_SHADER_UNIFORM_SPHERE_MAP = json.get("DEFAULT_SHADER_UNIFORM_SPHERE_MAP", "SphereMap").asString();
+			DEFAULT_SHADER_UNIFORM_CHARACTER_MAP = json.get("DEFAULT_SHADER_UNIFORM_CHARACTER_MAP", "CharacterMap").asString();
+			DEFAULT_SHADER_UNIFORM_NORMAL_MATRIX = json.get("DEFAULT_SHADER_UNIFORM_NORMAL_MATRIX", "NormalMatrix").asString();
+			DEFAULT_SHADER_UNIFORM_MODEL_MATRIX = json.get("DEFAULT_SHADER_UNIFORM_MODEL_MATRIX", "ModelMatrix").asString();
+			DEFAULT_SHADER_UNIFORM_VIEW_MATRIX = json.get("DEFAULT_SHADER_UNIFORM_VIEW_MATRIX", "ViewMatrix").asString();
+			DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX = json.get("DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX", "ModelViewMatrix").asString();
+			DEFAULT_SHADER_UNIFORM_INVERSE_VIEW_MATRIX = json.get("DEFAULT_SHADER_UNIFORM_INVERSE_VIEW_MATRIX", "InverseViewMatrix").asString();
+			DEFAULT_SHADER_UNIFORM_PROJECTION_MATRIX = json.get("DEFAULT_SHADER_UNIFORM_PROJECTION_MATRIX", "ProjectionMatrix").asString();
+			DEFAULT_SHADER_UNIFORM_NUMBER_OF_LIGHTS = json.get("DEFAULT_SHADER_UNIFORM_NUMBER_OF_LIGHTS", "numLights").asString();
+			DEFAULT_SHADER_UNIFORM_LIGHT_POSITION_VIEW_SPACE = json.get("DEFAULT_SHADER_UNIFORM_LIGHT_POSITION_VIEW_SPACE", "lightPositionViewSpace_").asString();
+			DEFAULT_SHADER_UNIFORM_DIFFUSE_LIGHT_COLOR = json.get("DEFAULT_SHADER_UNIFORM_DIFFUSE_LIGHT_COLOR", "lightDiffuseColor_").asString();
+			DEFAULT_SHADER_UNIFORM_SPECULAR_LIGHT_COLOR = json.get("DEFAULT_SHADER_UNIFORM_SPECULAR_LIGHT_COLOR", "lightSpecularColor_").asString();
+			DEFAULT_SHADER_UNIFORM_LIGHT_INTENSITY = json.get("DEFAULT_SHADER_UNIFORM_LIGHT_INTENSITY", "lightIntensity_").asString();
+			DEFAULT_SHADER_UNIFORM_LIGHT_ATTENUATION = json.get("DEFAULT_SHADER_UNIFORM_LIGHT_ATTENUATION", "lightAttenuation_").asString();
+			DEFAULT_SHADER_UNIFORM_LIGHT_RADIUS = json.get("DEFAULT_SHADER_UNIFORM_LIGHT_RADIUS", "lightRadius_").asString();
+			DEFAULT_SHADER_UNIFORM_AMBIENT_COLOR = json.get("DEFAULT_SHADER_UNIFORM_AMBIENT_COLOR", "ambientColor").asString();
+			DEFAULT_SHADER_UNIFORM_TRANSPARENCY = json.get("DEFAULT_SHADER_UNIFORM_TRANSPARENCY", "transparency").asString();
+
+			/* Shader attributes */
+			DEFAULT_SHADER_ATTRIBUTE_POSITION = json.get("DEFAULT_SHADER_ATTRIBUTE_POSITION", "Position").asString();
+			DEFAULT_SHADER_ATTRIBUTE_NORMAL = json.get("DEFAULT_SHADER_ATTRIBUTE_NORMAL", "Normal").asString();
+			DEFAULT_SHADER_ATTRIBUTE_TANGENT = json.get("DEFAULT_SHADER_ATTRIBUTE_TANGENT", "Tangent").asString();
+			DEFAULT_SHADER_ATTRIBUTE_BITANGENT = json.get("DEFAULT_SHADER_ATTRIBUTE_BITANGENT", "Bitangent").asString();
+			DEFAULT_SHADER_ATTRIBUTE_TEXCOORD = json.get("DEFAULT_SHADER_ATTRIBUTE_TEXCOORD", "TexCoord").asString();
+			DEFAULT_SHADER_ATTRIBUTE_INSTANCE_MODEL_VIEW_MATRIX = json.get("DEFAULT_SHADER_ATTRIBUTE_INSTANCE_MODEL_VIEW_MATRIX", "InstanceModelViewMatrix").asString();
+
+			/* Material key words */
+			WAVEFRONT_MATERIAL_NEWMTL = json.get("WAVEFRONT_MATERIAL_NEWMTL", "newmtl").asString();
+			WAVEFRONT_MATERIAL_AMBIENT_COLOR = json.get("WAVEFRONT_MATERIAL_AMBIENT_COLOR", "Ka").asString();
+			WAVEFRONT_MATERIAL_DIFFUSE_COLOR = json.get("WAVEFRONT_MATERIAL_DIFFUSE_COLOR", "Kd").asString();
+			WAVEFRONT_MATERIAL_SPECULAR_COLOR = json.get("WAVEFRONT_MATERIAL_SPECULAR_COLOR", "Ks").asString();
+			WAVEFRONT_MATERIAL_TRANSMISSION_FILTER = json.get("WAVEFRONT_MATERIAL_TRANSMISSION_FILTER", "Tf").asString();
+			WAVEFRONT_MATERIAL_SPECULAR_EXPONENT = json.get("WAVEFRONT_MATERIAL_SPECULAR_EXPONENT", "Ns").asString();
+			WAVEFRONT_MATERIAL_OPTICAL_DENSITY = json.get("WAVEFRONT_MATERIAL_OPTICAL_DENSITY", "Ni").asString();
+			WAVEFRONT_MATERIAL_ILLUMINATION_MODEL = json.get("WAVEFRONT_MATERIAL_ILLUMINATION_MODEL", "illum").asString();
+			WAVEFRONT_MATERIAL_DIFFUSE_MAP = json.get("WAVEFRONT_MATERIAL_DIFFUSE_MAP", "map_Kd").asString();
+			WAVEFRONT_MATERIAL_SPECULAR_MAP = json.get("WAVEFRONT_MATERIAL_SPECULAR_MAP", "map_Ks").asString();
+			WAVEFRONT_MATERIAL_NORMAL_MAP = json.get("WAVEFRONT_MATERIAL_NORMAL_MAP", "map_Bump").asString();
+			WAVEFRONT_MATERIAL_DISSOLVE = json.get("WAVEFRONT_MATERIAL_DISSOLVE", "d").asString();
+			WAVEFRONT_MATERIAL_REFLECTION = json.get("WAVEFRONT_MATERIAL_REFLECTION", "refl").asString();
+			WAVEFRONT_MATERIAL_REFLECTION_TYPE = json.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE", "-type").asString();
+			WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_TOP = json.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_TOP", "cube_top").asString();
+			WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BOTTOM = json.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BOTTOM", "cube_bottom").asString();
+			WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_FRONT = json.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_FRONT", "cube_front").asString();
+			WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BACK = json.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BACK", "cube_back").asString();
+			WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_LEFT = json.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_LEFT", "cube_left").asString();
+			WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_RIGHT = json.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_RIGHT", "cube_right").asString();
+			WAVEFRONT_MATERIAL_REFLECTION_TYPE_SPHERE = json.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE_SPHERE", "sphere").asString();
+
+			/* Camera configuration */
+			DEFAULT_FIELD_OF_VIEW = json.get("DEFAULT_FIELD_OF_VIEW", 60.0f).asFloat();
+			DEFAULT_ASPECT_RATIO = json.get("DEFAULT_ASPECT_RATIO", 4.0f / 3.0f).asFloat();
+			DEFAULT_NEAR_CLIPPING_PLANE = json.get("DEFAULT_NEAR_CLIPPING_PLANE", -1.0f).asFloat();
+			DEFAULT_FAR_CLIPPING_PLANE = json.get("DEFAULT_FAR_CLIPPING_PLANE", 1.0f).asFloat();
+			DEFAULT_CAMERA_POSITION = readVector3(json["DEFAULT_CAMERA_POSITION"]);
+			DEFAULT_CAMERA_ROTATION_AXES = readVector3(json["DEFAULT_CAMERA_ROTATION_AXES"]);
+
+			/* Light configuration */
+			DEFAULT_LIGHT_POSITION = vmml::Vector4f(readVector3(json["DEFAULT_LIGHT_POSITION"]), 1.0f);
+			DEFAULT_LIGHT_COLOR = readVector3(json["DEFAULT_LIGHT_COLOR"], vmml::Vector3f(1.0f, 1.0f, 1.0f));
+			DEFAULT_LIGHT_INTENSITY = json.get("DEFAULT_LIGHT_INTENSITY", 1000.0f).asFloat();
+			DEFAULT_LIGHT_ATTENUATION = json.get("DEFAULT_LIGHT_ATTENUATION", 1.0f).asFloat();
+			DEFAULT_LIGHT_RADIUS = json.get("DEFAULT_LIGHT_RADIUS", 10000.0f).asFloat();
+
+			/* Font configuration */
+			FONT_MAX_PIXEL_SIZE = json.get("FONT_MAX_PIXEL_SIZE", 512).asUInt();
+		}
+
+		/* Renderer configuration */
+		vmml::Vector3f DEFAULT_AMBIENT_COLOR;
+
+		/* Logger */
+		std::string LOG_MODE_INFO;
+		std::string LOG_MODE_WARNING;
+		std::string LOG_MODE_ERROR;
+		std::string LOG_MODE_SYSTEM;
+
+		/* Desktop specific view configuration */
+		GLint DEFAULT_VIEW_WIDTH;
+		GLint DEFAULT_VIEW_HEIGHT;
+		std::string DEFAULT_WINDOW_TITLE;
+
+		/* Desktop specific file path configuration */
+		std::string DEFAULT_FILE_PATH;
+
+		/* OBJ loader default group name */
+		std::string DEFAULT_GROUP_NAME;
+
+		/* Binary model cache */
+		bool MODEL_CACHE_ENABLED;
+		std::string MODEL_CACHE_FILE_EXTENSION;
+		std::string MODEL_CACHE_DIRECTORY;
+		bool MESH_OPTIMIZATION_ENABLED;
+		bool RELEASE_GEOMETRY_CPU_DATA;
+		GLuint LOD_LEVELS;
+		GLfloat LOD_REDUCTION;
+		GLfloat LOD_SCREEN_SIZE;
+		GLfloat LOD_HYSTERESIS;
+		std::string COOKED_TEXTURE_FILE_EXTENSION;
+
+		/* Shader macros*/
+		std::string SHADER_VERSION_MACRO;
+		std::string SHADER_MAX_LIGHTS_MACRO;
+
+		/* Shader configuration */
+		std::string DEFAULT_SHADER_VERSION_DESKTOP;
+		std::string DEFAULT_SHADER_VERSION_ES;
+		GLuint DEFAULT_SHADER_MAX_LIGHTS;
+		std::string DEFAULT_FRAGMENT_SHADER_FILENAME_EXTENSION;
+		std::string DEFAULT_VERTEX_SHADER_FILENAME_EXTENSION;
+
+		/* Shader uniforms */
+		std::string DEFAULT_SHADER_UNIFORM_DIFFUSE_MAP;
+		std::string DEFAULT_SHADER_UNIFORM_SPECULAR_MAP;
+		std::string DEFAULT_SHADER_UNIFORM_NORMAL_MAP;
+		std::string DEFAULT_SHADER_UNIFORM_CUBE_MAP;
+		std::string DEFAULT_SHADER_UNIFORM_SPHERE_MAP;
+		std::string DEFAULT_SHADER_UNIFORM_CHARACTER_MAP;
+		std::string DEFAULT_SHADER_UNIFORM_NORMAL_MATRIX;
+		std::string DEFAULT_SHADER_UNIFORM_MODEL_MATRIX;
+		std::string DEFAULT_SHADER_UNIFORM_VIEW_MATRIX;
+		std::string DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX;
+		std::string DEFAULT_SHADER_UNIFORM_INVERSE_VIEW_MATRIX;
+		std::string DEFAULT_SHADER_UNIFORM_PROJECTION_MATRIX;
+		std::string DEFAULT_SHADER_UNIFORM_NUMBER_OF_LIGHTS;
+		std::string DEFAULT_SHADER_UNIFORM_LIGHT_POSITION_VIEW_SPACE;
+		std::string DEFAULT_SHADER_UNIFORM_DIFFUSE_LIGHT_COLOR;
+		std::string DEFAULT_SHADER_UNIFORM_SPECULAR_LIGHT_COLOR;
+		std::string DEFAULT_SHADER_UNIFORM_LIGHT_INTENSITY;
+		std::string DEFAULT_SHADER_UNIFORM_LIGHT_ATTENUATION;
+		std::string DEFAULT_SHADER_UNIFORM_LIGHT_RADIUS;
+		std::string DEFAULT_SHADER_UNIFORM_AMBIENT_COLOR;
+		std::string DEFAULT_SHADER_UNIFORM_TRANSPARENCY;
+
+		/* Shader attributes */
+		std::string DEFAULT_SHADER_ATTRIBUTE_POSITION;
+		std::string DEFAULT_SHADER_ATTRIBUTE_NORMAL;
+		std::string DEFAULT_SHADER_ATTRIBUTE_TANGENT;
+		std::string DEFAULT_SHADER_ATTRIBUTE_BITANGENT;
+		std::string DEFAULT_SHADER_ATTRIBUTE_TEXCOORD;
+		std::string DEFAULT_SHADER_ATTRIBUTE_INSTANCE_MODEL_VIEW_MATRIX;
+
+		/* Material key words */
+		std::string WAVEFRONT_MATERIAL_NEWMTL;
+		std::string WAVEFRONT_MATERIAL_AMBIENT_COLOR;
+		std::string WAVEFRONT_MATERIAL_DIFFUSE_COLOR;
+		std::string WAVEFRONT_MATERIAL_SPECULAR_COLOR;
+		std::string WAVEFRONT_MATERIAL_TRANSMISSION_FILTER;
+		std::string WAVEFRONT_MATERIAL_SPECULAR_EXPONENT;
+		std::string WAVEFRONT_MATERIAL_OPTICAL_DENSITY;
+		std::string WAVEFRONT_MATERIAL_ILLUMINATION_MODEL;
+		std::string WAVEFRONT_MATERIAL_DIFFUSE_MAP;
+		std::string WAVEFRONT_MATERIAL_SPECULAR_MAP;
+		std::string WAVEFRONT_MATERIAL_NORMAL_MAP;
+		std::string WAVEFRONT_MATERIAL_DISSOLVE;
+		std::string WAVEFRONT_MATERIAL_REFLECTION;
+		std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE;
+		std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_TOP;
+		std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BOTTOM;
+		std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_FRONT;
+		std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BACK;
+		std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_LEFT;
+		std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_RIGHT;
+		std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_SPHERE;
+
+		/* Camera configuration */
+		GLfloat DEFAULT_FIELD_OF_VIEW;
+		GLfloat DEFAULT_ASPECT_RATIO;
+		GLfloat DEFAULT_NEAR_CLIPPING_PLANE;
+		GLfloat DEFAULT_FAR_CLIPPING_PLANE;
+		vmml::Vector3f DEFAULT_CAMERA_POSITION;
+		vmml::Vector3f DEFAULT_CAMERA_ROTATION_AXES;
+
+		/* Light configuration */
+		vmml::Vector4f DEFAULT_LIGHT_POSITION;
+		vmml::Vector3f DEFAULT_LIGHT_COLOR;
+		GLfloat DEFAULT_LIGHT_INTENSITY;
+		GLfloat DEFAULT_LIGHT_ATTENUATION;
+		GLfloat DEFAULT_LIGHT_RADIUS;
+
+		/* Font configuration */
+		GLuint FONT_MAX_PIXEL_SIZE;
+	};
+
+	/* The cache is created on first use since some configurations are already needed during static initialization */
+	ConfigurationValues &configuration()
+	{
+		static ConfigurationValues values;
+		return values;
+	}
+
+	std::vector<void(*)()> &configReloadFunctions()
+	{
+		static std::vector<void(*)()> functions;
+		return functions;
+	}
+
 	bool loadConfigFile(const std::string &fileName){
 		std::ifstream file(getFilePath(fileName), std::ifstream::in);
 		if (!jsonReader.parse(file, jsonValue))
@@ -16,127 +289,131 @@ namespace bRenderer
 			log("Failed to parse configurations file: " + jsonReader.getFormattedErrorMessages(), LM_ERROR);
 			return false;
 		}
+		// Values are overwritten in place so references handed out before stay valid
+		configuration().read(jsonValue);
+		for (auto f : configReloadFunctions())
+			f();
 		return true;
 	}
 
-	/* Renderer configuration */
-	vmml::Vector3f DEFAULT_AMBIENT_COLOR() { 
-		const Json::Value x = jsonValue["DEFAULT_AMBIENT_COLOR"];
-		return vmml::Vector3f(x[0].asFloat(), x[1].asFloat(), x[2].asFloat());
+	void addConfigReloadFunction(void(*f)())
+	{
+		configReloadFunctions().push_back(f);
 	}
 
+	/* Renderer configuration */
+	const vmml::Vector3f &DEFAULT_AMBIENT_COLOR() { return configuration().DEFAULT_AMBIENT_COLOR; }
+
 	/* Logger */
-	std::string LOG_MODE_INFO() { return jsonValue.get("LOG_MODE_INFO", "INFO").asString(); }
-	std::string LOG_MODE_WARNING() { return jsonValue.get("LOG_MODE_WARNING", "WARNING").asString(); }
-	std::string LOG_MODE_ERROR() { return jsonValue.get("LOG_MODE_ERROR", "ERROR").asString(); }
-	std::string LOG_MODE_SYSTEM() { return jsonValue.get("LOG_MODE_SYSTEM", "SYSTEM").asString(); }
+	const std::string &LOG_MODE_INFO() { return configuration().LOG_MODE_INFO; }
+	const std::string &LOG_MODE_WARNING() { return configuration().LOG_MODE_WARNING; }
+	const std::string &LOG_MODE_ERROR() { return configuration().LOG_MODE_ERROR; }
+	const std::string &LOG_MODE_SYSTEM() { return configuration().LOG_MODE_SYSTEM; }
 
 	/* Desktop specific view configuration */
-	GLint DEFAULT_VIEW_WIDTH() { return jsonValue.get("DEFAULT_VIEW_WIDTH", 640).asInt(); }
-	GLint DEFAULT_VIEW_HEIGHT() { return jsonValue.get("DEFAULT_VIEW_HEIGHT", 480).asInt(); }
-	std::string DEFAULT_WINDOW_TITLE() { return jsonValue.get("DEFAULT_WINDOW_TITLE", "bRenderer").asString(); }
+	GLint DEFAULT_VIEW_WIDTH() { return configuration().DEFAULT_VIEW_WIDTH; }
+	GLint DEFAULT_VIEW_HEIGHT() { return configuration().DEFAULT_VIEW_HEIGHT; }
+	const std::string &DEFAULT_WINDOW_TITLE() { return configuration().DEFAULT_WINDOW_TITLE; }
 
 	/* Desktop specific file path configuration */
-	std::string DEFAULT_FILE_PATH() { return jsonValue.get("DEFAULT_FILE_PATH", "data/").asString(); }
+	const std::string &DEFAULT_FILE_PATH() { return configuration().DEFAULT_FILE_PATH; }
 
 	/* OBJ loader default group name */
-	std::string DEFAULT_GROUP_NAME() { return jsonValue.get("DEFAULT_GROUP_NAME", "default").asString(); }
+	const std::string &DEFAULT_GROUP_NAME() { return configuration().DEFAULT_GROUP_NAME; }
+
+	/* Binary model cache */
+	bool MODEL_CACHE_ENABLED() { return configuration().MODEL_CACHE_ENABLED; }
+	const std::string &MODEL_CACHE_FILE_EXTENSION() { return configuration().MODEL_CACHE_FILE_EXTENSION; }
+	const std::string &MODEL_CACHE_DIRECTORY() { return configuration().MODEL_CACHE_DIRECTORY; }
+	bool MESH_OPTIMIZATION_ENABLED() { return configuration().MESH_OPTIMIZATION_ENABLED; }
+	bool RELEASE_GEOMETRY_CPU_DATA() { return configuration().RELEASE_GEOMETRY_CPU_DATA; }
+	GLuint LOD_LEVELS() { return configuration().LOD_LEVELS; }
+	GLfloat LOD_REDUCTION() { return configuration().LOD_REDUCTION; }
+	GLfloat LOD_SCREEN_SIZE() { return configuration().LOD_SCREEN_SIZE; }
+	GLfloat LOD_HYSTERESIS() { return configuration().LOD_HYSTERESIS; }
+	const std::string &COOKED_TEXTURE_FILE_EXTENSION() { return configuration().COOKED_TEXTURE_FILE_EXTENSION; }
 
 	/* Shader macros*/
-	std::string SHADER_VERSION_MACRO() { return jsonValue.get("SHADER_VERSION_MACRO", "$B_SHADER_VERSION").asString(); }
-	std::string SHADER_MAX_LIGHTS_MACRO() { return jsonValue.get("SHADER_MAX_LIGHTS_MACRO", "$B_SHADER_MAX_LIGHTS").asString(); }
+	const std::string &SHADER_VERSION_MACRO() { return configuration().SHADER_VERSION_MACRO; }
+	const std::string &SHADER_MAX_LIGHTS_MACRO() { return configuration().SHADER_MAX_LIGHTS_MACRO; }
 
 	/* Shader configuration */
-	std::string DEFAULT_SHADER_VERSION_DESKTOP() { return jsonValue.get("DEFAULT_SHADER_VERSION_DESKTOP", "#version 120").asString(); }
-	std::string DEFAULT_SHADER_VERSION_ES() { return jsonValue.get("DEFAULT_SHADER_VERSION_ES", "#version 100").asString(); }
-	GLuint DEFAULT_SHADER_MAX_LIGHTS() { return jsonValue.get("DEFAULT_SHADER_MAX_LIGHTS", 3).asUInt(); }
-	std::string DEFAULT_FRAGMENT_SHADER_FILENAME_EXTENSION() { return jsonValue.get("DEFAULT_FRAGMENT_SHADER_FILENAME_EXTENSION", ".frag").asString(); }
-	std::string DEFAULT_VERTEX_SHADER_FILENAME_EXTENSION() { return jsonValue.get("DEFAULT_VERTEX_SHADER_FILENAME_EXTENSION", ".vert").asString(); }
+	const std::string &DEFAULT_SHADER_VERSION_DESKTOP() { return configuration().DEFAULT_SHADER_VERSION_DESKTOP; }
+	const std::string &DEFAULT_SHADER_VERSION_ES() { return configuration().DEFAULT_SHADER_VERSION_ES; }
+	GLuint DEFAULT_SHADER_MAX_LIGHTS() { return configuration().DEFAULT_SHADER_MAX_LIGHTS; }
+	const std::string &DEFAULT_FRAGMENT_SHADER_FILENAME_EXTENSION() { return configuration().DEFAULT_FRAGMENT_SHADER_FILENAME_EXTENSION; }
+	const std::string &DEFAULT_VERTEX_SHADER_FILENAME_EXTENSION() { return configuration().DEFAULT_VERTEX_SHADER_FILENAME_EXTENSION; }
 
 	/* Shader uniforms */
-	std::string DEFAULT_SHADER_UNIFORM_DIFFUSE_MAP() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_DIFFUSE_MAP", "DiffuseMap").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_SPECULAR_MAP() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_SPECULAR_MAP", "SpecularMap").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_NORMAL_MAP() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_NORMAL_MAP", "NormalMap").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_CUBE_MAP() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_CUBE_MAP", "CubeMap").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_SPHERE_MAP() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_SPHERE_MAP", "SphereMap").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_CHARACTER_MAP() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_CHARACTER_MAP", "CharacterMap").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_NORMAL_MATRIX() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_NORMAL_MATRIX", "NormalMatrix").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_MODEL_MATRIX() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_MODEL_MATRIX", "ModelMatrix").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_VIEW_MATRIX() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_VIEW_MATRIX", "ViewMatrix").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX", "ModelViewMatrix").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_INVERSE_VIEW_MATRIX()  { return jsonValue.get("DEFAULT_SHADER_UNIFORM_INVERSE_VIEW_MATRIX", "InverseViewMatrix").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_PROJECTION_MATRIX() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_PROJECTION_MATRIX", "ProjectionMatrix").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_NUMBER_OF_LIGHTS() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_NUMBER_OF_LIGHTS", "numLights").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_LIGHT_POSITION_VIEW_SPACE() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_LIGHT_POSITION_VIEW_SPACE", "lightPositionViewSpace_").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_DIFFUSE_LIGHT_COLOR() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_DIFFUSE_LIGHT_COLOR", "lightDiffuseColor_").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_SPECULAR_LIGHT_COLOR() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_SPECULAR_LIGHT_COLOR", "lightSpecularColor_").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_LIGHT_INTENSITY() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_LIGHT_INTENSITY", "lightIntensity_").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_LIGHT_ATTENUATION() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_LIGHT_ATTENUATION", "lightAttenuation_").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_LIGHT_RADIUS() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_LIGHT_RADIUS", "lightRadius_").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_AMBIENT_COLOR() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_AMBIENT_COLOR", "ambientColor").asString(); }
-	std::string DEFAULT_SHADER_UNIFORM_TRANSPARENCY() { return jsonValue.get("DEFAULT_SHADER_UNIFORM_TRANSPARENCY", "transparency").asString(); }
+	const std::string &DEFAULT_SHADER_UNIFORM_DIFFUSE_MAP() { return configuration().DEFAULT_SHADER_UNIFORM_DIFFUSE_MAP; }
+	const std::string &DEFAULT_SHADER_UNIFORM_SPECULAR_MAP() { return configuration().DEFAULT_SHADER_UNIFORM_SPECULAR_MAP; }
+	const std::string &DEFAULT_SHADER_UNIFORM_NORMAL_MAP() { return configuration().DEFAULT_SHADER_UNIFORM_NORMAL_MAP; }
+	const std::string &DEFAULT_SHADER_UNIFORM_CUBE_MAP() { return configuration().DEFAULT_SHADER_UNIFORM_CUBE_MAP; }
+	const std::string &DEFAULT_SHADER_UNIFORM_SPHERE_MAP() { return configuration().DEFAULT_SHADER_UNIFORM_SPHERE_MAP; }
+	const std::string &DEFAULT_SHADER_UNIFORM_CHARACTER_MAP() { return configuration().DEFAULT_SHADER_UNIFORM_CHARACTER_MAP; }
+	const std::string &DEFAULT_SHADER_UNIFORM_NORMAL_MATRIX() { return configuration().DEFAULT_SHADER_UNIFORM_NORMAL_MATRIX; }
+	const std::string &DEFAULT_SHADER_UNIFORM_MODEL_MATRIX() { return configuration().DEFAULT_SHADER_UNIFORM_MODEL_MATRIX; }
+	const std::string &DEFAULT_SHADER_UNIFORM_VIEW_MATRIX() { return configuration().DEFAULT_SHADER_UNIFORM_VIEW_MATRIX; }
+	const std::string &DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX() { return configuration().DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX; }
+	const std::string &DEFAULT_SHADER_UNIFORM_INVERSE_VIEW_MATRIX() { return configuration().DEFAULT_SHADER_UNIFORM_INVERSE_VIEW_MATRIX; }
+	const std::string &DEFAULT_SHADER_UNIFORM_PROJECTION_MATRIX() { return configuration().DEFAULT_SHADER_UNIFORM_PROJECTION_MATRIX; }
+	const std::string &DEFAULT_SHADER_UNIFORM_NUMBER_OF_LIGHTS() { return configuration().DEFAULT_SHADER_UNIFORM_NUMBER_OF_LIGHTS; }
+	const std::string &DEFAULT_SHADER_UNIFORM_LIGHT_POSITION_VIEW_SPACE() { return configuration().DEFAULT_SHADER_UNIFORM_LIGHT_POSITION_VIEW_SPACE; }
+	const std::string &DEFAULT_SHADER_UNIFORM_DIFFUSE_LIGHT_COLOR() { return configuration().DEFAULT_SHADER_UNIFORM_DIFFUSE_LIGHT_COLOR; }
+	const std::string &DEFAULT_SHADER_UNIFORM_SPECULAR_LIGHT_COLOR() { return configuration().DEFAULT_SHADER_UNIFORM_SPECULAR_LIGHT_COLOR; }
+	const std::string &DEFAULT_SHADER_UNIFORM_LIGHT_INTENSITY() { return configuration().DEFAULT_SHADER_UNIFORM_LIGHT_INTENSITY; }
+	const std::string &DEFAULT_SHADER_UNIFORM_LIGHT_ATTENUATION() { return configuration().DEFAULT_SHADER_UNIFORM_LIGHT_ATTENUATION; }
+	const std::string &DEFAULT_SHADER_UNIFORM_LIGHT_RADIUS() { return configuration().DEFAULT_SHADER_UNIFORM_LIGHT_RADIUS; }
+	const std::string &DEFAULT_SHADER_UNIFORM_AMBIENT_COLOR() { return configuration().DEFAULT_SHADER_UNIFORM_AMBIENT_COLOR; }
+	const std::string &DEFAULT_SHADER_UNIFORM_TRANSPARENCY() { return configuration().DEFAULT_SHADER_UNIFORM_TRANSPARENCY; }
 
 	/* Shader attributes */
-	std::string DEFAULT_SHADER_ATTRIBUTE_POSITION() { return jsonValue.get("DEFAULT_SHADER_ATTRIBUTE_POSITION", "Position").asString(); }
-	std::string DEFAULT_SHADER_ATTRIBUTE_NORMAL() { return jsonValue.get("DEFAULT_SHADER_ATTRIBUTE_NORMAL", "Normal").asString(); }
-	std::string DEFAULT_SHADER_ATTRIBUTE_TANGENT() { return jsonValue.get("DEFAULT_SHADER_ATTRIBUTE_TANGENT", "Tangent").asString(); }
-	std::string DEFAULT_SHADER_ATTRIBUTE_BITANGENT() { return jsonValue.get("DEFAULT_SHADER_ATTRIBUTE_BITANGENT", "Bitangent").asString(); }
-	std::string DEFAULT_SHADER_ATTRIBUTE_TEXCOORD() { return jsonValue.get("DEFAULT_SHADER_ATTRIBUTE_TEXCOORD", "TexCoord").asString(); }
+	const std::string &DEFAULT_SHADER_ATTRIBUTE_POSITION() { return configuration().DEFAULT_SHADER_ATTRIBUTE_POSITION; }
+	const std::string &DEFAULT_SHADER_ATTRIBUTE_NORMAL() { return configuration().DEFAULT_SHADER_ATTRIBUTE_NORMAL; }
+	const std::string &DEFAULT_SHADER_ATTRIBUTE_TANGENT() { return configuration().DEFAULT_SHADER_ATTRIBUTE_TANGENT; }
+	const std::string &DEFAULT_SHADER_ATTRIBUTE_BITANGENT() { return configuration().DEFAULT_SHADER_ATTRIBUTE_BITANGENT; }
+	const std::string &DEFAULT_SHADER_ATTRIBUTE_TEXCOORD() { return configuration().DEFAULT_SHADER_ATTRIBUTE_TEXCOORD; }
+	const std::string &DEFAULT_SHADER_ATTRIBUTE_INSTANCE_MODEL_VIEW_MATRIX() { return configuration().DEFAULT_SHADER_ATTRIBUTE_INSTANCE_MODEL_VIEW_MATRIX; }
 
 	/* Material key words */
-	std::string WAVEFRONT_MATERIAL_NEWMTL() { return jsonValue.get("WAVEFRONT_MATERIAL_NEWMTL", "newmtl").asString(); }
-	std::string WAVEFRONT_MATERIAL_AMBIENT_COLOR() { return jsonValue.get("WAVEFRONT_MATERIAL_AMBIENT_COLOR", "Ka").asString(); }
-	std::string WAVEFRONT_MATERIAL_DIFFUSE_COLOR() { return jsonValue.get("WAVEFRONT_MATERIAL_DIFFUSE_COLOR", "Kd").asString(); }
-	std::string WAVEFRONT_MATERIAL_SPECULAR_COLOR() { return jsonValue.get("WAVEFRONT_MATERIAL_SPECULAR_COLOR", "Ks").asString(); }
-	std::string WAVEFRONT_MATERIAL_TRANSMISSION_FILTER() { return jsonValue.get("WAVEFRONT_MATERIAL_TRANSMISSION_FILTER", "Tf").asString(); }
-	std::string WAVEFRONT_MATERIAL_SPECULAR_EXPONENT() { return jsonValue.get("WAVEFRONT_MATERIAL_SPECULAR_EXPONENT", "Ns").asString(); }
-	std::string WAVEFRONT_MATERIAL_OPTICAL_DENSITY() { return jsonValue.get("WAVEFRONT_MATERIAL_OPTICAL_DENSITY", "Ni").asString(); }
-	std::string WAVEFRONT_MATERIAL_ILLUMINATION_MODEL() { return jsonValue.get("WAVEFRONT_MATERIAL_ILLUMINATION_MODEL", "illum").asString(); }
-	std::string WAVEFRONT_MATERIAL_DIFFUSE_MAP() { return jsonValue.get("WAVEFRONT_MATERIAL_DIFFUSE_MAP", "map_Kd").asString(); }
-	std::string WAVEFRONT_MATERIAL_SPECULAR_MAP() { return jsonValue.get("WAVEFRONT_MATERIAL_SPECULAR_MAP", "map_Ks").asString(); }
-	std::string WAVEFRONT_MATERIAL_NORMAL_MAP() { return jsonValue.get("WAVEFRONT_MATERIAL_NORMAL_MAP", "map_Bump").asString(); }
-	std::string WAVEFRONT_MATERIAL_DISSOLVE() { return jsonValue.get("WAVEFRONT_MATERIAL_DISSOLVE", "d").asString(); }
-	std::string WAVEFRONT_MATERIAL_REFLECTION() { return jsonValue.get("WAVEFRONT_MATERIAL_REFLECTION", "refl").asString(); }
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE() { return jsonValue.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE", "-type").asString(); }
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_TOP() { return jsonValue.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_TOP", "cube_top").asString(); }
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BOTTOM() { return jsonValue.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BOTTOM", "cube_bottom").asString(); }
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_FRONT() { return jsonValue.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_FRONT", "cube_front").asString(); }
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BACK() { return jsonValue.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BACK", "cube_back").asString(); }
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_LEFT() { return jsonValue.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_LEFT", "cube_left").asString(); }
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_RIGHT() { return jsonValue.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_RIGHT", "cube_right").asString(); }
-	std::string WAVEFRONT_MATERIAL_REFLECTION_TYPE_SPHERE() { return jsonValue.get("WAVEFRONT_MATERIAL_REFLECTION_TYPE_SPHERE", "sphere").asString(); }
+	const std::string &WAVEFRONT_MATERIAL_NEWMTL() { return configuration().WAVEFRONT_MATERIAL_NEWMTL; }
+	const std::string &WAVEFRONT_MATERIAL_AMBIENT_COLOR() { return configuration().WAVEFRONT_MATERIAL_AMBIENT_COLOR; }
+	const std::string &WAVEFRONT_MATERIAL_DIFFUSE_COLOR() { return configuration().WAVEFRONT_MATERIAL_DIFFUSE_COLOR; }
+	const std::string &WAVEFRONT_MATERIAL_SPECULAR_COLOR() { return configuration().WAVEFRONT_MATERIAL_SPECULAR_COLOR; }
+	const std::string &WAVEFRONT_MATERIAL_TRANSMISSION_FILTER() { return configuration().WAVEFRONT_MATERIAL_TRANSMISSION_FILTER; }
+	const std::string &WAVEFRONT_MATERIAL_SPECULAR_EXPONENT() { return configuration().WAVEFRONT_MATERIAL_SPECULAR_EXPONENT; }
+	const std::string &WAVEFRONT_MATERIAL_OPTICAL_DENSITY() { return configuration().WAVEFRONT_MATERIAL_OPTICAL_DENSITY; }
+	const std::string &WAVEFRONT_MATERIAL_ILLUMINATION_MODEL() { return configuration().WAVEFRONT_MATERIAL_ILLUMINATION_MODEL; }
+	const std::string &WAVEFRONT_MATERIAL_DIFFUSE_MAP() { return configuration().WAVEFRONT_MATERIAL_DIFFUSE_MAP; }
+	const std::string &WAVEFRONT_MATERIAL_SPECULAR_MAP() { return configuration().WAVEFRONT_MATERIAL_SPECULAR_MAP; }
+	const std::string &WAVEFRONT_MATERIAL_NORMAL_MAP() { return configuration().WAVEFRONT_MATERIAL_NORMAL_MAP; }
+	const std::string &WAVEFRONT_MATERIAL_DISSOLVE() { return configuration().WAVEFRONT_MATERIAL_DISSOLVE; }
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION() { return configuration().WAVEFRONT_MATERIAL_REFLECTION; }
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE() { return configuration().WAVEFRONT_MATERIAL_REFLECTION_TYPE; }
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_TOP() { return configuration().WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_TOP; }
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BOTTOM() { return configuration().WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BOTTOM; }
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_FRONT() { return configuration().WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_FRONT; }
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BACK() { return configuration().WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_BACK; }
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_LEFT() { return configuration().WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_LEFT; }
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_RIGHT() { return configuration().WAVEFRONT_MATERIAL_REFLECTION_TYPE_CUBE_RIGHT; }
+	const std::string &WAVEFRONT_MATERIAL_REFLECTION_TYPE_SPHERE() { return configuration().WAVEFRONT_MATERIAL_REFLECTION_TYPE_SPHERE; }
 
 	/* Camera configuration */
-	GLfloat DEFAULT_FIELD_OF_VIEW() { return jsonValue.get("DEFAULT_FIELD_OF_VIEW", 60.0f).asFloat(); }
-	GLfloat DEFAULT_ASPECT_RATIO() { return jsonValue.get("DEFAULT_ASPECT_RATIO", 4.0f / 3.0f).asFloat(); }
-	GLfloat DEFAULT_NEAR_CLIPPING_PLANE() { return jsonValue.get("DEFAULT_NEAR_CLIPPING_PLANE", -1.0f).asFloat(); }
-	GLfloat DEFAULT_FAR_CLIPPING_PLANE() { return jsonValue.get("DEFAULT_FAR_CLIPPING_PLANE", 1.0f).asFloat(); }
-	vmml::Vector3f DEFAULT_CAMERA_POSITION() {
-		const Json::Value x = jsonValue["DEFAULT_CAMERA_POSITION"];
-		return vmml::Vector3f(x[0].asFloat(), x[1].asFloat(), x[2].asFloat());
-	}
-	vmml::Vector3f DEFAULT_CAMERA_ROTATION_AXES() {
-		const Json::Value x = jsonValue["DEFAULT_CAMERA_ROTATION_AXES"];
-		return vmml::Vector3f(x[0].asFloat(), x[1].asFloat(), x[2].asFloat());
-	}
+	GLfloat DEFAULT_FIELD_OF_VIEW() { return configuration().DEFAULT_FIELD_OF_VIEW; }
+	GLfloat DEFAULT_ASPECT_RATIO() { return configuration().DEFAULT_ASPECT_RATIO; }
+	GLfloat DEFAULT_NEAR_CLIPPING_PLANE() { return configuration().DEFAULT_NEAR_CLIPPING_PLANE; }
+	GLfloat DEFAULT_FAR_CLIPPING_PLANE() { return configuration().DEFAULT_FAR_CLIPPING_PLANE; }
+	const vmml::Vector3f &DEFAULT_CAMERA_POSITION() { return configuration().DEFAULT_CAMERA_POSITION; }
+	const vmml::Vector3f &DEFAULT_CAMERA_ROTATION_AXES() { return configuration().DEFAULT_CAMERA_ROTATION_AXES; }
 
 	/* Light configuration */
-	vmml::Vector4f DEFAULT_LIGHT_POSITION()	{
-		const Json::Value x = jsonValue["DEFAULT_LIGHT_POSITION"];
-		return vmml::Vector4f(x[0].asFloat(), x[1].asFloat(), x[2].asFloat(), 1.0);
-	}
-	vmml::Vector3f DEFAULT_LIGHT_COLOR() { 
-		const Json::Value x = jsonValue["DEFAULT_LIGHT_COLOR"];
-		if (x.size() >= 3)
-			return vmml::Vector3f(x[0].asFloat(), x[1].asFloat(), x[2].asFloat());
-		static const vmml::Vector3f y = vmml::Vector3f(1.0f, 1.0f, 1.0f); 
-		return y; 
-	}
-	GLfloat DEFAULT_LIGHT_INTENSITY()		{ return jsonValue.get("DEFAULT_LIGHT_INTENSITY", 1000.0f).asFloat(); }
-	GLfloat DEFAULT_LIGHT_ATTENUATION()		{ return jsonValue.get("DEFAULT_LIGHT_ATTENUATION", 1.0f).asFloat(); }
-	GLfloat DEFAULT_LIGHT_RADIUS()			{ return jsonValue.get("DEFAULT_LIGHT_RADIUS", 10000.0f).asFloat(); }
+	const vmml::Vector4f &DEFAULT_LIGHT_POSITION() { return configuration().DEFAULT_LIGHT_POSITION; }
+	const vmml::Vector3f &DEFAULT_LIGHT_COLOR() { return configuration().DEFAULT_LIGHT_COLOR; }
+	GLfloat DEFAULT_LIGHT_INTENSITY() { return configuration().DEFAULT_LIGHT_INTENSITY; }
+	GLfloat DEFAULT_LIGHT_ATTENUATION() { return configuration().DEFAULT_LIGHT_ATTENUATION; }
+	GLfloat DEFAULT_LIGHT_RADIUS() { return configuration().DEFAULT_LIGHT_RADIUS; }
 
 	/* Font configuration */
-	GLuint FONT_MAX_PIXEL_SIZE()			{ return jsonValue.get("FONT_MAX_PIXEL_SIZE", 512).asUInt(); }
+	GLuint FONT_MAX_PIXEL_SIZE() { return configuration().FONT_MAX_PIXEL_SIZE; }
 
 } // namespace bRenderer
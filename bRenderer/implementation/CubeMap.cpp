@@ -1,5 +1,6 @@
 #include "headers/CubeMap.h"
 #include "headers/TextureData.h"
+#include "headers/RenderState.h"
 
 CubeMap::CubeMap(const std::vector<TextureData> &data)
 	: Texture()
@@ -24,7 +25,5 @@ CubeMap::CubeMap(const std::vector<TextureData> &data)
 
 void CubeMap::bind(GLint texUnit)
 {
-	glActiveTexture(texUnit);
-	glEnable(GL_TEXTURE_CUBE_MAP);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, getTextureID());
+	RenderState::bindTexture(texUnit, GL_TEXTURE_CUBE_MAP, getTextureID());
 }
\ No newline at end of file
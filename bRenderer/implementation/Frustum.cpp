@@ -0,0 +1,220 @@
+#include "headers/Frustum.h"
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define B_FRUSTUM_SSE
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define B_FRUSTUM_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+	/* Returns true if the box is completely outside of the plane, the operations are in the same order as in the SIMD versions */
+	inline bool isOutside(const vmml::Vector4f &plane, GLfloat minX, GLfloat minY, GLfloat minZ, GLfloat maxX, GLfloat maxY, GLfloat maxZ)
+	{
+		GLfloat cx = (minX + maxX) * 0.5f, cy = (minY + maxY) * 0.5f, cz = (minZ + maxZ) * 0.5f;
+		GLfloat ex = (maxX - minX) * 0.5f, ey = (maxY - minY) * 0.5f, ez = (maxZ - minZ) * 0.5f;
+		GLfloat d = plane.x() * cx + plane.y() * cy;
+		d = d + plane.z() * cz;
+		d = d + plane.w();
+		GLfloat r = std::fabs(plane.x()) * ex + std::fabs(plane.y()) * ey;
+		r = r + std::fabs(plane.z()) * ez;
+		return d + r <= 0.0f;
+	}
+
+	inline bool isOutside(const vmml::Vector4f *planes, const Frustum::BoxArray &boxes, size_t i)
+	{
+		for (int p = 0; p < 6; ++p)
+		{
+			if (isOutside(planes[p], boxes.minX[i], boxes.minY[i], boxes.minZ[i], boxes.maxX[i], boxes.maxY[i], boxes.maxZ[i]))
+				return true;
+		}
+		return false;
+	}
+
+#if defined(B_FRUSTUM_SSE)
+	/* The plane coordinates and their absolute values copied into all four lanes */
+	struct PlaneLanes
+	{
+		__m128 x[6], y[6], z[6], w[6], absX[6], absY[6], absZ[6];
+
+		PlaneLanes(const vmml::Vector4f *planes)
+		{
+			for (int p = 0; p < 6; ++p)
+			{
+				x[p] = _mm_set1_ps(planes[p].x()); y[p] = _mm_set1_ps(planes[p].y()); z[p] = _mm_set1_ps(planes[p].z()); w[p] = _mm_set1_ps(planes[p].w());
+				absX[p] = _mm_set1_ps(std::fabs(planes[p].x())); absY[p] = _mm_set1_ps(std::fabs(planes[p].y())); absZ[p] = _mm_set1_ps(std::fabs(planes[p].z()));
+			}
+		}
+	};
+
+	/* Returns a bit for each of the four boxes starting at i that is at least partially inside */
+	inline uint32_t testFourBoxes(const PlaneLanes &planes, const Frustum::BoxArray &boxes, size_t i)
+	{
+		const __m128 half = _mm_set1_ps(0.5f);
+		__m128 minX = _mm_loadu_ps(&boxes.minX[i]), minY = _mm_loadu_ps(&boxes.minY[i]), minZ = _mm_loadu_ps(&boxes.minZ[i]);
+		__m128 maxX = _mm_loadu_ps(&boxes.maxX[i]), maxY = _mm_loadu_ps(&boxes.maxY[i]), maxZ = _mm_loadu_ps(&boxes.maxZ[i]);
+		__m128 cx = _mm_mul_ps(_mm_add_ps(minX, maxX), half), cy = _mm_mul_ps(_mm_add_ps(minY, maxY), half), cz = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+		__m128 ex = _mm_mul_ps(_mm_sub_ps(maxX, minX), half), ey = _mm_mul_ps(_mm_sub_ps(maxY, minY), half), ez = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+		__m128 outside = _mm_setzero_ps();
+		for (int p = 0; p < 6; ++p)
+		{
+			__m128 d = _mm_add_ps(_mm_mul_ps(planes.x[p], cx), _mm_mul_ps(planes.y[p], cy));
+			d = _mm_add_ps(d, _mm_mul_ps(planes.z[p], cz));
+			d = _mm_add_ps(d, planes.w[p]);
+			__m128 r = _mm_add_ps(_mm_mul_ps(planes.absX[p], ex), _mm_mul_ps(planes.absY[p], ey));
+			r = _mm_add_ps(r, _mm_mul_ps(planes.absZ[p], ez));
+			outside = _mm_or_ps(outside, _mm_cmple_ps(_mm_add_ps(d, r), _mm_setzero_ps()));
+		}
+		return ~static_cast<uint32_t>(_mm_movemask_ps(outside)) & 0xf;
+	}
+#elif defined(B_FRUSTUM_NEON)
+	/* The plane coordinates and their absolute values copied into all four lanes */
+	struct PlaneLanes
+	{
+		float32x4_t x[6], y[6], z[6], w[6], absX[6], absY[6], absZ[6];
+
+		PlaneLanes(const vmml::Vector4f *planes)
+		{
+			for (int p = 0; p < 6; ++p)
+			{
+				x[p] = vdupq_n_f32(planes[p].x()); y[p] = vdupq_n_f32(planes[p].y()); z[p] = vdupq_n_f32(planes[p].z()); w[p] = vdupq_n_f32(planes[p].w());
+				absX[p] = vdupq_n_f32(std::fabs(planes[p].x())); absY[p] = vdupq_n_f32(std::fabs(planes[p].y())); absZ[p] = vdupq_n_f32(std::fabs(planes[p].z()));
+			}
+		}
+	};
+
+	/* Returns a bit for each of the four boxes starting at i that is at least partially inside, multiply and add are kept separate to match the scalar version */
+	inline uint32_t testFourBoxes(const PlaneLanes &planes, const Frustum::BoxArray &boxes, size_t i)
+	{
+		const float32x4_t half = vdupq_n_f32(0.5f);
+		float32x4_t minX = vld1q_f32(&boxes.minX[i]), minY = vld1q_f32(&boxes.minY[i]), minZ = vld1q_f32(&boxes.minZ[i]);
+		float32x4_t maxX = vld1q_f32(&boxes.maxX[i]), maxY = vld1q_f32(&boxes.maxY[i]), maxZ = vld1q_f32(&boxes.maxZ[i]);
+		float32x4_t cx = vmulq_f32(vaddq_f32(minX, maxX), half), cy = vmulq_f32(vaddq_f32(minY, maxY), half), cz = vmulq_f32(vaddq_f32(minZ, maxZ), half);
+		float32x4_t ex = vmulq_f32(vsubq_f32(maxX, minX), half), ey = vmulq_f32(vsubq_f32(maxY, minY), half), ez = vmulq_f32(vsubq_f32(maxZ, minZ), half);
+
+		uint32x4_t outside = vdupq_n_u32(0);
+		for (int p = 0; p < 6; ++p)
+		{
+			float32x4_t d = vaddq_f32(vmulq_f32(planes.x[p], cx), vmulq_f32(planes.y[p], cy));
+			d = vaddq_f32(d, vmulq_f32(planes.z[p], cz));
+			d = vaddq_f32(d, planes.w[p]);
+			float32x4_t r = vaddq_f32(vmulq_f32(planes.absX[p], ex), vmulq_f32(planes.absY[p], ey));
+			r = vaddq_f32(r, vmulq_f32(planes.absZ[p], ez));
+			outside = vorrq_u32(outside, vcleq_f32(vaddq_f32(d, r), vdupq_n_f32(0.0f)));
+		}
+		uint32_t bits = (vgetq_lane_u32(outside, 0) & 1) | (vgetq_lane_u32(outside, 1) & 2) | (vgetq_lane_u32(outside, 2) & 4) | (vgetq_lane_u32(outside, 3) & 8);
+		return ~bits & 0xf;
+	}
+#endif
+}
+
+/* Public functions */
+
+void Frustum::BoxArray::resize(size_t n)
+{
+	minX.resize(n); minY.resize(n); minZ.resize(n);
+	maxX.resize(n); maxY.resize(n); maxZ.resize(n);
+}
+
+void Frustum::BoxArray::push_back(const vmml::AABBf &box)
+{
+	resize(size() + 1);
+	set(size() - 1, box.getMin(), box.getMax());
+}
+
+void Frustum::BoxArray::set(size_t i, const vmml::Vector3f &min, const vmml::Vector3f &max)
+{
+	minX[i] = min.x(); minY[i] = min.y(); minZ[i] = min.z();
+	maxX[i] = max.x(); maxY[i] = max.y(); maxZ[i] = max.z();
+}
+
+void Frustum::setup(const vmml::Matrix4f &viewProjectionMatrix)
+{
+	vmml::Vector4f row0 = viewProjectionMatrix.get_row(0), row1 = viewProjectionMatrix.get_row(1);
+	vmml::Vector4f row2 = viewProjectionMatrix.get_row(2), row3 = viewProjectionMatrix.get_row(3);
+	_planes[0] = row3 + row0;
+	_planes[1] = row3 - row0;
+	_planes[2] = row3 + row1;
+	_planes[3] = row3 - row1;
+	_planes[4] = row3 + row2;
+	_planes[5] = row3 - row2;
+}
+
+vmml::Visibility Frustum::testBox(const vmml::AABBf &box) const
+{
+	GLuint planeMask = ALL_PLANES;
+	if (!testBox(box.getMin(), box.getMax(), planeMask))
+		return vmml::VISIBILITY_NONE;
+	return planeMask ? vmml::VISIBILITY_PARTIAL : vmml::VISIBILITY_FULL;
+}
+
+bool Frustum::testBox(const vmml::Vector3f &min, const vmml::Vector3f &max, GLuint &planeMask) const
+{
+	vmml::Vector3f center = (min + max) * 0.5f;
+	vmml::Vector3f extent = (max - min) * 0.5f;
+	for (GLuint p = 0; p < 6; ++p)
+	{
+		if (!(planeMask & (1 << p)))
+			continue;
+		const vmml::Vector4f &plane = _planes[p];
+		GLfloat d = plane.x() * center.x() + plane.y() * center.y() + plane.z() * center.z() + plane.w();
+		GLfloat r = extent.x() * std::fabs(plane.x()) + extent.y() * std::fabs(plane.y()) + extent.z() * std::fabs(plane.z());
+		if (d + r <= 0.0f)
+			return false;
+		if (d - r >= 0.0f)
+			planeMask &= ~(1 << p);
+	}
+	return true;
+}
+
+uint32_t Frustum::testBoxes(const BoxArray &boxes, size_t first, size_t count) const
+{
+	uint32_t mask = 0;
+	size_t i = 0;
+#if defined(B_FRUSTUM_SSE) || defined(B_FRUSTUM_NEON)
+	if (count >= 4)
+	{
+		PlaneLanes planes(_planes);
+		for (; i + 4 <= count; i += 4)
+			mask |= testFourBoxes(planes, boxes, first + i) << i;
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		if (!isOutside(_planes, boxes, first + i))
+			mask |= 1u << i;
+	}
+	return mask;
+}
+
+void Frustum::testBoxes(const BoxArray &boxes, std::vector< uint32_t > &visibilityMask) const
+{
+	size_t n = boxes.size();
+	visibilityMask.assign((n + 31) / 32, 0);
+	size_t i = 0;
+#if defined(B_FRUSTUM_SSE) || defined(B_FRUSTUM_NEON)
+	PlaneLanes planes(_planes);
+	for (; i + 4 <= n; i += 4)
+		visibilityMask[i / 32] |= testFourBoxes(planes, boxes, i) << (i % 32);
+#endif
+	for (; i < n; ++i)
+	{
+		if (!isOutside(_planes, boxes, i))
+			visibilityMask[i / 32] |= 1u << (i % 32);
+	}
+}
+
+void Frustum::testBoxesReference(const BoxArray &boxes, std::vector< uint32_t > &visibilityMask) const
+{
+	size_t n = boxes.size();
+	visibilityMask.assign((n + 31) / 32, 0);
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (!isOutside(_planes, boxes, i))
+			visibilityMask[i / 32] |= 1u << (i % 32);
+	}
+}
@@ -1,4 +1,11 @@
 #include "headers/Geometry.h"
+#include "headers/Configuration.h"
+#include "headers/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+GLuint Geometry::_idCounter = 0;
 
 /* Public functions */
 
@@ -6,35 +13,64 @@ void Geometry::initialize(GeometryDataPtr geometryData)
 {
 	// Create bounding volume
 	_boundingBox = createBoundingBoxObjectSpace(geometryData->vboVertices);
+
+	// Only store the vertex components the shader uses
+	VertexLayout::Components components = geometryData->vertexComponents;
+	if (_material && _material->getShader())
+		components &= VertexLayout::getRequiredComponents(*_material->getShader());
+	_vertexLayout = &VertexLayout::get(components);
+	// The layout may have changed
+	if (_initialized)
+		deleteVertexArrays();
 	
 	// Initialize geometry
     copyVertexData(geometryData->vboVertices);
     copyIndexData(geometryData->vboIndices);
     initializeVertexBuffer();
+    initializeIndexBuffer();
+	// Batched instances have to be transformed again from the new data
+	_batchIndexCapacity = 0;
+	for (auto i = _instanceBatches.begin(); i != _instanceBatches.end(); ++i)
+		i->matrices.clear();
+
+	// Levels of detail are drawn with the same material, properties and instances
+	_levelsOfDetail.clear();
+	for (auto i = geometryData->levelsOfDetail.begin(); i != geometryData->levelsOfDetail.end(); ++i)
+	{
+		std::shared_ptr< Geometry > lod(new Geometry);
+		lod->setMaterial(_material);
+		lod->setProperties(_properties);
+		lod->initialize(*i);
+		for (auto j = _instances.begin(); j != _instances.end(); ++j)
+			lod->addInstance(j->first, j->second);
+		_levelsOfDetail.push_back(lod);
+	}
 
 	_initialized = true;
 }
 
 void Geometry::draw(GLenum mode)
 {
-	glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+	bindBuffers(_material ? _material->getShader() : nullptr);
 
 	if (_material)
 		_material->bind();
 
 	if (_properties)
 		_properties->passToShader(_material->getShader());
+	if (_material && _material->getShader())
+		_material->getShader()->applyInstanceMatrix();
 
-	glDrawElements(mode, _nIndices, GL_UNSIGNED_SHORT, _indexData.get());
+	drawElements(mode);
 
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	unbindBuffers();
 
 }
 
 void Geometry::drawInstance(const std::string &instanceName, GLenum mode)
 {
 	if (getInstanceProperties(instanceName)){
-		glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+		bindBuffers(_material ? _material->getShader() : nullptr);
 
 		if (_material)
 			_material->bind();
@@ -44,13 +80,84 @@ void Geometry::drawInstance(const std::string &instanceName, GLenum mode)
 
 		// Instance properties may override properties set for the geometry in  general
 		getInstanceProperties(instanceName)->passToShader(_material->getShader());
+		if (_material && _material->getShader())
+			_material->getShader()->applyInstanceMatrix();
+
+		drawElements(mode);
+
+		unbindBuffers();
+	}
+}
 
-		glDrawElements(mode, _nIndices, GL_UNSIGNED_SHORT, _indexData.get());
+void Geometry::drawInstances(const std::vector<std::string> &instanceNames, size_t nInstances, GLenum mode)
+{
+	if (nInstances < 2 || !_material || !_material->getShader()){
+		IDrawable::drawInstances(instanceNames, nInstances, mode);
+		return;
+	}
+	// Batching on the CPU only pays off if the vertices of at least two instances can be addressed with 16 bit indices
+	bool hardwareInstancing = supportsHardwareInstancing() && _material->getShader()->supportsInstancing();
+	// It also needs the vertices and indices in main memory
+	if (!hardwareInstancing && (_nVertices * 2 > 65536 || !_vertexData || !_indexData)){
+		IDrawable::drawInstances(instanceNames, nInstances, mode);
+		return;
+	}
 
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	// Instances can only be drawn together if nothing but their model view matrix differs
+	Shader::UniformHandle modelViewHandle = Shader::getUniformHandle(bRenderer::DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX());
+	PropertiesPtr instanceProperties = nullptr;
+	_instanceMatrices.clear();
+	for (size_t i = 0; i < nInstances; i++){
+		PropertiesPtr properties = getInstanceProperties(instanceNames[i]);
+		if (!properties)
+			continue;
+		if (!instanceProperties)
+			instanceProperties = properties;
+		else if (!properties->equalsExcept(*instanceProperties, modelViewHandle)){
+			IDrawable::drawInstances(instanceNames, nInstances, mode);
+			return;
+		}
+		_instanceMatrices.push_back(properties->getMatrix4x4(modelViewHandle));
 	}
+	if (_instanceMatrices.empty())
+		return;
+
+	if (hardwareInstancing)
+		drawInstancesHardware(instanceProperties, mode);
+	else
+		drawInstancesBatched(instanceProperties, mode);
 }
 
+bool Geometry::supportsHardwareInstancing()
+{
+#ifdef B_OS_DESKTOP
+	return GLEW_VERSION_3_3 != 0;
+#else
+	// the context is created for OpenGL ES 2.0, which doesn't support instancing
+	return false;
+#endif
+}
+
+bool Geometry::supportsVertexArrayObjects()
+{
+#ifdef B_OS_DESKTOP
+	return GLEW_VERSION_3_0 || GLEW_ARB_vertex_array_object;
+#else
+	// the context is created for OpenGL ES 2.0, where vertex array objects need the OES extension functions
+	return false;
+#endif
+}
+
+bool Geometry::supports32BitIndices()
+{
+#ifdef B_OS_DESKTOP
+	return true;
+#else
+	static const char *extensions = reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS));
+	static const bool supported = extensions && std::strstr(extensions, "GL_OES_element_index_uint");
+	return supported;
+#endif
+}
 
 PropertiesPtr Geometry::addInstance(const std::string &instanceName)
 {
@@ -58,12 +165,16 @@ PropertiesPtr Geometry::addInstance(const std::string &instanceName)
 	PropertiesPtr &properties = _instances[instanceName];
 	properties = PropertiesPtr(new Properties);
 	properties->setName(instanceName);
+	for (auto i = _levelsOfDetail.begin(); i != _levelsOfDetail.end(); ++i)
+		(*i)->addInstance(instanceName, properties);
 	return properties;
 }
 
 void Geometry::addInstance(const std::string &instanceName, PropertiesPtr instanceProperties)
 {
 	_instances.insert(PropertiesMap::value_type(instanceName, instanceProperties));
+	for (auto i = _levelsOfDetail.begin(); i != _levelsOfDetail.end(); ++i)
+		(*i)->addInstance(instanceName, instanceProperties);
 }
 
 PropertiesPtr Geometry::getInstanceProperties(const std::string &instanceName)
@@ -75,19 +186,97 @@ PropertiesPtr Geometry::getInstanceProperties(const std::string &instanceName)
 void Geometry::removeInstance(const std::string &instanceName)
 {
 	_instances.erase(instanceName);
+	for (auto i = _levelsOfDetail.begin(); i != _levelsOfDetail.end(); ++i)
+		(*i)->removeInstance(instanceName);
 }
 
 void Geometry::clearInstances()
 {
 	_instances.clear();
+	for (auto i = _levelsOfDetail.begin(); i != _levelsOfDetail.end(); ++i)
+		(*i)->clearInstances();
+}
+
+void Geometry::releaseCPUData()
+{
+	_vertexData = nullptr;
+	_indexData = nullptr;
+	for (auto i = _levelsOfDetail.begin(); i != _levelsOfDetail.end(); ++i)
+		(*i)->releaseCPUData();
+}
+
+void Geometry::setMaterial(MaterialPtr arg)
+{
+	_material = arg;
+	for (auto i = _levelsOfDetail.begin(); i != _levelsOfDetail.end(); ++i)
+		(*i)->setMaterial(arg);
+}
+
+void Geometry::setProperties(PropertiesPtr arg)
+{
+	_properties = arg;
+	for (auto i = _levelsOfDetail.begin(); i != _levelsOfDetail.end(); ++i)
+		(*i)->setProperties(arg);
+}
+
+std::shared_ptr< Geometry > Geometry::getLevelOfDetail(GLuint level)
+{
+	if (level == 0 || _levelsOfDetail.empty())
+		return nullptr;
+	return _levelsOfDetail[std::min(static_cast<size_t>(level), _levelsOfDetail.size()) - 1];
 }
 
 /* Private functions */
 
+void Geometry::bindBuffers(ShaderPtr shader)
+{
+	// the chunks switch the vertex buffer while drawing, which a vertex array object can't follow
+	if (!shader || !supportsVertexArrayObjects() || !_indexChunks.empty()){
+		RenderState::bindVertexArray(0);
+		RenderState::bindVertexBuffer(_vertexBuffer, _vertexLayout);
+		RenderState::bindIndexBuffer(_indexBuffer);
+		return;
+	}
+
+	if (_vertexArraysProgramDeletions != RenderState::getProgramDeletions()){
+		deleteVertexArrays();
+		_vertexArraysProgramDeletions = RenderState::getProgramDeletions();
+	}
+
+	GLuint &vertexArray = _vertexArrays[shader->getProgramID()];
+	if (vertexArray){
+		RenderState::bindVertexArray(vertexArray);
+		return;
+	}
+
+	// The vertex array stores the attribute pointers and the index buffer
+	glGenVertexArrays(1, &vertexArray);
+	RenderState::bindVertexArray(vertexArray);
+	RenderState::bindVertexBuffer(_vertexBuffer, _vertexLayout);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+	shader->bindAttribs(_vertexLayout);
+}
+
+void Geometry::unbindBuffers()
+{
+	RenderState::unbindVertexArray();
+	RenderState::unbindIndexBuffer();
+	RenderState::unbindVertexBuffer();
+}
+
+void Geometry::deleteVertexArrays()
+{
+	for (auto i = _vertexArrays.begin(); i != _vertexArrays.end(); ++i){
+		RenderState::deleteVertexArray(i->second);
+		glDeleteVertexArrays(1, &i->second);
+	}
+	_vertexArrays.clear();
+}
+
 Geometry::VertexDataPtr Geometry::allocVertexData(size_t nVertices)
 {
     _nVertices  = nVertices;
-    _vertexData = VertexDataPtr(new Vertex[_nVertices]);
+    _vertexData = VertexDataPtr(new Vertex[_nVertices], std::default_delete< Vertex[] >());
     
     return _vertexData;
 }
@@ -95,7 +284,7 @@ Geometry::VertexDataPtr Geometry::allocVertexData(size_t nVertices)
 Geometry::IndexDataPtr Geometry::allocIndexData(size_t nIndices)
 {
     _nIndices  = nIndices;
-    _indexData = IndexDataPtr(new GLushort[_nIndices]);
+    _indexData = IndexDataPtr(new Index[_nIndices], std::default_delete< Index[] >());
     
     return _indexData;
 }
@@ -122,9 +311,270 @@ void Geometry::initializeVertexBuffer()
 {
 	if (!_initialized)
 		glGenBuffers(1, &_vertexBuffer);
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
-    glBufferData(GL_ARRAY_BUFFER, _nVertices*sizeof(Vertex), _vertexData.get(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    std::vector< GLubyte > vertices;
+    _vertexLayout->pack(_vertexData.get(), _nVertices, vertices);
+    RenderState::bindVertexBuffer(_vertexBuffer, _vertexLayout);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size(), vertices.data(), GL_STATIC_DRAW);
+    RenderState::unbindVertexBuffer();
+}
+
+void Geometry::initializeIndexBuffer()
+{
+	if (!_initialized)
+		glGenBuffers(1, &_indexBuffer);
+	// the index buffer binding would otherwise be stored in a vertex array object
+	RenderState::bindVertexArray(0);
+	RenderState::bindIndexBuffer(_indexBuffer);
+
+	deleteIndexChunks();
+	// Use 16 bit indices whenever possible to save memory and bandwidth
+	if (_nVertices <= 65536){
+		_indexType = GL_UNSIGNED_SHORT;
+		std::vector< GLushort > indices(_indexData.get(), _indexData.get() + _nIndices);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, _nIndices*sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+	}
+	else if (supports32BitIndices()){
+		_indexType = GL_UNSIGNED_INT;
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, _nIndices*sizeof(GLuint), _indexData.get(), GL_STATIC_DRAW);
+	}
+	else{
+		_indexType = GL_UNSIGNED_SHORT;
+		initializeIndexChunks();
+	}
+	RenderState::unbindIndexBuffer();
+}
+
+void Geometry::initializeIndexChunks()
+{
+	bRenderer::log("OES_element_index_uint is not supported, splitting geometry with " + std::to_string(_nVertices) + " vertices into chunks", bRenderer::LM_WARNING);
+
+	std::vector< GLushort > indices;
+	indices.reserve(_nIndices);
+	// position of each vertex in the current chunk, -1 if the chunk doesn't use it
+	std::vector< GLint > chunkIndices(_nVertices, -1);
+	std::vector< Index > chunkVertices;
+	size_t firstIndex = 0;
+
+	// triangles are never split between chunks
+	const Index *src = _indexData.get();
+	for (size_t i = 0; i + 2 < _nIndices; i += 3){
+		if (chunkVertices.size() + 3 > 65536){
+			addIndexChunk(chunkVertices, firstIndex, indices.size() - firstIndex);
+			for (auto v = chunkVertices.begin(); v != chunkVertices.end(); ++v)
+				chunkIndices[*v] = -1;
+			chunkVertices.clear();
+			firstIndex = indices.size();
+		}
+		for (size_t j = i; j < i + 3; j++){
+			GLint &chunkIndex = chunkIndices[src[j]];
+			if (chunkIndex < 0){
+				chunkIndex = static_cast<GLint>(chunkVertices.size());
+				chunkVertices.push_back(src[j]);
+			}
+			indices.push_back(static_cast<GLushort>(chunkIndex));
+		}
+	}
+	if (!chunkVertices.empty())
+		addIndexChunk(chunkVertices, firstIndex, indices.size() - firstIndex);
+
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size()*sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+}
+
+void Geometry::addIndexChunk(const std::vector< Index > &vertices, size_t firstIndex, size_t nIndices)
+{
+	IndexChunk chunk;
+	chunk.firstIndex = firstIndex;
+	chunk.nIndices = nIndices;
+	// the first chunk replaces the contents of the vertex buffer of the geometry, so bindBuffers() binds it
+	if (_indexChunks.empty())
+		chunk.vertexBuffer = _vertexBuffer;
+	else
+		glGenBuffers(1, &chunk.vertexBuffer);
+
+	GeometryData::VboVertices chunkVertices(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++)
+		chunkVertices[i] = _vertexData.get()[vertices[i]];
+	std::vector< GLubyte > packed;
+	_vertexLayout->pack(chunkVertices.data(), chunkVertices.size(), packed);
+	RenderState::bindVertexBuffer(chunk.vertexBuffer, _vertexLayout);
+	glBufferData(GL_ARRAY_BUFFER, packed.size(), packed.data(), GL_STATIC_DRAW);
+	RenderState::unbindVertexBuffer();
+
+	_indexChunks.push_back(chunk);
+}
+
+void Geometry::deleteIndexChunks()
+{
+	for (auto i = _indexChunks.begin(); i != _indexChunks.end(); ++i){
+		if (i->vertexBuffer != _vertexBuffer)
+			glDeleteBuffers(1, &i->vertexBuffer);
+	}
+	_indexChunks.clear();
+}
+
+void Geometry::drawElements(GLenum mode)
+{
+	if (_indexChunks.empty()){
+		glDrawElements(mode, _nIndices, _indexType, 0);
+		return;
+	}
+
+	// bindBuffers() bound the vertex buffer of the first chunk, the attribute pointers have to follow every other one
+	ShaderPtr shader = _material ? _material->getShader() : nullptr;
+	for (auto i = _indexChunks.begin(); i != _indexChunks.end(); ++i){
+		if (i != _indexChunks.begin()){
+			RenderState::bindVertexBuffer(i->vertexBuffer, _vertexLayout);
+			if (shader && RenderState::needsAttribSetup())
+				shader->bindAttribs(_vertexLayout);
+		}
+		glDrawElements(mode, static_cast<GLsizei>(i->nIndices), GL_UNSIGNED_SHORT, reinterpret_cast<void*>(i->firstIndex * sizeof(GLushort)));
+	}
+}
+
+void Geometry::drawInstancesHardware(PropertiesPtr instanceProperties, GLenum mode)
+{
+#ifdef B_OS_DESKTOP
+	ShaderPtr shader = _material->getShader();
+
+	bindBuffers(shader);
+	_material->bind();
+	if (_properties)
+		_properties->passToShader(shader);
+	instanceProperties->passToShader(shader);
+
+	// Pass the model view matrices as an attribute that advances once per instance
+	if (!_instanceBuffer)
+		glGenBuffers(1, &_instanceBuffer);
+	RenderState::bindVertexBuffer(_instanceBuffer);
+	glBufferData(GL_ARRAY_BUFFER, _instanceMatrices.size() * sizeof(vmml::Matrix4f), _instanceMatrices[0].begin(), GL_STREAM_DRAW);
+
+	GLint loc = shader->getInstanceMatrixLocation();
+	for (GLint c = 0; c < 4; c++){
+		glEnableVertexAttribArray(loc + c);
+		glVertexAttribPointer(loc + c, 4, GL_FLOAT, GL_FALSE, sizeof(vmml::Matrix4f), reinterpret_cast<void*>(sizeof(GLfloat) * 4 * c));
+		glVertexAttribDivisor(loc + c, 1);
+	}
+
+	glDrawElementsInstanced(mode, _nIndices, _indexType, 0, static_cast<GLsizei>(_instanceMatrices.size()));
+
+	for (GLint c = 0; c < 4; c++){
+		glVertexAttribDivisor(loc + c, 0);
+		glDisableVertexAttribArray(loc + c);
+	}
+
+	unbindBuffers();
+#endif
+}
+
+void Geometry::drawInstancesBatched(PropertiesPtr instanceProperties, GLenum mode)
+{
+	ShaderPtr shader = _material->getShader();
+	Shader::UniformHandle modelViewHandle = Shader::getUniformHandle(bRenderer::DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX());
+	size_t vertexSize = static_cast<size_t>(_vertexLayout->getStride()) * _nVertices;
+
+	// The vertices are stored relative to the first instance, so they stay valid as long as only the camera moves
+	vmml::Matrix4f reference = _instanceMatrices[0];
+	vmml::Matrix4f referenceInverse;
+	if (!reference.inverse(referenceInverse)){
+		reference = vmml::Matrix4f::IDENTITY;
+		referenceInverse = vmml::Matrix4f::IDENTITY;
+	}
+
+	// Indices are 16 bit, so the instances may have to be split into multiple batches
+	size_t nInstances = _instanceMatrices.size();
+	size_t maxInstances = 65536 / _nVertices;
+
+	// All batches share one index buffer holding the indices of as many instances as the largest batch
+	RenderState::bindVertexArray(0);
+	if (!_batchIndexBuffer)
+		glGenBuffers(1, &_batchIndexBuffer);
+	RenderState::bindIndexBuffer(_batchIndexBuffer);
+	if (_batchIndexCapacity < std::min(maxInstances, nInstances)){
+		_batchIndexCapacity = std::min(maxInstances, std::max(nInstances, _batchIndexCapacity * 2));
+		std::vector< GLushort > indices(_batchIndexCapacity * _nIndices);
+		for (size_t k = 0; k < _batchIndexCapacity; k++){
+			for (size_t i = 0; i < _nIndices; i++)
+				indices[k * _nIndices + i] = static_cast<GLushort>(_indexData.get()[i] + k * _nVertices);
+		}
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+	}
+
+	for (size_t first = 0, b = 0; first < nInstances; first += maxInstances, b++){
+		size_t count = std::min(maxInstances, nInstances - first);
+		if (_instanceBatches.size() <= b)
+			_instanceBatches.resize(b + 1);
+		InstanceBatch &batch = _instanceBatches[b];
+
+		if (!batch.buffer)
+			glGenBuffers(1, &batch.buffer);
+		RenderState::bindVertexBuffer(batch.buffer, _vertexLayout);
+		if (batch.capacity < count){
+			batch.capacity = std::min(maxInstances, std::max(count, batch.capacity * 2));
+			glBufferData(GL_ARRAY_BUFFER, batch.capacity * vertexSize, nullptr, GL_DYNAMIC_DRAW);
+			batch.matrices.clear();
+		}
+
+		// Only instances that moved relative to the first one are transformed and uploaded again
+		for (size_t k = 0; k < count; k++){
+			vmml::Matrix4f m = referenceInverse * _instanceMatrices[first + k];
+			if (k < batch.matrices.size() && equalsApproximately(batch.matrices[k], m))
+				continue;
+			if (k < batch.matrices.size())
+				batch.matrices[k] = m;
+			else
+				batch.matrices.push_back(m);
+
+			transformVertices(m, _batchVertices);
+			// Packing with the layout of the geometry stores the sign of the bitangent the shader expects
+			_vertexLayout->pack(_batchVertices.data(), _nVertices, _batchPacked);
+			glBufferSubData(GL_ARRAY_BUFFER, k * vertexSize, vertexSize, _batchPacked.data());
+		}
+
+		_material->bind();
+		if (_properties)
+			_properties->passToShader(shader);
+		instanceProperties->passToShader(shader);
+		shader->setUniform(modelViewHandle, reference);
+		shader->applyInstanceMatrix();
+
+		glDrawElements(mode, static_cast<GLsizei>(count * _nIndices), GL_UNSIGNED_SHORT, 0);
+	}
+
+	unbindBuffers();
+}
+
+void Geometry::transformVertices(const vmml::Matrix4f &m, GeometryData::VboVertices &vertices) const
+{
+	const Vertex *src = _vertexData.get();
+	vertices.resize(_nVertices);
+	for (size_t v = 0; v < _nVertices; v++){
+		vertices[v] = src[v];
+		vertices[v].position.x = m(0, 0)*src[v].position.x + m(0, 1)*src[v].position.y + m(0, 2)*src[v].position.z + m(0, 3);
+		vertices[v].position.y = m(1, 0)*src[v].position.x + m(1, 1)*src[v].position.y + m(1, 2)*src[v].position.z + m(1, 3);
+		vertices[v].position.z = m(2, 0)*src[v].position.x + m(2, 1)*src[v].position.y + m(2, 2)*src[v].position.z + m(2, 3);
+		vertices[v].normal = transformDirection(m, src[v].normal);
+		vertices[v].tangent = transformDirection(m, src[v].tangent);
+		vertices[v].bitangent = transformDirection(m, src[v].bitangent);
+	}
+}
+
+bool Geometry::equalsApproximately(const vmml::Matrix4f &a, const vmml::Matrix4f &b)
+{
+	// relative matrices of instances that didn't move may still differ in the last bits when the camera moved
+	for (int i = 0; i < 16; i++){
+		if (std::fabs(a.array[i] - b.array[i]) > 1e-5f * std::max(1.0f, std::fabs(a.array[i])))
+			return false;
+	}
+	return true;
+}
+
+Vector3 Geometry::transformDirection(const vmml::Matrix4f &m, const Vector3 &d)
+{
+	Vector3 r;
+	r.x = m(0, 0)*d.x + m(0, 1)*d.y + m(0, 2)*d.z;
+	r.y = m(1, 0)*d.x + m(1, 1)*d.y + m(1, 2)*d.z;
+	r.z = m(2, 0)*d.x + m(2, 1)*d.y + m(2, 2)*d.z;
+	return r;
 }
 
 vmml::AABBf Geometry::createBoundingBoxObjectSpace(const GeometryData::VboVertices &arg)
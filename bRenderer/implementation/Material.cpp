@@ -2,6 +2,8 @@
 #include "headers/ObjectManager.h"
 #include "headers/Configuration.h"
 
+GLuint Material::_idCounter = 0;
+
 void Material::initialize(ObjectManager *o, const MaterialData &materialData, ShaderPtr shader)
 {
     for (auto i = materialData.textures.cbegin(); i != materialData.textures.cend(); ++i)
@@ -32,6 +34,10 @@ void Material::initialize(ObjectManager *o, const MaterialData &materialData, Sh
 void Material::bind()
 {
     _shader->bind();
+
+    // textures and uniforms are still set if the material was bound last (while the render state is tracked)
+    if (!RenderState::bindMaterial(this))
+        return;
     _shader->setUniforms(_textures);
     _shader->setUniforms(_vectors);
     _shader->setUniforms(_scalars);
@@ -0,0 +1,238 @@
+#include "headers/MeshOptimizer.h"
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+	const size_t NO_VERTEX = std::numeric_limits< size_t >::max();
+
+	vmml::Vector3f position(const Vertex &vertex)
+	{
+		return vmml::Vector3f(vertex.position.x, vertex.position.y, vertex.position.z);
+	}
+
+	/* Tipsify: returns the next vertex to fan around, preferring vertices that are still in the cache */
+	size_t nextVertex(const std::vector< size_t > &candidates, const std::vector< size_t > &cacheTime, size_t time, const std::vector< size_t > &liveTriangles,
+		std::vector< size_t > &deadEnds, size_t &cursor)
+	{
+		size_t best = NO_VERTEX;
+		size_t bestPriority = 0;
+		for (auto i = candidates.begin(); i != candidates.end(); ++i)
+		{
+			size_t v = *i;
+			if (liveTriangles[v] == 0)
+				continue;
+			// vertices that stay in the cache while all their triangles are emitted are preferred, the older the better
+			size_t age = time - cacheTime[v];
+			size_t priority = age + 2 * liveTriangles[v] <= MeshOptimizer::CACHE_SIZE ? age + 1 : 1;
+			if (priority > bestPriority)
+			{
+				best = v;
+				bestPriority = priority;
+			}
+		}
+		if (best != NO_VERTEX)
+			return best;
+
+		// dead end, continue with a recently used vertex or the next vertex in the input order
+		while (!deadEnds.empty())
+		{
+			size_t v = deadEnds.back();
+			deadEnds.pop_back();
+			if (liveTriangles[v] > 0)
+				return v;
+		}
+		for (; cursor < liveTriangles.size(); ++cursor)
+		{
+			if (liveTriangles[cursor] > 0)
+				return cursor++;
+		}
+		return NO_VERTEX;
+	}
+}
+
+/* Public functions */
+
+void MeshOptimizer::optimize(GeometryData &group, bool sortForOverdraw)
+{
+	optimizeVertexCache(group, sortForOverdraw);
+	optimizeVertexFetch(group);
+}
+
+void MeshOptimizer::optimizeVertexCache(GeometryData &group, bool sortForOverdraw)
+{
+	const GeometryData::VboIndices &indices = group.vboIndices;
+	const size_t nTriangles = indices.size() / 3;
+	const size_t nVertices = group.vboVertices.size();
+	if (nTriangles == 0)
+		return;
+
+	// triangles adjacent to each vertex, stored consecutively in a single array
+	std::vector< size_t > adjacencyOffsets(nVertices + 1, 0);
+	for (size_t i = 0; i < nTriangles * 3; ++i)
+		adjacencyOffsets[indices[i] + 1]++;
+	for (size_t v = 0; v < nVertices; ++v)
+		adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+	std::vector< size_t > adjacency(nTriangles * 3);
+	std::vector< size_t > liveTriangles(nVertices);
+	{
+		std::vector< size_t > fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (size_t i = 0; i < nTriangles * 3; ++i)
+			adjacency[fill[indices[i]]++] = i / 3;
+		for (size_t v = 0; v < nVertices; ++v)
+			liveTriangles[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+	}
+
+	// a vertex is in the cache if fewer than CACHE_SIZE vertices were added since it was
+	std::vector< size_t > cacheTime(nVertices, 0);
+	size_t time = CACHE_SIZE + 1;
+	std::vector< bool > emitted(nTriangles, false);
+	std::vector< size_t > deadEnds, candidates;
+	std::vector< size_t > order, clusters;
+	order.reserve(nTriangles);
+
+	size_t cursor = 0;
+	size_t fanning = nextVertex(candidates, cacheTime, time, liveTriangles, deadEnds, cursor);
+	while (fanning != NO_VERTEX)
+	{
+		// a new cluster starts whenever the cache has to be filled again
+		if (time - cacheTime[fanning] > CACHE_SIZE)
+			clusters.push_back(order.size());
+
+		candidates.clear();
+		for (size_t a = adjacencyOffsets[fanning]; a < adjacencyOffsets[fanning + 1]; ++a)
+		{
+			size_t triangle = adjacency[a];
+			if (emitted[triangle])
+				continue;
+			for (size_t k = 0; k < 3; ++k)
+			{
+				size_t v = indices[triangle * 3 + k];
+				deadEnds.push_back(v);
+				candidates.push_back(v);
+				liveTriangles[v]--;
+				if (time - cacheTime[v] > CACHE_SIZE)
+					cacheTime[v] = time++;
+			}
+			emitted[triangle] = true;
+			order.push_back(triangle);
+		}
+		fanning = nextVertex(candidates, cacheTime, time, liveTriangles, deadEnds, cursor);
+	}
+
+	if (sortForOverdraw && clusters.size() > 1)
+	{
+		// clusters on the outside of the mesh that face away from its center occlude the rest from most directions, so they are drawn first
+		clusters.push_back(order.size());
+		vmml::Vector3f center = vmml::Vector3f::ZERO;
+		GLfloat area = 0.0f;
+		std::vector< vmml::Vector3f > clusterCenters(clusters.size() - 1, vmml::Vector3f::ZERO);
+		std::vector< vmml::Vector3f > clusterNormals(clusters.size() - 1, vmml::Vector3f::ZERO);
+		std::vector< GLfloat > clusterAreas(clusters.size() - 1, 0.0f);
+		for (size_t c = 0; c + 1 < clusters.size(); ++c)
+		{
+			for (size_t i = clusters[c]; i < clusters[c + 1]; ++i)
+			{
+				size_t triangle = order[i];
+				vmml::Vector3f p1 = position(group.vboVertices[indices[triangle * 3]]);
+				vmml::Vector3f p2 = position(group.vboVertices[indices[triangle * 3 + 1]]);
+				vmml::Vector3f p3 = position(group.vboVertices[indices[triangle * 3 + 2]]);
+				vmml::Vector3f normal = (p2 - p1).cross(p3 - p1);
+				GLfloat triangleArea = normal.length();
+				vmml::Vector3f centroid = (p1 + p2 + p3) / 3.0f;
+				clusterCenters[c] += centroid * triangleArea;
+				clusterNormals[c] += normal;
+				clusterAreas[c] += triangleArea;
+			}
+			center += clusterCenters[c];
+			area += clusterAreas[c];
+		}
+		if (area > 0.0f)
+			center /= area;
+
+		std::vector< GLfloat > keys(clusters.size() - 1, 0.0f);
+		for (size_t c = 0; c < keys.size(); ++c)
+		{
+			GLfloat normalLength = clusterNormals[c].length();
+			if (clusterAreas[c] > 0.0f && normalLength > 0.0f)
+				keys[c] = (clusterCenters[c] / clusterAreas[c] - center).dot(clusterNormals[c] / normalLength);
+		}
+
+		std::vector< size_t > sortedClusters(keys.size());
+		for (size_t c = 0; c < sortedClusters.size(); ++c)
+			sortedClusters[c] = c;
+		std::stable_sort(sortedClusters.begin(), sortedClusters.end(), [&keys](size_t a, size_t b) { return keys[a] > keys[b]; });
+
+		std::vector< size_t > sortedOrder;
+		sortedOrder.reserve(order.size());
+		for (auto c = sortedClusters.begin(); c != sortedClusters.end(); ++c)
+			sortedOrder.insert(sortedOrder.end(), order.begin() + clusters[*c], order.begin() + clusters[*c + 1]);
+		order.swap(sortedOrder);
+	}
+
+	// the per corner index data is kept in the same order as the indices if it exists
+	bool reorderIndexData = group.indices.size() == indices.size();
+	GeometryData::VboIndices newIndices(indices.size());
+	std::vector< IndexData > newIndexData(reorderIndexData ? indices.size() : 0);
+	for (size_t i = 0; i < nTriangles; ++i)
+	{
+		for (size_t k = 0; k < 3; ++k)
+		{
+			newIndices[i * 3 + k] = indices[order[i] * 3 + k];
+			if (reorderIndexData)
+				newIndexData[i * 3 + k] = group.indices[order[i] * 3 + k];
+		}
+	}
+	// indices that don't form a complete triangle stay at the end
+	for (size_t i = nTriangles * 3; i < indices.size(); ++i)
+	{
+		newIndices[i] = indices[i];
+		if (reorderIndexData)
+			newIndexData[i] = group.indices[i];
+	}
+	group.vboIndices.swap(newIndices);
+	if (reorderIndexData)
+		group.indices.swap(newIndexData);
+}
+
+void MeshOptimizer::optimizeVertexFetch(GeometryData &group)
+{
+	const size_t nVertices = group.vboVertices.size();
+	std::vector< size_t > remap(nVertices, NO_VERTEX);
+	size_t next = 0;
+	for (auto i = group.vboIndices.begin(); i != group.vboIndices.end(); ++i)
+	{
+		if (remap[*i] == NO_VERTEX)
+			remap[*i] = next++;
+		*i = static_cast<Index>(remap[*i]);
+	}
+
+	// unused vertices are kept at the end
+	GeometryData::VboVertices vertices(nVertices);
+	for (size_t v = 0; v < nVertices; ++v)
+	{
+		if (remap[v] == NO_VERTEX)
+			remap[v] = next++;
+		vertices[remap[v]] = group.vboVertices[v];
+	}
+	group.vboVertices.swap(vertices);
+}
+
+MeshOptimizer::Statistics MeshOptimizer::analyze(const GeometryData &group, size_t cacheSize)
+{
+	Statistics statistics;
+	statistics.nTriangles = group.vboIndices.size() / 3;
+	statistics.nVertices = group.vboVertices.size();
+
+	std::vector< size_t > cacheTime(group.vboVertices.size(), 0);
+	size_t time = cacheSize + 1;
+	for (auto i = group.vboIndices.begin(); i != group.vboIndices.end(); ++i)
+	{
+		if (time - cacheTime[*i] > cacheSize)
+		{
+			cacheTime[*i] = time++;
+			statistics.nTransforms++;
+		}
+	}
+	return statistics;
+}
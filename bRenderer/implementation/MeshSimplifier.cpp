@@ -0,0 +1,266 @@
+#include "headers/MeshSimplifier.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+	const Index NO_INDEX = std::numeric_limits< Index >::max();
+
+	/* Symmetric 4x4 matrix measuring the squared distance of a point to a set of planes */
+	struct Quadric
+	{
+		double aa = 0, ab = 0, ac = 0, ad = 0, bb = 0, bc = 0, bd = 0, cc = 0, cd = 0, dd = 0;
+
+		void addPlane(double a, double b, double c, double d, double weight)
+		{
+			aa += weight * a * a; ab += weight * a * b; ac += weight * a * c; ad += weight * a * d;
+			bb += weight * b * b; bc += weight * b * c; bd += weight * b * d;
+			cc += weight * c * c; cd += weight * c * d;
+			dd += weight * d * d;
+		}
+
+		Quadric &operator+=(const Quadric &q)
+		{
+			aa += q.aa; ab += q.ab; ac += q.ac; ad += q.ad; bb += q.bb; bc += q.bc; bd += q.bd; cc += q.cc; cd += q.cd; dd += q.dd;
+			return *this;
+		}
+
+		double error(const Point3 &p) const
+		{
+			double x = p.x, y = p.y, z = p.z;
+			return aa * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+				+ bb * y * y + 2 * bc * y * z + 2 * bd * y
+				+ cc * z * z + 2 * cd * z + dd;
+		}
+	};
+
+	struct Collapse
+	{
+		double	cost;
+		Index	from, to;
+
+		bool operator<(const Collapse &other) const { return cost < other.cost; }
+	};
+
+	/* Identifies a position by the bits of its coordinates */
+	struct PositionKey
+	{
+		uint32_t x, y, z;
+
+		PositionKey(const Point3 &p) { std::memcpy(&x, &p.x, 4); std::memcpy(&y, &p.y, 4); std::memcpy(&z, &p.z, 4); }
+		bool operator==(const PositionKey &other) const { return x == other.x && y == other.y && z == other.z; }
+	};
+
+	struct PositionKeyHash
+	{
+		size_t operator()(const PositionKey &key) const { return (key.x * 73856093u) ^ (key.y * 19349663u) ^ (key.z * 83492791u); }
+	};
+
+	vmml::Vector3f position(const Vertex &vertex)
+	{
+		return vmml::Vector3f(vertex.position.x, vertex.position.y, vertex.position.z);
+	}
+
+	/* Locks vertices that share their position with others (seams of other attributes) and vertices on borders or non-manifold edges */
+	std::vector< bool > findLockedVertices(const GeometryData::VboVertices &vertices, const GeometryData::VboIndices &indices)
+	{
+		std::vector< bool > locked(vertices.size(), false);
+
+		std::unordered_map< PositionKey, Index, PositionKeyHash > positions;
+		std::vector< Index > welded(vertices.size());
+		for (size_t v = 0; v < vertices.size(); ++v)
+		{
+			auto inserted = positions.insert(std::make_pair(PositionKey(vertices[v].position), static_cast<Index>(v)));
+			welded[v] = inserted.first->second;
+			if (!inserted.second)
+				locked[v] = locked[inserted.first->second] = true;
+		}
+
+		// inner edges are shared by exactly two triangles
+		std::unordered_map< uint64_t, GLuint > edgeTriangles;
+		auto edgeKey = [&welded](Index a, Index b)
+		{
+			Index wa = welded[a], wb = welded[b];
+			return wa < wb ? (static_cast<uint64_t>(wa) << 32) | wb : (static_cast<uint64_t>(wb) << 32) | wa;
+		};
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			for (size_t k = 0; k < 3; ++k)
+				edgeTriangles[edgeKey(indices[i + k], indices[i + (k + 1) % 3])]++;
+		}
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			for (size_t k = 0; k < 3; ++k)
+			{
+				Index a = indices[i + k], b = indices[i + (k + 1) % 3];
+				if (edgeTriangles[edgeKey(a, b)] != 2)
+					locked[a] = locked[b] = true;
+			}
+		}
+		return locked;
+	}
+}
+
+/* Public functions */
+
+GeometryData::VboIndices MeshSimplifier::simplify(const GeometryData::VboVertices &vertices, const GeometryData::VboIndices &indices, size_t targetIndexCount)
+{
+	const size_t nVertices = vertices.size();
+	GeometryData::VboIndices result(indices.begin(), indices.begin() + indices.size() / 3 * 3);
+	if (result.size() <= targetIndexCount)
+		return result;
+
+	std::vector< bool > locked = findLockedVertices(vertices, result);
+
+	// every vertex starts with the planes of its triangles, weighted by their area
+	std::vector< Quadric > quadrics(nVertices);
+	for (size_t i = 0; i < result.size(); i += 3)
+	{
+		vmml::Vector3f p1 = position(vertices[result[i]]);
+		vmml::Vector3f normal = (position(vertices[result[i + 1]]) - p1).cross(position(vertices[result[i + 2]]) - p1);
+		GLfloat length = normal.length();
+		if (length <= 0.0f)
+			continue;
+		normal /= length;
+		double d = -normal.dot(p1);
+		for (size_t k = 0; k < 3; ++k)
+			quadrics[result[i + k]].addPlane(normal.x(), normal.y(), normal.z(), d, 0.5 * length);
+	}
+
+	std::vector< size_t > adjacencyOffsets(nVertices + 1), adjacency;
+	std::vector< Collapse > collapses;
+	std::vector< bool > touched(nVertices);
+	std::vector< Index > remap(nVertices);
+
+	// Every pass collapses the cheapest edges whose neighborhoods don't overlap, then the triangles are rebuilt
+	while (result.size() > targetIndexCount)
+	{
+		const size_t nTriangles = result.size() / 3;
+
+		std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+		for (size_t i = 0; i < result.size(); ++i)
+			adjacencyOffsets[result[i] + 1]++;
+		for (size_t v = 0; v < nVertices; ++v)
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		adjacency.resize(result.size());
+		{
+			std::vector< size_t > fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < result.size(); ++i)
+				adjacency[fill[result[i]]++] = i / 3;
+		}
+
+		// inner edges appear in two triangles in opposite directions, so only one of them adds the collapses
+		collapses.clear();
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			for (size_t k = 0; k < 3; ++k)
+			{
+				Index a = result[i + k], b = result[i + (k + 1) % 3];
+				if (a >= b)
+					continue;
+				Quadric q = quadrics[a];
+				q += quadrics[b];
+				if (!locked[a])
+					collapses.push_back(Collapse{ q.error(vertices[b].position), a, b });
+				if (!locked[b])
+					collapses.push_back(Collapse{ q.error(vertices[a].position), b, a });
+			}
+		}
+		std::sort(collapses.begin(), collapses.end());
+
+		std::fill(touched.begin(), touched.end(), false);
+		for (size_t v = 0; v < nVertices; ++v)
+			remap[v] = static_cast<Index>(v);
+
+		size_t removed = 0, applied = 0;
+		for (auto c = collapses.begin(); c != collapses.end() && (nTriangles - removed) * 3 > targetIndexCount; ++c)
+		{
+			if (touched[c->from] || touched[c->to])
+				continue;
+
+			// the triangles that remain must not flip
+			bool flips = false;
+			vmml::Vector3f target = position(vertices[c->to]);
+			for (size_t a = adjacencyOffsets[c->from]; a < adjacencyOffsets[c->from + 1] && !flips; ++a)
+			{
+				const Index *t = &result[adjacency[a] * 3];
+				if (t[0] == c->to || t[1] == c->to || t[2] == c->to)
+					continue;
+				vmml::Vector3f p[3], q[3];
+				for (size_t k = 0; k < 3; ++k)
+				{
+					p[k] = position(vertices[t[k]]);
+					q[k] = t[k] == c->from ? target : p[k];
+				}
+				vmml::Vector3f before = (p[1] - p[0]).cross(p[2] - p[0]);
+				vmml::Vector3f after = (q[1] - q[0]).cross(q[2] - q[0]);
+				flips = before.dot(after) <= 0.0f;
+			}
+			if (flips)
+				continue;
+
+			remap[c->from] = c->to;
+			quadrics[c->to] += quadrics[c->from];
+			for (size_t a = adjacencyOffsets[c->from]; a < adjacencyOffsets[c->from + 1]; ++a)
+			{
+				const Index *t = &result[adjacency[a] * 3];
+				touched[t[0]] = touched[t[1]] = touched[t[2]] = true;
+				if (t[0] == c->to || t[1] == c->to || t[2] == c->to)
+					removed++;
+			}
+			applied++;
+		}
+		if (applied == 0)
+			break;
+
+		// drop the triangles that collapsed
+		size_t n = 0;
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			Index a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+			if (a == b || b == c || a == c)
+				continue;
+			result[n++] = a;
+			result[n++] = b;
+			result[n++] = c;
+		}
+		result.resize(n);
+	}
+	return result;
+}
+
+void MeshSimplifier::createLevelsOfDetail(GeometryData &group, GLuint nLevels, GLfloat reduction)
+{
+	group.levelsOfDetail.clear();
+	GeometryData::VboIndices indices = group.vboIndices;
+	for (GLuint level = 1; level <= nLevels; ++level)
+	{
+		size_t target = static_cast<size_t>(indices.size() / 3 * reduction) * 3;
+		GeometryData::VboIndices simplified = simplify(group.vboVertices, indices, target);
+
+		// stop once less than half of the intended reduction is possible
+		if (simplified.empty() || simplified.size() > indices.size() - (indices.size() - target) / 2)
+			break;
+		indices.swap(simplified);
+
+		// every level only keeps the vertices it uses
+		GeometryDataPtr lod = GeometryDataPtr(new GeometryData);
+		lod->materialData = group.materialData;
+		lod->vertexComponents = group.vertexComponents;
+		std::vector< Index > remap(group.vboVertices.size(), NO_INDEX);
+		lod->vboIndices.reserve(indices.size());
+		for (auto i = indices.begin(); i != indices.end(); ++i)
+		{
+			if (remap[*i] == NO_INDEX)
+			{
+				remap[*i] = static_cast<Index>(lod->vboVertices.size());
+				lod->vboVertices.push_back(group.vboVertices[*i]);
+			}
+			lod->vboIndices.push_back(remap[*i]);
+		}
+		group.levelsOfDetail.push_back(lod);
+	}
+}
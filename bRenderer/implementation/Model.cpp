@@ -2,6 +2,9 @@
 #include "headers/ModelData.h"
 #include "headers/TextureData.h"
 #include "headers/ObjectManager.h"
+#include "headers/Configuration.h"
+#include <algorithm>
+#include <cmath>
 
 Model::Model(ObjectManager *o, const ModelData &modelData, GLuint shaderMaxLights, bool variableNumberOfLights, bool shaderFromFile, bool ambientLighting, PropertiesPtr properties)
 	: _properties(properties)
@@ -15,9 +18,9 @@ Model::Model(ObjectManager *o, const ModelData &modelData, GLuint shaderMaxLight
 		GeometryDataPtr gData = i->second;
 
 		MaterialPtr material = o->createMaterialShaderCombination(gData->materialData.name, gData->materialData, shaderFromFile, shaderMaxLights, variableNumberOfLights, ambientLighting);
-		g->initialize(gData);
 		g->setMaterial(material);
 		g->setProperties(properties);
+		g->initialize(gData);
 
 		// expand bounding box
 		_boundingBox.merge(g->getBoundingBoxObjectSpace());
@@ -34,9 +37,9 @@ Model::Model(ObjectManager *o, const ModelData &modelData, ShaderPtr shader, Pro
 		_groups.insert(std::pair< std::string, GeometryPtr >(i->first, g));
         GeometryDataPtr gData = i->second;
 		MaterialPtr material = o->createMaterial(gData->materialData.name, gData->materialData, shader);
-        g->initialize(gData);
         g->setMaterial(material);
 		g->setProperties(properties);
+        g->initialize(gData);
 
 		// expand bounding box
 		_boundingBox.merge(g->getBoundingBoxObjectSpace());
@@ -53,9 +56,9 @@ Model::Model(const ModelData &modelData, MaterialPtr material, PropertiesPtr pro
 		GeometryPtr g = GeometryPtr(new Geometry);
 		_groups.insert(std::pair< std::string, GeometryPtr >(i->first, g));
 		GeometryDataPtr gData = i->second;
-		g->initialize(gData);
 		g->setMaterial(material);
 		g->setProperties(properties);
+		g->initialize(gData);
 
 		// expand bounding box
 		_boundingBox.merge(g->getBoundingBoxObjectSpace());
@@ -107,6 +110,46 @@ Model::InstanceMapPtr Model::addInstance(const std::string &instanceName)
 	return instanceMap;
 }
 
+GLuint Model::getNumLevelsOfDetail()
+{
+	GLuint nLevels = 0;
+	for (auto i = _groups.begin(); i != _groups.end(); ++i)
+		nLevels = std::max(nLevels, i->second->getNumLevelsOfDetail());
+	return nLevels;
+}
+
+GLuint Model::selectLevelOfDetail(const std::string &instanceName, GLfloat screenSize)
+{
+	GLuint nLevels = getNumLevelsOfDetail();
+	GLuint &level = _instanceLevels[instanceName];
+	level = std::min(level, nLevels);
+
+	GLfloat step = std::sqrt(bRenderer::LOD_REDUCTION());
+	GLfloat hysteresis = bRenderer::LOD_HYSTERESIS();
+	auto threshold = [step](GLuint i) { return bRenderer::LOD_SCREEN_SIZE() * std::pow(step, static_cast<GLfloat>(i)); };
+
+	while (level < nLevels && screenSize < threshold(level) * (1.0f - hysteresis))
+		level++;
+	while (level > 0 && screenSize >= threshold(level - 1) * (1.0f + hysteresis))
+		level--;
+	return level;
+}
+
+GLuint Model::selectLevelOfDetail(GLfloat screenSize)
+{
+	GLuint nLevels = getNumLevelsOfDetail();
+	GLfloat threshold = bRenderer::LOD_SCREEN_SIZE();
+	GLfloat step = std::sqrt(bRenderer::LOD_REDUCTION());
+
+	GLuint level = 0;
+	while (level < nLevels && screenSize < threshold)
+	{
+		level++;
+		threshold *= step;
+	}
+	return level;
+}
+
 PropertiesPtr Model::getInstanceProperties(const std::string &instanceName, const std::string &geometryName)
 {
 	return _groups[geometryName]->getInstanceProperties(instanceName);
@@ -123,6 +166,7 @@ void Model::removeInstance(const std::string &instanceName)
 {
 	// remove from model
 	_instances.erase(instanceName);
+	_instanceLevels.erase(instanceName);
 	// remove from associated geometry
 	for (auto i = _groups.begin(); i != _groups.end(); ++i)
 	{
@@ -134,6 +178,7 @@ void Model::clearInstances()
 {
 	// clear in model
 	_instances.clear();
+	_instanceLevels.clear();
 	// clear in associated geometry
 	for (auto i = _groups.begin(); i != _groups.end(); ++i)
 	{
@@ -0,0 +1,274 @@
+#include "headers/ModelCache.h"
+#include "headers/BinaryFile.h"
+#include "headers/FileHandler.h"
+#include "headers/Configuration.h"
+#include "headers/Logger.h"
+#include <algorithm>
+
+namespace
+{
+	const char MAGIC[8] = { 'B', 'M', 'E', 'S', 'H', 0, 0, 0 };
+	const uint32_t ENDIANNESS_MARKER = 0x01020304;
+	const size_t BLOB_ALIGNMENT = 16;
+
+	void writeMaterial(BinaryWriter &writer, const MaterialData &material)
+	{
+		writer.string(material.name);
+		writer.value(static_cast<uint32_t>(material.textures.size()));
+		for (auto i = material.textures.begin(); i != material.textures.end(); ++i){
+			writer.string(i->first);
+			writer.string(i->second);
+		}
+		writer.value(static_cast<uint32_t>(material.cubeTextures.size()));
+		for (auto i = material.cubeTextures.begin(); i != material.cubeTextures.end(); ++i){
+			writer.string(i->first);
+			writer.string(i->second);
+		}
+		writer.value(static_cast<uint32_t>(material.vectors.size()));
+		for (auto i = material.vectors.begin(); i != material.vectors.end(); ++i){
+			writer.string(i->first);
+			writer.value(i->second.x());
+			writer.value(i->second.y());
+			writer.value(i->second.z());
+		}
+		writer.value(static_cast<uint32_t>(material.scalars.size()));
+		for (auto i = material.scalars.begin(); i != material.scalars.end(); ++i){
+			writer.string(i->first);
+			writer.value(i->second);
+		}
+	}
+
+	void readMaterial(BinaryReader &reader, MaterialData &material)
+	{
+		material.name = reader.string();
+		uint32_t n = reader.value< uint32_t >();
+		for (uint32_t i = 0; i < n && reader.ok(); i++){
+			std::string key = reader.string();
+			material.textures[key] = reader.string();
+		}
+		n = reader.value< uint32_t >();
+		for (uint32_t i = 0; i < n && reader.ok(); i++){
+			std::string key = reader.string();
+			material.cubeTextures[key] = reader.string();
+		}
+		n = reader.value< uint32_t >();
+		for (uint32_t i = 0; i < n && reader.ok(); i++){
+			std::string key = reader.string();
+			GLfloat x = reader.value< GLfloat >();
+			GLfloat y = reader.value< GLfloat >();
+			GLfloat z = reader.value< GLfloat >();
+			material.vectors[key] = vmml::Vector3f(x, y, z);
+		}
+		n = reader.value< uint32_t >();
+		for (uint32_t i = 0; i < n && reader.ok(); i++){
+			std::string key = reader.string();
+			material.scalars[key] = reader.value< GLfloat >();
+		}
+	}
+
+	uint32_t optionFlags(bool flipT, bool flipZ)
+	{
+		return (flipT ? 1 : 0) | (flipZ ? 2 : 0) | (bRenderer::MESH_OPTIMIZATION_ENABLED() ? 4 : 0);
+	}
+
+	/* Writes the sizes of the blobs of a geometry, the offsets are filled in once they are known */
+	void writeGeometryTable(BinaryWriter &writer, const GeometryData &geometry, std::vector< size_t > &offsetPositions)
+	{
+		writer.value(static_cast<uint64_t>(geometry.vboVertices.size()));
+		offsetPositions.push_back(writer.size());
+		writer.value(static_cast<uint64_t>(0));
+		writer.value(static_cast<uint64_t>(geometry.vboIndices.size()));
+		offsetPositions.push_back(writer.size());
+		writer.value(static_cast<uint64_t>(0));
+	}
+
+	void writeGeometryBlobs(BinaryWriter &writer, const GeometryData &geometry, std::vector< size_t >::const_iterator &offsetPosition)
+	{
+		writer.align(BLOB_ALIGNMENT);
+		writer.patch(*offsetPosition++, writer.size());
+		if (!geometry.vboVertices.empty())
+			writer.write(geometry.vboVertices.data(), geometry.vboVertices.size() * sizeof(Vertex));
+		writer.align(BLOB_ALIGNMENT);
+		writer.patch(*offsetPosition++, writer.size());
+		if (!geometry.vboIndices.empty())
+			writer.write(geometry.vboIndices.data(), geometry.vboIndices.size() * sizeof(Index));
+	}
+
+	/* Reads the blobs of a geometry, returns false if they are outside of the file */
+	bool readGeometry(BinaryReader &reader, GeometryData &geometry)
+	{
+		uint64_t nVertices = reader.value< uint64_t >();
+		uint64_t vertexOffset = reader.value< uint64_t >();
+		uint64_t nIndices = reader.value< uint64_t >();
+		uint64_t indexOffset = reader.value< uint64_t >();
+		if (!reader.ok())
+			return false;
+
+		const char *vertices = reader.blob(vertexOffset, nVertices, sizeof(Vertex));
+		const char *indices = reader.blob(indexOffset, nIndices, sizeof(Index));
+		if (!vertices || !indices)
+			return false;
+		// The blobs are aligned, so they can be copied directly
+		const Vertex *v = reinterpret_cast<const Vertex *>(vertices);
+		const Index *idx = reinterpret_cast<const Index *>(indices);
+		geometry.vboVertices.assign(v, v + nVertices);
+		geometry.vboIndices.assign(idx, idx + nIndices);
+		return true;
+	}
+
+	/* Reads the header and the source files, returns false if the cache is outdated */
+	bool readHeader(BinaryReader &reader, const std::string &cachePath, bool flipT, bool flipZ)
+	{
+		char magic[sizeof(MAGIC)];
+		if (!reader.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+			return false;
+		if (reader.value< uint32_t >() != ModelCache::VERSION || reader.value< uint32_t >() != ENDIANNESS_MARKER
+			|| reader.value< uint32_t >() != sizeof(Vertex) || reader.value< uint32_t >() != sizeof(Index)
+			|| reader.value< uint32_t >() != optionFlags(flipT, flipZ)
+			|| reader.value< uint32_t >() != bRenderer::LOD_LEVELS() || reader.value< GLfloat >() != bRenderer::LOD_REDUCTION() || !reader.ok())
+			return false;
+
+		uint32_t nSourceFiles = reader.value< uint32_t >();
+		for (uint32_t i = 0; i < nSourceFiles && reader.ok(); i++)
+		{
+			SourceStamp stamp;
+			if (!stamp.read(reader) || !stamp.isCurrent())
+			{
+				bRenderer::log("Model cache " + cachePath + " is outdated", bRenderer::LM_INFO);
+				return false;
+			}
+		}
+		return reader.ok();
+	}
+}
+
+/* Public functions */
+
+bool ModelCache::read(const std::string &cachePath, bool flipT, bool flipZ, ModelData::GroupMap &groups)
+{
+	bRenderer::MappedFile file(cachePath);
+	if (!file.isOpen())
+		return false;
+	BinaryReader reader(file.begin(), file.end());
+
+	if (!readHeader(reader, cachePath, flipT, flipZ))
+		return false;
+
+	// Groups
+	ModelData::GroupMap result;
+	uint32_t nGroups = reader.value< uint32_t >();
+	for (uint32_t i = 0; i < nGroups && reader.ok(); i++)
+	{
+		std::string name = reader.string();
+		GeometryDataPtr group = GeometryDataPtr(new GeometryData);
+		readMaterial(reader, group->materialData);
+		group->vertexComponents = reader.value< uint32_t >();
+		bool valid = readGeometry(reader, *group);
+		uint32_t nLevels = reader.value< uint32_t >();
+		for (uint32_t j = 0; j < nLevels && valid; j++)
+		{
+			GeometryDataPtr lod = GeometryDataPtr(new GeometryData);
+			lod->materialData = group->materialData;
+			lod->vertexComponents = group->vertexComponents;
+			valid = readGeometry(reader, *lod);
+			group->levelsOfDetail.push_back(lod);
+		}
+		if (!valid)
+		{
+			bRenderer::log("Model cache " + cachePath + " is corrupt", bRenderer::LM_WARNING);
+			return false;
+		}
+		result[name] = group;
+	}
+	if (!reader.ok())
+	{
+		bRenderer::log("Model cache " + cachePath + " is corrupt", bRenderer::LM_WARNING);
+		return false;
+	}
+
+	groups.swap(result);
+	return true;
+}
+
+bool ModelCache::write(const std::string &cachePath, const std::vector< std::string > &sourceFiles, bool flipT, bool flipZ, const ModelData::GroupMap &groups)
+{
+	BinaryWriter writer;
+
+	// Header
+	writer.write(MAGIC, sizeof(MAGIC));
+	writer.value(static_cast<uint32_t>(VERSION));
+	writer.value(ENDIANNESS_MARKER);
+	writer.value(static_cast<uint32_t>(sizeof(Vertex)));
+	writer.value(static_cast<uint32_t>(sizeof(Index)));
+	writer.value(optionFlags(flipT, flipZ));
+	writer.value(static_cast<uint32_t>(bRenderer::LOD_LEVELS()));
+	writer.value(bRenderer::LOD_REDUCTION());
+
+	// Source files
+	writer.value(static_cast<uint32_t>(sourceFiles.size()));
+	for (auto i = sourceFiles.begin(); i != sourceFiles.end(); ++i)
+	{
+		SourceStamp stamp;
+		if (!stamp.create(*i))
+			return false;
+		stamp.write(writer);
+	}
+
+	// Group table, the offsets of the blobs are filled in once they are known
+	std::vector< size_t > offsetPositions;
+	writer.value(static_cast<uint32_t>(groups.size()));
+	for (auto i = groups.begin(); i != groups.end(); ++i)
+	{
+		const GeometryData &group = *i->second;
+		writer.string(i->first);
+		writeMaterial(writer, group.materialData);
+		writer.value(static_cast<uint32_t>(group.vertexComponents));
+		writeGeometryTable(writer, group, offsetPositions);
+		writer.value(static_cast<uint32_t>(group.levelsOfDetail.size()));
+		for (auto lod = group.levelsOfDetail.begin(); lod != group.levelsOfDetail.end(); ++lod)
+			writeGeometryTable(writer, **lod, offsetPositions);
+	}
+
+	// Vertex and index blobs, each group followed by its levels of detail
+	std::vector< size_t >::const_iterator offsetPosition = offsetPositions.begin();
+	for (auto i = groups.begin(); i != groups.end(); ++i)
+	{
+		const GeometryData &group = *i->second;
+		writeGeometryBlobs(writer, group, offsetPosition);
+		for (auto lod = group.levelsOfDetail.begin(); lod != group.levelsOfDetail.end(); ++lod)
+			writeGeometryBlobs(writer, **lod, offsetPosition);
+	}
+
+	// the runtime cache directory is created when the first model is cached
+	size_t separator = cachePath.find_last_of("/");
+	if (separator != std::string::npos && !bRenderer::createDirectory(cachePath.substr(0, separator)))
+		return false;
+	return writer.save(cachePath);
+}
+
+bool ModelCache::isUpToDate(const std::string &cachePath, bool flipT, bool flipZ)
+{
+	bRenderer::MappedFile file(cachePath);
+	BinaryReader reader(file.begin(), file.end());
+	return file.isOpen() && readHeader(reader, cachePath, flipT, flipZ);
+}
+
+std::string ModelCache::getCachePath(const std::string &fileName)
+{
+	return bRenderer::getFilePath(fileName) + bRenderer::MODEL_CACHE_FILE_EXTENSION();
+}
+
+std::string ModelCache::getRuntimeCachePath(const std::string &fileName)
+{
+	std::string directory = bRenderer::MODEL_CACHE_DIRECTORY();
+	if (directory.empty())
+		return getCachePath(fileName);
+	if (directory.find_last_of("/") != directory.length() - 1)
+		directory.append("/");
+
+	// models in subdirectories are flattened into the cache directory, a clash only makes the cache outdated
+	std::string cacheName = fileName;
+	std::replace(cacheName.begin(), cacheName.end(), '/', '_');
+	std::replace(cacheName.begin(), cacheName.end(), '\\', '_');
+	return directory + cacheName + bRenderer::MODEL_CACHE_FILE_EXTENSION();
+}
@@ -3,11 +3,15 @@
 #include "external/obj_parser/obj_parser.hpp"
 #include "headers/FileHandler.h"
 #include "headers/OBJLoader.h"
+#include "headers/Logger.h"
+#include "headers/ModelCache.h"
+#include "headers/MeshOptimizer.h"
+#include "headers/MeshSimplifier.h"
+#include "headers/Configuration.h"
 
 ModelData::ModelData(const std::string &fileName, bool flipT, bool flipZ)
 	: _objLoader(new OBJLoader(this,
                             obj::obj_parser::parse_blank_lines_as_comment |
-                            obj::obj_parser::triangulate_faces            |
                             obj::obj_parser::translate_negative_indices))
 ,   _flipT(flipT)
 ,   _flipZ(flipZ)
@@ -18,7 +22,6 @@ ModelData::ModelData(const std::string &fileName, bool flipT, bool flipZ)
 ModelData::ModelData(bool flipT, bool flipZ)
 	: _objLoader(new OBJLoader(this,
                             obj::obj_parser::parse_blank_lines_as_comment |
-                            obj::obj_parser::triangulate_faces            |
                             obj::obj_parser::translate_negative_indices))
 ,   _flipT(flipT)
 ,   _flipZ(flipZ)
@@ -31,14 +34,83 @@ ModelData::~ModelData()
 
 ModelData::GroupMap ModelData::getData() const
 {
-	return _objLoader->getData();
+	return _groups;
 }
 
 ModelData &ModelData::load(const std::string &fileName)
 {
-    std::ifstream file(bRenderer::getFilePath(fileName), std::ifstream::in);
-	if (!_objLoader) _objLoader = new OBJLoader(this, obj::obj_parser::parse_blank_lines_as_comment | obj::obj_parser::triangulate_faces | obj::obj_parser::translate_negative_indices);
-		_objLoader->load(file);
+	// A valid cache makes parsing unnecessary, cooked caches are used even if the runtime cache is disabled
+	if (ModelCache::read(ModelCache::getCachePath(fileName), _flipT, _flipZ, _groups)
+		|| (bRenderer::MODEL_CACHE_ENABLED() && ModelCache::read(ModelCache::getRuntimeCachePath(fileName), _flipT, _flipZ, _groups)))
+	{
+		bRenderer::log("Loaded " + fileName + " from model cache", bRenderer::LM_INFO);
+		return *this;
+	}
+
+	// Only models that were parsed without errors are cached
+	if (parse(fileName) && bRenderer::MODEL_CACHE_ENABLED())
+		writeCache(fileName, ModelCache::getRuntimeCachePath(fileName));
     return *this;
 }
 
+bool ModelData::cook(const std::string &fileName)
+{
+	return parse(fileName) && writeCache(fileName, ModelCache::getCachePath(fileName));
+}
+
+bool ModelData::parse(const std::string &fileName)
+{
+	bRenderer::MappedFile file(bRenderer::getFilePath(fileName));
+	if (!file.isOpen())
+	{
+		bRenderer::log("Could not open " + fileName, bRenderer::LM_ERROR);
+		return false;
+	}
+	if (!_objLoader) _objLoader = new OBJLoader(this, obj::obj_parser::parse_blank_lines_as_comment | obj::obj_parser::translate_negative_indices);
+	bool loaded = _objLoader->load(file.begin(), file.end());
+	_groups = _objLoader->getData();
+
+	if (bRenderer::MESH_OPTIMIZATION_ENABLED())
+		optimize(fileName);
+	if (bRenderer::LOD_LEVELS() > 0)
+		createLevelsOfDetail(fileName);
+	return loaded;
+}
+
+void ModelData::optimize(const std::string &fileName)
+{
+	for (auto i = _groups.begin(); i != _groups.end(); ++i)
+	{
+		MeshOptimizer::Statistics before = MeshOptimizer::analyze(*i->second);
+		MeshOptimizer::optimize(*i->second);
+		MeshOptimizer::Statistics after = MeshOptimizer::analyze(*i->second);
+		bRenderer::log("Optimized " + fileName + " group " + i->first + ": ACMR " + std::to_string(before.getACMR()) + " -> " + std::to_string(after.getACMR())
+			+ ", ATVR " + std::to_string(before.getATVR()) + " -> " + std::to_string(after.getATVR()), bRenderer::LM_INFO);
+	}
+}
+
+void ModelData::createLevelsOfDetail(const std::string &fileName)
+{
+	for (auto i = _groups.begin(); i != _groups.end(); ++i)
+	{
+		MeshSimplifier::createLevelsOfDetail(*i->second, bRenderer::LOD_LEVELS(), bRenderer::LOD_REDUCTION());
+
+		std::string triangles = std::to_string(i->second->vboIndices.size() / 3);
+		for (auto lod = i->second->levelsOfDetail.begin(); lod != i->second->levelsOfDetail.end(); ++lod)
+		{
+			if (bRenderer::MESH_OPTIMIZATION_ENABLED())
+				MeshOptimizer::optimize(**lod);
+			triangles += ", " + std::to_string((*lod)->vboIndices.size() / 3);
+		}
+		bRenderer::log("Created " + std::to_string(i->second->levelsOfDetail.size()) + " levels of detail for " + fileName + " group " + i->first
+			+ " with " + triangles + " triangles", bRenderer::LM_INFO);
+	}
+}
+
+bool ModelData::writeCache(const std::string &fileName, const std::string &cachePath)
+{
+	std::vector< std::string > sourceFiles(1, fileName);
+	const std::vector< std::string > &materialLibraries = _objLoader->getMaterialLibraries();
+	sourceFiles.insert(sourceFiles.end(), materialLibraries.begin(), materialLibraries.end());
+	return ModelCache::write(cachePath, sourceFiles, _flipT, _flipZ, _groups);
+}
@@ -1,5 +1,7 @@
 #include "headers/ModelRenderer.h"
 #include "headers/Configuration.h"
+#include <algorithm>
+#include <limits>
 
 /* Public functions */
 
@@ -22,6 +24,7 @@ ObjectManagerPtr ModelRenderer::getObjectManager()
 void ModelRenderer::setObjectManager(ObjectManagerPtr o)
 {
 	_objectManager = o;
+	_viewSpaceLights.valid = false;
 }
 
 RenderQueuePtr ModelRenderer::getRenderQueue()
@@ -31,34 +34,53 @@ RenderQueuePtr ModelRenderer::getRenderQueue()
 
 void ModelRenderer::drawModel(const std::string &modelName, const std::string &cameraName, const vmml::Matrix4f & modelMatrix, const std::vector<std::string> &lightNames, bool doFrustumCulling, bool cullIndividualGeometry)
 {
-	drawModel(_objectManager->getModel(modelName), modelMatrix, _objectManager->getCamera(cameraName)->getViewMatrix(), _objectManager->getCamera(cameraName)->getProjectionMatrix(), lightNames, doFrustumCulling, cullIndividualGeometry);
+	CameraPtr camera = _objectManager->getCamera(cameraName);
+	drawModel(_objectManager->getModel(modelName), modelMatrix, camera->getViewMatrix(), camera->getProjectionMatrix(), lightNames, doFrustumCulling, cullIndividualGeometry);
 }
 
 void ModelRenderer::drawModel(ModelPtr model, const vmml::Matrix4f &modelMatrix, const vmml::Matrix4f &viewMatrix, const vmml::Matrix4f &projectionMatrix, const std::vector<std::string> &lightNames, bool doFrustumCulling, bool cullIndividualGeometry)
+{
+	drawModel(model, modelMatrix, viewMatrix, projectionMatrix, _objectManager->getLightHandles(lightNames), doFrustumCulling, cullIndividualGeometry);
+}
+
+void ModelRenderer::drawModel(ModelPtr model, const vmml::Matrix4f &modelMatrix, const vmml::Matrix4f &viewMatrix, const vmml::Matrix4f &projectionMatrix, const std::vector< LightHandle > &lights, bool doFrustumCulling, bool cullIndividualGeometry)
 {
 	vmml::Matrix4f modelViewMatrix = viewMatrix*modelMatrix;
 	vmml::Matrix4f modelViewProjectionMatrix = projectionMatrix*modelViewMatrix;
 	vmml::Visibility visibility = vmml::VISIBILITY_FULL;
+	// The planes are extracted once and used for the model and all its geometry
+	Frustum frustum;
 
 	GLint compareShader = -1;
 
 	// Frustum culling
 	if (doFrustumCulling){
-		visibility = viewFrustumCulling(model->getBoundingBoxObjectSpace(), modelViewProjectionMatrix);
+		frustum.setup(modelViewProjectionMatrix);
+		visibility = frustum.testBox(model->getBoundingBoxObjectSpace());
 		//if (visibility == vmml::VISIBILITY_NONE) 	bRenderer::log(modelName + " was culled");
 	}
 
 	// Draw geometry
 	if (visibility != vmml::VISIBILITY_NONE){
+		// Drawn models have no instance to keep the last level for, so the level is selected without hysteresis
+		GLuint level = 0;
+		if (model->getNumLevelsOfDetail() > 0)
+			level = model->selectLevelOfDetail(getScreenSize(model->getBoundingBoxObjectSpace(), modelViewProjectionMatrix));
+
+		// The lights are gathered once for all shaders of the model
+		const LightPack *lightPack = nullptr;
+
 		Model::GroupMap &groupsModel = model->getGroups();
 		for (auto i = groupsModel.begin(); i != groupsModel.end(); ++i)
 		{
-			GeometryPtr geometry = i->second;
+			// Geometry with fewer levels of detail uses its last one
+			GLuint geometryLevel = std::min(level, i->second->getNumLevelsOfDetail());
+			GeometryPtr geometry = geometryLevel > 0 ? i->second->getLevelOfDetail(geometryLevel) : i->second;
 
 			// Only do frustum culling for the geometry if the model has more than one geometry object, 
 			// otherwise the culling result of the whole model is the same as for the geometry
 			if (doFrustumCulling && cullIndividualGeometry && groupsModel.size() > 1){
-				visibility = viewFrustumCulling(geometry->getBoundingBoxObjectSpace(), modelViewProjectionMatrix);
+				visibility = frustum.testBox(geometry->getBoundingBoxObjectSpace());
 				//if (visibility == vmml::VISIBILITY_NONE) 	bRenderer::log(modelName + " was culled");
 			}
 
@@ -74,27 +96,11 @@ void ModelRenderer::drawModel(ModelPtr model, const vmml::Matrix4f &modelMatrix,
 					shader->setUniform(bRenderer::DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX(), modelViewMatrix);
 
 					// Lighting
-					if (shader->supportsDiffuseLighting() || shader->supportsSpecularLighting()){
-						GLfloat numLights = static_cast<GLfloat>(lightNames.size());
-						bool variableNumberOfLights = shader->supportsVariableNumberOfLights();
-						GLuint maxLights = shader->getMaxLights();
-						if (numLights > maxLights)
-							numLights = static_cast<GLfloat>(maxLights);
-
-						if (variableNumberOfLights && numLights > 0)
-							shader->setUniform(bRenderer::DEFAULT_SHADER_UNIFORM_NUMBER_OF_LIGHTS(), numLights);
-						for (int i = 0; i < numLights; i++){
-							std::string pos = std::to_string(i);
-							LightPtr l = _objectManager->getLight(lightNames[i]);
-							shader->setUniform(bRenderer::DEFAULT_SHADER_UNIFORM_LIGHT_POSITION_VIEW_SPACE() + pos, (viewMatrix*l->getPosition()));
-							if (shader->supportsDiffuseLighting())
-								shader->setUniform(bRenderer::DEFAULT_SHADER_UNIFORM_DIFFUSE_LIGHT_COLOR() + pos, l->getDiffuseColor());
-							if (shader->supportsSpecularLighting())
-								shader->setUniform(bRenderer::DEFAULT_SHADER_UNIFORM_SPECULAR_LIGHT_COLOR() + pos, l->getSpecularColor());
-							shader->setUniform(bRenderer::DEFAULT_SHADER_UNIFORM_LIGHT_INTENSITY() + pos, l->getIntensity());
-							shader->setUniform(bRenderer::DEFAULT_SHADER_UNIFORM_LIGHT_ATTENUATION() + pos, l->getAttenuation());
-							shader->setUniform(bRenderer::DEFAULT_SHADER_UNIFORM_LIGHT_RADIUS() + pos, l->getRadius());
-						}
+					if (shader->supportsDiffuseLighting() || shader->supportsSpecularLighting())
+					{
+						if (!lightPack)
+							lightPack = &getLightPack(viewMatrix, lights);
+						shader->setLights(*lightPack);
 					}
 					// Ambient
 					if (shader->supportsAmbientLighting())
@@ -102,6 +108,7 @@ void ModelRenderer::drawModel(ModelPtr model, const vmml::Matrix4f &modelMatrix,
 				}
 
 				geometry->draw();
+				countTriangles(geometry, geometryLevel);
 			}
 		}
 	}
@@ -109,26 +116,42 @@ void ModelRenderer::drawModel(ModelPtr model, const vmml::Matrix4f &modelMatrix,
 
 void ModelRenderer::queueModelInstance(const std::string &modelName, const std::string &instanceName, const std::string &cameraName, const vmml::Matrix4f & modelMatrix, const std::vector<std::string> &lightNames, bool doFrustumCulling, bool cullIndividualGeometry, bool isTransparent, GLenum blendSfactor, GLenum blendDfactor, GLfloat customDistance)
 {
-	queueModelInstance(_objectManager->getModel(modelName), instanceName, modelMatrix, _objectManager->getCamera(cameraName)->getViewMatrix(), _objectManager->getCamera(cameraName)->getProjectionMatrix(), lightNames, doFrustumCulling, cullIndividualGeometry, isTransparent, blendSfactor, blendDfactor, customDistance);
+	CameraPtr camera = _objectManager->getCamera(cameraName);
+	queueModelInstance(_objectManager->getModel(modelName), instanceName, modelMatrix, camera->getViewMatrix(), camera->getProjectionMatrix(), lightNames, doFrustumCulling, cullIndividualGeometry, isTransparent, blendSfactor, blendDfactor, customDistance);
 }
 
 void ModelRenderer::queueModelInstance(ModelPtr model, const std::string &instanceName, const vmml::Matrix4f &modelMatrix, const vmml::Matrix4f &viewMatrix, const vmml::Matrix4f &projectionMatrix, const std::vector<std::string> &lightNames, bool doFrustumCulling, bool cullIndividualGeometry, bool isTransparent, GLenum blendSfactor, GLenum blendDfactor, GLfloat customDistance)
+{
+	queueModelInstance(model, instanceName, modelMatrix, viewMatrix, projectionMatrix, _objectManager->getLightHandles(lightNames), doFrustumCulling, cullIndividualGeometry, isTransparent, blendSfactor, blendDfactor, customDistance);
+}
+
+void ModelRenderer::queueModelInstance(ModelPtr model, const std::string &instanceName, const vmml::Matrix4f &modelMatrix, const vmml::Matrix4f &viewMatrix, const vmml::Matrix4f &projectionMatrix, const std::vector< LightHandle > &lights, bool doFrustumCulling, bool cullIndividualGeometry, bool isTransparent, GLenum blendSfactor, GLenum blendDfactor, GLfloat customDistance)
 {
 	vmml::Matrix4f modelViewMatrix = viewMatrix*modelMatrix;
 	vmml::Matrix4f modelViewProjectionMatrix = projectionMatrix*modelViewMatrix;
 	vmml::Visibility visibility = vmml::VISIBILITY_FULL;
+	// The planes are extracted once and used for the model and all its geometry
+	Frustum frustum;
 
 	// Frustum culling
 	if (doFrustumCulling){
-		visibility = viewFrustumCulling(model->getBoundingBoxObjectSpace(), modelViewProjectionMatrix);
+		frustum.setup(modelViewProjectionMatrix);
+		visibility = frustum.testBox(model->getBoundingBoxObjectSpace());
 		//if (visibility == vmml::VISIBILITY_NONE) 	bRenderer::log(modelName + " was culled");
 	}
 
+	// Occlusion culling, only if the occluders were rendered with the same camera
+	if (visibility != vmml::VISIBILITY_NONE && _occlusionCuller && _occlusionCuller->getViewProjectionMatrix() == projectionMatrix*viewMatrix){
+		if (!_occlusionCuller->isVisible(model->getBoundingBoxObjectSpace(), modelViewProjectionMatrix))
+			visibility = vmml::VISIBILITY_NONE;
+	}
+
 	// Queue model if visible
 	if (visibility != vmml::VISIBILITY_NONE){
 
 		// Update instance properties
 		Model::InstanceMapPtr instanceMap = model->addInstance(instanceName);
+		const LightPack *lightPack = nullptr;
 		for (auto i = instanceMap->begin(); i != instanceMap->end(); ++i)
 		{
 			ShaderPtr shader = i->first;
@@ -138,74 +161,122 @@ void ModelRenderer::queueModelInstance(ModelPtr model, const std::string &instan
 			properties->setMatrix(bRenderer::DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX(), modelViewMatrix);
 
 			// Lighting
-			if (shader->supportsDiffuseLighting() || shader->supportsSpecularLighting()){
-				GLfloat numLights = static_cast<GLfloat>(lightNames.size());
-				bool variableNumberOfLights = shader->supportsVariableNumberOfLights();
-				GLuint maxLights = shader->getMaxLights();
-				if (numLights > maxLights)
-					numLights = static_cast<GLfloat>(maxLights);
-
-				if (variableNumberOfLights && numLights > 0)
-					properties->setScalar(bRenderer::DEFAULT_SHADER_UNIFORM_NUMBER_OF_LIGHTS(), numLights);
-				for (int i = 0; i < numLights; i++){
-					std::string pos = std::to_string(i);
-					LightPtr l = _objectManager->getLight(lightNames[i]);
-					properties->setVector(bRenderer::DEFAULT_SHADER_UNIFORM_LIGHT_POSITION_VIEW_SPACE() + pos, (viewMatrix*l->getPosition()));
-					if (shader->supportsDiffuseLighting())
-						properties->setVector(bRenderer::DEFAULT_SHADER_UNIFORM_DIFFUSE_LIGHT_COLOR() + pos, l->getDiffuseColor());
-					if (shader->supportsSpecularLighting())
-						properties->setVector(bRenderer::DEFAULT_SHADER_UNIFORM_SPECULAR_LIGHT_COLOR() + pos, l->getSpecularColor());
-					properties->setScalar(bRenderer::DEFAULT_SHADER_UNIFORM_LIGHT_INTENSITY() + pos, l->getIntensity());
-					properties->setScalar(bRenderer::DEFAULT_SHADER_UNIFORM_LIGHT_ATTENUATION() + pos, l->getAttenuation());
-					properties->setScalar(bRenderer::DEFAULT_SHADER_UNIFORM_LIGHT_RADIUS() + pos, l->getRadius());
-				}
+			if (shader->supportsDiffuseLighting() || shader->supportsSpecularLighting())
+			{
+				if (!lightPack)
+					lightPack = &getLightPack(viewMatrix, lights);
+				properties->setLights(*lightPack);
 			}
 			// Ambient
 			if (shader->supportsAmbientLighting())
 				properties->setVector(bRenderer::DEFAULT_SHADER_UNIFORM_AMBIENT_COLOR(), _objectManager->getAmbientColor());
 		}
 
+		GLuint level = 0;
+		if (model->getNumLevelsOfDetail() > 0)
+			level = model->selectLevelOfDetail(instanceName, getScreenSize(model->getBoundingBoxObjectSpace(), modelViewProjectionMatrix));
+
 		// Queue geometry
 		Model::GroupMap &groupsModel = model->getGroups();
 		for (auto i = groupsModel.begin(); i != groupsModel.end(); ++i)
 		{
-			std::string geometryName = i->first;
-			GeometryPtr geometry = i->second;
+			// Geometry with fewer levels of detail uses its last one
+			GLuint geometryLevel = std::min(level, i->second->getNumLevelsOfDetail());
+			GeometryPtr geometry = geometryLevel > 0 ? i->second->getLevelOfDetail(geometryLevel) : i->second;
 
 			// Only do frustum culling for the geometry if the model has more than one geometry object, 
 			// otherwise the culling result of the whole model is the same as for the geometry
 			if (doFrustumCulling && cullIndividualGeometry && groupsModel.size() > 1){
-				visibility = viewFrustumCulling(geometry->getBoundingBoxObjectSpace(), modelViewProjectionMatrix);
+				visibility = frustum.testBox(geometry->getBoundingBoxObjectSpace());
 				//if (visibility == vmml::VISIBILITY_NONE) 	bRenderer::log(modelName + " was culled");
 			}
 
 			if (visibility != vmml::VISIBILITY_NONE){
-				GLuint programID = geometry->getMaterial()->getShader()->getProgramID();
-
-				if (isTransparent){
-					// Find out distance
-					GLfloat distance = customDistance;
-					if (distance > 9999.0f){
-						vmml::Vector3f centerViewSpace = (modelViewProjectionMatrix * geometry->getBoundingBoxObjectSpace().getCenter());
-						distance = centerViewSpace.z();
-					}
-					_renderQueue->submitToRenderQueue(programID, geometry->getMaterial()->getName(), geometryName, instanceName, geometry, distance, isTransparent, blendSfactor, blendDfactor);
+				MaterialPtr material = geometry->getMaterial();
+				GLuint programID = material->getShader()->getProgramID();
+
+				// Find out distance
+				GLfloat distance = customDistance;
+				if (distance > 9999.0f){
+					vmml::Vector3f centerViewSpace = (modelViewProjectionMatrix * geometry->getBoundingBoxObjectSpace().getCenter());
+					distance = centerViewSpace.z();
 				}
-				else
-					_renderQueue->submitToRenderQueue(programID, geometry->getMaterial()->getName(), geometryName, instanceName, geometry);
+				_renderQueue->submitToRenderQueue(programID, material->getID(), geometry->getID(), instanceName, geometry, distance, isTransparent, blendSfactor, blendDfactor);
+				countTriangles(geometry, geometryLevel);
 			}
 		}
 	}
 }
 
+GLuint ModelRenderer::addSceneInstance(const std::string &modelName, const std::string &instanceName, const vmml::Matrix4f &modelMatrix, const std::vector<std::string> &lightNames, bool isTransparent)
+{
+	ModelPtr model = _objectManager->getModel(modelName);
+	GLuint sceneInstanceID = _sceneHierarchy.addObject(BoundingVolumeHierarchy::transformBox(model->getBoundingBoxObjectSpace(), modelMatrix));
+	if (_sceneInstances.size() <= sceneInstanceID)
+		_sceneInstances.resize(sceneInstanceID + 1);
+
+	SceneInstance &instance = _sceneInstances[sceneInstanceID];
+	instance.model = model;
+	instance.instanceName = instanceName;
+	instance.modelMatrix = modelMatrix;
+	// the lights are looked up once instead of every time the scene is queued
+	instance.lights = _objectManager->getLightHandles(lightNames);
+	instance.isTransparent = isTransparent;
+	return sceneInstanceID;
+}
+
+void ModelRenderer::moveSceneInstance(GLuint sceneInstanceID, const vmml::Matrix4f &modelMatrix)
+{
+	if (sceneInstanceID >= _sceneInstances.size() || !_sceneInstances[sceneInstanceID].model)
+		return;
+	SceneInstance &instance = _sceneInstances[sceneInstanceID];
+	instance.modelMatrix = modelMatrix;
+	_sceneHierarchy.moveObject(sceneInstanceID, BoundingVolumeHierarchy::transformBox(instance.model->getBoundingBoxObjectSpace(), modelMatrix));
+}
+
+void ModelRenderer::removeSceneInstance(GLuint sceneInstanceID)
+{
+	if (sceneInstanceID >= _sceneInstances.size())
+		return;
+	_sceneInstances[sceneInstanceID] = SceneInstance();
+	_sceneHierarchy.removeObject(sceneInstanceID);
+}
+
+void ModelRenderer::clearScene()
+{
+	_sceneInstances.clear();
+	_sceneHierarchy.clear();
+}
+
+void ModelRenderer::queueScene(const std::string &cameraName)
+{
+	CameraPtr camera = _objectManager->getCamera(cameraName);
+	queueScene(camera->getViewMatrix(), camera->getProjectionMatrix());
+}
+
+void ModelRenderer::queueScene(const vmml::Matrix4f &viewMatrix, const vmml::Matrix4f &projectionMatrix)
+{
+	_visibleSceneInstances.clear();
+	_sceneHierarchy.cull(Frustum(projectionMatrix*viewMatrix), _visibleSceneInstances);
+
+	// The instances were already tested against the frustum
+	for (auto i = _visibleSceneInstances.begin(); i != _visibleSceneInstances.end(); ++i)
+	{
+		const SceneInstance &instance = _sceneInstances[*i];
+		queueModelInstance(instance.model, instance.instanceName, instance.modelMatrix, viewMatrix, projectionMatrix, instance.lights, false, false, instance.isTransparent);
+	}
+}
+
 void ModelRenderer::drawText(const std::string &textSpriteName, const std::string &cameraName, const vmml::Matrix4f &modelMatrix, const std::vector<std::string> &lightNames, bool doFrustumCulling)
 {
-	drawModel(_objectManager->getTextSprite(textSpriteName), modelMatrix, _objectManager->getCamera(cameraName)->getViewMatrix(), _objectManager->getCamera(cameraName)->getProjectionMatrix(), lightNames, doFrustumCulling, false);
+	CameraPtr camera = _objectManager->getCamera(cameraName);
+	drawModel(_objectManager->getTextSprite(textSpriteName), modelMatrix, camera->getViewMatrix(), camera->getProjectionMatrix(), lightNames, doFrustumCulling, false);
 }
 
 void ModelRenderer::queueTextInstance(const std::string &textSpriteName, const std::string &instanceName, const std::string &cameraName, const vmml::Matrix4f &modelMatrix, const std::vector<std::string> &lightNames, bool doFrustumCulling, GLenum blendSfactor, GLenum blendDfactor, GLfloat customDistance)
 {
-	queueModelInstance(_objectManager->getTextSprite(textSpriteName), instanceName, modelMatrix, _objectManager->getCamera(cameraName)->getViewMatrix(), _objectManager->getCamera(cameraName)->getProjectionMatrix(), lightNames, doFrustumCulling, false, true, blendSfactor, blendDfactor, customDistance);
+	CameraPtr camera = _objectManager->getCamera(cameraName);
+	queueModelInstance(_objectManager->getTextSprite(textSpriteName), instanceName, modelMatrix, camera->getViewMatrix(), camera->getProjectionMatrix(), lightNames, doFrustumCulling, false, true, blendSfactor, blendDfactor, customDistance);
 }
 
 void ModelRenderer::drawQueue(GLenum mode)
@@ -216,11 +287,94 @@ void ModelRenderer::drawQueue(GLenum mode)
 void ModelRenderer::clearQueue()
 {
 	_renderQueue->clear();
+	resetLevelOfDetailStatistics();
 }
 
 vmml::Visibility ModelRenderer::viewFrustumCulling(const vmml::AABBf &aabbObjectSpace, const vmml::Matrix4f &modelViewProjectionMatrix)
 {
-	vmml::FrustumCullerf culler;
-	culler.setup(modelViewProjectionMatrix);
-	return culler.test_aabb(vmml::Vector2f(aabbObjectSpace.getMin().x(), aabbObjectSpace.getMax().x()), vmml::Vector2f(aabbObjectSpace.getMin().y(), aabbObjectSpace.getMax().y()), vmml::Vector2f(aabbObjectSpace.getMin().z(), aabbObjectSpace.getMax().z()));
+	return Frustum(modelViewProjectionMatrix).testBox(aabbObjectSpace);
+}
+
+GLfloat ModelRenderer::getScreenSize(const vmml::AABBf &aabbObjectSpace, const vmml::Matrix4f &modelViewProjectionMatrix)
+{
+	const vmml::Vector3f &min = aabbObjectSpace.getMin();
+	const vmml::Vector3f &max = aabbObjectSpace.getMax();
+	vmml::Vector2f ndcMin(std::numeric_limits<GLfloat>::max()), ndcMax(-std::numeric_limits<GLfloat>::max());
+	for (int corner = 0; corner < 8; corner++)
+	{
+		vmml::Vector4f p = modelViewProjectionMatrix * vmml::Vector4f(corner & 1 ? max.x() : min.x(), corner & 2 ? max.y() : min.y(), corner & 4 ? max.z() : min.z(), 1.0f);
+		if (p.w() <= 0.0f)
+			return 1.0f;
+		for (int k = 0; k < 2; k++)
+		{
+			ndcMin[k] = std::min(ndcMin[k], p[k] / p.w());
+			ndcMax[k] = std::max(ndcMax[k], p[k] / p.w());
+		}
+	}
+	// normalized device coordinates span 2 units across the viewport
+	return std::max(ndcMax.x() - ndcMin.x(), ndcMax.y() - ndcMin.y()) * 0.5f;
+}
+
+const LightPack &ModelRenderer::getLightPack(const vmml::Matrix4f &viewMatrix, const std::vector< LightHandle > &lights)
+{
+	updateViewSpaceLights(viewMatrix);
+
+	ViewSpaceLights &cache = _viewSpaceLights;
+	cache.pack.clear();
+	for (auto i = lights.begin(); i != lights.end(); ++i)
+	{
+		// a light replaced under the same name has a new generation in its slot
+		if (i->index >= cache.objects.size() || !cache.objects[i->index] || cache.generations[i->index] != i->generation)
+			continue;
+		const Light *light = cache.objects[i->index];
+		if (light->getVersion() != cache.versions[i->index])
+			transformLight(i->index, *light);
+		cache.pack.addLight(cache.lights[i->index]);
+	}
+	return cache.pack;
+}
+
+/* Private functions */
+
+void ModelRenderer::countTriangles(GeometryPtr geometry, GLuint level)
+{
+	if (_trianglesPerLevel.size() <= level)
+		_trianglesPerLevel.resize(level + 1, 0);
+	_trianglesPerLevel[level] += geometry->getNumIndices() / 3;
+}
+
+void ModelRenderer::updateViewSpaceLights(const vmml::Matrix4f &viewMatrix)
+{
+	ViewSpaceLights &cache = _viewSpaceLights;
+	const ObjectManager::LightRegistry &registry = _objectManager->getLightRegistry();
+	if (cache.valid && cache.registryVersion == registry.getVersion() && cache.viewMatrix == viewMatrix)
+		return;
+
+	cache.viewMatrix = viewMatrix;
+	size_t numSlots = registry.getNumSlots();
+	cache.lights.resize(numSlots);
+	cache.objects.assign(numSlots, nullptr);
+	cache.generations.assign(numSlots, 0);
+	cache.versions.resize(numSlots);
+	for (auto i = registry.begin(); i != registry.end(); ++i)
+	{
+		LightHandle handle = registry.getHandle(i);
+		cache.objects[handle.index] = i->get();
+		cache.generations[handle.index] = handle.generation;
+		transformLight(handle.index, **i);
+	}
+	cache.registryVersion = registry.getVersion();
+	cache.valid = true;
+}
+
+void ModelRenderer::transformLight(GLuint slot, const Light &light)
+{
+	LightPack::Light &l = _viewSpaceLights.lights[slot];
+	l.positionViewSpace = _viewSpaceLights.viewMatrix*light.getPosition();
+	l.diffuseColor = light.getDiffuseColor();
+	l.specularColor = light.getSpecularColor();
+	l.intensity = light.getIntensity();
+	l.attenuation = light.getAttenuation();
+	l.radius = light.getRadius();
+	_viewSpaceLights.versions[slot] = light.getVersion();
 }
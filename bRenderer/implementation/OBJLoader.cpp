@@ -2,6 +2,7 @@
 #include "headers/Configuration.h"
 #include "headers/Logger.h"
 #include "headers/FileHandler.h"
+#include <thread>
 
 void OBJLoader::info_callback(const std::string& filename, std::size_t line_number, const std::string& message)
 {
@@ -25,17 +26,35 @@ void OBJLoader::geometric_vertex_callback(obj::float_type x, obj::float_type y,
 
 void OBJLoader::texture_vertex_callback(obj::float_type u, obj::float_type v)
 {
-	_texCoords.push_back(vmml::Vector2f(u, v));
+	vmml::Vector2f texCoord(u, v);
+	auto inserted = _texCoordIndices.insert(TexCoordIndexMap::value_type(texCoord, static_cast<Index>(_texCoords.size())));
+	_canonicalTexCoords.push_back(inserted.first->second);
+	_texCoords.push_back(texCoord);
 }
 
 void OBJLoader::vertex_normal_callback(obj::float_type x, obj::float_type y, obj::float_type z)
 {
-	_normals.push_back(vmml::Vector3f(x, y, z));
+	vmml::Vector3f normal(x, y, z);
+	auto inserted = _normalIndices.insert(NormalIndexMap::value_type(normal, static_cast<Index>(_normals.size())));
+	_canonicalNormals.push_back(inserted.first->second);
+	_normals.push_back(normal);
 }
 
 template< bool POSITION, bool TEX_COORD, bool NORMAL >
 void OBJLoader::genVertex(const IndexData &d)
 {
+	// Reuse the vertex if the same combination of position, texture coordinates and normal was used before,
+	// texture coordinates and normals are compared by value
+	static const Index NO_INDEX = std::numeric_limits< Index >::max();
+	VertexKey key = { POSITION ? d.vertexIndex : NO_INDEX, TEX_COORD ? _canonicalTexCoords[d.texCoordsIndex] : NO_INDEX, NORMAL ? _canonicalNormals[d.normalIndex] : NO_INDEX };
+	auto inserted = _vertexIndices->insert(VertexIndexMap::value_type(key, static_cast<Index>(_group->vboVertices.size())));
+	_statistics.nCorners++;
+	if (!inserted.second)
+	{
+		_group->vboIndices.push_back(inserted.first->second);
+		return;
+	}
+
 	Vertex v;
 
 	if (POSITION)
@@ -93,7 +112,7 @@ void OBJLoader::genVertex(const IndexData &d)
 	v.bitangent.z = 0.0;
 
 	_group->vboVertices.push_back(v);
-	_group->vboIndices.push_back(_group->vboIndices.size());
+	_group->vboIndices.push_back(inserted.first->second);
 }
 
 template< bool NORMAL >
@@ -103,11 +122,133 @@ void OBJLoader::genFace(const IndexData &d1, const IndexData &d2, const IndexDat
 	f.v1 = d1.vertexIndex;
 	f.v2 = d2.vertexIndex;
 	f.v3 = d3.vertexIndex;
-	f.normal = vmml::Vector3f::ZERO;
 
 	_faces.push_back(f);
 }
 
+template< bool TEX_COORD, bool NORMAL >
+void OBJLoader::genTriangle(const IndexData &d1, const IndexData &d2, const IndexData &d3)
+{
+	_group->indices.push_back(d1);
+	_group->indices.push_back(d2);
+	_group->indices.push_back(d3);
+
+	genVertex< true, TEX_COORD, NORMAL >(d1);
+	genVertex< true, TEX_COORD, NORMAL >(d2);
+	genVertex< true, TEX_COORD, NORMAL >(d3);
+
+	// face normals are only needed if the file doesn't provide normals
+	if (!NORMAL)
+		genFace< false >(d1, d2, d3);
+}
+
+template< bool TEX_COORD, bool NORMAL >
+void OBJLoader::genPolygon()
+{
+	size_t n = _polygon.size();
+	if (n < 3)
+		return;
+	if (n == 3)
+	{
+		genTriangle< TEX_COORD, NORMAL >(_polygon[0], _polygon[1], _polygon[2]);
+		return;
+	}
+	_statistics.nPolygons++;
+
+	// Project the polygon onto the plane perpendicular to the largest component of its normal (Newell's method)
+	vmml::Vector3f normal = vmml::Vector3f::ZERO;
+	for (size_t i = 0; i < n; i++)
+	{
+		const vmml::Vector3f &a = _vertices[_polygon[i].vertexIndex].position;
+		const vmml::Vector3f &b = _vertices[_polygon[(i + 1) % n].vertexIndex].position;
+		normal += vmml::Vector3f((a.y() - b.y()) * (a.z() + b.z()), (a.z() - b.z()) * (a.x() + b.x()), (a.x() - b.x()) * (a.y() + b.y()));
+	}
+	int axis = 0;
+	if (std::abs(normal.y()) > std::abs(normal[axis])) axis = 1;
+	if (std::abs(normal.z()) > std::abs(normal[axis])) axis = 2;
+	int u = (axis + 1) % 3, v = (axis + 2) % 3;
+	// the projection keeps the orientation if the normal points along the positive axis
+	GLfloat orientation = normal[axis] < 0.0f ? -1.0f : 1.0f;
+
+	_polygonPoints.resize(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		const vmml::Vector3f &p = _vertices[_polygon[i].vertexIndex].position;
+		_polygonPoints[i] = vmml::Vector2f(p[u], p[v]);
+	}
+
+	// Convex polygons are split into a fan
+	bool convex = true;
+	for (size_t i = 0; i < n && convex; i++)
+		convex = isConvexCorner(_polygonPoints[(i + n - 1) % n], _polygonPoints[i], _polygonPoints[(i + 1) % n], orientation);
+	if (convex)
+	{
+		for (size_t i = 1; i + 1 < n; i++)
+			genTriangle< TEX_COORD, NORMAL >(_polygon[0], _polygon[i], _polygon[i + 1]);
+		return;
+	}
+	_statistics.nConcavePolygons++;
+
+	// Concave polygons are triangulated by repeatedly cutting off ears
+	_polygonCorners.resize(n);
+	for (size_t i = 0; i < n; i++)
+		_polygonCorners[i] = i;
+	while (_polygonCorners.size() > 3)
+	{
+		size_t m = _polygonCorners.size();
+		bool foundEar = false;
+		for (size_t i = 0; i < m && !foundEar; i++)
+		{
+			size_t prev = _polygonCorners[(i + m - 1) % m], cur = _polygonCorners[i], next = _polygonCorners[(i + 1) % m];
+			const vmml::Vector2f &a = _polygonPoints[prev], &b = _polygonPoints[cur], &c = _polygonPoints[next];
+			if (!isConvexCorner(a, b, c, orientation))
+				continue;
+
+			// no other corner may lie inside the ear
+			bool isEar = true;
+			for (size_t j = 0; j < m && isEar; j++)
+			{
+				size_t k = _polygonCorners[j];
+				if (k == prev || k == cur || k == next)
+					continue;
+				const vmml::Vector2f &p = _polygonPoints[k];
+				if (p != a && p != b && p != c && isInTriangle(p, a, b, c))
+					isEar = false;
+			}
+			if (isEar)
+			{
+				genTriangle< TEX_COORD, NORMAL >(_polygon[prev], _polygon[cur], _polygon[next]);
+				_polygonCorners.erase(_polygonCorners.begin() + i);
+				foundEar = true;
+			}
+		}
+		// self-intersecting or degenerate polygon, fall back to a fan for the rest
+		if (!foundEar)
+		{
+			for (size_t i = 1; i + 1 < m; i++)
+				genTriangle< TEX_COORD, NORMAL >(_polygon[_polygonCorners[0]], _polygon[_polygonCorners[i]], _polygon[_polygonCorners[i + 1]]);
+			return;
+		}
+	}
+	genTriangle< TEX_COORD, NORMAL >(_polygon[_polygonCorners[0]], _polygon[_polygonCorners[1]], _polygon[_polygonCorners[2]]);
+}
+
+bool OBJLoader::isConvexCorner(const vmml::Vector2f &prev, const vmml::Vector2f &cur, const vmml::Vector2f &next, GLfloat orientation)
+{
+	GLfloat cross = (cur.x() - prev.x()) * (next.y() - cur.y()) - (cur.y() - prev.y()) * (next.x() - cur.x());
+	return cross * orientation > 0.0f;
+}
+
+bool OBJLoader::isInTriangle(const vmml::Vector2f &p, const vmml::Vector2f &a, const vmml::Vector2f &b, const vmml::Vector2f &c)
+{
+	GLfloat d1 = (p.x() - b.x()) * (a.y() - b.y()) - (a.x() - b.x()) * (p.y() - b.y());
+	GLfloat d2 = (p.x() - c.x()) * (b.y() - c.y()) - (b.x() - c.x()) * (p.y() - c.y());
+	GLfloat d3 = (p.x() - a.x()) * (c.y() - a.y()) - (c.x() - a.x()) * (p.y() - a.y());
+	bool hasNegative = (d1 < 0.0f) || (d2 < 0.0f) || (d3 < 0.0f);
+	bool hasPositive = (d1 > 0.0f) || (d2 > 0.0f) || (d3 > 0.0f);
+	return !(hasNegative && hasPositive);
+}
+
 void OBJLoader::triangular_face_geometric_vertices_callback(obj::index_type v1, obj::index_type v2, obj::index_type v3)
 {
 	IndexData d1, d2, d3;
@@ -115,15 +256,7 @@ void OBJLoader::triangular_face_geometric_vertices_callback(obj::index_type v1,
 	d2.vertexIndex = v2 - 1;
 	d3.vertexIndex = v3 - 1;
 
-	_group->indices.push_back(d1);
-	_group->indices.push_back(d2);
-	_group->indices.push_back(d3);
-
-	genVertex< true, false, false >(d1);
-	genVertex< true, false, false >(d2);
-	genVertex< true, false, false >(d3);
-
-	genFace< false >(d1, d2, d3);
+	genTriangle< false, false >(d1, d2, d3);
 }
 
 void OBJLoader::triangular_face_geometric_vertices_texture_vertices_callback(const obj::index_2_tuple_type& v1_vt1, const obj::index_2_tuple_type& v2_vt2, const obj::index_2_tuple_type& v3_vt3)
@@ -136,15 +269,7 @@ void OBJLoader::triangular_face_geometric_vertices_texture_vertices_callback(con
 	d3.vertexIndex = boost::get<0>(v3_vt3) -1;
 	d3.texCoordsIndex = boost::get<1>(v3_vt3) -1;
 
-	_group->indices.push_back(d1);
-	_group->indices.push_back(d2);
-	_group->indices.push_back(d3);
-
-	genVertex< true, true, false >(d1);
-	genVertex< true, true, false >(d2);
-	genVertex< true, true, false >(d3);
-
-	genFace< false >(d1, d2, d3);
+	genTriangle< true, false >(d1, d2, d3);
 }
 
 void OBJLoader::triangular_face_geometric_vertices_vertex_normals_callback(const obj::index_2_tuple_type& v1_vn1, const obj::index_2_tuple_type& v2_vn2, const obj::index_2_tuple_type& v3_vn3)
@@ -157,13 +282,7 @@ void OBJLoader::triangular_face_geometric_vertices_vertex_normals_callback(const
 	d3.vertexIndex = boost::get<0>(v3_vn3) -1;
 	d3.normalIndex = boost::get<1>(v3_vn3) -1;
 
-	_group->indices.push_back(d1);
-	_group->indices.push_back(d2);
-	_group->indices.push_back(d3);
-
-	genVertex< true, false, true >(d1);
-    genVertex< true, false, true >(d2);
-    genVertex< true, false, true >(d3);
+	genTriangle< false, true >(d1, d2, d3);
 }
 
 void OBJLoader::triangular_face_geometric_vertices_texture_vertices_vertex_normals_callback(const obj::index_3_tuple_type& v1_vt1_vn1, const obj::index_3_tuple_type& v2_vt2_vn2, const obj::index_3_tuple_type& v3_vt3_vn3)
@@ -179,73 +298,91 @@ void OBJLoader::triangular_face_geometric_vertices_texture_vertices_vertex_norma
 	d3.texCoordsIndex = boost::get<1>(v3_vt3_vn3) -1;
 	d3.normalIndex = boost::get<2>(v3_vt3_vn3) -1;
 
-	_group->indices.push_back(d1);
-	_group->indices.push_back(d2);
-	_group->indices.push_back(d3);
-
-	genVertex< true, true, true >(d1);
-	genVertex< true, true, true >(d2);
-	genVertex< true, true, true >(d3);
+	genTriangle< true, true >(d1, d2, d3);
 }
 
 void OBJLoader::polygonal_face_geometric_vertices_begin_callback(obj::index_type v1, obj::index_type v2, obj::index_type v3)
 {
-	// (*ostream_) << "f " << v1 << " " << v2 << " " << v3;
+	_polygon.clear();
+	polygonal_face_geometric_vertices_vertex_callback(v1);
+	polygonal_face_geometric_vertices_vertex_callback(v2);
+	polygonal_face_geometric_vertices_vertex_callback(v3);
 }
 
 void OBJLoader::polygonal_face_geometric_vertices_vertex_callback(obj::index_type v)
 {
-	// (*ostream_) << " " << v;
+	IndexData d;
+	d.vertexIndex = v - 1;
+	_polygon.push_back(d);
 }
 
 void OBJLoader::polygonal_face_geometric_vertices_end_callback()
 {
-	// (*ostream_) << "\n";
+	genPolygon< false, false >();
 }
 
 void OBJLoader::polygonal_face_geometric_vertices_texture_vertices_begin_callback(const obj::index_2_tuple_type& v1_vt1, const obj::index_2_tuple_type& v2_vt2, const obj::index_2_tuple_type& v3_vt3)
 {
-	// (*ostream_) << "f " << boost::get<0>(v1_vt1) << "/" << boost::get<1>(v1_vt1) << " " << boost::get<0>(v2_vt2) << "/" << boost::get<1>(v2_vt2) << " " << boost::get<0>(v3_vt3) << "/" << boost::get<1>(v3_vt3);
+	_polygon.clear();
+	polygonal_face_geometric_vertices_texture_vertices_vertex_callback(v1_vt1);
+	polygonal_face_geometric_vertices_texture_vertices_vertex_callback(v2_vt2);
+	polygonal_face_geometric_vertices_texture_vertices_vertex_callback(v3_vt3);
 }
 
 void OBJLoader::polygonal_face_geometric_vertices_texture_vertices_vertex_callback(const obj::index_2_tuple_type& v_vt)
 {
-	// (*ostream_) << " " << boost::get<0>(v_vt) << "/" << boost::get<1>(v_vt);
+	IndexData d;
+	d.vertexIndex = boost::get<0>(v_vt) -1;
+	d.texCoordsIndex = boost::get<1>(v_vt) -1;
+	_polygon.push_back(d);
 }
 
 void OBJLoader::polygonal_face_geometric_vertices_texture_vertices_end_callback()
 {
-	// (*ostream_) << "\n";
+	genPolygon< true, false >();
 }
 
 void OBJLoader::polygonal_face_geometric_vertices_vertex_normals_begin_callback(const obj::index_2_tuple_type& v1_vn1, const obj::index_2_tuple_type& v2_vn2, const obj::index_2_tuple_type& v3_vn3)
 {
-	// (*ostream_) << "f " << boost::get<0>(v1_vn1) << "//" << boost::get<1>(v1_vn1) << " " << boost::get<0>(v2_vn2) << "//" << boost::get<1>(v2_vn2) << " " << boost::get<0>(v3_vn3) << "//" << boost::get<1>(v3_vn3);
+	_polygon.clear();
+	polygonal_face_geometric_vertices_vertex_normals_vertex_callback(v1_vn1);
+	polygonal_face_geometric_vertices_vertex_normals_vertex_callback(v2_vn2);
+	polygonal_face_geometric_vertices_vertex_normals_vertex_callback(v3_vn3);
 }
 
 void OBJLoader::polygonal_face_geometric_vertices_vertex_normals_vertex_callback(const obj::index_2_tuple_type& v_vn)
 {
-	// (*ostream_) << " " << boost::get<0>(v_vn) << "//" << boost::get<1>(v_vn);
+	IndexData d;
+	d.vertexIndex = boost::get<0>(v_vn) -1;
+	d.normalIndex = boost::get<1>(v_vn) -1;
+	_polygon.push_back(d);
 }
 
 void OBJLoader::polygonal_face_geometric_vertices_vertex_normals_end_callback()
 {
-	// (*ostream_) << "\n";
+	genPolygon< false, true >();
 }
 
 void OBJLoader::polygonal_face_geometric_vertices_texture_vertices_vertex_normals_begin_callback(const obj::index_3_tuple_type& v1_vt1_vn1, const obj::index_3_tuple_type& v2_vt2_vn2, const obj::index_3_tuple_type& v3_vt3_vn3)
 {
-	// (*ostream_) << "f " << boost::get<0>(v1_vt1_vn1) << "/" << boost::get<1>(v1_vt1_vn1) << "/" << boost::get<2>(v1_vt1_vn1) << " " << boost::get<0>(v2_vt2_vn2) << "/" << boost::get<1>(v2_vt2_vn2) << "/" << boost::get<2>(v2_vt2_vn2) << " " << boost::get<0>(v3_vt3_vn3) << "/" << boost::get<1>(v3_vt3_vn3) << "/" << boost::get<2>(v3_vt3_vn3);
+	_polygon.clear();
+	polygonal_face_geometric_vertices_texture_vertices_vertex_normals_vertex_callback(v1_vt1_vn1);
+	polygonal_face_geometric_vertices_texture_vertices_vertex_normals_vertex_callback(v2_vt2_vn2);
+	polygonal_face_geometric_vertices_texture_vertices_vertex_normals_vertex_callback(v3_vt3_vn3);
 }
 
 void OBJLoader::polygonal_face_geometric_vertices_texture_vertices_vertex_normals_vertex_callback(const obj::index_3_tuple_type& v_vt_vn)
 {
-	// (*ostream_) << " " << boost::get<0>(v_vt_vn) << "/" << boost::get<1>(v_vt_vn) << "/" << boost::get<2>(v_vt_vn);
+	IndexData d;
+	d.vertexIndex = boost::get<0>(v_vt_vn) -1;
+	d.texCoordsIndex = boost::get<1>(v_vt_vn) -1;
+	d.normalIndex = boost::get<2>(v_vt_vn) -1;
+	_polygon.push_back(d);
 }
 
 void OBJLoader::polygonal_face_geometric_vertices_texture_vertices_vertex_normals_end_callback()
 {
-	// (*ostream_) << "\n";
+	genPolygon< true, true >();
 }
 
 void OBJLoader::group_name_callback(const std::string& group_name)
@@ -262,6 +399,7 @@ void OBJLoader::object_name_callback(const std::string& object_name)
 void OBJLoader::material_library_callback(const std::string& filename)
 {
 	bRenderer::log("mtllib " + filename);
+	_materialLibraries.push_back(filename);
 	loadObjMtl(filename, _materials);
 }
 
@@ -280,9 +418,16 @@ void OBJLoader::comment_callback(const std::string& comment)
 }
 
 bool OBJLoader::load(std::istream& istream)
+{
+	std::string text((std::istreambuf_iterator<char>(istream)), std::istreambuf_iterator<char>());
+	return load(text.data(), text.data() + text.size());
+}
+
+bool OBJLoader::load(const char *begin, const char *end)
 {
 	createGroup(bRenderer::DEFAULT_GROUP_NAME());
 	obj::obj_parser obj_parser(_flags);
+	obj_parser.number_of_threads(std::thread::hardware_concurrency());
 
 	std::string ifilename;
 	obj_parser.info_callback(boost::bind(&OBJLoader::info_callback, this, ifilename, _1, _2));
@@ -316,41 +461,43 @@ bool OBJLoader::load(std::istream& istream)
 	obj_parser.material_name_callback(boost::bind(&OBJLoader::material_name_callback, this, _1));
 	obj_parser.comment_callback(boost::bind(&OBJLoader::comment_callback, this, _1));
 
-	bool ret = obj_parser.parse(istream);
+	bool ret = obj_parser.parse(begin, end);
 
 	// if there is not only vertex- but also face data, update normals accordingly
 	if (_faces.size() > 0)
 	{
-		createFaceNormals();
 		createVertexNormals();
 
 		for (auto i = _groups.begin(); i != _groups.end(); ++i)
 		{
-			for (auto j = i->second->vboIndices.begin(); j != i->second->vboIndices.end(); ++j)
+			// corners sharing a vertex share the position as well, so writing the vertex multiple times gives the same result
+			GeometryData &group = *i->second;
+			for (size_t j = 0; j < group.vboIndices.size(); ++j)
 			{
-				auto idx = i->second->indices[*j].vertexIndex;
+				auto idx = group.indices[j].vertexIndex;
+				Vertex &vertex = group.vboVertices[group.vboIndices[j]];
 
 				vmml::Vector3f cNormal = _vertices[idx].normal;
-				Vector3 &normal = i->second->vboVertices[*j].normal;
+				Vector3 &normal = vertex.normal;
 				normal.x = cNormal.x();
 				normal.y = cNormal.y();
 				normal.z = cNormal.z();
-
-				vmml::Vector3f cTangent = _vertices[idx].tangent;
-				Vector3 &tangent = i->second->vboVertices[*j].tangent;
-				tangent.x = cTangent.x();
-				tangent.y = cTangent.y();
-				tangent.z = cTangent.z();
-
-				vmml::Vector3f cBitangent = _vertices[idx].bitangent;
-				Vector3 &bitangent = i->second->vboVertices[*j].bitangent;
-				bitangent.x = cBitangent.x();
-				bitangent.y = cBitangent.y();
-				bitangent.z = cBitangent.z();
 			}
 		}
 	}
 
+	// tangents need the final normals and texture coordinates of each vertex
+	if (_texCoords.size() > 0)
+	{
+		for (auto i = _groups.begin(); i != _groups.end(); ++i)
+			createTangents(*i->second);
+	}
+
+	// normals are always present (or generated), tangents are only generated if there are texture coordinates
+	VertexLayout::Components components = VertexLayout::VC_NORMAL;
+	if (_texCoords.size() > 0)
+		components |= VertexLayout::VC_TEXCOORD | VertexLayout::VC_TANGENT | VertexLayout::VC_BITANGENT;
+
 	// delete empty groups
 	auto i = _groups.begin();
 	while (i != _groups.end())
@@ -358,9 +505,21 @@ bool OBJLoader::load(std::istream& istream)
 		if (i->second->vboIndices.size() == 0 || i->second->vboVertices.size() == 0)
 			_groups.erase(i++);
 		else
+		{
+			i->second->vertexComponents = components;
 			++i;
+		}
 	}
 
+	_statistics.nVertices = 0;
+	for (auto g = _groups.begin(); g != _groups.end(); ++g)
+		_statistics.nVertices += g->second->vboVertices.size();
+	if (_statistics.nPolygons > 0)
+		bRenderer::log("Triangulated " + std::to_string(_statistics.nPolygons) + " polygons (" + std::to_string(_statistics.nConcavePolygons) + " concave).", bRenderer::LM_INFO);
+	if (_statistics.nCorners > 0)
+		bRenderer::log("Generated " + std::to_string(_statistics.nVertices) + " vertices for " + std::to_string(_statistics.nCorners) + " face corners ("
+			+ std::to_string(100 - (100 * _statistics.nVertices) / _statistics.nCorners) + "% shared).", bRenderer::LM_INFO);
+
 	return ret;
 }
 
@@ -473,89 +632,183 @@ void OBJLoader::loadObjMtl(const std::string &fileName, MaterialMap &materials,
 	}
 }
 
-void OBJLoader::createFaceNormals()
+void OBJLoader::createVertexNormals()
 {
-	for (int i = 0; i < _faces.size(); ++i)
+	const size_t nFaces = _faces.size();
+	const size_t nVertices = _vertices.size();
+	size_t nThreads = std::min< size_t >(std::max(std::thread::hardware_concurrency(), 1u), nFaces / MIN_FACES_PER_THREAD);
+	nThreads = std::max< size_t >(nThreads, 1);
+
+	// every thread adds the normals of a range of faces to its own array
+	std::vector< std::vector< vmml::Vector3f > > normalSums(nThreads);
+	auto accumulate = [this, nFaces, nVertices, nThreads, &normalSums](size_t thread)
 	{
-		// obtain reference to face
-		FaceData &face = _faces[i];
-
-		// obtain indices of this face's three vertices
-		Index indexV1 = face.v1;
-		Index indexV2 = face.v2;
-		Index indexV3 = face.v3;
-
-		// add this face's index to list of adjacent faces of each vertex
-		_vertices[indexV1].faces.push_back(i);
-		_vertices[indexV2].faces.push_back(i);
-		_vertices[indexV3].faces.push_back(i);
-
-		// obtain each of this face's vertex positions
-		const vmml::Vector3f &p1 = _vertices[indexV1].position;
-		const vmml::Vector3f &p2 = _vertices[indexV2].position;
-		const vmml::Vector3f &p3 = _vertices[indexV3].position;
-
-		vmml::Vector3f e = p2 - p1;
-		vmml::Vector3f f = p3 - p1;
-
-		// calculate normal for this face
-		vmml::Vector3f normal = e.cross(f);
-		//invert z Axis
-		normal.set(normal.x(), normal.y(), (-1.0f)*normal.z());
-
-		// set face normal
-		face.normal = vmml::normalize(normal);
-
-		// if texture coordinates for this face exist
-		size_t nT = _texCoords.size();
-		if (nT > indexV1 && nT > indexV2 && nT > indexV3)
+		std::vector< vmml::Vector3f > &normalSum = normalSums[thread];
+		normalSum.assign(nVertices, vmml::Vector3f::ZERO);
+		size_t end = nFaces * (thread + 1) / nThreads;
+		for (size_t i = nFaces * thread / nThreads; i < end; ++i)
 		{
-			vmml::Vector3f v1(0.0, 0.0, 0.0);
-			v1.cross(face.normal, vmml::Vector3f(0.0, 0.0, -1.0));
-			vmml::Vector3f v2(0.0, 0.0, 0.0);
-			v2.cross(face.normal, vmml::Vector3f(0.0, -1.0, 0.0));
-			if (v1.length() > v2.length()){
-				face.tangent = v1;
-			}
-			else{
-				face.tangent = v2;
-			}
-			face.bitangent.cross(face.normal, face.tangent);
-			face.bitangent = vmml::normalize(face.bitangent);
+			const FaceData &face = _faces[i];
+			const vmml::Vector3f &p1 = _vertices[face.v1].position;
+			const vmml::Vector3f &p2 = _vertices[face.v2].position;
+			const vmml::Vector3f &p3 = _vertices[face.v3].position;
+
+			// calculate normal for this face
+			vmml::Vector3f normal = (p2 - p1).cross(p3 - p1);
+			//invert z Axis
+			normal.set(normal.x(), normal.y(), (-1.0f)*normal.z());
+
+			// faces without area don't have a direction
+			GLfloat length = normal.length();
+			if (length <= 0.0f)
+				continue;
+			normal /= length;
+
+			normalSum[face.v1] += normal;
+			normalSum[face.v2] += normal;
+			normalSum[face.v3] += normal;
 		}
+	};
+
+	std::vector< std::thread > threads;
+	for (size_t i = 1; i < nThreads; ++i)
+		threads.push_back(std::thread(accumulate, i));
+	accumulate(0);
+	for (auto i = threads.begin(); i != threads.end(); ++i)
+		i->join();
+
+	std::vector< vmml::Vector3f > &normalSum = normalSums[0];
+	for (size_t i = 1; i < nThreads; ++i)
+	{
+		for (size_t v = 0; v < nVertices; ++v)
+			normalSum[v] += normalSums[i][v];
 	}
-}
 
-void OBJLoader::createVertexNormals()
-{
-	for (VertexData &vertex : _vertices)
+	for (size_t v = 0; v < nVertices; ++v)
 	{
 		// only calculate vertex normal if not present
-		vmml::Vector3f n = vmml::Vector3f::ZERO;
+		VertexData &vertex = _vertices[v];
 		if (vertex.normal.squared_length() < std::numeric_limits< float >::epsilon())
 		{
-			vmml::Vector3f normalSum = vmml::Vector3f::ZERO;
-			for (Index &face : vertex.faces)
-			{
-				normalSum += _faces[face].normal;
-			}
-			n = vmml::normalize(normalSum);
+			if (normalSum[v].squared_length() > 0.0f)
+				vertex.normal = vmml::normalize(normalSum[v]);
 		}
 		else
 		{
-			n = vmml::normalize(vertex.normal);
+			vertex.normal = vmml::normalize(vertex.normal);
 		}
+	}
+}
+
+void OBJLoader::createTangents(GeometryData &group)
+{
+	const size_t nVertices = group.vboVertices.size();
+	const std::vector< Index > &indices = group.vboIndices;
+	std::vector< Vertex > &vertices = group.vboVertices;
+	if (nVertices == 0)
+		return;
+
+	// tangents, bitangents and normals are kept in separate arrays per component so the per vertex pass can be vectorized
+	std::vector< GLfloat > soa(9 * nVertices, 0.0f);
+	GLfloat *tx = &soa[0], *ty = tx + nVertices, *tz = ty + nVertices;
+	GLfloat *bx = tz + nVertices, *by = bx + nVertices, *bz = by + nVertices;
+	GLfloat *nx = bz + nVertices, *ny = nx + nVertices, *nz = ny + nVertices;
+
+	// accumulate the tangent and bitangent of each triangle, weighted by the angle at each corner
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		const Index corner[3] = { indices[i], indices[i + 1], indices[i + 2] };
+		const Vertex &v1 = vertices[corner[0]];
+		const Vertex &v2 = vertices[corner[1]];
+		const Vertex &v3 = vertices[corner[2]];
+
+		const vmml::Vector3f p[3] = {
+			vmml::Vector3f(v1.position.x, v1.position.y, v1.position.z),
+			vmml::Vector3f(v2.position.x, v2.position.y, v2.position.z),
+			vmml::Vector3f(v3.position.x, v3.position.y, v3.position.z)
+		};
+		vmml::Vector3f e1 = p[1] - p[0];
+		vmml::Vector3f e2 = p[2] - p[0];
+		GLfloat ds1 = v2.texCoord.s - v1.texCoord.s, dt1 = v2.texCoord.t - v1.texCoord.t;
+		GLfloat ds2 = v3.texCoord.s - v1.texCoord.s, dt2 = v3.texCoord.t - v1.texCoord.t;
+
+		// triangles without an area in texture space don't define a direction
+		GLfloat det = ds1 * dt2 - ds2 * dt1;
+		if (std::abs(det) < std::numeric_limits< float >::epsilon() * std::numeric_limits< float >::epsilon())
+			continue;
+
+		vmml::Vector3f tangent = (e1 * dt2 - e2 * dt1) * (1.0f / det);
+		vmml::Vector3f bitangent = (e2 * ds1 - e1 * ds2) * (1.0f / det);
+		GLfloat tLength = tangent.length(), bLength = bitangent.length();
+		if (tLength <= 0.0f || bLength <= 0.0f)
+			continue;
+		tangent /= tLength;
+		bitangent /= bLength;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			vmml::Vector3f a = p[(k + 1) % 3] - p[k];
+			vmml::Vector3f b = p[(k + 2) % 3] - p[k];
+			GLfloat lengths = a.length() * b.length();
+			if (lengths <= 0.0f)
+				continue;
+			GLfloat angle = std::acos(std::max(-1.0f, std::min(1.0f, a.dot(b) / lengths)));
+
+			Index v = corner[k];
+			tx[v] += tangent.x() * angle;
+			ty[v] += tangent.y() * angle;
+			tz[v] += tangent.z() * angle;
+			bx[v] += bitangent.x() * angle;
+			by[v] += bitangent.y() * angle;
+			bz[v] += bitangent.z() * angle;
+		}
+	}
+
+	for (size_t v = 0; v < nVertices; ++v)
+	{
+		nx[v] = vertices[v].normal.x;
+		ny[v] = vertices[v].normal.y;
+		nz[v] = vertices[v].normal.z;
+	}
+
+	// Gram-Schmidt: remove the normal component of the tangent and normalize it, degenerate tangents end up with length 0
+	for (size_t v = 0; v < nVertices; ++v)
+	{
+		GLfloat d = nx[v] * tx[v] + ny[v] * ty[v] + nz[v] * tz[v];
+		GLfloat x = tx[v] - nx[v] * d;
+		GLfloat y = ty[v] - ny[v] * d;
+		GLfloat z = tz[v] - nz[v] * d;
+		GLfloat lengthSquared = x * x + y * y + z * z;
+		GLfloat scale = lengthSquared > 1e-12f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+		tx[v] = x * scale;
+		ty[v] = y * scale;
+		tz[v] = z * scale;
+	}
+
+	for (size_t v = 0; v < nVertices; ++v)
+	{
+		Vertex &vertex = vertices[v];
+		vmml::Vector3f n(nx[v], ny[v], nz[v]);
+		vmml::Vector3f t(tx[v], ty[v], tz[v]);
 
-		vmml::Vector3f tangentSum = vmml::Vector3f::ZERO;
-		vmml::Vector3f bitangentSum = vmml::Vector3f::ZERO;
-		for (Index &face : vertex.faces)
+		// vertices without a usable texture mapping get any tangent orthogonal to the normal
+		if (t.squared_length() == 0.0f)
 		{
-			tangentSum += _faces[face].tangent;
-			bitangentSum += _faces[face].bitangent;
+			vmml::Vector3f axis = std::abs(n.z()) < 0.9f ? vmml::Vector3f(0.0f, 0.0f, -1.0f) : vmml::Vector3f(0.0f, -1.0f, 0.0f);
+			t = n.cross(axis);
+			t = t.squared_length() > 0.0f ? vmml::normalize(t) : vmml::Vector3f(1.0f, 0.0f, 0.0f);
 		}
 
-		vertex.normal = n;
-		vertex.tangent = vmml::normalize(tangentSum);
-		vertex.bitangent = vmml::normalize(bitangentSum);
+		// the bitangent is orthogonal to both, pointing to the side of the accumulated bitangent (mirrored texture mappings flip it)
+		vmml::Vector3f b = n.cross(t);
+		if (b.dot(vmml::Vector3f(bx[v], by[v], bz[v])) < 0.0f)
+			b = -b;
+
+		vertex.tangent.x = t.x();
+		vertex.tangent.y = t.y();
+		vertex.tangent.z = t.z();
+		vertex.bitangent.x = b.x();
+		vertex.bitangent.y = b.y();
+		vertex.bitangent.z = b.z();
 	}
 }
@@ -24,8 +24,8 @@ MaterialPtr ObjectManager::loadObjMaterial(const std::string &fileName, const st
 	// log activity
 	bRenderer::log("loading Material: " + materialName, bRenderer::LM_SYS);
 
-	if (getModel(materialName))
-		return _materials[materialName];
+	if (getMaterial(materialName))
+		return getMaterial(materialName);
 
 	MaterialData materialData = OBJLoader::loadMaterial(fileName, materialName);
 
@@ -44,8 +44,8 @@ MaterialPtr ObjectManager::loadObjMaterial(const std::string &fileName, const st
 	// log activity
 	bRenderer::log("loading Material: " + materialName, bRenderer::LM_SYS);
 
-	if (getModel(materialName))
-		return _materials[materialName];
+	if (getMaterial(materialName))
+		return getMaterial(materialName);
 
 	return createMaterial(materialName, OBJLoader::loadMaterial(fileName, materialName), shader);
 }
@@ -59,7 +59,7 @@ ModelPtr ObjectManager::loadObjModel(const std::string &fileName, bool flipT, bo
 	std::string name = getRawName(fileName);
 
 	if (getModel(name))
-		return _models[name];
+		return getModel(name);
 
 	// create model
 	ModelData modelData(fileName, flipT, flipZ);
@@ -75,7 +75,7 @@ ModelPtr ObjectManager::loadObjModel(const std::string &fileName, bool flipT, bo
 	std::string name = getRawName(fileName);
 
 	if (getModel(name))
-		return _models[name];
+		return getModel(name);
 
 	// create model
 	ModelData modelData(fileName, flipT, flipZ);
@@ -92,7 +92,7 @@ ModelPtr ObjectManager::loadObjModel(const std::string &fileName, bool flipT, bo
 	std::string name = getRawName(fileName);
 
 	if (getModel(name))
-		return _models[name];
+		return getModel(name);
 
 	// create model
 	ModelData modelData(fileName, flipT, flipZ);
@@ -105,7 +105,7 @@ TexturePtr ObjectManager::loadTexture(const std::string &fileName)
 	std::string name = getRawName(fileName);
 
 	if (getTexture(name))
-		return _textures[name];
+		return getTexture(name);
 
 	// create texture data
 	TextureData textureData(fileName);
@@ -147,7 +147,7 @@ ShaderPtr ObjectManager::loadShaderFile(const std::string &shaderName, GLuint sh
 	std::string name = getRawName(shaderName);
 
 	if (getShader(name))
-		return _shaders[name];
+		return getShader(name);
 
 	ShaderDataFile shaderData(shaderName, _shaderVersionDesktop, _shaderVersionES, shaderMaxLights, variableNumberOfLights, ambientLighting, diffuseLighting, specularLighting, cubicReflectionMap);
 	ShaderPtr shader = createShader(name, shaderData);
@@ -162,7 +162,7 @@ ShaderPtr ObjectManager::generateShader(const std::string &shaderName, GLuint sh
 	std::string name = getRawName(shaderName);
 
 	if (getShader(name))
-		return _shaders[name];
+		return getShader(name);
 
 	ShaderDataGenerator shaderGenerator(shaderMaxLights, ambientLighting, materialData, variableNumberOfLights, isText);
 	return createShader(name, shaderGenerator);
@@ -173,7 +173,7 @@ ShaderPtr ObjectManager::generateShader(const std::string &shaderName, const Sha
 	std::string name = getRawName(shaderName);
 
 	if (getShader(name))
-		return _shaders[name];
+		return getShader(name);
 
 	ShaderDataGenerator shaderGenerator(shaderGeneratorSettings);
 	return createShader(name, shaderGenerator);
@@ -182,28 +182,25 @@ ShaderPtr ObjectManager::generateShader(const std::string &shaderName, const Sha
 MaterialPtr ObjectManager::createMaterial(const std::string &name, ShaderPtr shader)
 {
 	if (getMaterial(name)) return getMaterial(name);
-	MaterialPtr &material = _materials[name];
-
-	material = MaterialPtr(new Material);
+	MaterialPtr material = MaterialPtr(new Material);
 	material->setShader(shader);
 	material->setName(name);
+	_materials.add(name, material);
 	return material;
 }
 
 MaterialPtr ObjectManager::createMaterial(const std::string &name, const MaterialData &materialData, ShaderPtr shader)
 {
 	if (getMaterial(name)) return getMaterial(name);
-	MaterialPtr &material = _materials[name];
-
-	material = MaterialPtr(new Material);
+	MaterialPtr material = MaterialPtr(new Material);
 	material->initialize(this, materialData, shader);
+	_materials.add(name, material);
 	return material;
 }
 
 MaterialPtr ObjectManager::createMaterialShaderCombination(const std::string &name, const MaterialData &materialData, bool shaderFromFile, GLuint shaderMaxLights, bool variableNumberOfLights, bool ambientLighting, bool isText)
 {
 	if (getMaterial(name)) return getMaterial(name);
-	MaterialPtr &material = _materials[name];
 	ShaderPtr shader;
 
 	if (shaderFromFile){
@@ -217,8 +214,9 @@ MaterialPtr ObjectManager::createMaterialShaderCombination(const std::string &na
 	else{
 		shader = generateShader(name, shaderMaxLights, ambientLighting, materialData, variableNumberOfLights, isText);
 	}
-	material = MaterialPtr(new Material);
+	MaterialPtr material = MaterialPtr(new Material);
 	material->initialize(this, materialData, shader);
+	_materials.add(name, material);
 	return material;
 }
 
@@ -235,54 +233,54 @@ PropertiesPtr ObjectManager::createProperties(const std::string &name)
 ModelPtr ObjectManager::createModel(const std::string &name, const ModelData &modelData, bool shaderFromFile, GLuint shaderMaxLights, bool variableNumberOfLights, bool ambientLighting, PropertiesPtr properties)
 {
 	if (getModel(name)) return getModel(name);
-	ModelPtr &model = _models[name];
-
-	model = ModelPtr(new Model(this, modelData, shaderMaxLights, variableNumberOfLights, shaderFromFile, ambientLighting, properties));
+	ModelPtr model = ModelPtr(new Model(this, modelData, shaderMaxLights, variableNumberOfLights, shaderFromFile, ambientLighting, properties));
+	if (bRenderer::RELEASE_GEOMETRY_CPU_DATA())
+		model->releaseCPUData();
+	_models.add(name, model);
 	return model;
 }
 
 ModelPtr ObjectManager::createModel(const std::string &name, const ModelData &modelData, ShaderPtr shader, PropertiesPtr properties)
 {
 	if (getModel(name)) return getModel(name);
-	ModelPtr &model = _models[name];
-
-	model = ModelPtr(new Model(this, modelData, shader, properties));
+	ModelPtr model = ModelPtr(new Model(this, modelData, shader, properties));
+	if (bRenderer::RELEASE_GEOMETRY_CPU_DATA())
+		model->releaseCPUData();
+	_models.add(name, model);
 	return model;
 }
 
 ModelPtr ObjectManager::createModel(const std::string &name, const ModelData &modelData, MaterialPtr material, PropertiesPtr properties)
 {
 	if (getModel(name)) return getModel(name);
-	ModelPtr &model = _models[name];
-
-	model = ModelPtr(new Model(modelData, material, properties));
+	ModelPtr model = ModelPtr(new Model(modelData, material, properties));
+	if (bRenderer::RELEASE_GEOMETRY_CPU_DATA())
+		model->releaseCPUData();
+	_models.add(name, model);
 	return model;
 }
 
 ModelPtr ObjectManager::createSprite(const std::string &name, MaterialPtr material, bool flipT, PropertiesPtr properties)
 {
 	if (getModel(name)) return getModel(name);
-	ModelPtr &model = _models[name];
-
-	model = ModelPtr(new Sprite(material, flipT, properties));
+	ModelPtr model = ModelPtr(new Sprite(material, flipT, properties));
+	_models.add(name, model);
 	return model;
 }
 
 ModelPtr ObjectManager::createSprite(const std::string &name, const std::string &textureFileName, ShaderPtr shader, bool flipT, PropertiesPtr properties)
 {
 	if (getModel(name)) return getModel(name);
-	ModelPtr &model = _models[name];
-
-	model = ModelPtr(new Sprite(this, textureFileName, name, shader, flipT, properties));
+	ModelPtr model = ModelPtr(new Sprite(this, textureFileName, name, shader, flipT, properties));
+	_models.add(name, model);
 	return model;
 }
 
 ModelPtr ObjectManager::createSprite(const std::string &name, const std::string &textureFileName, GLuint shaderMaxLights, bool variableNumberOfLights, bool flipT, PropertiesPtr properties)
 {
 	if (getModel(name)) return getModel(name);
-	ModelPtr &model = _models[name];
-
-	model = ModelPtr(new Sprite(this, name, textureFileName, shaderMaxLights, variableNumberOfLights, flipT, properties));
+	ModelPtr model = ModelPtr(new Sprite(this, name, textureFileName, shaderMaxLights, variableNumberOfLights, flipT, properties));
+	_models.add(name, model);
 	return model;
 }
 
@@ -307,23 +305,21 @@ TextSpritePtr ObjectManager::createTextSprite(const std::string &name, MaterialP
 TexturePtr ObjectManager::createTexture(const std::string &name, const TextureData &textureData)
 {
 	if (getTexture(name)) return getTexture(name);
-	TexturePtr &texture = _textures[name];
-
-	texture = TexturePtr(new Texture(textureData));
+	TexturePtr texture = TexturePtr(new Texture(textureData));
 
+	_textures.add(name, texture);
 	return texture;
 }
 
 TexturePtr ObjectManager::createTexture(const std::string &name, GLsizei width, GLsizei height, GLenum format, ImageDataPtr imageData)
 {
 	if (getTexture(name)) return getTexture(name);
-	TexturePtr &texture = _textures[name];
-
 	// create texture
 	TextureData textureData(width, height, format, imageData);
 
-	texture = TexturePtr(new Texture(textureData));
+	TexturePtr texture = TexturePtr(new Texture(textureData));
 
+	_textures.add(name, texture);
 	return texture;
 }
 
@@ -373,15 +369,13 @@ ShaderPtr ObjectManager::createShader(const std::string &name, const IShaderData
 	if (shaderData.isValid())
 	{
 		if (getShader(name)) return getShader(name);
-		ShaderPtr &shader = _shaders[name];
-
 		bRenderer::log("Created shader '" + name + "'.", bRenderer::LM_INFO);
-		shader = ShaderPtr(new Shader(shaderData));
-		shader->registerAttrib(bRenderer::DEFAULT_SHADER_ATTRIBUTE_POSITION(), 3, GL_FLOAT, sizeof(Vertex), offsetof(Vertex, position));
-		shader->registerAttrib(bRenderer::DEFAULT_SHADER_ATTRIBUTE_NORMAL(), 3, GL_FLOAT, sizeof(Vertex), offsetof(Vertex, normal));
-		shader->registerAttrib(bRenderer::DEFAULT_SHADER_ATTRIBUTE_TANGENT(), 3, GL_FLOAT, sizeof(Vertex), offsetof(Vertex, tangent));
-		shader->registerAttrib(bRenderer::DEFAULT_SHADER_ATTRIBUTE_BITANGENT(), 3, GL_FLOAT, sizeof(Vertex), offsetof(Vertex, bitangent));
-		shader->registerAttrib(bRenderer::DEFAULT_SHADER_ATTRIBUTE_TEXCOORD(), 2, GL_FLOAT, sizeof(Vertex), offsetof(Vertex, texCoord));
+		ShaderPtr shader = ShaderPtr(new Shader(shaderData));
+		// the attributes are registered with the layout of the Vertex struct, geometry may bind them with a more compact layout
+		const VertexLayout &layout = VertexLayout::get(VertexLayout::VC_ALL);
+		for (auto i = layout.getAttributes().begin(); i != layout.getAttributes().end(); ++i)
+			shader->registerAttrib(i->name, i->size, i->type, layout.getStride(), i->offset);
+		_shaders.add(name, shader);
 		return shader;
 	}
 
@@ -391,36 +385,32 @@ ShaderPtr ObjectManager::createShader(const std::string &name, const IShaderData
 CameraPtr ObjectManager::createCamera(const std::string &name)
 {
 	if (getCamera(name)) return getCamera(name);
-	CameraPtr &camera = _cameras[name];
-
-	camera = CameraPtr(new Camera());
+	CameraPtr camera = CameraPtr(new Camera());
+	_cameras.add(name, camera);
 	return camera;
 }
 
 CameraPtr ObjectManager::createCamera(const std::string &name, const vmml::Vector3f &position, const vmml::Vector3f &rotationAxes)
 {
 	if (getCamera(name)) return getCamera(name);
-	CameraPtr &camera = _cameras[name];
-
-	camera = CameraPtr(new Camera(position, rotationAxes));
+	CameraPtr camera = CameraPtr(new Camera(position, rotationAxes));
+	_cameras.add(name, camera);
 	return camera;
 }
 
 CameraPtr ObjectManager::createCamera(const std::string &name, GLfloat fov, GLfloat aspect, GLfloat near, GLfloat far)
 {
 	if (getCamera(name)) return getCamera(name);
-	CameraPtr &camera = _cameras[name];
-
-	camera = CameraPtr(new Camera(fov, aspect, near, far));
+	CameraPtr camera = CameraPtr(new Camera(fov, aspect, near, far));
+	_cameras.add(name, camera);
 	return camera;
 }
 
 CameraPtr ObjectManager::createCamera(const std::string &name, const vmml::Vector3f &position, const vmml::Vector3f &rotationAxes, GLfloat fov, GLfloat aspect, GLfloat near, GLfloat far)
 {
 	if (getCamera(name)) return getCamera(name);
-	CameraPtr &camera = _cameras[name];
-
-	camera = CameraPtr(new Camera(position, rotationAxes, fov, aspect, near, far));
+	CameraPtr camera = CameraPtr(new Camera(position, rotationAxes, fov, aspect, near, far));
+	_cameras.add(name, camera);
 	return camera;
 }
 
@@ -436,36 +426,32 @@ MatrixStackPtr ObjectManager::createMatrixStack(const std::string &name)
 LightPtr ObjectManager::createLight(const std::string &name)
 {
 	if (getLight(name)) return getLight(name);
-	LightPtr &light = _lights[name];
-
-	light = LightPtr(new Light());
+	LightPtr light = LightPtr(new Light());
+	_lights.add(name, light);
 	return light;
 }
 
 LightPtr ObjectManager::createLight(const std::string &name, const vmml::Vector3f &position, const vmml::Vector3f &color)
 {
 	if (getLight(name)) return getLight(name);
-	LightPtr &light = _lights[name];
-
-	light = LightPtr(new Light(position, color));
+	LightPtr light = LightPtr(new Light(position, color));
+	_lights.add(name, light);
 	return light;
 }
 
 LightPtr ObjectManager::createLight(const std::string &name, const vmml::Vector3f &position, const vmml::Vector3f &color, GLfloat intensity, GLfloat attenuation, GLfloat radius)
 {
 	if (getLight(name)) return getLight(name);
-	LightPtr &light = _lights[name];
-
-	light = LightPtr(new Light(position, color, intensity, attenuation, radius));
+	LightPtr light = LightPtr(new Light(position, color, intensity, attenuation, radius));
+	_lights.add(name, light);
 	return light;
 }
 
 LightPtr ObjectManager::createLight(const std::string &name, const vmml::Vector3f &position, const vmml::Vector3f &diffuseColor, const vmml::Vector3f &specularColor, GLfloat intensity, GLfloat attenuation, GLfloat radius)
 {
 	if (getLight(name)) return getLight(name);
-	LightPtr &light = _lights[name];
-
-	light = LightPtr(new Light(position, diffuseColor, specularColor, intensity, attenuation, radius));
+	LightPtr light = LightPtr(new Light(position, diffuseColor, specularColor, intensity, attenuation, radius));
+	_lights.add(name, light);
 	return light;
 }
 
@@ -488,15 +474,13 @@ FramebufferPtr ObjectManager::createFramebuffer(const std::string &name, GLint w
 bool ObjectManager::addShader(const std::string &name, ShaderPtr ptr)
 {
 	if (getShader(name)) return false;
-	_shaders.insert(ShaderMap::value_type(name, ptr));
-	return true;
+	return _shaders.add(name, ptr).isValid();
 }
 
 bool ObjectManager::addTexture(const std::string &name, TexturePtr ptr)
 {
 	if (getTexture(name)) return false;
-	_textures.insert(TextureMap::value_type(name, ptr));
-	return true;
+	return _textures.add(name, ptr).isValid();
 }
 
 bool ObjectManager::addCubeMap(const std::string &name, CubeMapPtr ptr)
@@ -523,8 +507,7 @@ bool ObjectManager::addFont(const std::string &name, FontPtr ptr)
 bool ObjectManager::addMaterial(const std::string &name, MaterialPtr ptr)
 {
 	if (getMaterial(name)) return false;
-	_materials.insert(MaterialMap::value_type(name, ptr));
-	return true;
+	return _materials.add(name, ptr).isValid();
 }
 
 bool ObjectManager::addProperties(const std::string &name, PropertiesPtr ptr)
@@ -537,8 +520,7 @@ bool ObjectManager::addProperties(const std::string &name, PropertiesPtr ptr)
 bool ObjectManager::addModel(const std::string &name, ModelPtr ptr)
 {
 	if (getModel(name)) return false;
-	_models.insert(ModelMap::value_type(name, ptr));
-	return true;
+	return _models.add(name, ptr).isValid();
 }
 
 bool ObjectManager::addTextSprite(const std::string &name, TextSpritePtr ptr)
@@ -551,8 +533,7 @@ bool ObjectManager::addTextSprite(const std::string &name, TextSpritePtr ptr)
 bool ObjectManager::addCamera(const std::string &name, CameraPtr ptr)
 {
 	if (getCamera(name)) return false;
-	_cameras.insert(CameraMap::value_type(name, ptr));
-	return true;
+	return _cameras.add(name, ptr).isValid();
 }
 
 bool ObjectManager::addMatrixStack(const std::string &name, MatrixStackPtr ptr)
@@ -565,8 +546,7 @@ bool ObjectManager::addMatrixStack(const std::string &name, MatrixStackPtr ptr)
 bool ObjectManager::addLight(const std::string &name, LightPtr ptr)
 {
 	if (getLight(name)) return false;
-	_lights.insert(LightMap::value_type(name, ptr));
-	return true;
+	return _lights.add(name, ptr).isValid();
 }
 
 bool ObjectManager::addFramebuffer(const std::string &name, FramebufferPtr ptr)
@@ -585,99 +565,169 @@ bool ObjectManager::addDrawable(const std::string &name, DrawablePtr ptr)
 
 ShaderPtr ObjectManager::getShader(const std::string &name)
 {
-	if (_shaders.count(name) > 0)
-		return _shaders[name];
-	return nullptr;
+	return _shaders.get(name);
+}
+
+ShaderPtr ObjectManager::getShader(ShaderHandle handle)
+{
+	return _shaders.get(handle);
+}
+
+ShaderHandle ObjectManager::getShaderHandle(const std::string &name)
+{
+	return _shaders.find(name);
 }
 
 TexturePtr ObjectManager::getTexture(const std::string &name)
 {
-	if (_textures.count(name) > 0)
-		return _textures[name];
-	return nullptr;
+	return _textures.get(name);
+}
+
+TexturePtr ObjectManager::getTexture(TextureHandle handle)
+{
+	return _textures.get(handle);
+}
+
+TextureHandle ObjectManager::getTextureHandle(const std::string &name)
+{
+	return _textures.find(name);
 }
 
 CubeMapPtr ObjectManager::getCubeMap(const std::string &name)
 {
-	if (_cubeMaps.count(name) > 0)
-		return _cubeMaps[name];
+	auto i = _cubeMaps.find(name);
+	if (i != _cubeMaps.end())
+		return i->second;
 	return nullptr;
 }
 
 DepthMapPtr ObjectManager::getDepthMap(const std::string &name)
 {
-	if (_depthMaps.count(name) > 0)
-		return _depthMaps[name];
+	auto i = _depthMaps.find(name);
+	if (i != _depthMaps.end())
+		return i->second;
 	return nullptr;
 }
 
 FontPtr ObjectManager::getFont(const std::string &name)
 {
-	if (_fonts.count(name) > 0)
-		return _fonts[name];
+	auto i = _fonts.find(name);
+	if (i != _fonts.end())
+		return i->second;
 	return nullptr;
 }
 
 MaterialPtr ObjectManager::getMaterial(const std::string &name)
 {
-	if (_materials.count(name) > 0)
-		return _materials[name];
-	return nullptr;
+	return _materials.get(name);
+}
+
+MaterialPtr ObjectManager::getMaterial(MaterialHandle handle)
+{
+	return _materials.get(handle);
+}
+
+MaterialHandle ObjectManager::getMaterialHandle(const std::string &name)
+{
+	return _materials.find(name);
 }
 
 PropertiesPtr ObjectManager::getProperties(const std::string &name)
 {
-	if (_properties.count(name) > 0)
-		return _properties[name];
+	auto i = _properties.find(name);
+	if (i != _properties.end())
+		return i->second;
 	return nullptr;
 }
 
 ModelPtr ObjectManager::getModel(const std::string &name)
 {
-	if (_models.count(name) > 0)
-		return _models[name];
-	return nullptr;
+	return _models.get(name);
+}
+
+ModelPtr ObjectManager::getModel(ModelHandle handle)
+{
+	return _models.get(handle);
+}
+
+ModelHandle ObjectManager::getModelHandle(const std::string &name)
+{
+	return _models.find(name);
 }
 
 TextSpritePtr ObjectManager::getTextSprite(const std::string &name)
 {
-	if (_textSprites.count(name) > 0)
-		return _textSprites[name];
+	auto i = _textSprites.find(name);
+	if (i != _textSprites.end())
+		return i->second;
 	return nullptr;
 }
 
 CameraPtr ObjectManager::getCamera(const std::string &name)
 {
-	if (_cameras.count(name) > 0)
-		return _cameras[name];
-	return nullptr;
+	return _cameras.get(name);
+}
+
+CameraPtr ObjectManager::getCamera(CameraHandle handle)
+{
+	return _cameras.get(handle);
+}
+
+CameraHandle ObjectManager::getCameraHandle(const std::string &name)
+{
+	return _cameras.find(name);
 }
 
 MatrixStackPtr ObjectManager::getMatrixStack(const std::string &name)
 {
-	if (_matrixStacks.count(name) > 0)
-		return _matrixStacks[name];
+	auto i = _matrixStacks.find(name);
+	if (i != _matrixStacks.end())
+		return i->second;
 	return nullptr;
 }
 
 LightPtr ObjectManager::getLight(const std::string &name)
 {
-	if (_lights.count(name) > 0)
-		return _lights[name];
-	return nullptr;
+	return _lights.get(name);
+}
+
+LightPtr ObjectManager::getLight(LightHandle handle)
+{
+	return _lights.get(handle);
+}
+
+LightHandle ObjectManager::getLightHandle(const std::string &name)
+{
+	return _lights.find(name);
+}
+
+std::vector< LightHandle > ObjectManager::getLightHandles(const std::vector< std::string > &names)
+{
+	std::vector< LightHandle > handles;
+	handles.reserve(names.size());
+	for (auto i = names.begin(); i != names.end(); ++i)
+		handles.push_back(_lights.find(*i));
+	return handles;
+}
+
+const ObjectManager::LightRegistry &ObjectManager::getLightRegistry() const
+{
+	return _lights;
 }
 
 FramebufferPtr ObjectManager::getFramebuffer(const std::string &name)
 {
-	if (_framebuffers.count(name) > 0)
-		return _framebuffers[name];
+	auto i = _framebuffers.find(name);
+	if (i != _framebuffers.end())
+		return i->second;
 	return nullptr;
 }
 
 DrawablePtr ObjectManager::getDrawable(const std::string &name)
 {
-	if (_drawables.count(name) > 0)
-		return _drawables[name];
+	auto i = _drawables.find(name);
+	if (i != _drawables.end())
+		return i->second;
 	return nullptr;
 }
 
@@ -698,18 +748,18 @@ vmml::Vector3f ObjectManager::getAmbientColor()
 
 void ObjectManager::removeShader(const std::string &name, bool del)
 {
-	if (del && _shaders.count(name) > 0){
-		_shaders[name]->deleteShader();
+	ShaderPtr shader = _shaders.remove(name);
+	if (del && shader){
+		shader->deleteShader();
 	}
-	_shaders.erase(name);
 }
 
 void ObjectManager::removeTexture(const std::string &name, bool del)
 {
-	if (del && _textures.count(name) > 0){
-		_textures[name]->deleteTexture();
+	TexturePtr texture = _textures.remove(name);
+	if (del && texture){
+		texture->deleteTexture();
 	}
-	_textures.erase(name);
 }
 
 void ObjectManager::removeCubeMap(const std::string &name, bool del)
@@ -738,7 +788,7 @@ void ObjectManager::removeFont(const std::string &name, bool del)
 
 void ObjectManager::removeMaterial(const std::string &name)
 {
-	_materials.erase(name);
+	_materials.remove(name);
 }
 
 void ObjectManager::removeProperties(const std::string &name)
@@ -748,10 +798,10 @@ void ObjectManager::removeProperties(const std::string &name)
 
 void ObjectManager::removeModel(const std::string &name, bool del)
 {
-	if (del && _models.count(name) > 0){
-		_models[name]->deleteModelGeometry();
+	ModelPtr model = _models.remove(name);
+	if (del && model){
+		model->deleteModelGeometry();
 	}
-	_models.erase(name);
 }
 
 void ObjectManager::removeTextSprite(const std::string &name, bool del)
@@ -764,7 +814,7 @@ void ObjectManager::removeTextSprite(const std::string &name, bool del)
 
 void ObjectManager::removeCamera(const std::string &name)
 {
-	_cameras.erase(name);
+	_cameras.remove(name);
 }
 
 void ObjectManager::removeMatrixStack(const std::string &name)
@@ -774,7 +824,7 @@ void ObjectManager::removeMatrixStack(const std::string &name)
 
 void ObjectManager::removeLight(const std::string &name)
 {
-	_lights.erase(name);
+	_lights.remove(name);
 }
 
 void ObjectManager::removeFramebuffer(const std::string &name, bool del)
@@ -794,13 +844,13 @@ void ObjectManager::clear(bool del)
 {
 	if(del) for (auto i = _shaders.begin(); i != _shaders.end(); ++i)
 	{
-		i->second->deleteShader();
+		(*i)->deleteShader();
 	}
 	_shaders.clear();
 
 	if (del) for (auto i = _textures.begin(); i != _textures.end(); ++i)
 	{
-		i->second->deleteTexture();
+		(*i)->deleteTexture();
 	}
 	_textures.clear();
 
@@ -828,7 +878,7 @@ void ObjectManager::clear(bool del)
 	
 	if (del) for (auto i = _models.begin(); i != _models.end(); ++i)
 	{
-		i->second->deleteModelGeometry();
+		(*i)->deleteModelGeometry();
 	}
 	_models.clear();
 
@@ -0,0 +1,384 @@
+#include "headers/OcclusionCuller.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define B_OCCLUSION_SSE
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define B_OCCLUSION_NEON
+#include <arm_neon.h>
+#endif
+
+/* Public functions */
+
+OcclusionCuller::OcclusionCuller(GLuint width, GLuint height, GLuint nThreads)
+{
+	Level level;
+	level.width = std::max((width + 3) / 4 * 4, 4u);
+	level.height = std::max(height, 1u);
+	level.depth.assign(level.width * level.height, 1.0f);
+	_levels.push_back(level);
+	while (level.width > 1 || level.height > 1)
+	{
+		level.width = (level.width + 1) / 2;
+		level.height = (level.height + 1) / 2;
+		level.depth.assign(level.width * level.height, 1.0f);
+		_levels.push_back(level);
+	}
+
+	if (nThreads == 0)
+		nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	_nBands = std::min(nThreads, _levels[0].height);
+	for (GLuint band = 1; band < _nBands; band++)
+		_workers.push_back(std::thread(&OcclusionCuller::work, this, band));
+}
+
+OcclusionCuller::~OcclusionCuller()
+{
+	{
+		std::lock_guard< std::mutex > lock(_mutex);
+		_stop = true;
+	}
+	_start.notify_all();
+	for (auto i = _workers.begin(); i != _workers.end(); ++i)
+		i->join();
+}
+
+GLuint OcclusionCuller::addOccluder(const std::vector< vmml::Vector3f > &positions, const std::vector< Index > &indices, const vmml::Matrix4f &modelMatrix)
+{
+	GLuint occluderID;
+	if (!_freeIDs.empty())
+	{
+		occluderID = _freeIDs.back();
+		_freeIDs.pop_back();
+	}
+	else
+	{
+		occluderID = static_cast<GLuint>(_occluders.size());
+		_occluders.push_back(Occluder());
+	}
+	Occluder &occluder = _occluders[occluderID];
+	occluder.positions = positions;
+	occluder.indices.assign(indices.begin(), indices.begin() + indices.size() / 3 * 3);
+	occluder.modelMatrix = modelMatrix;
+	occluder.alive = true;
+	return occluderID;
+}
+
+GLuint OcclusionCuller::addOccluder(const ModelData &modelData, const vmml::Matrix4f &modelMatrix)
+{
+	std::vector< vmml::Vector3f > positions;
+	std::vector< Index > indices;
+	ModelData::GroupMap groups = modelData.getData();
+	for (auto i = groups.begin(); i != groups.end(); ++i)
+	{
+		Index offset = static_cast<Index>(positions.size());
+		for (auto v = i->second->vboVertices.begin(); v != i->second->vboVertices.end(); ++v)
+			positions.push_back(vmml::Vector3f(v->position.x, v->position.y, v->position.z));
+		for (auto index = i->second->vboIndices.begin(); index != i->second->vboIndices.end(); ++index)
+			indices.push_back(*index + offset);
+	}
+	return addOccluder(positions, indices, modelMatrix);
+}
+
+void OcclusionCuller::moveOccluder(GLuint occluderID, const vmml::Matrix4f &modelMatrix)
+{
+	if (occluderID >= _occluders.size() || !_occluders[occluderID].alive)
+		return;
+	_occluders[occluderID].modelMatrix = modelMatrix;
+}
+
+void OcclusionCuller::removeOccluder(GLuint occluderID)
+{
+	if (occluderID >= _occluders.size() || !_occluders[occluderID].alive)
+		return;
+	_occluders[occluderID] = Occluder();
+	_freeIDs.push_back(occluderID);
+}
+
+void OcclusionCuller::clearOccluders()
+{
+	_occluders.clear();
+	_freeIDs.clear();
+}
+
+void OcclusionCuller::render(const vmml::Matrix4f &viewMatrix, const vmml::Matrix4f &projectionMatrix)
+{
+	_viewProjectionMatrix = projectionMatrix*viewMatrix;
+	_nTested = _nCulled = 0;
+
+	// Transforming and setting up the triangles is cheap for few triangles, so it is done once on the calling thread
+	_triangles.clear();
+	for (auto o = _occluders.begin(); o != _occluders.end(); ++o)
+	{
+		if (!o->alive)
+			continue;
+		vmml::Matrix4f modelViewProjectionMatrix = _viewProjectionMatrix*o->modelMatrix;
+		_clipSpace.resize(o->positions.size());
+		for (size_t v = 0; v < o->positions.size(); ++v)
+			_clipSpace[v] = modelViewProjectionMatrix * vmml::Vector4f(o->positions[v], 1.0f);
+		for (size_t i = 0; i < o->indices.size(); i += 3)
+		{
+			vmml::Vector4f v[3] = { _clipSpace[o->indices[i]], _clipSpace[o->indices[i + 1]], _clipSpace[o->indices[i + 2]] };
+			addTriangle(v);
+		}
+	}
+
+	// Every worker rasterizes its own band of rows
+	{
+		std::lock_guard< std::mutex > lock(_mutex);
+		_pending = _nBands - 1;
+		_frame++;
+	}
+	_start.notify_all();
+	rasterizeBand(0);
+	{
+		std::unique_lock< std::mutex > lock(_mutex);
+		_done.wait(lock, [this]() { return _pending == 0; });
+	}
+
+	buildPyramid();
+}
+
+bool OcclusionCuller::isVisible(const vmml::AABBf &aabbObjectSpace, const vmml::Matrix4f &modelViewProjectionMatrix)
+{
+	_nTested++;
+	const Level &base = _levels[0];
+	const vmml::Vector3f &boxMin = aabbObjectSpace.getMin(), &boxMax = aabbObjectSpace.getMax();
+
+	// Screen rectangle and nearest depth of the box
+	GLfloat minX = 0.0f, maxX = 0.0f, minY = 0.0f, maxY = 0.0f, minZ = 0.0f;
+	for (int i = 0; i < 8; ++i)
+	{
+		vmml::Vector4f corner(i & 1 ? boxMax.x() : boxMin.x(), i & 2 ? boxMax.y() : boxMin.y(), i & 4 ? boxMax.z() : boxMin.z(), 1.0f);
+		vmml::Vector4f clip = modelViewProjectionMatrix * corner;
+		if (clip.w() <= 0.0f || clip.z() + clip.w() < 0.0f)
+			return true;
+		GLfloat invW = 1.0f / clip.w();
+		GLfloat x = (clip.x() * invW * 0.5f + 0.5f) * base.width;
+		GLfloat y = (clip.y() * invW * 0.5f + 0.5f) * base.height;
+		GLfloat z = clip.z() * invW * 0.5f + 0.5f;
+		if (i == 0)
+		{
+			minX = maxX = x; minY = maxY = y; minZ = z;
+			continue;
+		}
+		minX = std::min(minX, x); maxX = std::max(maxX, x);
+		minY = std::min(minY, y); maxY = std::max(maxY, y);
+		minZ = std::min(minZ, z);
+	}
+	if (minZ > 1.0f || maxX < 0.0f || maxY < 0.0f || minX >= base.width || minY >= base.height)
+		return true;
+
+	GLuint x0 = static_cast<GLuint>(std::max(minX, 0.0f)), x1 = static_cast<GLuint>(std::min(maxX, base.width - 1.0f));
+	GLuint y0 = static_cast<GLuint>(std::max(minY, 0.0f)), y1 = static_cast<GLuint>(std::min(maxY, base.height - 1.0f));
+
+	// Use the level where the rectangle covers at most 2x2 texels
+	GLuint level = 0;
+	while ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)
+		level++;
+	for (GLuint y = y0 >> level; y <= y1 >> level; ++y)
+	{
+		for (GLuint x = x0 >> level; x <= x1 >> level; ++x)
+		{
+			if (getDepth(level, x, y) >= minZ)
+				return true;
+		}
+	}
+	_nCulled++;
+	return false;
+}
+
+/* Private functions */
+
+void OcclusionCuller::addTriangle(const vmml::Vector4f *v)
+{
+	// Triangles completely outside of one of the planes are skipped
+	for (int k = 0; k < 3; ++k)
+	{
+		if (v[0][k] > v[0].w() && v[1][k] > v[1].w() && v[2][k] > v[2].w())
+			return;
+		if (v[0][k] < -v[0].w() && v[1][k] < -v[1].w() && v[2][k] < -v[2].w())
+			return;
+	}
+
+	GLfloat d[3] = { v[0].z() + v[0].w(), v[1].z() + v[1].w(), v[2].z() + v[2].w() };
+	if (d[0] >= 0.0f && d[1] >= 0.0f && d[2] >= 0.0f)
+	{
+		setupTriangle(v[0], v[1], v[2]);
+		return;
+	}
+
+	// Clip against the near plane (z + w >= 0), which leaves a triangle or a quad
+	vmml::Vector4f clipped[4];
+	int n = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		int next = (i + 1) % 3;
+		if (d[i] >= 0.0f)
+			clipped[n++] = v[i];
+		if ((d[i] >= 0.0f) != (d[next] >= 0.0f))
+			clipped[n++] = v[i] + (v[next] - v[i]) * (d[i] / (d[i] - d[next]));
+	}
+	if (n >= 3)
+		setupTriangle(clipped[0], clipped[1], clipped[2]);
+	if (n == 4)
+		setupTriangle(clipped[0], clipped[2], clipped[3]);
+}
+
+void OcclusionCuller::setupTriangle(const vmml::Vector4f &v0, const vmml::Vector4f &v1, const vmml::Vector4f &v2)
+{
+	const Level &base = _levels[0];
+	const vmml::Vector4f *v[3] = { &v0, &v1, &v2 };
+	GLfloat x[3], y[3], z[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		GLfloat invW = 1.0f / v[i]->w();
+		x[i] = (v[i]->x() * invW * 0.5f + 0.5f) * base.width;
+		y[i] = (v[i]->y() * invW * 0.5f + 0.5f) * base.height;
+		z[i] = v[i]->z() * invW * 0.5f + 0.5f;
+	}
+
+	GLfloat det = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+	if (det == 0.0f)
+		return;
+
+	// Pixels whose centers lie between the smallest and largest coordinates, clamped to the screen before converting to integers
+	GLfloat minX = std::max(std::ceil(std::min(std::min(x[0], x[1]), x[2]) - 0.5f), 0.0f);
+	GLfloat maxX = std::min(std::floor(std::max(std::max(x[0], x[1]), x[2]) - 0.5f), base.width - 1.0f);
+	GLfloat minY = std::max(std::ceil(std::min(std::min(y[0], y[1]), y[2]) - 0.5f), 0.0f);
+	GLfloat maxY = std::min(std::floor(std::max(std::max(y[0], y[1]), y[2]) - 0.5f), base.height - 1.0f);
+	if (minX > maxX || minY > maxY)
+		return;
+
+	Triangle t;
+	GLfloat sign = det > 0.0f ? 1.0f : -1.0f;
+	for (int k = 0; k < 3; ++k)
+	{
+		int next = (k + 1) % 3;
+		t.a[k] = sign * (y[k] - y[next]);
+		t.b[k] = sign * (x[next] - x[k]);
+		t.c[k] = sign * (x[k] * y[next] - x[next] * y[k]);
+	}
+	t.dzdx = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / det;
+	t.dzdy = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) / det;
+	t.z = z[0] - t.dzdx * x[0] - t.dzdy * y[0];
+	t.minX = static_cast<GLint>(minX);
+	t.maxX = static_cast<GLint>(maxX);
+	t.minY = static_cast<GLint>(minY);
+	t.maxY = static_cast<GLint>(maxY);
+	_triangles.push_back(t);
+}
+
+void OcclusionCuller::rasterizeBand(GLuint band)
+{
+	Level &base = _levels[0];
+	GLint firstRow = static_cast<GLint>(base.height * band / _nBands);
+	GLint endRow = static_cast<GLint>(base.height * (band + 1) / _nBands);
+	std::fill(base.depth.begin() + firstRow * base.width, base.depth.begin() + endRow * base.width, 1.0f);
+
+	for (auto t = _triangles.begin(); t != _triangles.end(); ++t)
+	{
+		GLint y0 = std::max(t->minY, firstRow), y1 = std::min(t->maxY, endRow - 1);
+		// Rows are padded to a multiple of 4, so the SIMD versions start at the group of four holding the first pixel
+#if defined(B_OCCLUSION_SSE) || defined(B_OCCLUSION_NEON)
+		GLint x0 = t->minX & ~3;
+#else
+		GLint x0 = t->minX;
+#endif
+		for (GLint y = y0; y <= y1; ++y)
+			rasterizeRow(*t, &base.depth[y * base.width], x0, t->maxX, static_cast<GLfloat>(y) + 0.5f);
+	}
+}
+
+void OcclusionCuller::rasterizeRow(const Triangle &t, GLfloat *row, GLint first, GLint last, GLfloat py)
+{
+#if defined(B_OCCLUSION_SSE)
+	const __m128 laneCenters = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f), zero = _mm_setzero_ps();
+	__m128 a0 = _mm_set1_ps(t.a[0]), a1 = _mm_set1_ps(t.a[1]), a2 = _mm_set1_ps(t.a[2]), dzdx = _mm_set1_ps(t.dzdx);
+	__m128 rowE0 = _mm_set1_ps(t.b[0] * py + t.c[0]), rowE1 = _mm_set1_ps(t.b[1] * py + t.c[1]), rowE2 = _mm_set1_ps(t.b[2] * py + t.c[2]);
+	__m128 rowZ = _mm_set1_ps(t.dzdy * py + t.z);
+	for (GLint x = first; x <= last; x += 4)
+	{
+		__m128 px = _mm_add_ps(_mm_set1_ps(static_cast<GLfloat>(x)), laneCenters);
+		__m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, px), rowE0), zero);
+		inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, px), rowE1), zero));
+		inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, px), rowE2), zero));
+		__m128 z = _mm_add_ps(_mm_mul_ps(dzdx, px), rowZ);
+		__m128 depth = _mm_loadu_ps(row + x);
+		depth = _mm_or_ps(_mm_and_ps(inside, _mm_min_ps(depth, z)), _mm_andnot_ps(inside, depth));
+		_mm_storeu_ps(row + x, depth);
+	}
+#elif defined(B_OCCLUSION_NEON)
+	// multiply and add are kept separate to match the scalar version
+	const float laneCentersArray[4] = { 0.5f, 1.5f, 2.5f, 3.5f };
+	const float32x4_t laneCenters = vld1q_f32(laneCentersArray), zero = vdupq_n_f32(0.0f);
+	float32x4_t a0 = vdupq_n_f32(t.a[0]), a1 = vdupq_n_f32(t.a[1]), a2 = vdupq_n_f32(t.a[2]), dzdx = vdupq_n_f32(t.dzdx);
+	float32x4_t rowE0 = vdupq_n_f32(t.b[0] * py + t.c[0]), rowE1 = vdupq_n_f32(t.b[1] * py + t.c[1]), rowE2 = vdupq_n_f32(t.b[2] * py + t.c[2]);
+	float32x4_t rowZ = vdupq_n_f32(t.dzdy * py + t.z);
+	for (GLint x = first; x <= last; x += 4)
+	{
+		float32x4_t px = vaddq_f32(vdupq_n_f32(static_cast<GLfloat>(x)), laneCenters);
+		uint32x4_t inside = vcgeq_f32(vaddq_f32(vmulq_f32(a0, px), rowE0), zero);
+		inside = vandq_u32(inside, vcgeq_f32(vaddq_f32(vmulq_f32(a1, px), rowE1), zero));
+		inside = vandq_u32(inside, vcgeq_f32(vaddq_f32(vmulq_f32(a2, px), rowE2), zero));
+		float32x4_t z = vaddq_f32(vmulq_f32(dzdx, px), rowZ);
+		float32x4_t depth = vld1q_f32(row + x);
+		vst1q_f32(row + x, vbslq_f32(inside, vminq_f32(depth, z), depth));
+	}
+#else
+	GLfloat rowE0 = t.b[0] * py + t.c[0], rowE1 = t.b[1] * py + t.c[1], rowE2 = t.b[2] * py + t.c[2];
+	GLfloat rowZ = t.dzdy * py + t.z;
+	for (GLint x = first; x <= last; ++x)
+	{
+		GLfloat px = static_cast<GLfloat>(x) + 0.5f;
+		if (t.a[0] * px + rowE0 >= 0.0f && t.a[1] * px + rowE1 >= 0.0f && t.a[2] * px + rowE2 >= 0.0f)
+		{
+			GLfloat z = t.dzdx * px + rowZ;
+			if (z < row[x])
+				row[x] = z;
+		}
+	}
+#endif
+}
+
+void OcclusionCuller::buildPyramid()
+{
+	for (size_t l = 1; l < _levels.size(); ++l)
+	{
+		const Level &below = _levels[l - 1];
+		Level &level = _levels[l];
+		for (GLuint y = 0; y < level.height; ++y)
+		{
+			const GLfloat *row0 = &below.depth[2 * y * below.width];
+			const GLfloat *row1 = &below.depth[std::min(2 * y + 1, below.height - 1) * below.width];
+			for (GLuint x = 0; x < level.width; ++x)
+			{
+				GLuint x0 = 2 * x, x1 = std::min(2 * x + 1, below.width - 1);
+				level.depth[y * level.width + x] = std::max(std::max(row0[x0], row0[x1]), std::max(row1[x0], row1[x1]));
+			}
+		}
+	}
+}
+
+void OcclusionCuller::work(GLuint band)
+{
+	size_t frame = 0;
+	while (true)
+	{
+		{
+			std::unique_lock< std::mutex > lock(_mutex);
+			_start.wait(lock, [this, &frame]() { return _stop || _frame != frame; });
+			if (_stop)
+				return;
+			frame = _frame;
+		}
+		rasterizeBand(band);
+		{
+			std::lock_guard< std::mutex > lock(_mutex);
+			if (--_pending == 0)
+				_done.notify_one();
+		}
+	}
+}
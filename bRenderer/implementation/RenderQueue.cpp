@@ -1,40 +1,152 @@
 #include "headers/RenderQueue.h"
+#include <cstring>
 
 void RenderQueue::submitToRenderQueue(GLuint programID, const std::string &materialName, const std::string &drawableName, const std::string &instanceName, DrawablePtr drawable, GLfloat distanceToCamera, bool isTransparent, GLenum blendSfactor, GLenum blendDfactor)
 {
-	// Transparent
+	submitToRenderQueue(programID, getNameID(materialName), getNameID(drawableName), instanceName, drawable, distanceToCamera, isTransparent, blendSfactor, blendDfactor);
+}
+
+void RenderQueue::submitToRenderQueue(GLuint programID, GLuint materialID, GLuint drawableID, const std::string &instanceName, DrawablePtr drawable, GLfloat distanceToCamera, bool isTransparent, GLenum blendSfactor, GLenum blendDfactor, GLuint layer)
+{
+	uint64_t depth = quantizeDepth(distanceToCamera);
+	uint64_t key = static_cast<uint64_t>(layer & 0xF) << 60;
+
+	// Transparent (back-to-front)
 	if (isTransparent){
-		_renderCallsTransparent.insert(RenderCallsTransparent::value_type(distanceToCamera, RenderCall{ drawable, instanceName, blendSfactor, blendDfactor }));
+		key |= static_cast<uint64_t>(1) << 59;
+		key |= (0xFFFFFF - depth) << 35;
+		key |= static_cast<uint64_t>(programID & 0x3FF) << 25;
+		key |= static_cast<uint64_t>(materialID & 0xFFF) << 13;
+		key |= static_cast<uint64_t>(drawableID & 0x1FFF);
 	}
-	// Opaque
+	// Opaque (grouped by state, then front-to-back)
 	else{
-		std::string key = std::to_string(programID)+materialName + drawableName;
-		_renderCallsOpaque.insert(RenderCallsOpaque::value_type(key, RenderCall{ drawable, instanceName }));
+		key |= static_cast<uint64_t>(programID & 0x3FF) << 49;
+		key |= static_cast<uint64_t>(materialID & 0xFFF) << 37;
+		key |= static_cast<uint64_t>(drawableID & 0x1FFF) << 24;
+		key |= depth;
 	}
+
+	// Reuse render calls of previous frames
+	if (_nRenderCalls == _renderCalls.size())
+		_renderCalls.push_back(RenderCall());
+	RenderCall &renderCall = _renderCalls[_nRenderCalls];
+	renderCall.drawable = drawable;
+	renderCall.instanceName.assign(instanceName);
+	renderCall.blendSfactor = blendSfactor;
+	renderCall.blendDfactor = blendDfactor;
+
+	_sortEntries.push_back(SortEntry{ key, static_cast<GLuint>(_nRenderCalls) });
+	++_nRenderCalls;
+	_sorted = false;
 }
 
 void RenderQueue::draw(GLenum mode)
 {
-	// Opaque
-	for (auto renderCall = _renderCallsOpaque.begin(); renderCall != _renderCallsOpaque.end(); ++renderCall){
-		renderCall->second.drawable->drawInstance((renderCall->second.instanceName), mode);
-	}
+	if (!_sorted)
+		sort();
 
-	// Transparent
-	for (auto renderCall = _renderCallsTransparent.rbegin(); renderCall != _renderCallsTransparent.rend(); ++renderCall){
-		glBlendFunc(renderCall->second.blendSfactor, renderCall->second.blendDfactor);
-		renderCall->second.drawable->drawInstance((renderCall->second.instanceName), mode);
+	// Only state changes between consecutive calls are passed to OpenGL
+	RenderState::begin();
+	size_t n = _sortEntries.size();
+	for (size_t i = 0; i < n;){
+		RenderCall &renderCall = _renderCalls[_sortEntries[i].index];
+		bool isTransparent = (_sortEntries[i].key >> 59) & 1;
+
+		// Opaque calls of the same drawable are next to each other and can be drawn together
+		size_t j = i + 1;
+		if (_instancing && !isTransparent){
+			while (j < n && !((_sortEntries[j].key >> 59) & 1) && _renderCalls[_sortEntries[j].index].drawable == renderCall.drawable)
+				++j;
+		}
+
+		if (j - i > 1){
+			if (_instanceNames.size() < j - i)
+				_instanceNames.resize(j - i);
+			for (size_t k = i; k < j; ++k)
+				_instanceNames[k - i].assign(_renderCalls[_sortEntries[k].index].instanceName);
+			renderCall.drawable->drawInstances(_instanceNames, j - i, mode);
+		}
+		else{
+			// Transparent
+			if (isTransparent)
+				RenderState::setBlendFunc(renderCall.blendSfactor, renderCall.blendDfactor);
+			renderCall.drawable->drawInstance(renderCall.instanceName, mode);
+		}
+		i = j;
 	}
+	RenderState::end();
 
-	// reset blend function so opaque objects are not affected
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	_statistics = RenderState::getStatistics();
 }
 
 void RenderQueue::clear()
 {
-	// Opaque
-	_renderCallsOpaque.clear();
+	// Release the drawables but keep the memory for the next frame
+	for (size_t i = 0; i < _nRenderCalls; ++i)
+		_renderCalls[i].drawable.reset();
+	_nRenderCalls = 0;
+	_sortEntries.clear();
+	_sorted = true;
+}
+
+/* Protected functions */
+
+void RenderQueue::sort()
+{
+	size_t n = _sortEntries.size();
+	_sorted = true;
+	if (n < 2)
+		return;
+	_sortBuffer.resize(n);
 
-	// Transparent
-	_renderCallsTransparent.clear();
-}
\ No newline at end of file
+	// Count the occurrences of every byte value for all 8 bytes of the keys at once
+	static const int passes = 8;
+	size_t counts[passes * 256] = {};
+	for (auto i = _sortEntries.begin(); i != _sortEntries.end(); ++i){
+		for (int pass = 0; pass < passes; ++pass)
+			++counts[pass * 256 + ((i->key >> (pass * 8)) & 0xFF)];
+	}
+
+	// Least significant digit radix sort, which is stable
+	SortEntry *src = _sortEntries.data();
+	SortEntry *dst = _sortBuffer.data();
+	for (int pass = 0; pass < passes; ++pass){
+		size_t *count = &counts[pass * 256];
+
+		// Skip the pass if all keys share the same byte
+		if (count[(src[0].key >> (pass * 8)) & 0xFF] == n)
+			continue;
+
+		size_t offset = 0;
+		for (int b = 0; b < 256; ++b){
+			size_t c = count[b];
+			count[b] = offset;
+			offset += c;
+		}
+		for (size_t i = 0; i < n; ++i)
+			dst[count[(src[i].key >> (pass * 8)) & 0xFF]++] = src[i];
+		std::swap(src, dst);
+	}
+	if (src != _sortEntries.data())
+		_sortEntries.swap(_sortBuffer);
+}
+
+GLuint RenderQueue::quantizeDepth(GLfloat distance)
+{
+	// Flip the bits of the float so that its unsigned integer representation has the same order
+	uint32_t bits;
+	std::memcpy(&bits, &distance, sizeof(bits));
+	bits = (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+	return bits >> 8;
+}
+
+GLuint RenderQueue::getNameID(const std::string &name)
+{
+	auto i = _nameIDs.find(name);
+	if (i != _nameIDs.end())
+		return i->second;
+	GLuint id = static_cast<GLuint>(_nameIDs.size());
+	_nameIDs[name] = id;
+	return id;
+}
@@ -0,0 +1,213 @@
+#include "headers/RenderState.h"
+
+/* Initial values after creating a context */
+bool				RenderState::_tracking = false;
+GLuint				RenderState::_program = 0;
+GLuint				RenderState::_programDeletions = 0;
+GLuint				RenderState::_vertexArray = 0;
+GLuint				RenderState::_vertexBuffer = 0;
+const VertexLayout	*RenderState::_vertexLayout = nullptr;
+GLuint				RenderState::_indexBuffer = 0;
+GLuint				RenderState::_attribProgram = 0;
+GLuint				RenderState::_attribVertexBuffer = 0;
+const void			*RenderState::_material = nullptr;
+GLuint				RenderState::_textures[MAX_TEXTURE_UNITS] = {};
+bool				RenderState::_blendFuncKnown = false;
+GLenum				RenderState::_blendSfactor = GL_SRC_ALPHA;
+GLenum				RenderState::_blendDfactor = GL_ONE_MINUS_SRC_ALPHA;
+RenderState::Statistics	RenderState::_statistics;
+
+void RenderState::begin()
+{
+	_tracking = true;
+	_statistics = Statistics();
+
+	// the renderer always leaves the vertex and index buffer unbound
+	_vertexBuffer = 0;
+	_indexBuffer = 0;
+	_attribProgram = 0;
+	_attribVertexBuffer = 0;
+	_material = nullptr;
+	_blendFuncKnown = false;
+
+	// textures may have been bound anywhere, 0 marks them as unknown
+	for (GLuint i = 0; i < MAX_TEXTURE_UNITS; i++)
+		_textures[i] = 0;
+}
+
+void RenderState::end()
+{
+	// the index buffer has to be unbound from the default vertex array
+	if (_vertexArray)
+		glBindVertexArray(0);
+	if (_vertexBuffer)
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	if (_indexBuffer)
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	// reset blend function so opaque objects are not affected
+	if (_statistics.blendChanges > 0 && (_blendSfactor != GL_SRC_ALPHA || _blendDfactor != GL_ONE_MINUS_SRC_ALPHA))
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	_vertexArray = 0;
+	_vertexBuffer = 0;
+	_indexBuffer = 0;
+	_tracking = false;
+}
+
+bool RenderState::bindProgram(GLuint programID)
+{
+	if (_program == programID)
+	{
+		_statistics.programBindsAvoided++;
+		return false;
+	}
+	glUseProgram(programID);
+	_program = programID;
+	_statistics.programBinds++;
+	return true;
+}
+
+void RenderState::deleteProgram(GLuint programID)
+{
+	if (_program == programID)
+		_program = 0;
+	if (_attribProgram == programID)
+		_attribProgram = 0;
+	_programDeletions++;
+}
+
+bool RenderState::bindVertexBuffer(GLuint buffer, const VertexLayout *layout)
+{
+	_vertexLayout = layout;
+	if (_tracking && _vertexBuffer == buffer)
+	{
+		_statistics.vertexBufferBindsAvoided++;
+		return false;
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	_vertexBuffer = buffer;
+	_statistics.vertexBufferBinds++;
+	return true;
+}
+
+void RenderState::unbindVertexBuffer()
+{
+	// while tracking the buffer stays bound, end() unbinds it
+	if (!_tracking)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		_vertexBuffer = 0;
+	}
+}
+
+bool RenderState::bindIndexBuffer(GLuint buffer)
+{
+	if (_tracking && _indexBuffer == buffer)
+	{
+		_statistics.indexBufferBindsAvoided++;
+		return false;
+	}
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+	_indexBuffer = buffer;
+	_statistics.indexBufferBinds++;
+	return true;
+}
+
+void RenderState::unbindIndexBuffer()
+{
+	// while tracking the buffer stays bound, end() unbinds it
+	if (!_tracking)
+	{
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		_indexBuffer = 0;
+	}
+}
+
+bool RenderState::bindVertexArray(GLuint vertexArray)
+{
+	// like the program the vertex array is always tracked, so contexts without vertex array objects never get here with an ID other than 0
+	if (_vertexArray == vertexArray)
+	{
+		_statistics.vertexArrayBindsAvoided++;
+		return false;
+	}
+	glBindVertexArray(vertexArray);
+	_vertexArray = vertexArray;
+	_statistics.vertexArrayBinds++;
+	return true;
+}
+
+void RenderState::unbindVertexArray()
+{
+	// while tracking the vertex array stays bound, end() unbinds it
+	if (!_tracking && _vertexArray)
+	{
+		glBindVertexArray(0);
+		_vertexArray = 0;
+	}
+}
+
+void RenderState::deleteVertexArray(GLuint vertexArray)
+{
+	// deleting a bound vertex array binds the default one
+	if (_vertexArray == vertexArray)
+		_vertexArray = 0;
+}
+
+bool RenderState::needsAttribSetup()
+{
+	if (_vertexArray)
+		return false;
+	// attribute pointers refer to the buffer bound when they are set and their locations depend on the program
+	if (_tracking && _attribProgram == _program && _attribVertexBuffer == _vertexBuffer)
+	{
+		_statistics.attribSetupsAvoided++;
+		return false;
+	}
+	_attribProgram = _program;
+	_attribVertexBuffer = _vertexBuffer;
+	_statistics.attribSetups++;
+	return true;
+}
+
+bool RenderState::bindMaterial(const void *material)
+{
+	if (_tracking && _material == material)
+	{
+		_statistics.materialBindsAvoided++;
+		return false;
+	}
+	_material = material;
+	_statistics.materialBinds++;
+	return true;
+}
+
+void RenderState::bindTexture(GLint texUnit, GLenum target, GLuint textureID)
+{
+	GLuint unit = static_cast<GLuint>(texUnit - GL_TEXTURE0);
+	if (_tracking && unit < MAX_TEXTURE_UNITS && _textures[unit] == textureID)
+	{
+		_statistics.textureBindsAvoided++;
+		return;
+	}
+	glActiveTexture(texUnit);
+	glEnable(target);
+	glBindTexture(target, textureID);
+	if (unit < MAX_TEXTURE_UNITS)
+		_textures[unit] = textureID;
+	_statistics.textureBinds++;
+}
+
+void RenderState::setBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+	if (_tracking && _blendFuncKnown && _blendSfactor == sfactor && _blendDfactor == dfactor)
+	{
+		_statistics.blendChangesAvoided++;
+		return;
+	}
+	glBlendFunc(sfactor, dfactor);
+	_blendFuncKnown = true;
+	_blendSfactor = sfactor;
+	_blendDfactor = dfactor;
+	_statistics.blendChanges++;
+}
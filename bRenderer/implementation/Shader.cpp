@@ -2,8 +2,13 @@
 #include "headers/GeometryData.h"
 #include "headers/IShaderData.h"
 #include "headers/Shader.h"
+#include "headers/VertexLayout.h"
+#include "headers/Configuration.h"
+#include <cstring>
+#include <algorithm>
 
 Shader::Shader(const IShaderData &shaderData)
+	: _uniformVersion(++_uniformVersionCounter)
 {
     GLuint vertShader, fragShader;
     
@@ -30,6 +35,9 @@ Shader::Shader(const IShaderData &shaderData)
     
     // Attach fragment shader to program.
     glAttachShader(_programID, fragShader);
+
+    // Attribute 0 has to be an array in compatibility contexts, so it mustn't be taken by the instance matrix
+    glBindAttribLocation(_programID, 0, bRenderer::DEFAULT_SHADER_ATTRIBUTE_POSITION().c_str());
         
     // Link program.
     if (!link()) {
@@ -48,90 +56,240 @@ Shader::Shader(const IShaderData &shaderData)
             _programID = 0;
         }
     }
+    else {
+        _instanceMatrixLoc = glGetAttribLocation(_programID, bRenderer::DEFAULT_SHADER_ATTRIBUTE_INSTANCE_MODEL_VIEW_MATRIX().c_str());
+
+        // resolve the light slots now so setting the lights doesn't look up any locations
+        for (GLuint i = 0; i < _shaderMaxLights; i++)
+        {
+            const LightUniforms &light = getLightUniforms(i);
+            registerUniform(getUniformName(light.positionViewSpace));
+            registerUniform(getUniformName(light.diffuseColor));
+            registerUniform(getUniformName(light.specularColor));
+            registerUniform(getUniformName(light.intensity));
+            registerUniform(getUniformName(light.attenuation));
+            registerUniform(getUniformName(light.radius));
+        }
+    }
     
     resetTexUnit();
     glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &_maxTexUnits);
 	bRenderer::log("Number of available tex units: " + std::to_string(_maxTexUnits)+".", bRenderer::LM_INFO);
 }
 
+GLuint Shader::_uniformVersionCounter = 0;
+
+namespace
+{
+	/* Names of all uniform handles, shared by all shaders */
+	struct UniformHandleRegistry
+	{
+		std::unordered_map< std::string, Shader::UniformHandle > handles;
+		std::vector< std::string > names;
+	};
+
+	UniformHandleRegistry &uniformHandleRegistry()
+	{
+		static UniformHandleRegistry registry;
+		return registry;
+	}
+}
+
+Shader::UniformHandle Shader::getUniformHandle(const std::string &name)
+{
+	UniformHandleRegistry &registry = uniformHandleRegistry();
+	auto i = registry.handles.find(name);
+	if (i != registry.handles.end())
+		return i->second;
+
+	UniformHandle handle = static_cast<UniformHandle>(registry.names.size());
+	registry.handles[name] = handle;
+	registry.names.push_back(name);
+	return handle;
+}
+
+const std::string &Shader::getUniformName(UniformHandle handle)
+{
+	return uniformHandleRegistry().names[handle];
+}
+
+const Shader::LightUniforms &Shader::getLightUniforms(GLuint light)
+{
+	static std::vector< LightUniforms > lightUniforms;
+	while (lightUniforms.size() <= light)
+	{
+		std::string pos = std::to_string(lightUniforms.size());
+		LightUniforms uniforms;
+		uniforms.positionViewSpace = getUniformHandle(bRenderer::DEFAULT_SHADER_UNIFORM_LIGHT_POSITION_VIEW_SPACE() + pos);
+		uniforms.diffuseColor = getUniformHandle(bRenderer::DEFAULT_SHADER_UNIFORM_DIFFUSE_LIGHT_COLOR() + pos);
+		uniforms.specularColor = getUniformHandle(bRenderer::DEFAULT_SHADER_UNIFORM_SPECULAR_LIGHT_COLOR() + pos);
+		uniforms.intensity = getUniformHandle(bRenderer::DEFAULT_SHADER_UNIFORM_LIGHT_INTENSITY() + pos);
+		uniforms.attenuation = getUniformHandle(bRenderer::DEFAULT_SHADER_UNIFORM_LIGHT_ATTENUATION() + pos);
+		uniforms.radius = getUniformHandle(bRenderer::DEFAULT_SHADER_UNIFORM_LIGHT_RADIUS() + pos);
+		lightUniforms.push_back(uniforms);
+	}
+	return lightUniforms[light];
+}
+
 void Shader::setUniform(const std::string &name, const vmml::Vector4f &arg)
 {
-    glUseProgram(_programID);
-    
-    GLint loc = findUniformLocation(name);
-    if (loc > -1)
-    {
-        glUniform4fv(loc, 1, arg.begin());
-    }
+	setUniform(getUniformHandle(name), arg);
 }
 
 void Shader::setUniform(const std::string &name, const vmml::Vector3f &arg)
 {
-    glUseProgram(_programID);
-    
-    GLint loc = findUniformLocation(name);
-    if (loc > -1)
-    {
-        glUniform3fv(loc, 1, arg.begin());
-    }
+	setUniform(getUniformHandle(name), arg);
 }
 
 void Shader::setUniform(const std::string &name, const vmml::Matrix4f &arg)
 {
-    glUseProgram(_programID);
-    
-    GLint loc = findUniformLocation(name);
-    if (loc > -1)
-    {
-        glUniformMatrix4fv(loc, 1, false, arg.begin());
-    }
+	setUniform(getUniformHandle(name), arg);
 }
 
 void Shader::setUniform(const std::string &name, const vmml::Matrix3f &arg)
 {
-    glUseProgram(_programID);
-    
-    GLint loc = findUniformLocation(name);
-    if (loc > -1)
-    {
-        glUniformMatrix3fv(loc, 1, false, arg.begin());
-    }
+	setUniform(getUniformHandle(name), arg);
 }
 
 void Shader::setUniform(const std::string &name, GLfloat arg)
 {
-    glUseProgram(_programID);
-    
-    GLint loc = findUniformLocation(name);
-    if (loc > -1)
-    {
-        glUniform1f(loc, arg);
-    }
+	setUniform(getUniformHandle(name), arg);
 }
 
 void Shader::setUniform(const std::string &name, TexturePtr texture)
 {
-    glUseProgram(_programID);
+	setUniform(getUniformHandle(name), texture);
+}
+
+void Shader::setUniform(UniformHandle handle, const vmml::Vector4f &arg)
+{
+    setUniform(handle, arg.begin(), GL_FLOAT_VEC4);
+}
+
+void Shader::setUniform(UniformHandle handle, const vmml::Vector3f &arg)
+{
+    setUniform(handle, arg.begin(), GL_FLOAT_VEC3);
+}
+
+void Shader::setUniform(UniformHandle handle, const vmml::Matrix4f &arg)
+{
+    setUniform(handle, arg.begin(), GL_FLOAT_MAT4);
+}
 
-    GLint loc = findUniformLocation(name);
+void Shader::applyInstanceMatrix()
+{
+    static const UniformHandle handle = getUniformHandle(bRenderer::DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX());
+    if (_instanceMatrixLoc < 0 || handle >= _uniforms.size() || _uniforms[handle].size != 16)
+        return;
+    // one column per location
+    for (GLint c = 0; c < 4; c++)
+        glVertexAttrib4fv(_instanceMatrixLoc + c, &_uniforms[handle].value[4 * c]);
+}
+
+void Shader::setUniform(UniformHandle handle, const vmml::Matrix3f &arg)
+{
+    setUniform(handle, arg.begin(), GL_FLOAT_MAT3);
+}
+
+void Shader::setUniform(UniformHandle handle, GLfloat arg)
+{
+    setUniform(handle, &arg, GL_FLOAT);
+}
+
+void Shader::setUniform(UniformHandle handle, const GLfloat *value, GLenum type)
+{
+    GLsizei size;
+    switch (type)
+    {
+    case GL_FLOAT_MAT4:	size = 16; break;
+    case GL_FLOAT_MAT3:	size = 9; break;
+    case GL_FLOAT_VEC4:	size = 4; break;
+    case GL_FLOAT_VEC3:	size = 3; break;
+    case GL_FLOAT:		size = 1; break;
+    default:
+        bRenderer::log("Uniform type not supported", bRenderer::LM_ERROR);
+        return;
+    }
+
+    static const UniformHandle modelViewMatrix = getUniformHandle(bRenderer::DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX());
+    // shaders reading the model view matrix from the instance attribute only keep it until applyInstanceMatrix()
+    if (type == GL_FLOAT_MAT4 && handle == modelViewMatrix && _instanceMatrixLoc > -1)
+    {
+        if (handle >= _uniforms.size())
+            _uniforms.resize(handle + 1);
+        updateUniformState(_uniforms[handle], value, 16);
+        return;
+    }
+
+    GLint loc = findUniformLocation(handle);
+    if (loc > -1 && updateUniformState(_uniforms[handle], value, size))
+    {
+        useProgram();
+        switch (type)
+        {
+        case GL_FLOAT_MAT4:	glUniformMatrix4fv(loc, 1, false, value); break;
+        case GL_FLOAT_MAT3:	glUniformMatrix3fv(loc, 1, false, value); break;
+        case GL_FLOAT_VEC4:	glUniform4fv(loc, 1, value); break;
+        case GL_FLOAT_VEC3:	glUniform3fv(loc, 1, value); break;
+        default:			glUniform1f(loc, *value); break;
+        }
+    }
+}
+
+void Shader::setUniform(UniformHandle handle, TexturePtr texture)
+{
+    GLint loc = findUniformLocation(handle);
     if (loc > -1)
     {
         texture->bind(GL_TEXTURE0 + _cTexUnit);
-        glUniform1i(loc, _cTexUnit);
+
+        // the sampler only needs to be updated if the texture unit changed
+        GLfloat unit = static_cast<GLfloat>(_cTexUnit);
+        if (updateUniformState(_uniforms[handle], &unit, 1))
+        {
+            useProgram();
+            glUniform1i(loc, _cTexUnit);
+        }
         
         _cTexUnit = (_cTexUnit + 1) % _maxTexUnits;
     }
 }
 
+void Shader::setLights(const LightPack &lights)
+{
+	static const UniformHandle numberOfLights = getUniformHandle(bRenderer::DEFAULT_SHADER_UNIFORM_NUMBER_OF_LIGHTS());
+
+	GLuint numLights = std::min(lights.getNumLights(), _shaderMaxLights);
+	if (_variableNumberOfLights && numLights > 0)
+		setUniform(numberOfLights, static_cast<GLfloat>(numLights));
+
+	for (GLuint i = 0; i < numLights; i++)
+	{
+		const LightUniforms &uniforms = getLightUniforms(i);
+		const LightPack::Light &light = lights.getLight(i);
+		setUniform(uniforms.positionViewSpace, light.positionViewSpace);
+		if (_diffuseLighting)
+			setUniform(uniforms.diffuseColor, light.diffuseColor);
+		if (_specularLighting)
+			setUniform(uniforms.specularColor, light.specularColor);
+		setUniform(uniforms.intensity, light.intensity);
+		setUniform(uniforms.attenuation, light.attenuation);
+		setUniform(uniforms.radius, light.radius);
+	}
+}
+
 GLint Shader::registerUniform(const std::string &name)
 {
-    GLint loc = glGetUniformLocation(_programID, name.c_str());
-    
-    // add 1 because -1 is returned by glGetUniformLocation if operation fails,
-    // but the map's default value is 0.
-    _uniformLocations[name] = loc + 1;
+    UniformHandle handle = getUniformHandle(name);
+    if (handle >= _uniforms.size())
+        _uniforms.resize(handle + 1);
+
+    UniformState &state = _uniforms[handle];
+    state.loc = glGetUniformLocation(_programID, name.c_str());
+    state.resolved = true;
+    state.size = 0;
     
-    return loc;
+    return state.loc;
 }
 
 GLint Shader::registerAttrib(const std::string &name, GLint size, GLenum type, GLsizei stride, size_t offset)
@@ -153,14 +311,19 @@ GLint Shader::registerAttrib(const std::string &name, GLint size, GLenum type, G
 
 GLint Shader::findUniformLocation(const std::string &name)
 {
-    GLint loc = getUniformLocation(name);
-    if (loc < 0)
-    {
-        loc = registerUniform(name);
-    }
+    return findUniformLocation(getUniformHandle(name));
+}
+
+GLint Shader::findUniformLocation(UniformHandle handle)
+{
+    if (handle < _uniforms.size() && _uniforms[handle].resolved)
+        return _uniforms[handle].loc;
+
+    // look up the location only once, a missing uniform is reported a single time
+    GLint loc = registerUniform(getUniformName(handle));
     if (loc < 0)
     {
-		bRenderer::log("Couldn't find uniform '" + name + "'.", bRenderer::LM_WARNING);
+		bRenderer::log("Couldn't find uniform '" + getUniformName(handle) + "'.", bRenderer::LM_WARNING);
     }
     return loc;
 }
@@ -181,7 +344,10 @@ GLint Shader::findAttribLocation(const std::string &name, GLint size, GLenum typ
 
 GLint Shader::getUniformLocation(const std::string &name)
 {
-    return _uniformLocations[name] - 1;     // subtract 1 again
+    UniformHandle handle = getUniformHandle(name);
+    if (handle < _uniforms.size() && _uniforms[handle].resolved)
+        return _uniforms[handle].loc;
+    return -1;
 }
 
 GLint Shader::getAttribLocation(const std::string &name)
@@ -194,25 +360,63 @@ void Shader::resetTexUnit()
     _cTexUnit = 0;
 }
 
+void Shader::useProgram()
+{
+    RenderState::bindProgram(_programID);
+}
+
+bool Shader::updateUniformState(UniformState &state, const GLfloat *value, GLsizei size)
+{
+    if (state.size == size && std::memcmp(state.value, value, size * sizeof(GLfloat)) == 0)
+        return false;
+
+    std::memcpy(state.value, value, size * sizeof(GLfloat));
+    state.size = size;
+    _uniformVersion = ++_uniformVersionCounter;
+    return true;
+}
+
 void Shader::bind()
 {
-    glUseProgram(_programID);
-    
+    useProgram();
+
+    // attribute pointers only need to be set again if the program or the vertex buffer changed
+    if (RenderState::needsAttribSetup())
+        bindAttribs(RenderState::getVertexLayout());
+
+    resetTexUnit();
+}
+
+void Shader::bindAttribs(const VertexLayout *layout)
+{
     for (auto i = _attribs.begin(); i != _attribs.end(); ++i)
     {
         const Attrib &attrib = i->second;
         GLint loc = attrib.loc - 1;
-        if (loc > -1)
+        if (loc > -1 && !layout)
         {
+            glEnableVertexAttribArray(loc);
             glVertexAttribPointer(loc, attrib.size, attrib.type, GL_FALSE, attrib.stride, reinterpret_cast<void*>(attrib.offset));
         }
+        else if (loc > -1)
+        {
+            const VertexLayout::Attribute *a = layout->findAttribute(i->first);
+            // the shader reads the default value (0, 0, 0, 1) if the layout doesn't contain the attribute
+            if (a)
+            {
+                glEnableVertexAttribArray(loc);
+                glVertexAttribPointer(loc, a->size, a->type, a->normalized, layout->getStride(), reinterpret_cast<void*>(a->offset));
+            }
+            else
+            {
+                glDisableVertexAttribArray(loc);
+            }
+        }
         else
         {
 //			bRenderer::log("Couldn't bind attrib '" + i->first + "' because its location is not valid.", bRenderer::LM_ERROR);
         }
     }
-    
-    resetTexUnit();
 }
 
 bool Shader::compile(GLuint* shader, GLenum type, const std::string &src)
@@ -3,6 +3,7 @@
 #include "headers/OSdetect.h"
 #include "headers/Configuration.h"
 #include "headers/ShaderSource.h"
+#include "headers/Geometry.h"
 
 /* Public functions */
 
@@ -121,16 +122,17 @@ void ShaderDataGenerator::initializeSourceCommonVariables()
 
 void ShaderDataGenerator::createVertShader()
 {
-	// matrices
-	_vertShaderSrc += bRenderer::SHADER_SOURCE_MATRICES();
+	// matrices, the model view matrix is read per instance if instances can be drawn with one draw call
+	bool instancing = Geometry::supportsHardwareInstancing();
+	_vertShaderSrc += bRenderer::shader_source_matrices(instancing);
 	// attributes
 	_vertShaderSrc += bRenderer::SHADER_SOURCE_ATTRIBUTES();
 	
 	// main function begin
-	_vertShaderSrc += bRenderer::shader_source_function_vertex_main_begin((_diffuseLighting || _specularLighting), (_diffuseMap || _normalMap || _specularMap || _isText), _normalMap);
+	_vertShaderSrc += bRenderer::shader_source_function_vertex_main_begin((_diffuseLighting || _specularLighting), (_diffuseMap || _normalMap || _specularMap || _isText), _normalMap, instancing);
 	if (_normalMap){
 		// main function tbn
-		_vertShaderSrc += bRenderer::SHADER_SOURCE_FUNCTION_VERTEX_MAIN_TBN();
+		_vertShaderSrc += bRenderer::shader_source_function_vertex_main_tbn(instancing);
 		if (_specularLighting){
 			// camera tangent space
 			_vertShaderSrc += bRenderer::SHADER_SOURCE_FUNCTION_VERTEX_MAIN_CAMERA_TANGENT_SPACE();
@@ -36,16 +36,21 @@ namespace bRenderer
     }
     
     // Matrices
-	std::string SHADER_SOURCE_MATRICES() { return
-		"uniform mat4 " + DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX() + SHADER_SOURCE_LINE_ENDING()
-		+ "uniform mat4 " + DEFAULT_SHADER_UNIFORM_PROJECTION_MATRIX() + SHADER_SOURCE_LINE_ENDING(); }
+	std::string shader_source_matrices(bool instancing)
+	{
+		// with instancing the model view matrix is an attribute that advances once per instance
+		std::string matrices = instancing ? "attribute mat4 " + DEFAULT_SHADER_ATTRIBUTE_INSTANCE_MODEL_VIEW_MATRIX() : "uniform mat4 " + DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX();
+		return matrices + SHADER_SOURCE_LINE_ENDING()
+			+ "uniform mat4 " + DEFAULT_SHADER_UNIFORM_PROJECTION_MATRIX() + SHADER_SOURCE_LINE_ENDING();
+	}
+
+	std::string shader_source_model_view_matrix(bool instancing) { return instancing ? DEFAULT_SHADER_ATTRIBUTE_INSTANCE_MODEL_VIEW_MATRIX() : DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX(); }
 
     // Attributes
     std::string SHADER_SOURCE_ATTRIBUTES() { return
     "attribute vec4 " + DEFAULT_SHADER_ATTRIBUTE_POSITION() + SHADER_SOURCE_LINE_ENDING()
 	+ "attribute vec3 " + DEFAULT_SHADER_ATTRIBUTE_NORMAL() + SHADER_SOURCE_LINE_ENDING()
-	+ "attribute vec3 " + DEFAULT_SHADER_ATTRIBUTE_TANGENT() + SHADER_SOURCE_LINE_ENDING()
-	+ "attribute vec3 " + DEFAULT_SHADER_ATTRIBUTE_BITANGENT() + SHADER_SOURCE_LINE_ENDING()
+	+ "attribute vec4 " + DEFAULT_SHADER_ATTRIBUTE_TANGENT() + SHADER_SOURCE_LINE_ENDING()
 	+ "attribute vec4 " + DEFAULT_SHADER_ATTRIBUTE_TEXCOORD() + SHADER_SOURCE_LINE_ENDING(); }
     
     // Varyings
@@ -79,27 +84,32 @@ namespace bRenderer
     
     // Vertex Shader Main Function
     //Begin
-	std::string shader_source_function_vertex_main_begin(bool hasLighting, bool hasTextures, bool normalMap)
+	std::string shader_source_function_vertex_main_begin(bool hasLighting, bool hasTextures, bool normalMap, bool instancing)
     {
+		std::string modelView = shader_source_model_view_matrix(instancing);
 		std::string main =
 			"void main() {" + SHADER_SOURCE_LINE_BREAK()
-			+ "vec4 posViewSpace = " + DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX() + "*" + DEFAULT_SHADER_ATTRIBUTE_POSITION() + SHADER_SOURCE_LINE_ENDING()
+			+ "vec4 posViewSpace = " + modelView + "*" + DEFAULT_SHADER_ATTRIBUTE_POSITION() + SHADER_SOURCE_LINE_ENDING()
 			+ "float lightDistance = 0.0" + SHADER_SOURCE_LINE_ENDING();
         if (hasTextures)
 			main += "texCoordVarying = " + DEFAULT_SHADER_ATTRIBUTE_TEXCOORD() + ".st" + SHADER_SOURCE_LINE_ENDING();
         if (hasLighting && !normalMap)
-			main += "normalVaryingViewSpace = mat3(" + DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX() + ")*" + DEFAULT_SHADER_ATTRIBUTE_NORMAL() + SHADER_SOURCE_LINE_ENDING();
+			main += "normalVaryingViewSpace = mat3(" + modelView + ")*" + DEFAULT_SHADER_ATTRIBUTE_NORMAL() + SHADER_SOURCE_LINE_ENDING();
         return main;
     }
     // TBN for normal map
-    std::string SHADER_SOURCE_FUNCTION_VERTEX_MAIN_TBN() { return
-		+"vec3 vertexNormal_ViewSpace = mat3(" + DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX() + ") * " + DEFAULT_SHADER_ATTRIBUTE_NORMAL() + SHADER_SOURCE_LINE_ENDING()
-		+ "vec3 vertexTangent_ViewSpace = mat3(" + DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX() + ") * " + DEFAULT_SHADER_ATTRIBUTE_TANGENT() + SHADER_SOURCE_LINE_ENDING()
-		+ "vec3 vertexBitangent_ViewSpace = mat3(" + DEFAULT_SHADER_UNIFORM_MODEL_VIEW_MATRIX() + ") * " + DEFAULT_SHADER_ATTRIBUTE_BITANGENT() + SHADER_SOURCE_LINE_ENDING()
+    std::string shader_source_function_vertex_main_tbn(bool instancing)
+	{
+		std::string modelView = shader_source_model_view_matrix(instancing);
+		return "vec3 vertexNormal_ViewSpace = mat3(" + modelView + ") * " + DEFAULT_SHADER_ATTRIBUTE_NORMAL() + SHADER_SOURCE_LINE_ENDING()
+		+ "vec3 vertexTangent_ViewSpace = mat3(" + modelView + ") * " + DEFAULT_SHADER_ATTRIBUTE_TANGENT() + ".xyz" + SHADER_SOURCE_LINE_ENDING()
+		// the w component of the tangent holds the sign of the bitangent
+		+ "vec3 vertexBitangent_ViewSpace = mat3(" + modelView + ") * (cross(" + DEFAULT_SHADER_ATTRIBUTE_NORMAL() + ", " + DEFAULT_SHADER_ATTRIBUTE_TANGENT() + ".xyz) * sign(" + DEFAULT_SHADER_ATTRIBUTE_TANGENT() + ".w))" + SHADER_SOURCE_LINE_ENDING()
     + "vec3 firstRow = vec3(vertexTangent_ViewSpace.x, vertexBitangent_ViewSpace.x, vertexNormal_ViewSpace.x)" + SHADER_SOURCE_LINE_ENDING()
     + "vec3 secondRow = vec3(vertexTangent_ViewSpace.y, vertexBitangent_ViewSpace.y, vertexNormal_ViewSpace.y)" + SHADER_SOURCE_LINE_ENDING()
     + "vec3 thirdRow = vec3(vertexTangent_ViewSpace.z, vertexBitangent_ViewSpace.z, vertexNormal_ViewSpace.z)" + SHADER_SOURCE_LINE_ENDING()
-    + "mat3 TBN = mat3(firstRow, secondRow, thirdRow)" + SHADER_SOURCE_LINE_ENDING(); }
+    + "mat3 TBN = mat3(firstRow, secondRow, thirdRow)" + SHADER_SOURCE_LINE_ENDING();
+	}
     // Camera tangent space
     std::string SHADER_SOURCE_FUNCTION_VERTEX_MAIN_CAMERA_TANGENT_SPACE() { return "surfaceToCameraTangentSpace = TBN*( - posViewSpace.xyz )" + SHADER_SOURCE_LINE_ENDING(); }
 	// Camera view space
@@ -4,29 +4,25 @@
 
 Sprite::Sprite(MaterialPtr material, bool flipT, PropertiesPtr	properties)
 {
-	createGeometry(flipT);
-
 	setMaterial(material);
+	createGeometry(flipT);
 	setProperties(properties);
 }
 
 Sprite::Sprite(ObjectManager *o, const std::string &textureFileName, const std::string &materialName, ShaderPtr shader, bool flipT, PropertiesPtr	properties)
 {
-	createGeometry(flipT);
-
 	MaterialData md; 
 	md.textures[bRenderer::DEFAULT_SHADER_UNIFORM_DIFFUSE_MAP()] = textureFileName;
 
 	MaterialPtr material = o->createMaterial(materialName, md, shader);
 
 	setMaterial(material);
+	createGeometry(flipT);
 	setProperties(properties);
 }
 
 Sprite::Sprite(ObjectManager *o, const std::string &name, const std::string &textureFileName, GLuint shaderMaxLights, bool variableNumberOfLights, bool flipT, PropertiesPtr	properties)
 {
-	createGeometry(flipT);
-
 	MaterialData md;
 	md.textures[bRenderer::DEFAULT_SHADER_UNIFORM_DIFFUSE_MAP()] = textureFileName;
 
@@ -35,6 +31,7 @@ Sprite::Sprite(ObjectManager *o, const std::string &name, const std::string &tex
 	MaterialPtr material = o->createMaterial(name, md, shader);
 
 	setMaterial(material);
+	createGeometry(flipT);
 	setProperties(properties);
 }
 
@@ -101,6 +98,8 @@ void Sprite::createGeometry(bool flipT)
 	gData->indices.push_back(IndexData(3, 4, 0));
 	gData->indices.push_back(IndexData(0, 3, 0));
 
+	// the material is needed to choose the vertex layout
+	g->setMaterial(getMaterial());
 	g->initialize(gData);
 
 	setBoundingBoxObjectSpace(g->getBoundingBoxObjectSpace());
@@ -8,9 +8,6 @@
 TextSprite::TextSprite(ObjectManager *o, const std::string &name, vmml::Vector3f color, const std::string &text, FontPtr font, PropertiesPtr properties)
 	: Sprite(), _text(text), _font(font)
 {
-	// Create geometry
-	createGeometry();
-
 	// Create shader and material
 	ShaderPtr shader = o->generateShader(name, { 0, false, true, false, false, true, false, false, false, false, false, false, true });
 	MaterialPtr material = o->createMaterial(name, shader);
@@ -21,19 +18,24 @@ TextSprite::TextSprite(ObjectManager *o, const std::string &name, vmml::Vector3f
 	material->setVector(bRenderer::WAVEFRONT_MATERIAL_DIFFUSE_COLOR(), color);
 
 	setMaterial(material);
+
+	// Create geometry
+	createGeometry();
+
 	setProperties(properties);
 }
 
 TextSprite::TextSprite(MaterialPtr material, const std::string &text, FontPtr font, PropertiesPtr	properties)
 	: Sprite(), _text(text), _font(font)
 {
-	// Create geometry
-	createGeometry();
-
 	// Add atlas texture to the material
 	material->setTexture(bRenderer::DEFAULT_SHADER_UNIFORM_CHARACTER_MAP(), font->getAtlas());
 
 	setMaterial(material);
+
+	// Create geometry
+	createGeometry();
+
 	setProperties(properties);
 }
 
@@ -150,6 +152,8 @@ void TextSprite::createGeometry()
 		}
 	}
 
+	// the material is needed to choose the vertex layout
+	g->setMaterial(getMaterial());
 	g->initialize(gData);
 
 	setBoundingBoxObjectSpace(g->getBoundingBoxObjectSpace());
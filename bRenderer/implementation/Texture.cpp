@@ -1,5 +1,7 @@
 #include "headers/Texture.h"
 #include "headers/TextureData.h"
+#include "headers/RenderState.h"
+#include <algorithm>
 
 Texture::Texture(const TextureData &data)
 {
@@ -18,7 +20,15 @@ Texture::Texture(const TextureData &data)
 
             glTexImage2D(GL_TEXTURE_2D, 0, data.getFormat(), data.getWidth(), data.getHeight(), 0, data.getFormat(), GL_UNSIGNED_BYTE, data.getImageData().get());
 
-            glGenerateMipmap(GL_TEXTURE_2D);
+            // Cooked textures come with their mip levels
+            const std::vector< ImageDataPtr > &mipLevels = data.getMipLevels();
+            if (mipLevels.empty())
+                glGenerateMipmap(GL_TEXTURE_2D);
+            for (size_t i = 0; i < mipLevels.size(); i++)
+            {
+                GLsizei level = static_cast<GLsizei>(i + 1);
+                glTexImage2D(GL_TEXTURE_2D, level, data.getFormat(), std::max(data.getWidth() >> level, 1), std::max(data.getHeight() >> level, 1), 0, data.getFormat(), GL_UNSIGNED_BYTE, mipLevels[i].get());
+            }
         }
         else{
             // Create empty texture (e.g. for binding to a framebuffer) without mipmap
@@ -37,7 +47,5 @@ Texture::Texture(const TextureData &data)
 
 void Texture::bind(GLint texUnit)
 {
-    glActiveTexture(texUnit);
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, _textureID);
+    RenderState::bindTexture(texUnit, GL_TEXTURE_2D, _textureID);
 }
\ No newline at end of file
@@ -1,4 +1,44 @@
 #include "headers/TextureData.h"
+#include "headers/BinaryFile.h"
+#include "headers/FileHandler.h"
+#include "headers/Configuration.h"
+#include "headers/Logger.h"
+#include <algorithm>
+
+namespace
+{
+	const char MAGIC[8] = { 'B', 'T', 'E', 'X', 0, 0, 0, 0 };
+	const uint32_t VERSION = 1;
+	const uint32_t ENDIANNESS_MARKER = 0x01020304;
+	const size_t BLOB_ALIGNMENT = 16;
+
+	ImageDataPtr allocateImageData(size_t size)
+	{
+		return ImageDataPtr(new GLubyte[size], std::default_delete< GLubyte[] >());
+	}
+
+	GLsizei mipSize(GLsizei size, size_t level)
+	{
+		return std::max(static_cast<GLsizei>(size >> level), 1);
+	}
+
+	/* Reads the header and the source file, returns false if the cooked file is outdated */
+	bool readHeader(BinaryReader &reader, GLenum &format, GLsizei &width, GLsizei &height, uint32_t &nLevels)
+	{
+		char magic[sizeof(MAGIC)];
+		if (!reader.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+			return false;
+		if (reader.value< uint32_t >() != VERSION || reader.value< uint32_t >() != ENDIANNESS_MARKER)
+			return false;
+		format = reader.value< uint32_t >();
+		width = reader.value< int32_t >();
+		height = reader.value< int32_t >();
+		nLevels = reader.value< uint32_t >();
+
+		SourceStamp stamp;
+		return stamp.read(reader) && stamp.isCurrent() && width > 0 && height > 0;
+	}
+}
 
 TextureData::TextureData(const std::string &fileName)
 {
@@ -17,6 +57,149 @@ TextureData &TextureData::create(GLsizei width, GLsizei height, GLenum format, I
 	_height = height;
 	_format = format;
 	_imageData = imageData;
+	_mipLevels.clear();
 
 	return *this;
-}
\ No newline at end of file
+}
+
+bool TextureData::loadCooked(const std::string &fileName)
+{
+	std::string cookedPath = getCookedPath(fileName);
+	bRenderer::MappedFile file(cookedPath);
+	if (!file.isOpen())
+		return false;
+	BinaryReader reader(file.begin(), file.end());
+
+	GLenum format;
+	GLsizei width, height;
+	uint32_t nLevels;
+	if (!readHeader(reader, format, width, height, nLevels))
+		return false;
+
+	ImageDataPtr imageData;
+	std::vector< ImageDataPtr > mipLevels;
+	for (uint32_t i = 0; i < nLevels && reader.ok(); i++)
+	{
+		size_t size = static_cast<size_t>(mipSize(width, i)) * mipSize(height, i) * getBytesPerPixel(format);
+		const char *blob = reader.blob(reader.value< uint64_t >(), size, 1);
+		if (!blob)
+			break;
+		ImageDataPtr level = allocateImageData(size);
+		std::memcpy(level.get(), blob, size);
+		if (i == 0)
+			imageData = level;
+		else
+			mipLevels.push_back(level);
+	}
+	if (!reader.ok() || !imageData || mipLevels.size() + 1 != nLevels)
+	{
+		bRenderer::log("Cooked texture " + cookedPath + " is corrupt", bRenderer::LM_WARNING);
+		return false;
+	}
+
+	create(width, height, format, imageData);
+	_mipLevels.swap(mipLevels);
+	return true;
+}
+
+bool TextureData::saveCooked(const std::string &fileName) const
+{
+	if (!_imageData)
+		return false;
+
+	BinaryWriter writer;
+	uint32_t nLevels = static_cast<uint32_t>(_mipLevels.size() + 1);
+
+	// Header
+	writer.write(MAGIC, sizeof(MAGIC));
+	writer.value(VERSION);
+	writer.value(ENDIANNESS_MARKER);
+	writer.value(static_cast<uint32_t>(_format));
+	writer.value(static_cast<int32_t>(_width));
+	writer.value(static_cast<int32_t>(_height));
+	writer.value(nLevels);
+
+	SourceStamp stamp;
+	if (!stamp.create(fileName))
+		return false;
+	stamp.write(writer);
+
+	// Level table, the offsets are filled in once they are known
+	size_t tablePosition = writer.size();
+	for (uint32_t i = 0; i < nLevels; i++)
+		writer.value(static_cast<uint64_t>(0));
+
+	// Level blobs
+	for (uint32_t i = 0; i < nLevels; i++)
+	{
+		const ImageDataPtr &level = i == 0 ? _imageData : _mipLevels[i - 1];
+		size_t size = static_cast<size_t>(mipSize(_width, i)) * mipSize(_height, i) * getBytesPerPixel(_format);
+		writer.align(BLOB_ALIGNMENT);
+		writer.patch(tablePosition + i * sizeof(uint64_t), writer.size());
+		writer.write(level.get(), size);
+	}
+
+	return writer.save(getCookedPath(fileName));
+}
+
+TextureData &TextureData::generateMipLevels()
+{
+	_mipLevels.clear();
+	if (!_imageData)
+		return *this;
+
+	size_t bpp = getBytesPerPixel(_format);
+	const GLubyte *src = _imageData.get();
+	for (size_t level = 1; mipSize(_width, level - 1) > 1 || mipSize(_height, level - 1) > 1; level++)
+	{
+		GLsizei srcWidth = mipSize(_width, level - 1), srcHeight = mipSize(_height, level - 1);
+		GLsizei width = mipSize(_width, level), height = mipSize(_height, level);
+		ImageDataPtr data = allocateImageData(static_cast<size_t>(width) * height * bpp);
+		GLubyte *dst = data.get();
+
+		for (GLsizei y = 0; y < height; y++)
+		{
+			// Odd sizes repeat the last row or column
+			const GLubyte *row0 = src + static_cast<size_t>(std::min(2 * y, srcHeight - 1)) * srcWidth * bpp;
+			const GLubyte *row1 = src + static_cast<size_t>(std::min(2 * y + 1, srcHeight - 1)) * srcWidth * bpp;
+			for (GLsizei x = 0; x < width; x++)
+			{
+				size_t x0 = static_cast<size_t>(std::min(2 * x, srcWidth - 1)) * bpp;
+				size_t x1 = static_cast<size_t>(std::min(2 * x + 1, srcWidth - 1)) * bpp;
+				for (size_t c = 0; c < bpp; c++)
+					*dst++ = static_cast<GLubyte>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+			}
+		}
+		_mipLevels.push_back(data);
+		src = data.get();
+	}
+	return *this;
+}
+
+std::string TextureData::getCookedPath(const std::string &fileName)
+{
+	return bRenderer::getFilePath(fileName) + bRenderer::COOKED_TEXTURE_FILE_EXTENSION();
+}
+
+bool TextureData::isCookedUpToDate(const std::string &fileName)
+{
+	bRenderer::MappedFile file(getCookedPath(fileName));
+	BinaryReader reader(file.begin(), file.end());
+	GLenum format;
+	GLsizei width, height;
+	uint32_t nLevels;
+	return file.isOpen() && readHeader(reader, format, width, height, nLevels);
+}
+
+GLsizei TextureData::getBytesPerPixel(GLenum format)
+{
+	switch (format)
+	{
+	case GL_RGBA:
+		return 4;
+	case GL_RGB:
+		return 3;
+	default:
+		return 1;
+	}
+}
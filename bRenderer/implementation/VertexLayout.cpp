@@ -0,0 +1,213 @@
+#include "headers/VertexLayout.h"
+#include "headers/GeometryData.h"
+#include "headers/Shader.h"
+#include "headers/Configuration.h"
+#include <unordered_map>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+
+namespace
+{
+	/* Converts a value in [-1, 1] to a signed normalized integer with the given maximum */
+	GLint toSnorm(GLfloat v, GLint max)
+	{
+		v = std::max(-1.0f, std::min(1.0f, v));
+		return static_cast<GLint>(std::floor(v * max + 0.5f));
+	}
+
+	/* Writes a direction and a sign as four signed normalized values */
+	void writePackedVector(GLubyte *dst, GLenum type, const Vector3 &v, GLfloat w)
+	{
+		if (type == GL_INT_2_10_10_10_REV){
+			uint32_t bits = (static_cast<uint32_t>(toSnorm(v.x, 511)) & 0x3FF)
+				| ((static_cast<uint32_t>(toSnorm(v.y, 511)) & 0x3FF) << 10)
+				| ((static_cast<uint32_t>(toSnorm(v.z, 511)) & 0x3FF) << 20)
+				| ((static_cast<uint32_t>(toSnorm(w, 1)) & 0x3) << 30);
+			std::memcpy(dst, &bits, sizeof(bits));
+		}
+		else{
+			GLbyte bytes[4] = { static_cast<GLbyte>(toSnorm(v.x, 127)), static_cast<GLbyte>(toSnorm(v.y, 127)), static_cast<GLbyte>(toSnorm(v.z, 127)), static_cast<GLbyte>(toSnorm(w, 127)) };
+			std::memcpy(dst, bytes, sizeof(bytes));
+		}
+	}
+
+	/* Converts a float to a half float, rounding to the nearest value */
+	GLushort toHalf(GLfloat f)
+	{
+		uint32_t x;
+		std::memcpy(&x, &f, sizeof(x));
+		uint32_t sign = (x >> 16) & 0x8000;
+		uint32_t mantissa = x & 0x7FFFFF;
+		int32_t exponent = static_cast<int32_t>((x >> 23) & 0xFF) - 127 + 15;
+
+		// infinity and NaN
+		if (((x >> 23) & 0xFF) == 0xFF)
+			return static_cast<GLushort>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+		// too large
+		if (exponent >= 31)
+			return static_cast<GLushort>(sign | 0x7C00);
+		// subnormal or too small
+		if (exponent <= 0){
+			if (exponent < -10)
+				return static_cast<GLushort>(sign);
+			mantissa |= 0x800000;
+			uint32_t shift = static_cast<uint32_t>(14 - exponent);
+			uint32_t half = mantissa >> shift;
+			if ((mantissa >> (shift - 1)) & 1)
+				half++;
+			return static_cast<GLushort>(sign | half);
+		}
+		// a carry from rounding correctly increases the exponent
+		uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+		if (mantissa & 0x1000)
+			half++;
+		return static_cast<GLushort>(half);
+	}
+
+	/* Returns the sign of the bitangent relative to cross(normal, tangent) */
+	GLfloat bitangentSign(const Vertex &v)
+	{
+		GLfloat cx = v.normal.y * v.tangent.z - v.normal.z * v.tangent.y;
+		GLfloat cy = v.normal.z * v.tangent.x - v.normal.x * v.tangent.z;
+		GLfloat cz = v.normal.x * v.tangent.y - v.normal.y * v.tangent.x;
+		return (cx * v.bitangent.x + cy * v.bitangent.y + cz * v.bitangent.z) < 0.0f ? -1.0f : 1.0f;
+	}
+}
+
+/* Public functions */
+
+const VertexLayout &VertexLayout::get(Components components)
+{
+	static std::unordered_map< Components, std::unique_ptr< VertexLayout > > layouts;
+	components &= VC_ALL;
+	std::unique_ptr< VertexLayout > &layout = layouts[components];
+	if (!layout)
+		layout.reset(new VertexLayout(components));
+	return *layout;
+}
+
+VertexLayout::Components VertexLayout::getRequiredComponents(Shader &shader)
+{
+	Components components = VC_POSITION;
+	if (shader.getAttribLocation(bRenderer::DEFAULT_SHADER_ATTRIBUTE_NORMAL()) > -1)
+		components |= VC_NORMAL;
+	if (shader.getAttribLocation(bRenderer::DEFAULT_SHADER_ATTRIBUTE_TANGENT()) > -1)
+		components |= VC_TANGENT;
+	if (shader.getAttribLocation(bRenderer::DEFAULT_SHADER_ATTRIBUTE_BITANGENT()) > -1)
+		components |= VC_BITANGENT;
+	if (shader.getAttribLocation(bRenderer::DEFAULT_SHADER_ATTRIBUTE_TEXCOORD()) > -1)
+		components |= VC_TEXCOORD;
+	return components;
+}
+
+const VertexLayout::Attribute *VertexLayout::findAttribute(const std::string &name) const
+{
+	for (auto i = _attributes.begin(); i != _attributes.end(); ++i)
+	{
+		if (i->name == name)
+			return &(*i);
+	}
+	return nullptr;
+}
+
+void VertexLayout::pack(const Vertex *vertices, size_t nVertices, std::vector< GLubyte > &buffer) const
+{
+	buffer.resize(nVertices * _stride);
+	if (nVertices == 0)
+		return;
+
+	if (!isCompact()){
+		std::memcpy(&buffer[0], vertices, nVertices * sizeof(Vertex));
+		return;
+	}
+
+	for (size_t i = 0; i < nVertices; i++)
+	{
+		const Vertex &v = vertices[i];
+		GLubyte *dst = &buffer[i * _stride];
+		for (auto a = _attributes.begin(); a != _attributes.end(); ++a)
+		{
+			switch (a->component)
+			{
+			case VC_POSITION:
+				std::memcpy(dst + a->offset, &v.position, sizeof(Point3));
+				break;
+			case VC_NORMAL:
+				writePackedVector(dst + a->offset, a->type, v.normal, 0.0f);
+				break;
+			case VC_TANGENT:
+				writePackedVector(dst + a->offset, a->type, v.tangent, bitangentSign(v));
+				break;
+			case VC_TEXCOORD:
+				if (a->type == GL_HALF_FLOAT){
+					GLushort st[2] = { toHalf(v.texCoord.s), toHalf(v.texCoord.t) };
+					std::memcpy(dst + a->offset, st, sizeof(st));
+				}
+				else
+					std::memcpy(dst + a->offset, &v.texCoord, sizeof(TexCoord));
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
+
+/* Private functions */
+
+VertexLayout::VertexLayout(Components components)
+	: _components(components)
+{
+	// Same as the Vertex struct
+	if (!isCompact()){
+		_stride = sizeof(Vertex);
+		_attributes.push_back(Attribute{ VC_POSITION, bRenderer::DEFAULT_SHADER_ATTRIBUTE_POSITION(), 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, position) });
+		_attributes.push_back(Attribute{ VC_NORMAL, bRenderer::DEFAULT_SHADER_ATTRIBUTE_NORMAL(), 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, normal) });
+		_attributes.push_back(Attribute{ VC_TANGENT, bRenderer::DEFAULT_SHADER_ATTRIBUTE_TANGENT(), 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, tangent) });
+		_attributes.push_back(Attribute{ VC_BITANGENT, bRenderer::DEFAULT_SHADER_ATTRIBUTE_BITANGENT(), 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, bitangent) });
+		_attributes.push_back(Attribute{ VC_TEXCOORD, bRenderer::DEFAULT_SHADER_ATTRIBUTE_TEXCOORD(), 2, GL_FLOAT, GL_FALSE, offsetof(Vertex, texCoord) });
+		return;
+	}
+
+	GLenum vectorType = supportsPackedVectors() ? GL_INT_2_10_10_10_REV : GL_BYTE;
+	addAttribute(VC_POSITION, bRenderer::DEFAULT_SHADER_ATTRIBUTE_POSITION(), 3, GL_FLOAT, GL_FALSE, sizeof(Point3));
+	if (components & VC_NORMAL)
+		addAttribute(VC_NORMAL, bRenderer::DEFAULT_SHADER_ATTRIBUTE_NORMAL(), 4, vectorType, GL_TRUE, 4);
+	if (components & VC_TANGENT)
+		addAttribute(VC_TANGENT, bRenderer::DEFAULT_SHADER_ATTRIBUTE_TANGENT(), 4, vectorType, GL_TRUE, 4);
+	if (components & VC_TEXCOORD){
+		if (supportsHalfFloats())
+			addAttribute(VC_TEXCOORD, bRenderer::DEFAULT_SHADER_ATTRIBUTE_TEXCOORD(), 2, GL_HALF_FLOAT, GL_FALSE, 2 * sizeof(GLushort));
+		else
+			addAttribute(VC_TEXCOORD, bRenderer::DEFAULT_SHADER_ATTRIBUTE_TEXCOORD(), 2, GL_FLOAT, GL_FALSE, sizeof(TexCoord));
+	}
+}
+
+void VertexLayout::addAttribute(VertexComponent component, const std::string &name, GLint size, GLenum type, GLboolean normalized, size_t bytes)
+{
+	_attributes.push_back(Attribute{ component, name, size, type, normalized, static_cast<size_t>(_stride) });
+	_stride += static_cast<GLsizei>(bytes);
+}
+
+bool VertexLayout::supportsPackedVectors()
+{
+#ifdef B_OS_DESKTOP
+	return GLEW_VERSION_3_3 || GLEW_ARB_vertex_type_2_10_10_10_rev;
+#else
+	// the context is created for OpenGL ES 2.0, which only supports bytes
+	return false;
+#endif
+}
+
+bool VertexLayout::supportsHalfFloats()
+{
+#ifdef B_OS_DESKTOP
+	return GLEW_VERSION_3_0 || GLEW_ARB_half_float_vertex;
+#else
+	// the context is created for OpenGL ES 2.0, which doesn't support half float attributes
+	return false;
+#endif
+}
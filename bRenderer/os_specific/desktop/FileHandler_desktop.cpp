@@ -6,6 +6,23 @@
 #include "headers/Logger.h"
 #include "headers/Configuration.h"
 #include <sys/stat.h>
+#include <fstream>
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+#if defined(__linux) || defined(__APPLE__)
+#define B_MAPPED_FILES
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace bRenderer
 {
@@ -13,6 +30,57 @@ namespace bRenderer
 	
 	std::string standardFilePath = bRenderer::DEFAULT_FILE_PATH();
 
+	/* Internal functions */
+
+	bool listDirectory(const std::string &directory, std::vector< std::string > &fileNames)
+	{
+		std::string directoryPath = standardFilePath + directory;
+		if (!directory.empty() && directory.find_last_of("/") != directory.length() - 1)
+			directoryPath.append("/");
+		std::string prefix = directoryPath.substr(standardFilePath.length());
+
+		std::vector< std::string > entries, subdirectories;
+#ifdef _WIN32
+		WIN32_FIND_DATAA data;
+		HANDLE handle = FindFirstFileA((directoryPath + "*").c_str(), &data);
+		if (handle == INVALID_HANDLE_VALUE)
+			return false;
+		do
+		{
+			std::string name = data.cFileName;
+			if (name == "." || name == "..")
+				continue;
+			if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+				subdirectories.push_back(prefix + name);
+			else
+				entries.push_back(prefix + name);
+		} while (FindNextFileA(handle, &data));
+		FindClose(handle);
+#else
+		DIR *dir = opendir(directoryPath.c_str());
+		if (!dir)
+			return false;
+		while (dirent *entry = readdir(dir))
+		{
+			std::string name = entry->d_name;
+			if (name == "." || name == "..")
+				continue;
+			struct stat buffer;
+			if (stat((directoryPath + name).c_str(), &buffer) != 0)
+				continue;
+			if (S_ISDIR(buffer.st_mode))
+				subdirectories.push_back(prefix + name);
+			else
+				entries.push_back(prefix + name);
+		}
+		closedir(dir);
+#endif
+		fileNames.insert(fileNames.end(), entries.begin(), entries.end());
+		for (auto i = subdirectories.begin(); i != subdirectories.end(); ++i)
+			listDirectory(*i, fileNames);
+		return true;
+	}
+
 	/* External functions */
 
 	void setStandardFilePath(const std::string &path)
@@ -51,6 +119,122 @@ namespace bRenderer
 		
 	}
 
+	bool getFileStatus(const std::string &filePath, long long &size, long long &modificationTime)
+	{
+		struct stat buffer;
+		if (stat(filePath.c_str(), &buffer) != 0)
+			return false;
+		size = static_cast<long long>(buffer.st_size);
+		modificationTime = static_cast<long long>(buffer.st_mtime);
+		return true;
+	}
+
+	bool listFiles(const std::string &directory, std::vector< std::string > &fileNames)
+	{
+		fileNames.clear();
+		if (!listDirectory(directory, fileNames))
+		{
+			log("Could not read directory " + standardFilePath + directory, LM_ERROR);
+			return false;
+		}
+		std::sort(fileNames.begin(), fileNames.end());
+		return true;
+	}
+
+	bool createDirectory(const std::string &directoryPath)
+	{
+		// create the parents first, a leading separator is not a directory of its own
+		size_t separator = 0;
+		do
+		{
+			separator = directoryPath.find_first_of("/\\", separator + 1);
+			std::string path = directoryPath.substr(0, separator);
+			struct stat buffer;
+			if (stat(path.c_str(), &buffer) != 0)
+			{
+#ifdef _WIN32
+				CreateDirectoryA(path.c_str(), NULL);
+#else
+				mkdir(path.c_str(), 0755);
+#endif
+			}
+		} while (separator != std::string::npos);
+
+		struct stat buffer;
+		if (stat(directoryPath.c_str(), &buffer) != 0 || !(buffer.st_mode & S_IFDIR))
+		{
+			log("Could not create directory " + directoryPath, LM_ERROR);
+			return false;
+		}
+		return true;
+	}
+
+	/* MappedFile */
+
+	MappedFile::MappedFile(const std::string &filePath)
+	{
+#ifdef B_MAPPED_FILES
+		int fd = open(filePath.c_str(), O_RDONLY);
+		if (fd == -1)
+			return;
+		struct stat status;
+		if (fstat(fd, &status) == 0)
+		{
+			_open = true;
+			_size = static_cast<size_t>(status.st_size);
+			// files of size 0 cannot be mapped but are valid
+			if (_size > 0)
+			{
+				void *data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (data != MAP_FAILED)
+				{
+					madvise(data, _size, MADV_SEQUENTIAL);
+					_data = static_cast<const char *>(data);
+					_mapped = true;
+				}
+			}
+		}
+		close(fd);
+		if (_open && _size > 0 && !_mapped)
+		{
+			log("Could not map " + filePath + ", reading it instead", LM_WARNING);
+			read(filePath);
+		}
+#else
+		read(filePath);
+#endif
+	}
+
+	MappedFile::~MappedFile()
+	{
+#ifdef B_MAPPED_FILES
+		if (_mapped)
+			munmap(const_cast<char *>(_data), _size);
+#endif
+	}
+
+	bool MappedFile::read(const std::string &filePath)
+	{
+		_open = false;
+		_size = 0;
+		_data = nullptr;
+		std::ifstream file(filePath, std::ifstream::in | std::ifstream::binary);
+		if (!file)
+			return false;
+		file.seekg(0, std::ifstream::end);
+		std::streamoff size = file.tellg();
+		file.seekg(0, std::ifstream::beg);
+		if (size < 0)
+			return false;
+		_buffer.resize(static_cast<size_t>(size));
+		if (size > 0 && !file.read(_buffer.data(), size))
+			return false;
+		_data = _buffer.data();
+		_size = _buffer.size();
+		_open = true;
+		return true;
+	}
+
 } // namespace bRenderer
 
 #endif
\ No newline at end of file
@@ -8,6 +8,11 @@
 
 TextureData &TextureData::load(const std::string &fileName)
 {
+	// Cooked textures are already decoded and mipmapped
+	if (loadCooked(fileName))
+		return *this;
+	_mipLevels.clear();
+
 	std::string fullFileName = bRenderer::getFilePath(fileName);
 
 	static const size_t COMPONENTS = 4;
@@ -36,7 +41,7 @@ TextureData &TextureData::load(const std::string &fileName)
 		texture[j * 4 + 3] = pixeles[j * 4 + 3];
 	}
 
-	_imageData = ImageDataPtr(texture);
+	_imageData = ImageDataPtr(texture, std::default_delete< GLubyte[] >());
 
 	return *this;
 }
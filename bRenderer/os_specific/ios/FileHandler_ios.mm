@@ -3,6 +3,9 @@
 
 #include "headers/FileHandler.h"
 #include "headers/Logger.h"
+#include <fstream>
+#include <algorithm>
+#include <sys/stat.h>
 
 namespace bRenderer
 {
@@ -38,6 +41,84 @@ namespace bRenderer
         return [fileManager fileExistsAtPath:path];
     }
 
+    bool getFileStatus(const std::string &filePath, long long &size, long long &modificationTime)
+    {
+        struct stat buffer;
+        if (stat(filePath.c_str(), &buffer) != 0)
+            return false;
+        size = static_cast<long long>(buffer.st_size);
+        modificationTime = static_cast<long long>(buffer.st_mtime);
+        return true;
+    }
+
+    bool listFiles(const std::string &directory, std::vector< std::string > &fileNames)
+    {
+        fileNames.clear();
+        NSString *subpath = [NSString stringWithCString:directory.c_str()
+                                               encoding:[NSString defaultCStringEncoding]];
+        NSString *path = [[[NSBundle mainBundle] resourcePath] stringByAppendingPathComponent: subpath];
+        
+        NSFileManager *fileManager = [NSFileManager defaultManager];
+        NSDirectoryEnumerator *enumerator = [fileManager enumeratorAtPath:path];
+        if (!enumerator)
+        {
+            log("Could not read directory " + directory, LM_ERROR);
+            return false;
+        }
+        
+        for (NSString *file in enumerator)
+        {
+            if ([[[enumerator fileAttributes] fileType] isEqualToString:NSFileTypeDirectory])
+                continue;
+            NSString *fileName = [subpath length] > 0 ? [subpath stringByAppendingPathComponent:file] : file;
+            fileNames.push_back(std::string([fileName UTF8String]));
+        }
+        std::sort(fileNames.begin(), fileNames.end());
+        return true;
+    }
+
+    bool createDirectory(const std::string &directoryPath)
+    {
+        NSString *path = [NSString stringWithUTF8String:directoryPath.c_str()];
+        NSError *error = nil;
+        if (![[NSFileManager defaultManager] createDirectoryAtPath:path withIntermediateDirectories:YES attributes:nil error:&error])
+        {
+            log("Could not create directory " + directoryPath, LM_ERROR);
+            return false;
+        }
+        return true;
+    }
+
+    /* MappedFile */
+
+    MappedFile::MappedFile(const std::string &filePath)
+    {
+        read(filePath);
+    }
+
+    MappedFile::~MappedFile()
+    {
+    }
+
+    bool MappedFile::read(const std::string &filePath)
+    {
+        std::ifstream file(filePath, std::ifstream::in | std::ifstream::binary);
+        if (!file)
+            return false;
+        file.seekg(0, std::ifstream::end);
+        std::streamoff size = file.tellg();
+        file.seekg(0, std::ifstream::beg);
+        if (size < 0)
+            return false;
+        _buffer.resize(static_cast<size_t>(size));
+        if (size > 0 && !file.read(_buffer.data(), size))
+            return false;
+        _data = _buffer.data();
+        _size = _buffer.size();
+        _open = true;
+        return true;
+    }
+
 } // namespace bRenderer
 
 #endif
\ No newline at end of file
@@ -5,6 +5,11 @@
 
 TextureData &TextureData::load(const std::string &fileName)
 {
+    // Cooked textures are already decoded and mipmapped
+    if (loadCooked(fileName))
+        return *this;
+    _mipLevels.clear();
+    
     static const size_t COMPONENTS          = 4;
     static const size_t BITS_PER_COMPONENT  = 8;
     
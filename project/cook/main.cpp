@@ -0,0 +1,87 @@
+#include "headers/AssetCooker.h"
+#include "headers/FileHandler.h"
+#include "headers/Logger.h"
+#include "external/jsoncpp/json.h"
+#include <algorithm>
+#include <fstream>
+#include <cctype>
+
+/*	Cooks every model and image in a data directory (see AssetCooker) and writes the manifest next to them.
+*
+*	Usage: bRendererCook [data directory] [number of threads]
+*
+*	Models have to be cooked with the same flipT and flipZ options they are loaded with.
+*	These are read from the optional file cook.json in the data directory, e.g.
+*	{ "models": { "cave.obj": { "flipT": true, "flipZ": true } } }
+*	Models that are not listed are cooked without flipping.
+*/
+
+const std::string COOK_OPTIONS_FILE = "cook.json";
+const std::string COOK_MANIFEST_FILE = "cook_manifest.json";
+
+std::string getExtension(const std::string &fileName)
+{
+	size_t dot = fileName.find_last_of(".");
+	if (dot == std::string::npos)
+		return "";
+	std::string extension = fileName.substr(dot);
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return extension;
+}
+
+bool isModel(const std::string &fileName)
+{
+	return getExtension(fileName) == ".obj";
+}
+
+bool isImage(const std::string &fileName)
+{
+	std::string extension = getExtension(fileName);
+	return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp";
+}
+
+int main(int argc, char *argv[])
+{
+	std::string dataPath = argc > 1 ? argv[1] : "project/data";
+	GLuint nThreads = argc > 2 ? static_cast<GLuint>(std::max(std::atoi(argv[2]), 0)) : 0;
+	bRenderer::setStandardFilePath(dataPath);
+
+	// Options of the models
+	Json::Value options;
+	if (bRenderer::fileExists(COOK_OPTIONS_FILE))
+	{
+		std::ifstream file(bRenderer::getFilePath(COOK_OPTIONS_FILE), std::ifstream::in);
+		Json::Reader reader;
+		if (!reader.parse(file, options))
+		{
+			bRenderer::log("Could not parse " + COOK_OPTIONS_FILE + ": " + reader.getFormattedErrorMessages(), bRenderer::LM_ERROR);
+			return 1;
+		}
+	}
+	const Json::Value &modelOptions = options["models"];
+
+	std::vector< std::string > fileNames;
+	if (!bRenderer::listFiles("", fileNames))
+		return 1;
+
+	AssetCooker cooker;
+	for (auto i = fileNames.begin(); i != fileNames.end(); ++i)
+	{
+		if (isModel(*i))
+		{
+			const Json::Value &model = modelOptions[*i];
+			cooker.addModel(*i, model.get("flipT", false).asBool(), model.get("flipZ", false).asBool());
+		}
+		else if (isImage(*i))
+		{
+			cooker.addTexture(*i);
+		}
+	}
+
+	std::string manifestPath = dataPath;
+	if (manifestPath.find_last_of("/") != manifestPath.length() - 1)
+		manifestPath.append("/");
+	manifestPath.append(COOK_MANIFEST_FILE);
+
+	return cooker.run(manifestPath, nThreads) ? 0 : 1;
+}
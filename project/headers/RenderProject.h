@@ -63,6 +63,9 @@ private:
 	bool _running = false; 
 	GLint _lastStateSpaceKey = 0;
 	vmml::Matrix4f _viewMatrixHUD;
+	vmml::Matrix4f _caveModelMatrix;
+	OcclusionCullerPtr _occlusionCuller;
+	size_t _occlusionCulled = 0;
 
 };
 
@@ -54,6 +54,12 @@ void RenderProject::initFunction()
 	//bRenderer().getObjects()->loadObjModel("torch.obj", false, true, false, 1, false, true);							// create custom shader with a maximum of 1 light
 	bRenderer().getObjects()->loadObjModel_o("torch.obj", 1, FLIP_Z | AMBIENT_LIGHTING);							// create custom shader with a maximum of 1 light
 
+	// occlusion culling: the walls of the cave hide the crystals behind them
+	_caveModelMatrix = vmml::create_translation(vmml::Vector3f(30.f, -24.0, 0.0)) * vmml::create_scaling(vmml::Vector3f(0.3f));
+	_occlusionCuller = OcclusionCullerPtr(new OcclusionCuller());															// small depth buffer rasterized on all cores
+	_occlusionCuller->addOccluder(ModelData(std::string("cave.obj"), true, true), _caveModelMatrix);						// the cave has few enough triangles to be its own occluder
+	bRenderer().getModelRenderer()->setOcclusionCuller(_occlusionCuller);
+
 	// create sprites
 	bRenderer().getObjects()->createSprite_o("flame", flameMaterial, NO_OPTION, flameProperties);				// create a sprite using the material created above, to pass additional properties a Properties object is used
 	bRenderer().getObjects()->createSprite("sparks", "sparks.png");										// create a sprite displaying sparks as a texture
@@ -185,9 +191,13 @@ void RenderProject::terminateFunction()
 /* Update render queue */
 void RenderProject::updateRenderQueue(const std::string &camera, const double &deltaTime)
 {
+	/*** Occluders ***/
+	// render the occluders seen by the camera before queueing the instances they may hide
+	_occlusionCuller->render(bRenderer().getObjects()->getCamera(camera)->getViewMatrix(), bRenderer().getObjects()->getCamera(camera)->getProjectionMatrix());
+
 	/*** Cave ***/
 	// translate and scale 
-	vmml::Matrix4f modelMatrix = vmml::create_translation(vmml::Vector3f(30.f, -24.0, 0.0)) * vmml::create_scaling(vmml::Vector3f(0.3f));
+	vmml::Matrix4f modelMatrix = _caveModelMatrix;
 	// submit to render queue
 	bRenderer().getModelRenderer()->queueModelInstance("cave", "cave_instance", camera, modelMatrix, std::vector<std::string>({ "torchLight", "firstLight", "secondLight", "thirdLight" }), true, true);
 	
@@ -268,6 +278,12 @@ void RenderProject::updateRenderQueue(const std::string &camera, const double &d
 		bRenderer().getModelRenderer()->queueModelInstance(bRenderer().getObjects()->getModel("sparks"), ("sparks_instance" + std::to_string(z)), modelMatrix, _viewMatrixHUD, vmml::Matrix4f::IDENTITY, std::vector<std::string>({}), false, false, true, GL_SRC_ALPHA, GL_ONE, (-2.0f - 0.01f*z)); // negative distance because always in foreground
 	}
 
+	/*** Occlusion culling ***/
+	// write the number of instances hidden behind the cave walls to the console whenever it changes
+	if (_occlusionCuller->getNumCulled() != _occlusionCulled){
+		_occlusionCulled = _occlusionCuller->getNumCulled();
+		bRenderer::log("Occlusion culling: " + std::to_string(_occlusionCulled) + " of " + std::to_string(_occlusionCuller->getNumTested()) + " instances hidden");
+	}
 }
 
 /* Camera movement */